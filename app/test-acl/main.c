@@ -42,6 +42,8 @@
 #define	OPT_VERBOSE		"verbose"
 #define	OPT_IPV6		"ipv6"
 
+#define	SEARCH_ALG_ALL		"all"
+
 #define	TRACE_DEFAULT_NUM	0x10000
 #define	TRACE_STEP_MAX		0x1000
 #define	TRACE_STEP_DEF		0x100
@@ -81,6 +83,10 @@ static const struct acl_alg acl_alg[] = {
 		.name = "altivec",
 		.alg = RTE_ACL_CLASSIFY_ALTIVEC,
 	},
+	{
+		.name = "avx512",
+		.alg = RTE_ACL_CLASSIFY_AVX512,
+	},
 };
 
 static struct {
@@ -98,6 +104,7 @@ static struct {
 	uint32_t            verbose;
 	uint32_t            ipv6;
 	struct acl_alg      alg;
+	uint32_t            alg_mask;
 	uint32_t            used_traces;
 	void               *traces;
 	struct rte_acl_ctx *acx;
@@ -757,6 +764,7 @@ static void
 acx_init(void)
 {
 	int ret;
+	uint32_t i;
 	FILE *f;
 	struct rte_acl_config cfg;
 
@@ -782,7 +790,18 @@ acx_init(void)
 		rte_exit(rte_errno, "failed to create ACL context\n");
 
 	/* set default classify method for this context. */
-	if (config.alg.alg != RTE_ACL_CLASSIFY_DEFAULT) {
+	if (config.alg.alg == RTE_ACL_CLASSIFY_NUM) {
+		/* figure out which methods can be run on this machine. */
+		for (i = 0; i != RTE_DIM(acl_alg); i++) {
+			if (rte_acl_set_ctx_classify(config.acx,
+					acl_alg[i].alg) == 0)
+				config.alg_mask |= 1 << i;
+			else
+				dump_verbose(DUMP_NONE, stdout,
+					"%s method is not supported, "
+					"skipping\n", acl_alg[i].name);
+		}
+	} else if (config.alg.alg != RTE_ACL_CLASSIFY_DEFAULT) {
 		ret = rte_acl_set_ctx_classify(config.acx, config.alg.alg);
 		if (ret != 0)
 			rte_exit(ret, "failed to setup %s method "
@@ -815,7 +834,8 @@ acx_init(void)
 }
 
 static uint32_t
-search_ip5tuples_once(uint32_t categories, uint32_t step, const char *alg)
+search_ip5tuples_once(uint32_t categories, uint32_t step,
+	const struct acl_alg *alg)
 {
 	int ret;
 	uint32_t i, j, k, n, r;
@@ -832,8 +852,13 @@ search_ip5tuples_once(uint32_t categories, uint32_t step, const char *alg)
 			v += config.trace_sz;
 		}
 
-		ret = rte_acl_classify(config.acx, data, results,
-			n, categories);
+		/* in "all" mode each method is requested explicitly. */
+		if (config.alg.alg == RTE_ACL_CLASSIFY_NUM)
+			ret = rte_acl_classify_alg(config.acx, data, results,
+				n, categories, alg->alg);
+		else
+			ret = rte_acl_classify(config.acx, data, results,
+				n, categories);
 
 		if (ret != 0)
 			rte_exit(ret, "classify for ipv%c_5tuples returns %d\n",
@@ -853,31 +878,52 @@ search_ip5tuples_once(uint32_t categories, uint32_t step, const char *alg)
 
 	dump_verbose(DUMP_SEARCH, stdout,
 		"%s(%u, %u, %s) returns %u\n", __func__,
-		categories, step, alg, i);
+		categories, step, alg->name, i);
 	return i;
 }
 
-static int
-search_ip5tuples(__rte_unused void *arg)
+static void
+search_ip5tuples_alg(uint32_t lcore, const struct acl_alg *alg)
 {
 	uint64_t pkt, start, tm;
-	uint32_t i, lcore;
+	uint32_t i;
 
-	lcore = rte_lcore_id();
 	start = rte_rdtsc();
 	pkt = 0;
 
 	for (i = 0; i != config.iter_num; i++) {
 		pkt += search_ip5tuples_once(config.run_categories,
-			config.trace_step, config.alg.name);
+			config.trace_step, alg);
 	}
 
 	tm = rte_rdtsc() - start;
 	dump_verbose(DUMP_NONE, stdout,
-		"%s  @lcore %u: %" PRIu32 " iterations, %" PRIu64 " pkts, %"
-		PRIu32 " categories, %" PRIu64 " cycles, %#Lf cycles/pkt\n",
-		__func__, lcore, i, pkt, config.run_categories,
-		tm, (pkt == 0) ? 0 : (long double)tm / pkt);
+		"%s  @lcore %u, %s: %" PRIu32 " iterations, %" PRIu64
+		" pkts, %" PRIu32 " categories, %" PRIu64
+		" cycles, %#Lf cycles/pkt, %#Lf Mpps\n",
+		__func__, lcore, alg->name, i, pkt, config.run_categories,
+		tm, (pkt == 0) ? 0 : (long double)tm / pkt,
+		(tm == 0) ? 0 :
+		(long double)pkt * rte_get_tsc_hz() / tm / 1000000);
+}
+
+static int
+search_ip5tuples(__rte_unused void *arg)
+{
+	uint32_t i, lcore;
+
+	lcore = rte_lcore_id();
+
+	if (config.alg.alg != RTE_ACL_CLASSIFY_NUM) {
+		search_ip5tuples_alg(lcore, &config.alg);
+		return 0;
+	}
+
+	/* measure all methods supported on this machine one by one. */
+	for (i = 0; i != RTE_DIM(acl_alg); i++) {
+		if ((config.alg_mask & (1 << i)) != 0)
+			search_ip5tuples_alg(lcore, acl_alg + i);
+	}
 
 	return 0;
 }
@@ -908,6 +954,12 @@ get_alg_opt(const char *opt, const char *name)
 		}
 	}
 
+	if (strcmp(opt, SEARCH_ALG_ALL) == 0) {
+		config.alg.name = SEARCH_ALG_ALL;
+		config.alg.alg = RTE_ACL_CLASSIFY_NUM;
+		return;
+	}
+
 	rte_exit(-EINVAL, "invalid value: \"%s\" for option: %s\n",
 		opt, name);
 }
@@ -921,7 +973,7 @@ print_usage(const char *prgname)
 	n = 0;
 	buf[0] = 0;
 
-	for (i = 0; i < RTE_DIM(acl_alg) - 1; i++) {
+	for (i = 0; i < RTE_DIM(acl_alg); i++) {
 		rc = snprintf(buf + n, sizeof(buf) - n, "%s|",
 			acl_alg[i].name);
 		if (rc > sizeof(buf) - n)
@@ -929,7 +981,7 @@ print_usage(const char *prgname)
 		n += rc;
 	}
 
-	strlcpy(buf + n, acl_alg[i].name, sizeof(buf) - n);
+	strlcpy(buf + n, SEARCH_ALG_ALL, sizeof(buf) - n);
 
 	fprintf(stdout,
 		PRINT_USAGE_START
@@ -54,6 +54,7 @@ struct evt_options {
 	uint8_t dev_id;
 	uint8_t timdev_cnt;
 	uint8_t nb_timer_adptrs;
+	uint8_t nb_sched_lcores;
 	uint8_t timdev_use_burst;
 	uint8_t sched_type_list[EVT_MAX_STAGES];
 	uint16_t mbuf_sz;
@@ -138,6 +139,52 @@ evt_service_setup(uint32_t service_id)
 	return 0;
 }
 
+static inline int
+evt_service_setup_lcores(uint32_t service_id, uint8_t nb_lcores)
+{
+	int32_t core_cnt, i;
+	uint32_t core_array[RTE_MAX_LCORE];
+	uint8_t cnt, min_cnt, mapped;
+	unsigned int lcore;
+
+	if (nb_lcores <= 1)
+		return evt_service_setup(service_id);
+
+	/* Running on several lcores at once needs an MT safe service */
+	if (rte_service_probe_capability(service_id,
+				RTE_SERVICE_CAP_MT_SAFE) != 1)
+		return -ENOTSUP;
+
+	core_cnt = rte_service_lcore_list(core_array,
+			RTE_MAX_LCORE);
+	if (core_cnt < nb_lcores)
+		return -ENOENT;
+
+	/* Reset default mapping */
+	for (i = 0; i < core_cnt; i++)
+		rte_service_map_lcore_set(service_id, core_array[i], 0);
+
+	/* Map to the cores which have least number of services running. */
+	for (mapped = 0; mapped < nb_lcores; mapped++) {
+		lcore = 0;
+		min_cnt = UINT8_MAX;
+		for (i = 0; i < core_cnt; i++) {
+			if (rte_service_map_lcore_get(service_id,
+						core_array[i]) == 1)
+				continue;
+			cnt = rte_service_lcore_count_services(core_array[i]);
+			if (cnt < min_cnt) {
+				lcore = core_array[i];
+				min_cnt = cnt;
+			}
+		}
+		if (rte_service_map_lcore_set(service_id, lcore, 1))
+			return -ENOENT;
+	}
+
+	return 0;
+}
+
 static inline int
 evt_configure_eventdev(struct evt_options *opt, uint8_t nb_queues,
 		uint8_t nb_ports)
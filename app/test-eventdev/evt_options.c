@@ -30,6 +30,7 @@ evt_options_default(struct evt_options *opt)
 	opt->nb_pkts = (1ULL << 26); /* do ~64M packets */
 	opt->nb_timers = 1E8;
 	opt->nb_timer_adptrs = 1;
+	opt->nb_sched_lcores = 1;
 	opt->timer_tick_nsec = 1E3; /* 1000ns ~ 1us */
 	opt->max_tmo_nsec = 1E5;  /* 100000ns ~100us */
 	opt->expiry_nsec = 1E4;   /* 10000ns ~10us */
@@ -201,6 +202,18 @@ evt_parse_nb_timer_adptrs(struct evt_options *opt, const char *arg)
 	return ret;
 }
 
+static int
+evt_parse_nb_sched_lcores(struct evt_options *opt, const char *arg)
+{
+	int ret;
+
+	ret = parser_read_uint8(&(opt->nb_sched_lcores), arg);
+	if (!ret && opt->nb_sched_lcores == 0)
+		ret = -EINVAL;
+
+	return ret;
+}
+
 static int
 evt_parse_pool_sz(struct evt_options *opt, const char *arg)
 {
@@ -280,6 +293,8 @@ usage(char *program)
 		"\t                             burst mode.\n"
 		"\t--nb_timers        : number of timers to arm.\n"
 		"\t--nb_timer_adptrs  : number of timer adapters to use.\n"
+		"\t--nb_sched_lcores  : number of service lcores running the\n"
+		"\t                     event device scheduler service.\n"
 		"\t--timer_tick_nsec  : timer tick interval in ns.\n"
 		"\t--max_tmo_nsec     : max timeout interval in ns.\n"
 		"\t--expiry_nsec      : event timer expiry ns.\n"
@@ -351,6 +366,7 @@ static struct option lgopts[] = {
 	{ EVT_PROD_TIMERDEV_BURST, 0, 0, 0 },
 	{ EVT_NB_TIMERS,           1, 0, 0 },
 	{ EVT_NB_TIMER_ADPTRS,     1, 0, 0 },
+	{ EVT_NB_SCHED_LCORES,     1, 0, 0 },
 	{ EVT_TIMER_TICK_NSEC,     1, 0, 0 },
 	{ EVT_MAX_TMO_NSEC,        1, 0, 0 },
 	{ EVT_EXPIRY_NSEC,         1, 0, 0 },
@@ -385,6 +401,7 @@ evt_opts_parse_long(int opt_idx, struct evt_options *opt)
 		{ EVT_PROD_TIMERDEV_BURST, evt_parse_timer_prod_type_burst},
 		{ EVT_NB_TIMERS, evt_parse_nb_timers},
 		{ EVT_NB_TIMER_ADPTRS, evt_parse_nb_timer_adptrs},
+		{ EVT_NB_SCHED_LCORES, evt_parse_nb_sched_lcores},
 		{ EVT_TIMER_TICK_NSEC, evt_parse_timer_tick_nsec},
 		{ EVT_MAX_TMO_NSEC, evt_parse_max_tmo_nsec},
 		{ EVT_EXPIRY_NSEC, evt_parse_expiry_nsec},
@@ -37,6 +37,7 @@
 #define EVT_PROD_TIMERDEV_BURST  ("prod_type_timerdev_burst")
 #define EVT_NB_TIMERS            ("nb_timers")
 #define EVT_NB_TIMER_ADPTRS      ("nb_timer_adptrs")
+#define EVT_NB_SCHED_LCORES      ("nb_sched_lcores")
 #define EVT_TIMER_TICK_NSEC      ("timer_tick_nsec")
 #define EVT_MAX_TMO_NSEC         ("max_tmo_nsec")
 #define EVT_EXPIRY_NSEC          ("expiry_nsec")
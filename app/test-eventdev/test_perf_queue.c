@@ -229,7 +229,13 @@ perf_queue_eventdev_setup(struct evt_test *test, struct evt_options *opt)
 	if (!evt_has_distributed_sched(opt->dev_id)) {
 		uint32_t service_id;
 		rte_event_dev_service_id_get(opt->dev_id, &service_id);
-		ret = evt_service_setup(service_id);
+		ret = evt_service_setup_lcores(service_id,
+				opt->nb_sched_lcores);
+		if (ret == -ENOTSUP) {
+			evt_err("Event dev service can't run on %d lcores.",
+					opt->nb_sched_lcores);
+			return ret;
+		}
 		if (ret) {
 			evt_err("No service lcore found to run event dev.");
 			return ret;
@@ -278,6 +284,7 @@ static void
 perf_queue_opt_dump(struct evt_options *opt)
 {
 	evt_dump_fwd_latency(opt);
+	evt_dump("nb_sched_lcores", "%d", opt->nb_sched_lcores);
 	perf_opt_dump(opt, perf_queue_nb_event_queues(opt));
 }
 
@@ -46,8 +46,22 @@
 #define DRY_RUN_FLAG		(1 << 8)
 
 static char *distrib_string;
+static char *lookup_fn_string;
 static char line[LINE_MAX];
 
+/* lookup function names for -v option, "all" runs every supported one */
+static const char * const lookup_fn_names_v4[] = {
+	[RTE_FIB_DIR24_8_SCALAR_MACRO] = "s1",
+	[RTE_FIB_DIR24_8_SCALAR_INLINE] = "s2",
+	[RTE_FIB_DIR24_8_SCALAR_UNI] = "s3",
+	[RTE_FIB_DIR24_8_VECTOR_AVX512] = "v",
+};
+
+static const char * const lookup_fn_names_v6[] = {
+	[RTE_FIB6_TRIE_SCALAR] = "s",
+	[RTE_FIB6_TRIE_VECTOR_AVX512] = "v",
+};
+
 enum {
 	RT_PREFIX,
 	RT_NEXTHOP,
@@ -638,10 +652,39 @@ print_usage(void)
 		"1/2/4/8 (default 4)>]\n"
 		"[-g <number of tbl8's for dir24_8 or trie FIBs>]\n"
 		"[-w <path to the file to dump routing table>]\n"
-		"[-u <path to the file to dump ip's for lookup>]\n",
+		"[-u <path to the file to dump ip's for lookup>]\n"
+		"[-v <lookup function (valid only for dir and trie fib "
+		"types)>]\n\tavailable options for ipv4:\n"
+		"\t\ts1, s2, s3 - scalar implementations\n"
+		"\t\tv - AVX512 vector implementation\n"
+		"\tavailable options for ipv6:\n"
+		"\t\ts - scalar implementation\n"
+		"\t\tv - AVX512 vector implementation\n"
+		"\tall - measure every lookup function supported\n",
 		config.prgname);
 }
 
+static int
+get_lookup_fn(const char *name)
+{
+	uint32_t i, n;
+	const char * const *names;
+
+	if (config.flags & IPV6_FLAG) {
+		names = lookup_fn_names_v6;
+		n = RTE_DIM(lookup_fn_names_v6);
+	} else {
+		names = lookup_fn_names_v4;
+		n = RTE_DIM(lookup_fn_names_v4);
+	}
+
+	for (i = 0; i != n; i++) {
+		if (strcmp(name, names[i]) == 0)
+			return i;
+	}
+	return -1;
+}
+
 static int
 check_config(void)
 {
@@ -672,6 +715,20 @@ check_config(void)
 		printf("-e 1 is valid only for ipv4\n");
 		return -1;
 	}
+
+	if ((lookup_fn_string != NULL) &&
+			(get_fib_type() != RTE_FIB_DIR24_8) &&
+			(get_fib_type() != RTE_FIB6_TRIE)) {
+		printf("-v option is valid only for dir and trie fib types\n");
+		return -1;
+	}
+
+	if ((lookup_fn_string != NULL) &&
+			(strcmp(lookup_fn_string, "all") != 0) &&
+			(get_lookup_fn(lookup_fn_string) < 0)) {
+		printf("wrong -v option %s\n", lookup_fn_string);
+		return -1;
+	}
 	return 0;
 }
 
@@ -681,7 +738,7 @@ parse_opts(int argc, char **argv)
 	int opt;
 	char *endptr;
 
-	while ((opt = getopt(argc, argv, "f:t:n:d:l:r:c6ab:e:g:w:u:s")) !=
+	while ((opt = getopt(argc, argv, "f:t:n:d:l:r:c6ab:e:g:w:u:sv:")) !=
 			-1) {
 		switch (opt) {
 		case 'f':
@@ -769,6 +826,9 @@ parse_opts(int argc, char **argv)
 				rte_exit(-EINVAL, "Invalid option -g\n");
 			}
 			break;
+		case 'v':
+			lookup_fn_string = optarg;
+			break;
 		default:
 			print_usage();
 			rte_exit(-EINVAL, "Invalid options\n");
@@ -803,6 +863,45 @@ print_depth_err(void)
 		"-d 0:0 option or remove /0 prefix from routes file\n");
 }
 
+/*
+ * Report cycles per lookup and, for a given lookup function,
+ * the lookup throughput.
+ */
+static void
+print_lookup_perf(const char *fn_name, uint64_t acc, uint32_t num)
+{
+	double cycles = (double)acc / (double)num;
+
+	if (fn_name == NULL)
+		printf("AVG FIB lookup %.1f\n", cycles);
+	else
+		printf("AVG FIB lookup (%s) %.1f, %.2f Mpps\n", fn_name,
+			cycles, (double)rte_get_tsc_hz() / cycles / 1E6);
+}
+
+static int
+lookup_v4(struct rte_fib *fib, const char *fn_name)
+{
+	uint64_t start, acc;
+	uint32_t i;
+	int ret;
+	uint32_t *tbl4 = config.lookup_tbl;
+	uint64_t fib_nh[BURST_SZ];
+
+	acc = 0;
+	for (i = 0; i < config.nb_lookup_ips; i += BURST_SZ) {
+		start = rte_rdtsc_precise();
+		ret = rte_fib_lookup_bulk(fib, tbl4 + i, fib_nh, BURST_SZ);
+		acc += rte_rdtsc_precise() - start;
+		if (ret != 0) {
+			printf("FIB lookup fails, err %d\n", ret);
+			return -ret;
+		}
+	}
+	print_lookup_perf(fn_name, acc, i);
+	return 0;
+}
+
 static int
 run_v4(void)
 {
@@ -891,17 +990,30 @@ run_v4(void)
 		}
 	}
 
-	acc = 0;
-	for (i = 0; i < config.nb_lookup_ips; i += BURST_SZ) {
-		start = rte_rdtsc_precise();
-		ret = rte_fib_lookup_bulk(fib, tbl4 + i, fib_nh, BURST_SZ);
-		acc += rte_rdtsc_precise() - start;
+	if (lookup_fn_string == NULL) {
+		ret = lookup_v4(fib, NULL);
+		if (ret != 0)
+			return ret;
+	}
+
+	for (k = 0; lookup_fn_string != NULL &&
+			k != RTE_DIM(lookup_fn_names_v4); k++) {
+		if (strcmp(lookup_fn_string, "all") != 0 &&
+				strcmp(lookup_fn_string,
+				lookup_fn_names_v4[k]) != 0)
+			continue;
+		ret = rte_fib_set_lookup_fn(fib, k);
 		if (ret != 0) {
-			printf("FIB lookup fails, err %d\n", ret);
+			printf("Lookup function %s is not supported, "
+				"err %d\n", lookup_fn_names_v4[k], ret);
+			if (strcmp(lookup_fn_string, "all") == 0)
+				continue;
 			return -ret;
 		}
+		ret = lookup_v4(fib, lookup_fn_names_v4[k]);
+		if (ret != 0)
+			return ret;
 	}
-	printf("AVG FIB lookup %.1f\n", (double)acc / (double)i);
 
 	if (config.flags & CMP_FLAG) {
 		acc = 0;
@@ -981,6 +1093,30 @@ dump_rt_6(struct rt_rule_6 *rt)
 	return 0;
 }
 
+static int
+lookup_v6(struct rte_fib6 *fib, const char *fn_name)
+{
+	uint64_t start, acc;
+	uint32_t i;
+	int ret;
+	uint8_t *tbl6 = config.lookup_tbl;
+	uint64_t fib_nh[BURST_SZ];
+
+	acc = 0;
+	for (i = 0; i < config.nb_lookup_ips; i += BURST_SZ) {
+		start = rte_rdtsc_precise();
+		ret = rte_fib6_lookup_bulk(fib, (uint8_t (*)[16])(tbl6 + i*16),
+			fib_nh, BURST_SZ);
+		acc += rte_rdtsc_precise() - start;
+		if (ret != 0) {
+			printf("FIB lookup fails, err %d\n", ret);
+			return -ret;
+		}
+	}
+	print_lookup_perf(fn_name, acc, i);
+	return 0;
+}
+
 static int
 run_v6(void)
 {
@@ -1070,18 +1206,30 @@ run_v6(void)
 		}
 	}
 
-	acc = 0;
-	for (i = 0; i < config.nb_lookup_ips; i += BURST_SZ) {
-		start = rte_rdtsc_precise();
-		ret = rte_fib6_lookup_bulk(fib, (uint8_t (*)[16])(tbl6 + i*16),
-			fib_nh, BURST_SZ);
-		acc += rte_rdtsc_precise() - start;
+	if (lookup_fn_string == NULL) {
+		ret = lookup_v6(fib, NULL);
+		if (ret != 0)
+			return ret;
+	}
+
+	for (k = 0; lookup_fn_string != NULL &&
+			k != RTE_DIM(lookup_fn_names_v6); k++) {
+		if (strcmp(lookup_fn_string, "all") != 0 &&
+				strcmp(lookup_fn_string,
+				lookup_fn_names_v6[k]) != 0)
+			continue;
+		ret = rte_fib6_set_lookup_fn(fib, k);
 		if (ret != 0) {
-			printf("FIB lookup fails, err %d\n", ret);
+			printf("Lookup function %s is not supported, "
+				"err %d\n", lookup_fn_names_v6[k], ret);
+			if (strcmp(lookup_fn_string, "all") == 0)
+				continue;
 			return -ret;
 		}
+		ret = lookup_v6(fib, lookup_fn_names_v6[k]);
+		if (ret != 0)
+			return ret;
 	}
-	printf("AVG FIB lookup %.1f\n", (double)acc / (double)i);
 
 	if (config.flags & CMP_FLAG) {
 		acc = 0;
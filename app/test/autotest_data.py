@@ -796,6 +796,12 @@
         "Func":    default_autotest,
         "Report":  None,
     },
+    {
+        "Name":    "Sched performance autotest",
+        "Command": "sched_perf_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
     #
     # Please always make sure that ring_perf is the last test!
     #
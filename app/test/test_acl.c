@@ -13,6 +13,9 @@
 #include <rte_ip.h>
 #include <rte_acl.h>
 #include <rte_common.h>
+#include <rte_malloc.h>
+#include <rte_random.h>
+#include <rte_rcu_qsbr.h>
 
 #include "test_acl.h"
 
@@ -265,23 +268,47 @@ rte_acl_ipv4vlan_build(struct rte_acl_ctx *ctx,
 	return rte_acl_build(ctx, &cfg);
 }
 
-/*
- * Test scalar and SSE ACL lookup.
- */
 static int
-test_classify_run(struct rte_acl_ctx *acx, struct ipv4_7tuple test_data[],
-	size_t dim)
+verify_classify_results(const struct ipv4_7tuple test_data[],
+	const uint32_t results[], size_t num, const char *alg)
 {
-	int ret, i;
-	uint32_t result, count;
-	uint32_t results[dim * RTE_ACL_MAX_CATEGORIES];
-	const uint8_t *data[dim];
-	/* swap all bytes in the data to network order */
-	bswap_test_data(test_data, dim, 1);
+	size_t i;
+	uint32_t result;
 
-	/* store pointers to test data */
-	for (i = 0; i < (int) dim; i++)
-		data[i] = (uint8_t *)&test_data[i];
+	/* check if we allow everything we should allow */
+	for (i = 0; i != num; i++) {
+		result = results[i * RTE_ACL_MAX_CATEGORIES + ACL_ALLOW];
+		if (result != test_data[i].allow) {
+			printf("Line %i: %s: Error in allow results at %zu "
+				"(expected %"PRIu32" got %"PRIu32")!\n",
+				__LINE__, alg, i, test_data[i].allow,
+				result);
+			return -EINVAL;
+		}
+	}
+
+	/* check if we deny everything we should deny */
+	for (i = 0; i != num; i++) {
+		result = results[i * RTE_ACL_MAX_CATEGORIES + ACL_DENY];
+		if (result != test_data[i].deny) {
+			printf("Line %i: %s: Error in deny results at %zu "
+				"(expected %"PRIu32" got %"PRIu32")!\n",
+				__LINE__, alg, i, test_data[i].deny,
+				result);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+static int
+test_classify_alg(struct rte_acl_ctx *acx, struct ipv4_7tuple test_data[],
+	const uint8_t *data[], size_t dim, const char *alg)
+{
+	int ret;
+	uint32_t count;
+	uint32_t results[dim * RTE_ACL_MAX_CATEGORIES];
 
 	/**
 	 * these will run quite a few times, it's necessary to test code paths
@@ -290,76 +317,70 @@ test_classify_run(struct rte_acl_ctx *acx, struct ipv4_7tuple test_data[],
 	for (count = 0; count <= dim; count++) {
 		ret = rte_acl_classify(acx, data, results,
 				count, RTE_ACL_MAX_CATEGORIES);
+		/* method is not available on this architecture */
+		if (ret == -ENOTSUP)
+			return ret;
 		if (ret != 0) {
-			printf("Line %i: SSE classify failed!\n", __LINE__);
-			goto err;
-		}
-
-		/* check if we allow everything we should allow */
-		for (i = 0; i < (int) count; i++) {
-			result =
-				results[i * RTE_ACL_MAX_CATEGORIES + ACL_ALLOW];
-			if (result != test_data[i].allow) {
-				printf("Line %i: Error in allow results at %i "
-					"(expected %"PRIu32" got %"PRIu32")!\n",
-					__LINE__, i, test_data[i].allow,
-					result);
-				ret = -EINVAL;
-				goto err;
-			}
+			printf("Line %i: %s classify failed!\n",
+				__LINE__, alg);
+			return ret;
 		}
 
-		/* check if we deny everything we should deny */
-		for (i = 0; i < (int) count; i++) {
-			result = results[i * RTE_ACL_MAX_CATEGORIES + ACL_DENY];
-			if (result != test_data[i].deny) {
-				printf("Line %i: Error in deny results at %i "
-					"(expected %"PRIu32" got %"PRIu32")!\n",
-					__LINE__, i, test_data[i].deny,
-					result);
-				ret = -EINVAL;
-				goto err;
-			}
-		}
+		ret = verify_classify_results(test_data, results, count, alg);
+		if (ret != 0)
+			return ret;
 	}
 
-	/* make a quick check for scalar */
-	ret = rte_acl_classify_alg(acx, data, results,
-			dim, RTE_ACL_MAX_CATEGORIES,
-			RTE_ACL_CLASSIFY_SCALAR);
-	if (ret != 0) {
-		printf("Line %i: scalar classify failed!\n", __LINE__);
+	return 0;
+}
+
+/*
+ * Test ACL lookup with default and all other available classify methods.
+ */
+static int
+test_classify_run(struct rte_acl_ctx *acx, struct ipv4_7tuple test_data[],
+	size_t dim)
+{
+	int ret, i;
+	uint32_t j;
+	const uint8_t *data[dim];
+
+	static const struct {
+		const char *name;
+		enum rte_acl_classify_alg alg;
+	} test_alg[] = {
+		{"scalar", RTE_ACL_CLASSIFY_SCALAR},
+		{"sse", RTE_ACL_CLASSIFY_SSE},
+		{"avx2", RTE_ACL_CLASSIFY_AVX2},
+		{"neon", RTE_ACL_CLASSIFY_NEON},
+		{"altivec", RTE_ACL_CLASSIFY_ALTIVEC},
+		{"avx512", RTE_ACL_CLASSIFY_AVX512},
+	};
+
+	/* swap all bytes in the data to network order */
+	bswap_test_data(test_data, dim, 1);
+
+	/* store pointers to test data */
+	for (i = 0; i < (int) dim; i++)
+		data[i] = (uint8_t *)&test_data[i];
+
+	ret = test_classify_alg(acx, test_data, data, dim, "default");
+	if (ret != 0)
 		goto err;
-	}
 
-	/* check if we allow everything we should allow */
-	for (i = 0; i < (int) dim; i++) {
-		result = results[i * RTE_ACL_MAX_CATEGORIES + ACL_ALLOW];
-		if (result != test_data[i].allow) {
-			printf("Line %i: Error in allow results at %i "
-					"(expected %"PRIu32" got %"PRIu32")!\n",
-					__LINE__, i, test_data[i].allow,
-					result);
-			ret = -EINVAL;
-			goto err;
-		}
-	}
+	for (j = 0; j != RTE_DIM(test_alg); j++) {
 
-	/* check if we deny everything we should deny */
-	for (i = 0; i < (int) dim; i++) {
-		result = results[i * RTE_ACL_MAX_CATEGORIES + ACL_DENY];
-		if (result != test_data[i].deny) {
-			printf("Line %i: Error in deny results at %i "
-					"(expected %"PRIu32" got %"PRIu32")!\n",
-					__LINE__, i, test_data[i].deny,
-					result);
-			ret = -EINVAL;
+		/* skip methods not supported by the build or the CPU */
+		if (rte_acl_set_ctx_classify(acx, test_alg[j].alg) != 0)
+			continue;
+
+		ret = test_classify_alg(acx, test_data, data, dim,
+			test_alg[j].name);
+		if (ret != 0 && ret != -ENOTSUP)
 			goto err;
-		}
 	}
 
 	ret = 0;
-
 err:
 	/* swap data back to cpu order so that next time tests don't fail */
 	bswap_test_data(test_data, dim, 0);
@@ -1715,6 +1736,329 @@ test_u32_range(void)
 	return rc;
 }
 
+/*
+ * Incremental updates test: random rules are added and deleted from a built
+ * context, results are checked against a brute-force search of alive rules.
+ */
+#define	UPDATE_TEST_RULES	256
+#define	UPDATE_TEST_DATA	512
+#define	UPDATE_TEST_ROUNDS	16
+
+struct update_test {
+	struct rte_acl_ipv4vlan_rule rules[UPDATE_TEST_RULES];
+	uint8_t alive[UPDATE_TEST_RULES];
+	struct ipv4_7tuple data[UPDATE_TEST_DATA];
+	const uint8_t *ptrs[UPDATE_TEST_DATA];
+	uint32_t results[UPDATE_TEST_DATA];
+};
+
+static uint32_t
+update_test_mask(uint32_t len)
+{
+	return (len == 0) ? 0 : UINT32_MAX << (BIT_SIZEOF(uint32_t) - len);
+}
+
+static void
+update_test_gen(struct update_test *ut)
+{
+	uint32_t i;
+	uint16_t p;
+	struct rte_acl_ipv4vlan_rule *r;
+
+	/* addresses within 10.0.0.0/22, so that rules overlap a lot. */
+	for (i = 0; i != RTE_DIM(ut->rules); i++) {
+		r = ut->rules + i;
+		memset(r, 0, sizeof(*r));
+		r->data.userdata = i + 1;
+		r->data.priority = (i * 37) % RTE_DIM(ut->rules) + 1;
+		r->data.category_mask = 1;
+		r->src_mask_len = 22 + rte_rand() % 4;
+		r->src_addr = (RTE_IPV4(10, 0, 0, 0) | (rte_rand() & 0x3ff)) &
+			update_test_mask(r->src_mask_len);
+		r->dst_mask_len = 22 + rte_rand() % 4;
+		r->dst_addr = (RTE_IPV4(10, 0, 0, 0) | (rte_rand() & 0x3ff)) &
+			update_test_mask(r->dst_mask_len);
+		p = rte_rand() % 64;
+		r->src_port_low = p;
+		r->src_port_high = p + rte_rand() % 128;
+		r->dst_port_low = 0;
+		r->dst_port_high = UINT16_MAX;
+	}
+
+	for (i = 0; i != RTE_DIM(ut->data); i++) {
+		memset(ut->data + i, 0, sizeof(ut->data[i]));
+		ut->data[i].ip_src = RTE_IPV4(10, 0, 0, 0) |
+			(rte_rand() & 0x3ff);
+		ut->data[i].ip_dst = RTE_IPV4(10, 0, 0, 0) |
+			(rte_rand() & 0x3ff);
+		ut->data[i].port_src = rte_rand() % 128;
+		ut->data[i].port_dst = rte_rand();
+		ut->ptrs[i] = (const uint8_t *)(ut->data + i);
+	}
+	bswap_test_data(ut->data, RTE_DIM(ut->data), 1);
+}
+
+static uint32_t
+update_test_match(const struct update_test *ut, const struct ipv4_7tuple *d)
+{
+	uint32_t i, src, dst, res;
+	uint16_t port;
+	int32_t prio;
+	const struct rte_acl_ipv4vlan_rule *r;
+
+	src = rte_be_to_cpu_32(d->ip_src);
+	dst = rte_be_to_cpu_32(d->ip_dst);
+	port = rte_be_to_cpu_16(d->port_src);
+
+	res = 0;
+	prio = INT32_MIN;
+	for (i = 0; i != RTE_DIM(ut->rules); i++) {
+		r = ut->rules + i;
+		if (ut->alive[i] != 0 && r->data.priority > prio &&
+				((src ^ r->src_addr) &
+				update_test_mask(r->src_mask_len)) == 0 &&
+				((dst ^ r->dst_addr) &
+				update_test_mask(r->dst_mask_len)) == 0 &&
+				port >= r->src_port_low &&
+				port <= r->src_port_high) {
+			res = r->data.userdata;
+			prio = r->data.priority;
+		}
+	}
+
+	return res;
+}
+
+static int
+update_test_verify(struct update_test *ut, struct rte_acl_ctx *acx,
+	uint32_t round)
+{
+	int32_t rc;
+	uint32_t i, res;
+
+	rc = rte_acl_classify(acx, ut->ptrs, ut->results, RTE_DIM(ut->ptrs),
+		1);
+	if (rc != 0) {
+		printf("%s#%i: round %u: classify failed: %d\n",
+			__func__, __LINE__, round, rc);
+		return -1;
+	}
+
+	for (i = 0; i != RTE_DIM(ut->ptrs); i++) {
+		res = update_test_match(ut, ut->data + i);
+		if (res != ut->results[i]) {
+			printf("%s#%i: round %u: input #%u, "
+				"result %u, expected %u\n",
+				__func__, __LINE__, round, i,
+				ut->results[i], res);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int
+update_test_round(struct update_test *ut, struct rte_acl_ctx *acx,
+	uint32_t round)
+{
+	int32_t rc;
+	uint32_t i, j, k, num_del;
+	uint32_t del[8];
+	struct acl_ipv4vlan_rule rv;
+
+	/* delete up to 8 alive rules. */
+	num_del = 0;
+	for (i = 0; i != RTE_DIM(del); i++) {
+		j = rte_rand() % RTE_DIM(ut->rules);
+		if (ut->alive[j] != 0) {
+			ut->alive[j] = 0;
+			del[num_del++] = ut->rules[j].data.userdata;
+		}
+	}
+
+	rc = rte_acl_update_del_rules(acx, del, num_del);
+	if (rc != 0) {
+		printf("%s#%i: round %u: deleting %u rules failed: %d\n",
+			__func__, __LINE__, round, num_del, rc);
+		return -1;
+	}
+
+	/* add up to 8 rules, including some of the just deleted ones. */
+	for (i = 0; i != 8; i++) {
+		j = rte_rand() % RTE_DIM(ut->rules);
+		if (ut->alive[j] == 0) {
+			/* re-added rules get a different destination. */
+			ut->rules[j].dst_addr ^= 1u << (32 -
+				ut->rules[j].dst_mask_len);
+			ut->rules[j].dst_addr &=
+				update_test_mask(ut->rules[j].dst_mask_len);
+			acl_ipv4vlan_convert_rule(ut->rules + j, &rv);
+			rc = rte_acl_update_add_rules(acx,
+				(struct rte_acl_rule *)&rv, 1);
+			if (rc != 0) {
+				printf("%s#%i: round %u: adding rule %u "
+					"failed: %d\n", __func__, __LINE__,
+					round, j, rc);
+				return -1;
+			}
+			ut->alive[j] = 1;
+		}
+	}
+
+	/* deleting rules which are not present fails. */
+	for (k = 0; k != RTE_DIM(del); k++) {
+		j = rte_rand() % RTE_DIM(ut->rules);
+		if (ut->alive[j] == 0 && rte_acl_update_del_rules(acx,
+				&ut->rules[j].data.userdata, 1) != -ENOENT) {
+			printf("%s#%i: round %u: deleting missing rule %u "
+				"succeeded\n", __func__, __LINE__, round, j);
+			return -1;
+		}
+	}
+
+	rc = rte_acl_update_commit(acx);
+	if (rc != 0) {
+		printf("%s#%i: round %u: commit failed: %d\n",
+			__func__, __LINE__, round, rc);
+		return -1;
+	}
+
+	return update_test_verify(ut, acx, round);
+}
+
+static int
+test_update_ctx(struct update_test *ut, const struct rte_acl_update_config *cfg)
+{
+	int32_t rc;
+	uint32_t i, ud;
+	struct rte_acl_ctx *acx;
+	struct acl_ipv4vlan_rule rv;
+
+	acx = rte_acl_create(&acl_param);
+	if (acx == NULL) {
+		printf("%s#%i: Error creating ACL context!\n",
+			__func__, __LINE__);
+		return -1;
+	}
+
+	update_test_gen(ut);
+
+	/* context has to be built first. */
+	rc = rte_acl_update_enable(acx, cfg);
+	if (rc != -EINVAL) {
+		printf("%s#%i: enabling updates on empty context: %d\n",
+			__func__, __LINE__, rc);
+		goto err;
+	}
+
+	/* half of the rules are in the initial build. */
+	memset(ut->alive, 0, sizeof(ut->alive));
+	for (i = 0; i != RTE_DIM(ut->rules); i += 2) {
+		acl_ipv4vlan_convert_rule(ut->rules + i, &rv);
+		rc = rte_acl_add_rules(acx, (struct rte_acl_rule *)&rv, 1);
+		if (rc != 0) {
+			printf("%s#%i: adding rule %u failed: %d\n",
+				__func__, __LINE__, i, rc);
+			goto err;
+		}
+		ut->alive[i] = 1;
+	}
+
+	rc = rte_acl_ipv4vlan_build(acx, ipv4_7tuple_layout, 1);
+	if (rc != 0) {
+		printf("%s#%i: build failed: %d\n", __func__, __LINE__, rc);
+		goto err;
+	}
+
+	rc = rte_acl_update_enable(acx, cfg);
+	if (rc != 0) {
+		printf("%s#%i: enabling updates failed: %d\n",
+			__func__, __LINE__, rc);
+		goto err;
+	}
+
+	rc = update_test_verify(ut, acx, 0);
+	if (rc != 0)
+		goto err;
+
+	/* userdata has to be unique. */
+	acl_ipv4vlan_convert_rule(ut->rules, &rv);
+	rc = rte_acl_update_add_rules(acx, (struct rte_acl_rule *)&rv, 1);
+	if (rc != -EEXIST) {
+		printf("%s#%i: adding existing rule: %d\n",
+			__func__, __LINE__, rc);
+		goto err;
+	}
+
+	ud = ut->rules[1].data.userdata;
+	rc = rte_acl_update_del_rules(acx, &ud, 1);
+	if (rc != -ENOENT) {
+		printf("%s#%i: deleting missing rule: %d\n",
+			__func__, __LINE__, rc);
+		goto err;
+	}
+
+	for (i = 1; i <= UPDATE_TEST_ROUNDS; i++) {
+		rc = update_test_round(ut, acx, i);
+		if (rc != 0)
+			goto err;
+	}
+
+	/* full build from the current rules disables updates. */
+	rc = rte_acl_ipv4vlan_build(acx, ipv4_7tuple_layout, 1);
+	if (rc == 0)
+		rc = update_test_verify(ut, acx, i);
+	if (rc == 0 && rte_acl_update_commit(acx) != -EINVAL)
+		rc = -1;
+	if (rc != 0) {
+		printf("%s#%i: rebuild after updates failed: %d\n",
+			__func__, __LINE__, rc);
+		goto err;
+	}
+
+err:
+	rte_acl_free(acx);
+	return rc;
+}
+
+static int
+test_update(void)
+{
+	int32_t rc;
+	size_t sz;
+	struct update_test *ut;
+	struct rte_rcu_qsbr *v;
+	struct rte_acl_update_config cfg;
+
+	ut = rte_zmalloc(NULL, sizeof(*ut), 0);
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	v = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (ut == NULL || v == NULL) {
+		printf("%s#%i: Error allocating memory!\n",
+			__func__, __LINE__);
+		rte_free(ut);
+		rte_free(v);
+		return -1;
+	}
+	rte_rcu_qsbr_init(v, RTE_MAX_LCORE);
+
+	/* delta only, no QSBR. */
+	memset(&cfg, 0, sizeof(cfg));
+	rc = test_update_ctx(ut, &cfg);
+
+	/* small delta limit, to trigger full rebuilds. */
+	if (rc == 0) {
+		cfg.v = v;
+		cfg.max_delta_rules = 32;
+		rc = test_update_ctx(ut, &cfg);
+	}
+
+	rte_free(ut);
+	rte_free(v);
+	return rc;
+}
+
 static int
 test_acl(void)
 {
@@ -1736,6 +2080,8 @@ test_acl(void)
 		return -1;
 	if (test_u32_range() < 0)
 		return -1;
+	if (test_update() < 0)
+		return -1;
 
 	return 0;
 }
@@ -10,6 +10,7 @@
 #include <rte_bus_vdev.h>
 
 #include <rte_event_eth_rx_adapter.h>
+#include <rte_service.h>
 
 #include "test.h"
 
@@ -20,6 +21,14 @@
 #define TEST_INST_ID		0
 #define TEST_DEV_ID		0
 #define TEST_ETHDEV_ID		0
+#define TEST_VEC_INST_ID	1
+#define TEST_VEC_SZ		16
+#define TEST_VEC_POOL_SZ	64
+#define TEST_VEC_RETRY		1000
+#define TEST_PART_INST_ID	2
+#define TEST_NB_PARTS		2
+#define TEST_PART_ITER		8
+#define TEST_PART_BURST		32
 
 struct event_eth_rx_adapter_test_params {
 	struct rte_mempool *mp;
@@ -458,6 +467,469 @@ adapter_queue_add_del(void)
 	return TEST_SUCCESS;
 }
 
+static int
+adapter_queue_event_vector_config(void)
+{
+	struct rte_event_eth_rx_adapter_event_vector_config vec_conf;
+	struct rte_event_eth_rx_adapter_queue_conf queue_config;
+	struct rte_mempool *vec_mp;
+	struct rte_event ev;
+	uint32_t cap;
+	int err;
+
+	err = rte_event_eth_rx_adapter_caps_get(TEST_DEV_ID, TEST_ETHDEV_ID,
+					 &cap);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	vec_mp = rte_event_vector_pool_create("vector_pool", TEST_VEC_POOL_SZ,
+					      0, TEST_VEC_SZ, rte_socket_id());
+	TEST_ASSERT(vec_mp != NULL, "Failed to create vector pool");
+
+	vec_conf.vector_sz = TEST_VEC_SZ;
+	vec_conf.vector_timeout_ns = 100 * 1000;
+	vec_conf.vector_mp = vec_mp;
+
+	if (!(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR) ||
+	    (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT)) {
+		err = rte_event_eth_rx_adapter_queue_event_vector_config(
+				TEST_INST_ID, TEST_ETHDEV_ID, -1, &vec_conf);
+		TEST_ASSERT(err == -ENOTSUP, "Expected -ENOTSUP got %d", err);
+		rte_mempool_free(vec_mp);
+		return TEST_SUCCESS;
+	}
+
+	memset(&ev, 0, sizeof(ev));
+	ev.queue_id = 0;
+	ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	ev.priority = 0;
+
+	queue_config.rx_queue_flags = 0;
+	queue_config.ev = ev;
+	queue_config.servicing_weight = 1;
+
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* Queues added without the vector flag can not be vectorized */
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					TEST_ETHDEV_ID, -1, &vec_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	queue_config.rx_queue_flags =
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					TEST_ETHDEV_ID, -1, NULL);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(1 +
+					TEST_VEC_INST_ID, TEST_ETHDEV_ID, -1,
+					&vec_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	/* Vector size must fit in the vector pool elements */
+	vec_conf.vector_sz = TEST_VEC_SZ + 1;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					TEST_ETHDEV_ID, -1, &vec_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	vec_conf.vector_sz = 0;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					TEST_ETHDEV_ID, -1, &vec_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	vec_conf.vector_sz = TEST_VEC_SZ;
+	vec_conf.vector_timeout_ns = 0;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					TEST_ETHDEV_ID, -1, &vec_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	vec_conf.vector_timeout_ns = 100 * 1000;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					TEST_ETHDEV_ID, -1, &vec_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0, &vec_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	rte_mempool_free(vec_mp);
+
+	return TEST_SUCCESS;
+}
+
+/* Run the Rx adapter and event device services once, dequeue what is ready */
+static uint16_t
+vector_dequeue(uint8_t dev_id, uint32_t rxa_sid, uint32_t edev_sid,
+	       struct rte_event *ev, uint16_t nb_ev)
+{
+	uint16_t n = 0;
+	int i;
+
+	for (i = 0; i < TEST_VEC_RETRY && n == 0; i++) {
+		rte_service_run_iter_on_app_lcore(rxa_sid, 0);
+		rte_service_run_iter_on_app_lcore(edev_sid, 0);
+		n = rte_event_dequeue_burst(dev_id, 0, ev, nb_ev, 0);
+	}
+
+	return n;
+}
+
+static void
+vector_release(struct rte_event *ev, uint16_t nb_ev)
+{
+	uint16_t i;
+
+	for (i = 0; i < nb_ev; i++) {
+		rte_pktmbuf_free_bulk(ev[i].vec->mbufs, ev[i].vec->nb_elem);
+		rte_mempool_put(rte_mempool_from_obj(ev[i].vec), ev[i].vec);
+	}
+}
+
+/* Enqueue on event port 1 and poll a single Rx burst per service call */
+static int
+vector_conf_cb(uint8_t id, uint8_t dev_id,
+	       struct rte_event_eth_rx_adapter_conf *conf, void *arg)
+{
+	RTE_SET_USED(id);
+	RTE_SET_USED(dev_id);
+	RTE_SET_USED(arg);
+
+	conf->event_port_id = 1;
+	conf->max_nb_rx = 1;
+	return 0;
+}
+
+static int
+adapter_event_vector_rx(void)
+{
+	struct rte_event_eth_rx_adapter_event_vector_config vec_conf;
+	struct rte_event_eth_rx_adapter_queue_conf queue_config;
+	struct rte_event_dev_config dev_conf;
+	struct rte_event_dev_info dev_info;
+	struct rte_event ev[TEST_VEC_POOL_SZ];
+	struct rte_mempool *vec_mp;
+	uint32_t rxa_sid, edev_sid;
+	uint16_t eth_port;
+	uint16_t i, n;
+	int dev_id;
+	int err;
+
+	/* The datapath needs a device that can actually schedule events */
+	if (rte_vdev_init("event_sw_vec", NULL))
+		return TEST_SKIPPED;
+	dev_id = rte_event_dev_get_dev_id("event_sw_vec");
+	TEST_ASSERT(dev_id >= 0, "Failed to get event device id");
+
+	err = rte_vdev_init("net_null_vec", NULL);
+	TEST_ASSERT(err == 0, "Failed to create net_null_vec %d", err);
+	err = rte_eth_dev_get_port_by_name("net_null_vec", &eth_port);
+	TEST_ASSERT(err == 0, "Failed to get eth port %d", err);
+	err = port_init(eth_port, default_params.mp);
+	TEST_ASSERT(err == 0, "Port initialization failed err %d", err);
+
+	err = rte_event_dev_info_get(dev_id, &dev_info);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	memset(&dev_conf, 0, sizeof(dev_conf));
+	dev_conf.nb_event_queues = 1;
+	dev_conf.nb_event_ports = 2;
+	dev_conf.nb_event_queue_flows = dev_info.max_event_queue_flows;
+	dev_conf.nb_event_port_dequeue_depth =
+			dev_info.max_event_port_dequeue_depth;
+	dev_conf.nb_event_port_enqueue_depth =
+			dev_info.max_event_port_enqueue_depth;
+	dev_conf.nb_events_limit = dev_info.max_num_events;
+	err = rte_event_dev_configure(dev_id, &dev_conf);
+	TEST_ASSERT(err == 0, "Event device configure failed err %d", err);
+
+	err = rte_event_queue_setup(dev_id, 0, NULL);
+	TEST_ASSERT(err == 0, "Event queue setup failed %d", err);
+	for (i = 0; i < dev_conf.nb_event_ports; i++) {
+		err = rte_event_port_setup(dev_id, i, NULL);
+		TEST_ASSERT(err == 0, "Event port setup failed %d", err);
+	}
+	err = rte_event_port_link(dev_id, 0, NULL, NULL, 0);
+	TEST_ASSERT(err == 1, "Failed to link port %d", err);
+
+	err = rte_event_eth_rx_adapter_create_ext(TEST_VEC_INST_ID, dev_id,
+						  vector_conf_cb, NULL);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	memset(&queue_config, 0, sizeof(queue_config));
+	queue_config.rx_queue_flags =
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR;
+	queue_config.ev.queue_id = 0;
+	queue_config.ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	queue_config.servicing_weight = 1;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_VEC_INST_ID, eth_port, 0,
+						 &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	vec_mp = rte_event_vector_pool_create("vector_pool_rx",
+					      TEST_VEC_POOL_SZ, 0,
+					      TEST_VEC_POOL_SZ, rte_socket_id());
+	TEST_ASSERT(vec_mp != NULL, "Failed to create vector pool");
+
+	/* Vectors complete well before they can time out */
+	vec_conf.vector_sz = TEST_VEC_SZ;
+	vec_conf.vector_timeout_ns = 1000ULL * 1000 * 1000;
+	vec_conf.vector_mp = vec_mp;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(
+			TEST_VEC_INST_ID, eth_port, 0, &vec_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_dev_service_id_get(dev_id, &edev_sid);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_service_id_get(TEST_VEC_INST_ID,
+						      &rxa_sid);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	rte_service_runstate_set(edev_sid, 1);
+	rte_service_set_runstate_mapped_check(edev_sid, 0);
+	rte_service_runstate_set(rxa_sid, 1);
+	rte_service_set_runstate_mapped_check(rxa_sid, 0);
+
+	err = rte_event_dev_start(dev_id);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_start(TEST_VEC_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	n = vector_dequeue(dev_id, rxa_sid, edev_sid, ev, RTE_DIM(ev));
+	TEST_ASSERT(n > 0, "No vector received");
+	for (i = 0; i < n; i++) {
+		TEST_ASSERT_EQUAL(ev[i].event_type,
+				  RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR,
+				  "Unexpected event type %u",
+				  ev[i].event_type);
+		TEST_ASSERT_EQUAL(ev[i].vec->nb_elem, TEST_VEC_SZ,
+				  "Expected %u mbufs got %u", TEST_VEC_SZ,
+				  ev[i].vec->nb_elem);
+		TEST_ASSERT(ev[i].vec->attr_valid &&
+			    ev[i].vec->port == eth_port &&
+			    ev[i].vec->queue == 0,
+			    "Invalid vector attributes");
+		TEST_ASSERT_EQUAL(ev[i].flow_id, ev[0].flow_id,
+				  "Vectors of a queue must share the flow");
+	}
+	vector_release(ev, n);
+
+	/*
+	 * With a vector size above the Rx burst size and a single tick
+	 * timeout, the partially filled vector expires on the next
+	 * service iteration, before it can be completed.
+	 */
+	vec_conf.vector_sz = TEST_VEC_POOL_SZ;
+	vec_conf.vector_timeout_ns = 1;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(
+			TEST_VEC_INST_ID, eth_port, 0, &vec_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	n = vector_dequeue(dev_id, rxa_sid, edev_sid, ev, RTE_DIM(ev));
+	TEST_ASSERT(n > 0, "No vector received");
+	for (i = 0; i < n; i++)
+		TEST_ASSERT(ev[i].vec->nb_elem > 0 &&
+			    ev[i].vec->nb_elem < TEST_VEC_POOL_SZ,
+			    "Expected a partial vector got %u mbufs",
+			    ev[i].vec->nb_elem);
+	vector_release(ev, n);
+
+	/* Deleting the queue releases its pending vector */
+	err = rte_event_eth_rx_adapter_stop(TEST_VEC_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_queue_del(TEST_VEC_INST_ID, eth_port,
+						 0);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	while ((n = vector_dequeue(dev_id, rxa_sid, edev_sid, ev,
+				   RTE_DIM(ev))) != 0)
+		vector_release(ev, n);
+	TEST_ASSERT_EQUAL(rte_mempool_avail_count(vec_mp), TEST_VEC_POOL_SZ,
+			  "Event vectors leaked");
+	rte_event_dev_stop(dev_id);
+
+	err = rte_event_eth_rx_adapter_free(TEST_VEC_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	rte_mempool_free(vec_mp);
+	rte_event_dev_close(dev_id);
+	rte_vdev_uninit("event_sw_vec");
+	rte_eth_dev_stop(eth_port);
+	rte_vdev_uninit("net_null_vec");
+
+	return TEST_SUCCESS;
+}
+
+static uint64_t
+part_port_rx_get(uint8_t dev_id, uint8_t port_id)
+{
+	char name[RTE_EVENT_DEV_XSTATS_NAME_SIZE];
+
+	snprintf(name, sizeof(name), "port_%u_rx", port_id);
+	return rte_event_dev_xstats_by_name_get(dev_id, name, NULL);
+}
+
+/* Dequeue and free the events scheduled to port 0 until none are left */
+static void
+part_drain(uint8_t dev_id, uint32_t edev_sid)
+{
+	struct rte_event ev[TEST_PART_BURST];
+	uint16_t i, n;
+
+	do {
+		rte_service_run_iter_on_app_lcore(edev_sid, 0);
+		n = rte_event_dequeue_burst(dev_id, 0, ev, RTE_DIM(ev), 0);
+		for (i = 0; i < n; i++)
+			rte_pktmbuf_free(ev[i].mbuf);
+	} while (n != 0);
+}
+
+static int
+adapter_partitions_rx(void)
+{
+	struct rte_event_eth_rx_adapter_queue_conf queue_config;
+	struct rte_event_eth_rx_adapter_params rxa_params;
+	struct rte_event_eth_rx_adapter_stats stats;
+	struct rte_event_port_conf rx_p_conf;
+	struct rte_event_dev_config dev_conf;
+	struct rte_event_dev_info dev_info;
+	uint64_t port_rx[TEST_NB_PARTS];
+	uint32_t rxa_sid, edev_sid;
+	uint32_t nb_ports;
+	uint16_t eth_port;
+	int dev_id;
+	int err;
+	int i;
+
+	if (rte_vdev_init("event_sw_part", NULL))
+		return TEST_SKIPPED;
+	dev_id = rte_event_dev_get_dev_id("event_sw_part");
+	TEST_ASSERT(dev_id >= 0, "Failed to get event device id");
+
+	err = rte_vdev_init("net_null_part", NULL);
+	TEST_ASSERT(err == 0, "Failed to create net_null_part %d", err);
+	err = rte_eth_dev_get_port_by_name("net_null_part", &eth_port);
+	TEST_ASSERT(err == 0, "Failed to get eth port %d", err);
+	err = port_init(eth_port, default_params.mp);
+	TEST_ASSERT(err == 0, "Port initialization failed err %d", err);
+
+	err = rte_event_dev_info_get(dev_id, &dev_info);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	memset(&dev_conf, 0, sizeof(dev_conf));
+	dev_conf.nb_event_queues = 1;
+	dev_conf.nb_event_ports = 1;
+	dev_conf.nb_event_queue_flows = dev_info.max_event_queue_flows;
+	dev_conf.nb_event_port_dequeue_depth =
+			dev_info.max_event_port_dequeue_depth;
+	dev_conf.nb_event_port_enqueue_depth =
+			dev_info.max_event_port_enqueue_depth;
+	dev_conf.nb_events_limit = dev_info.max_num_events;
+	err = rte_event_dev_configure(dev_id, &dev_conf);
+	TEST_ASSERT(err == 0, "Event device configure failed err %d", err);
+	err = rte_event_queue_setup(dev_id, 0, NULL);
+	TEST_ASSERT(err == 0, "Event queue setup failed %d", err);
+	err = rte_event_port_setup(dev_id, 0, NULL);
+	TEST_ASSERT(err == 0, "Event port setup failed %d", err);
+
+	memset(&rx_p_conf, 0, sizeof(rx_p_conf));
+	rx_p_conf.new_event_threshold = dev_info.max_num_events;
+	rx_p_conf.dequeue_depth = dev_info.max_event_port_dequeue_depth;
+	rx_p_conf.enqueue_depth = dev_info.max_event_port_enqueue_depth;
+
+	rxa_params.nb_partitions = RTE_MAX_LCORE + 1;
+	err = rte_event_eth_rx_adapter_create_with_params(TEST_PART_INST_ID,
+					dev_id, &rx_p_conf, &rxa_params);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	rxa_params.nb_partitions = TEST_NB_PARTS;
+	err = rte_event_eth_rx_adapter_create_with_params(TEST_PART_INST_ID,
+					dev_id, &rx_p_conf, &rxa_params);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	memset(&queue_config, 0, sizeof(queue_config));
+	queue_config.ev.queue_id = 0;
+	queue_config.ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	queue_config.servicing_weight = 1;
+	err = rte_event_eth_rx_adapter_queue_add(TEST_PART_INST_ID, eth_port,
+						 -1, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* Each partition adds an event port of its own */
+	err = rte_event_dev_attr_get(dev_id, RTE_EVENT_DEV_ATTR_PORT_COUNT,
+				     &nb_ports);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(nb_ports, TEST_NB_PARTS + 1,
+			  "Expected %u event ports got %u", TEST_NB_PARTS + 1,
+			  nb_ports);
+	err = rte_event_port_link(dev_id, 0, NULL, NULL, 0);
+	TEST_ASSERT(err == 1, "Failed to link port %d", err);
+
+	err = rte_event_dev_service_id_get(dev_id, &edev_sid);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_service_id_get(TEST_PART_INST_ID,
+						      &rxa_sid);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	rte_service_runstate_set(edev_sid, 1);
+	rte_service_set_runstate_mapped_check(edev_sid, 0);
+	rte_service_runstate_set(rxa_sid, 1);
+	rte_service_set_runstate_mapped_check(rxa_sid, 0);
+
+	err = rte_event_dev_start(dev_id);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_start(TEST_PART_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* Successive service calls rotate across the partitions */
+	for (i = 0; i < TEST_PART_ITER; i++) {
+		rte_service_run_iter_on_app_lcore(rxa_sid, 0);
+		part_drain(dev_id, edev_sid);
+	}
+
+	err = rte_event_eth_rx_adapter_stop(TEST_PART_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	part_drain(dev_id, edev_sid);
+
+	for (i = 0; i < TEST_NB_PARTS; i++) {
+		port_rx[i] = part_port_rx_get(dev_id, i + 1);
+		TEST_ASSERT(port_rx[i] > 0, "No events from partition %d", i);
+	}
+
+	/* The adapter stats add up the partition stats */
+	err = rte_event_eth_rx_adapter_stats_get(TEST_PART_INST_ID, &stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(stats.rx_enq_count, port_rx[0] + port_rx[1],
+			  "Expected %" PRIu64 " events got %" PRIu64,
+			  port_rx[0] + port_rx[1], stats.rx_enq_count);
+	TEST_ASSERT_EQUAL(stats.rx_packets, stats.rx_enq_count,
+			  "Expected %" PRIu64 " packets got %" PRIu64,
+			  stats.rx_enq_count, stats.rx_packets);
+
+	err = rte_event_eth_rx_adapter_stats_reset(TEST_PART_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_stats_get(TEST_PART_INST_ID, &stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(stats.rx_packets == 0 && stats.rx_enq_count == 0,
+		    "Stats not reset");
+
+	err = rte_event_eth_rx_adapter_queue_del(TEST_PART_INST_ID, eth_port,
+						 -1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_event_eth_rx_adapter_free(TEST_PART_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	rte_event_dev_stop(dev_id);
+	rte_event_dev_close(dev_id);
+	rte_vdev_uninit("event_sw_part");
+	rte_eth_dev_stop(eth_port);
+	rte_vdev_uninit("net_null_part");
+
+	return TEST_SUCCESS;
+}
+
 static int
 adapter_multi_eth_add_del(void)
 {
@@ -684,6 +1156,10 @@ static struct unit_test_suite event_eth_rx_tests = {
 		TEST_CASE_ST(NULL, NULL, adapter_create_free),
 		TEST_CASE_ST(adapter_create, adapter_free,
 					adapter_queue_add_del),
+		TEST_CASE_ST(adapter_create, adapter_free,
+					adapter_queue_event_vector_config),
+		TEST_CASE_ST(NULL, NULL, adapter_event_vector_rx),
+		TEST_CASE_ST(NULL, NULL, adapter_partitions_rx),
 		TEST_CASE_ST(adapter_create, adapter_free,
 					adapter_multi_eth_add_del),
 		TEST_CASE_ST(adapter_create, adapter_free, adapter_start_stop),
@@ -31,6 +31,7 @@
 #define TEST_ETHDEV_PAIR_ID	PORT(PAIR_PORT_INDEX(0))
 
 #define EDEV_RETRY		0xffff
+#define TEST_VEC_SZ		8
 
 struct event_eth_tx_adapter_test_params {
 	struct rte_mempool *mp;
@@ -457,6 +458,75 @@ tx_adapter_single(uint16_t port, uint16_t tx_queue_id,
 	return -1;
 }
 
+static int
+tx_adapter_vector(uint16_t port, uint16_t tx_queue_id,
+		struct rte_mbuf **m, uint16_t nb_mbuf, uint8_t qid)
+{
+	struct rte_mbuf *r[TEST_VEC_SZ];
+	struct rte_event_vector *vec;
+	struct rte_mempool *vec_mp;
+	struct rte_event event;
+	unsigned int l;
+	uint16_t nb_rx;
+	uint16_t i;
+	int ret;
+
+	vec_mp = rte_event_vector_pool_create("vector_pool", 1, 0,
+					      TEST_VEC_SZ, rte_socket_id());
+	TEST_ASSERT(vec_mp != NULL, "Failed to create vector pool");
+
+	ret = rte_mempool_get(vec_mp, (void **)&vec);
+	TEST_ASSERT(ret == 0, "Failed to get vector");
+	vec->nb_elem = nb_mbuf;
+	vec->port = port;
+	vec->queue = tx_queue_id;
+	vec->attr_valid = 1;
+	memcpy(vec->mbufs, m, nb_mbuf * sizeof(m[0]));
+
+	memset(&event, 0, sizeof(event));
+	event.queue_id = qid;
+	event.op = RTE_EVENT_OP_NEW;
+	event.event_type = RTE_EVENT_TYPE_CPU_VECTOR;
+	event.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	event.vec = vec;
+
+	l = 0;
+	while (rte_event_enqueue_burst(TEST_DEV_ID, 0, &event, 1) != 1) {
+		l++;
+		if (l > EDEV_RETRY)
+			break;
+	}
+	TEST_ASSERT(l < EDEV_RETRY, "Unable to enqueue to eventdev");
+
+	nb_rx = 0;
+	l = 0;
+	while (nb_rx < nb_mbuf && l++ < EDEV_RETRY) {
+		if (eid != ~0ULL) {
+			ret = rte_service_run_iter_on_app_lcore(eid, 0);
+			TEST_ASSERT(ret == 0, "failed to run service %d", ret);
+		}
+
+		ret = rte_service_run_iter_on_app_lcore(tid, 0);
+		TEST_ASSERT(ret == 0, "failed to run service %d", ret);
+
+		nb_rx += rte_eth_rx_burst(TEST_ETHDEV_PAIR_ID, tx_queue_id,
+					  &r[nb_rx], nb_mbuf - nb_rx);
+	}
+
+	TEST_ASSERT_EQUAL(nb_rx, nb_mbuf, "Expected %u mbufs received %u",
+			  nb_mbuf, nb_rx);
+	for (i = 0; i < nb_mbuf; i++)
+		TEST_ASSERT_EQUAL(r[i], m[i], "mbuf comparison failed"
+				  " expected %p received %p", m[i], r[i]);
+
+	/* The adapter returns the vector to its pool */
+	TEST_ASSERT_EQUAL(rte_mempool_avail_count(vec_mp), 1,
+			  "Event vector not released");
+	rte_mempool_free(vec_mp);
+
+	return 0;
+}
+
 static int
 tx_adapter_service(void)
 {
@@ -619,6 +689,18 @@ tx_adapter_service(void)
 	err = rte_event_eth_tx_adapter_stats_get(1, &stats);
 	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
 
+	for (i = 0; i < TEST_VEC_SZ; i++)
+		pbufs[i] = &bufs[i];
+	err = tx_adapter_vector(TEST_ETHDEV_ID, 0, pbufs, TEST_VEC_SZ, ev_qid);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_tx_adapter_stats_get(TEST_INST_ID, &stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(stats.tx_packets, TEST_VEC_SZ,
+			"stats.tx_packets expected %u got %"PRIu64,
+			TEST_VEC_SZ,
+			stats.tx_packets);
+
 	err = rte_event_eth_tx_adapter_queue_del(TEST_INST_ID, TEST_ETHDEV_ID,
 						-1);
 	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
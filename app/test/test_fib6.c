@@ -9,6 +9,7 @@
 
 #include <rte_memory.h>
 #include <rte_log.h>
+#include <rte_malloc.h>
 #include <rte_rib6.h>
 #include <rte_fib6.h>
 
@@ -22,6 +23,8 @@ static int32_t test_free_null(void);
 static int32_t test_add_del_invalid(void);
 static int32_t test_get_invalid(void);
 static int32_t test_lookup(void);
+static int32_t test_invalid_rcu(void);
+static int32_t test_fib6_rcu_dq(void);
 
 #define MAX_ROUTES	(1 << 16)
 /** Maximum number of tbl8 for 2-byte entries */
@@ -329,6 +332,35 @@ check_fib(struct rte_fib6 *fib)
 	return TEST_SUCCESS;
 }
 
+/*
+ * Run check_fib() with every lookup function supported for the configuration.
+ */
+static int
+check_lookup_fns(struct rte_fib6_conf *config)
+{
+	struct rte_fib6 *fib;
+	int type, ret;
+
+	for (type = RTE_FIB6_TRIE_SCALAR;
+			type <= RTE_FIB6_TRIE_VECTOR_AVX512; type++) {
+		fib = rte_fib6_create(__func__, SOCKET_ID_ANY, config);
+		RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+		ret = rte_fib6_set_lookup_fn(fib, type);
+		if (ret == -ENOTSUP) {
+			printf("Lookup function %d is not supported\n", type);
+			rte_fib6_free(fib);
+			continue;
+		}
+		RTE_TEST_ASSERT(ret == 0, "Failed to set lookup function\n");
+		ret = check_fib(fib);
+		rte_fib6_free(fib);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+			"Check_fib fails for lookup function %d\n", type);
+	}
+
+	return TEST_SUCCESS;
+}
+
 int32_t
 test_lookup(void)
 {
@@ -346,36 +378,225 @@ test_lookup(void)
 	ret = check_fib(fib);
 	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
 		"Check_fib fails for DUMMY type\n");
+	ret = rte_fib6_set_lookup_fn(fib, RTE_FIB6_TRIE_SCALAR);
+	RTE_TEST_ASSERT(ret == -EINVAL,
+		"Lookup function set for DUMMY type\n");
 	rte_fib6_free(fib);
 
 	config.type = RTE_FIB6_TRIE;
 
 	config.trie.nh_sz = RTE_FIB6_TRIE_2B;
 	config.trie.num_tbl8 = MAX_TBL8 - 1;
-	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
-	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
-	ret = check_fib(fib);
+	ret = check_lookup_fns(&config);
 	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
 		"Check_fib fails for TRIE_2B type\n");
-	rte_fib6_free(fib);
 
 	config.trie.nh_sz = RTE_FIB6_TRIE_4B;
 	config.trie.num_tbl8 = MAX_TBL8;
-	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
-	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
-	ret = check_fib(fib);
+	ret = check_lookup_fns(&config);
 	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
 		"Check_fib fails for TRIE_4B type\n");
-	rte_fib6_free(fib);
 
 	config.trie.nh_sz = RTE_FIB6_TRIE_8B;
 	config.trie.num_tbl8 = MAX_TBL8;
-	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
-	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
-	ret = check_fib(fib);
+	ret = check_lookup_fns(&config);
 	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
 		"Check_fib fails for TRIE_8B type\n");
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * rte_fib6_rcu_qsbr_add positive and negative tests.
+ *  - Add RCU QSBR variable to FIB
+ *  - Add another RCU QSBR variable to FIB
+ *  - Check returns
+ */
+int32_t
+test_invalid_rcu(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	size_t sz;
+	struct rte_rcu_qsbr *qsv;
+	struct rte_rcu_qsbr *qsv2;
+	int32_t status;
+	struct rte_fib6_rcu_config rcu_cfg = {0};
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 100;
+	config.type = RTE_FIB6_DUMMY;
+
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for RCU\n");
+
+	status = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	RTE_TEST_ASSERT(status == 0, "Can not initialize RCU\n");
+
+	rcu_cfg.v = qsv;
+
+	/* Invalid parameters */
+	status = rte_fib6_rcu_qsbr_add(NULL, &rcu_cfg);
+	RTE_TEST_ASSERT(status == -EINVAL,
+		"Call succeeded with invalid parameters\n");
+	status = rte_fib6_rcu_qsbr_add(fib, NULL);
+	RTE_TEST_ASSERT(status == -EINVAL,
+		"Call succeeded with invalid parameters\n");
+
+	/* RCU is not supported by the DUMMY type */
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == -ENOTSUP,
+		"RCU QSBR variable added to DUMMY type FIB\n");
+	rte_fib6_free(fib);
+
+	config.type = RTE_FIB6_TRIE;
+	config.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	config.trie.num_tbl8 = MAX_TBL8;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* Invalid QSBR mode */
+	rcu_cfg.mode = 2;
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == -EINVAL,
+		"RCU QSBR variable added with invalid mode\n");
+
+	rcu_cfg.mode = RTE_FIB6_QSBR_MODE_DQ;
+	/* Attach RCU QSBR to FIB table */
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == 0, "Can not attach RCU to FIB\n");
+
+	/* Create and attach another RCU QSBR to FIB table */
+	qsv2 = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv2 != NULL, "Can not allocate memory for RCU\n");
+
+	rcu_cfg.v = qsv2;
+	rcu_cfg.mode = RTE_FIB6_QSBR_MODE_SYNC;
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == -EEXIST,
+		"Second RCU QSBR variable added to FIB\n");
+
+	rte_fib6_free(fib);
+	rte_free(qsv);
+	rte_free(qsv2);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Routes used by the RCU test, each one takes 3 tbl8 groups.
+ * Deletion of a route temporarily takes one more tbl8 group,
+ * which is not reclaimed until the reader is quiescent either.
+ */
+#define RCU_TEST_ROUTES	16
+#define RCU_TEST_DEPTH	48
+#define RCU_TEST_TBL8	(RCU_TEST_ROUTES * 4 + 1)
+
+/*
+ * rte_fib6_rcu_qsbr_add DQ mode functional test.
+ * Reader and writer are in the same thread in this test.
+ *  - Create FIB and add RCU QSBR variable to it
+ *  - Add routes with depth=48 using all the tbl8 groups
+ *  - Register a reader thread (not a real thread)
+ *  - Writer delete the routes
+ *  - Reader lookup the routes
+ *  - Writer re-add a route (no available tbl8 group)
+ *  - Reader report quiescent state
+ *  - Writer re-add the route
+ *  - Reader lookup the route
+ */
+int32_t
+test_fib6_rcu_dq(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	size_t sz;
+	struct rte_rcu_qsbr *qsv;
+	int32_t status;
+	uint32_t i;
+	uint8_t ip[1][RTE_FIB6_IPV6_ADDR_SIZE] = {{0x20, 0x01, 0, 0xb8} };
+	uint64_t def_nh = 100, next_hop = 1, nh;
+	struct rte_fib6_rcu_config rcu_cfg = {0};
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB6_TRIE;
+	config.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	config.trie.num_tbl8 = RCU_TEST_TBL8;
+
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(1);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for RCU\n");
+
+	status = rte_rcu_qsbr_init(qsv, 1);
+	RTE_TEST_ASSERT(status == 0, "Can not initialize RCU\n");
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_FIB6_QSBR_MODE_DQ;
+	/* Attach RCU QSBR to FIB table */
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == 0, "Can not attach RCU to FIB\n");
+
+	/* Use all the tbl8 groups, routes are in different /24 */
+	for (i = 0; i < RCU_TEST_ROUTES; i++) {
+		ip[0][2] = i;
+		status = rte_fib6_add(fib, ip[0], RCU_TEST_DEPTH, next_hop);
+		RTE_TEST_ASSERT(status == 0, "Failed to add a route\n");
+	}
+
+	/* Register pseudo reader */
+	status = rte_rcu_qsbr_thread_register(qsv, 0);
+	RTE_TEST_ASSERT(status == 0, "Can not register RCU reader\n");
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	status = rte_fib6_lookup_bulk(fib, ip, &nh, 1);
+	RTE_TEST_ASSERT((status == 0) && (nh == next_hop),
+		"Lookup returned wrong next hop\n");
+
+	/* Writer update */
+	for (i = 0; i < RCU_TEST_ROUTES; i++) {
+		ip[0][2] = i;
+		status = rte_fib6_delete(fib, ip[0], RCU_TEST_DEPTH);
+		RTE_TEST_ASSERT(status == 0, "Failed to delete a route\n");
+		status = rte_fib6_lookup_bulk(fib, ip, &nh, 1);
+		RTE_TEST_ASSERT((status == 0) && (nh == def_nh),
+			"Lookup returned wrong next hop\n");
+	}
+
+	/* tbl8 groups are not reclaimed until the reader is quiescent */
+	ip[0][2] = RCU_TEST_ROUTES;
+	status = rte_fib6_add(fib, ip[0], RCU_TEST_DEPTH, next_hop);
+	RTE_TEST_ASSERT(status == -ENOSPC,
+		"tbl8 group reused before the reader is quiescent\n");
+
+	/* Reader quiescent */
+	rte_rcu_qsbr_quiescent(qsv, 0);
+
+	status = rte_fib6_add(fib, ip[0], RCU_TEST_DEPTH, next_hop);
+	RTE_TEST_ASSERT(status == 0, "Failed to add a route\n");
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	status = rte_rcu_qsbr_thread_unregister(qsv, 0);
+	RTE_TEST_ASSERT(status == 0, "Can not unregister RCU reader\n");
+
+	status = rte_fib6_lookup_bulk(fib, ip, &nh, 1);
+	RTE_TEST_ASSERT((status == 0) && (nh == next_hop),
+		"Lookup returned wrong next hop\n");
+
 	rte_fib6_free(fib);
+	rte_free(qsv);
 
 	return TEST_SUCCESS;
 }
@@ -390,6 +611,8 @@ static struct unit_test_suite fib6_fast_tests = {
 	TEST_CASE(test_add_del_invalid),
 	TEST_CASE(test_get_invalid),
 	TEST_CASE(test_lookup),
+	TEST_CASE(test_invalid_rcu),
+	TEST_CASE(test_fib6_rcu_dq),
 	TEST_CASES_END()
 	}
 };
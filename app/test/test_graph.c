@@ -760,6 +760,332 @@ test_print_stats(void)
 	return 0;
 }
 
+static struct rte_graph_cluster_node_stats hist_stats[MAX_NODES + 1];
+
+static int
+graph_hist_stats_cb(bool is_first, bool is_last, void *cookie,
+		    const struct rte_graph_cluster_node_stats *st)
+{
+	int i;
+
+	RTE_SET_USED(is_first);
+	RTE_SET_USED(is_last);
+	RTE_SET_USED(cookie);
+
+	for (i = 0; i < MAX_NODES + 1; i++)
+		if (rte_node_from_name(node_patterns[i]) == st->id)
+			hist_stats[i] = *st;
+	return 0;
+}
+
+static uint64_t
+hist_sum(const uint64_t *hist, unsigned int nb_buckets)
+{
+	uint64_t sum = 0;
+	unsigned int i;
+
+	for (i = 0; i < nb_buckets; i++)
+		sum += hist[i];
+	return sum;
+}
+
+static int
+test_graph_hist(void)
+{
+	struct rte_graph_cluster_node_stats prev[MAX_NODES + 1];
+	struct rte_graph *graph = rte_graph_lookup("worker0");
+	struct rte_graph_cluster_stats_param s_param;
+	struct rte_graph_cluster_stats *stats;
+	const char *pattern = "worker0";
+	uint64_t calls, samples;
+	int i, rc = -1;
+
+	if (!rte_graph_has_stats_feature())
+		return 0;
+
+	if (rte_graph_hist_enable(graph_id, 0) != -EINVAL ||
+	    rte_graph_hist_enable(graph_id, 3) != -EINVAL) {
+		printf("Histogram enabled with invalid sample interval\n");
+		return -1;
+	}
+
+	memset(&s_param, 0, sizeof(s_param));
+	s_param.socket_id = SOCKET_ID_ANY;
+	s_param.graph_patterns = &pattern;
+	s_param.nb_graph_patterns = 1;
+	s_param.fn = graph_hist_stats_cb;
+
+	stats = rte_graph_cluster_stats_create(&s_param);
+	if (stats == NULL) {
+		printf("Unable to get stats\n");
+		return -1;
+	}
+
+	/* Every call is sampled */
+	rte_graph_cluster_stats_get(stats, 0);
+	memcpy(prev, hist_stats, sizeof(prev));
+	if (rte_graph_hist_enable(graph_id, 1)) {
+		printf("Histogram enable failed\n");
+		goto fail;
+	}
+	for (i = 0; i < 4; i++)
+		rte_graph_walk(graph);
+	rte_graph_cluster_stats_get(stats, 0);
+
+	for (i = 0; i < MAX_NODES + 1; i++) {
+		calls = hist_stats[i].calls - prev[i].calls;
+		samples = hist_sum(hist_stats[i].hist_burst,
+				   RTE_GRAPH_HIST_BURST_BUCKETS) -
+			  hist_sum(prev[i].hist_burst,
+				   RTE_GRAPH_HIST_BURST_BUCKETS);
+		if (calls != samples) {
+			printf("Burst samples miss match for node = %s expected = %"PRIu64", got = %"PRIu64"\n",
+			       node_patterns[i], calls, samples);
+			goto fail;
+		}
+		samples = hist_sum(hist_stats[i].hist_cycles,
+				   RTE_GRAPH_HIST_CYCLES_BUCKETS) -
+			  hist_sum(prev[i].hist_cycles,
+				   RTE_GRAPH_HIST_CYCLES_BUCKETS);
+		if (samples > calls) {
+			printf("Too many cycles samples for node = %s\n",
+			       node_patterns[i]);
+			goto fail;
+		}
+	}
+
+	/* Source node always produces a full burst */
+	i = rte_fls_u32(RTE_GRAPH_BURST_SIZE);
+	if (hist_stats[0].hist_burst[i] - prev[0].hist_burst[i] != 4) {
+		printf("Source node burst not accounted in bucket %d\n", i);
+		goto fail;
+	}
+
+	/* One call out of four is sampled */
+	memcpy(prev, hist_stats, sizeof(prev));
+	rte_graph_hist_enable(graph_id, 4);
+	for (i = 0; i < 8; i++)
+		rte_graph_walk(graph);
+	rte_graph_cluster_stats_get(stats, 0);
+	samples = hist_sum(hist_stats[0].hist_burst,
+			   RTE_GRAPH_HIST_BURST_BUCKETS) -
+		  hist_sum(prev[0].hist_burst, RTE_GRAPH_HIST_BURST_BUCKETS);
+	if (samples != 2) {
+		printf("Sampled %"PRIu64" source node calls, expected 2\n",
+		       samples);
+		goto fail;
+	}
+
+	/* Nothing is sampled once disabled */
+	memcpy(prev, hist_stats, sizeof(prev));
+	rte_graph_hist_disable(graph_id);
+	for (i = 0; i < 4; i++)
+		rte_graph_walk(graph);
+	rte_graph_cluster_stats_get(stats, 0);
+	if (memcmp(hist_stats[0].hist_burst, prev[0].hist_burst,
+		   sizeof(prev[0].hist_burst))) {
+		printf("Histogram updated after disable\n");
+		goto fail;
+	}
+
+	rc = 0;
+fail:
+	rte_graph_hist_disable(graph_id);
+	rte_graph_cluster_stats_destroy(stats);
+	return rc;
+}
+
+#define DISPATCH_NB_OBJS (2 * RTE_GRAPH_BURST_SIZE + 3)
+#define DISPATCH_LCORE_SRC 0
+#define DISPATCH_LCORE_STAGE 1
+
+static uint64_t dispatch_objs[DISPATCH_NB_OBJS];
+static unsigned int dispatch_stage_lcore;
+static uint32_t dispatch_src_calls;
+static uint32_t dispatch_stage_objs;
+static uint32_t dispatch_sink_objs;
+static uint32_t dispatch_sink_err;
+
+static uint16_t
+test_dispatch_src(struct rte_graph *graph, struct rte_node *node,
+		  void **objs, uint16_t nb_objs)
+{
+	void **next_stream;
+	uint16_t i;
+
+	RTE_SET_USED(objs);
+	RTE_SET_USED(nb_objs);
+
+	next_stream = rte_node_next_stream_get(graph, node, 0,
+					       DISPATCH_NB_OBJS);
+	for (i = 0; i < DISPATCH_NB_OBJS; i++)
+		next_stream[i] = &dispatch_objs[i];
+	rte_node_next_stream_put(graph, node, 0, DISPATCH_NB_OBJS);
+	dispatch_src_calls++;
+
+	return DISPATCH_NB_OBJS;
+}
+
+static uint16_t
+test_dispatch_stage(struct rte_graph *graph, struct rte_node *node,
+		    void **objs, uint16_t nb_objs)
+{
+	dispatch_stage_lcore = graph->lcore_id;
+	dispatch_stage_objs += nb_objs;
+	rte_node_enqueue(graph, node, 0, objs, nb_objs);
+
+	return nb_objs;
+}
+
+static uint16_t
+test_dispatch_sink(struct rte_graph *graph, struct rte_node *node,
+		   void **objs, uint16_t nb_objs)
+{
+	uint16_t i;
+
+	RTE_SET_USED(graph);
+	RTE_SET_USED(node);
+
+	for (i = 0; i < nb_objs; i++)
+		if (objs[i] != &dispatch_objs[dispatch_sink_objs + i])
+			dispatch_sink_err++;
+	dispatch_sink_objs += nb_objs;
+
+	return nb_objs;
+}
+
+static struct rte_node_register test_dispatch_src_node = {
+	.name = "test_dispatch_src",
+	.process = test_dispatch_src,
+	.flags = RTE_NODE_SOURCE_F,
+	.nb_edges = 1,
+	.next_nodes = {"test_dispatch_stage"},
+};
+RTE_NODE_REGISTER(test_dispatch_src_node);
+
+static struct rte_node_register test_dispatch_stage_node = {
+	.name = "test_dispatch_stage",
+	.process = test_dispatch_stage,
+	.nb_edges = 1,
+	.next_nodes = {"test_dispatch_sink"},
+};
+RTE_NODE_REGISTER(test_dispatch_stage_node);
+
+static struct rte_node_register test_dispatch_sink_node = {
+	.name = "test_dispatch_sink",
+	.process = test_dispatch_sink,
+};
+RTE_NODE_REGISTER(test_dispatch_sink_node);
+
+static void
+test_dispatch_reset(void)
+{
+	dispatch_stage_lcore = RTE_MAX_LCORE;
+	dispatch_src_calls = 0;
+	dispatch_stage_objs = 0;
+	dispatch_sink_objs = 0;
+	dispatch_sink_err = 0;
+}
+
+static int
+test_graph_dispatch(void)
+{
+	static const char *patterns[] = {"test_dispatch_*"};
+	struct rte_graph_param gconf = {
+		.socket_id = SOCKET_ID_ANY,
+		.nb_node_patterns = 1,
+		.node_patterns = patterns,
+	};
+	struct rte_graph *graph, *clone;
+	rte_graph_t gid, cid;
+	int ret = -1;
+
+	if (rte_node_lcore_affinity_set(test_dispatch_src_node.id,
+					RTE_MAX_LCORE + 1) != -EINVAL) {
+		printf("Invalid lcore affinity accepted\n");
+		return -1;
+	}
+	if (rte_node_lcore_affinity_set(test_dispatch_src_node.id,
+					DISPATCH_LCORE_SRC) ||
+	    rte_node_lcore_affinity_set(test_dispatch_stage_node.id,
+					DISPATCH_LCORE_STAGE)) {
+		printf("Failed to set node lcore affinity\n");
+		return -1;
+	}
+
+	gid = rte_graph_create("dispatch", &gconf);
+	if (gid == RTE_GRAPH_ID_INVALID) {
+		printf("Graph creation failed with error = %d\n", rte_errno);
+		goto affinity_reset;
+	}
+	cid = rte_graph_clone(gid, "1");
+	if (cid == RTE_GRAPH_ID_INVALID) {
+		printf("Graph clone failed with error = %d\n", rte_errno);
+		goto graph_destroy;
+	}
+	graph = rte_graph_lookup("dispatch");
+	clone = rte_graph_lookup("dispatch-1");
+	if (graph == NULL || clone == NULL) {
+		printf("Graph lookup failed\n");
+		goto clone_destroy;
+	}
+
+	if (rte_graph_dispatch_core_bind(gid, RTE_MAX_LCORE) != -EINVAL ||
+	    rte_graph_dispatch_core_bind(gid, DISPATCH_LCORE_SRC) ||
+	    rte_graph_dispatch_core_bind(gid, DISPATCH_LCORE_SRC) != -EBUSY ||
+	    rte_graph_dispatch_core_bind(cid, DISPATCH_LCORE_SRC) != -EEXIST ||
+	    rte_graph_dispatch_core_bind(cid, DISPATCH_LCORE_STAGE)) {
+		printf("Unexpected graph core bind result\n");
+		goto unbind;
+	}
+	if (rte_graph_destroy(gid) != -EBUSY) {
+		printf("Graph with clone destroyed\n");
+		goto unbind;
+	}
+
+	/* Stage node stream is handed over to the clone */
+	test_dispatch_reset();
+	rte_graph_walk(graph);
+	if (dispatch_src_calls != 1 || dispatch_stage_objs != 0) {
+		printf("Stage node processed on the source lcore\n");
+		goto unbind;
+	}
+	rte_graph_walk(clone);
+	if (dispatch_src_calls != 1 ||
+	    dispatch_stage_lcore != DISPATCH_LCORE_STAGE ||
+	    dispatch_stage_objs != DISPATCH_NB_OBJS ||
+	    dispatch_sink_objs != DISPATCH_NB_OBJS || dispatch_sink_err) {
+		printf("Stream not handed over to the stage lcore\n");
+		goto unbind;
+	}
+
+	/* Stream is processed locally when no graph is bound to the lcore */
+	rte_graph_dispatch_core_unbind(cid);
+	test_dispatch_reset();
+	rte_graph_walk(graph);
+	if (dispatch_src_calls != 1 ||
+	    dispatch_stage_lcore != DISPATCH_LCORE_SRC ||
+	    dispatch_stage_objs != DISPATCH_NB_OBJS ||
+	    dispatch_sink_objs != DISPATCH_NB_OBJS || dispatch_sink_err) {
+		printf("Stream not processed on the source lcore\n");
+		goto unbind;
+	}
+
+	ret = 0;
+unbind:
+	rte_graph_dispatch_core_unbind(cid);
+	rte_graph_dispatch_core_unbind(gid);
+clone_destroy:
+	rte_graph_destroy(cid);
+graph_destroy:
+	rte_graph_destroy(gid);
+affinity_reset:
+	rte_node_lcore_affinity_set(test_dispatch_src_node.id, RTE_MAX_LCORE);
+	rte_node_lcore_affinity_set(test_dispatch_stage_node.id,
+				    RTE_MAX_LCORE);
+	return ret;
+}
+
 static int
 graph_setup(void)
 {
@@ -799,6 +1125,8 @@ static struct unit_test_suite graph_testsuite = {
 		TEST_CASE(test_graph_lookup_functions),
 		TEST_CASE(test_graph_walk),
 		TEST_CASE(test_print_stats),
+		TEST_CASE(test_graph_hist),
+		TEST_CASE(test_graph_dispatch),
 		TEST_CASES_END(), /**< NULL terminate unit test array */
 	},
 };
@@ -18,6 +18,7 @@
 #include <rte_eal.h>
 #include <rte_ip.h>
 #include <rte_string_fns.h>
+#include <rte_errno.h>
 
 #include "test.h"
 
@@ -25,6 +26,7 @@
 #include <rte_fbk_hash.h>
 #include <rte_jhash.h>
 #include <rte_hash_crc.h>
+#include <rte_rcu_qsbr.h>
 
 /*******************************************************************************
  * Hash function performance test configuration section. Each performance test
@@ -983,6 +985,261 @@ static int test_extendable_bucket(void)
 	return 0;
 }
 
+/*
+ * Sequence of operations for online resize
+ *
+ *  - create table with lock free read-write concurrency
+ *  - add keys until the table is full
+ *  - start a resize to a bigger table
+ *  - migrate one bucket at a time, checking all keys are found with
+ *    single and bulk lookups and adding a new key in between
+ *  - fill the bigger table
+ *  - delete most keys and shrink the table back
+ *  - check remaining keys are found and deleted keys are not
+ */
+#define RESIZE_ENTRIES 64
+static int test_hash_resize(void)
+{
+	struct rte_hash_parameters params_resize = {
+		.name = "test_resize",
+		.entries = RESIZE_ENTRIES,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF
+	};
+	struct rte_hash *handle;
+	uint32_t rkeys[RESIZE_ENTRIES * 4];
+	int32_t pos[RESIZE_ENTRIES * 4];
+	const void *key_ptrs[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t bulk_pos[RTE_HASH_LOOKUP_BULK_MAX];
+	unsigned int i, j, n, num_keys;
+	int ret;
+
+	handle = rte_hash_create(&params_resize);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	/* Fill the table */
+	for (num_keys = 0; num_keys < RESIZE_ENTRIES; num_keys++) {
+		rkeys[num_keys] = num_keys;
+		pos[num_keys] = rte_hash_add_key(handle, &rkeys[num_keys]);
+		if (pos[num_keys] < 0)
+			break;
+	}
+
+	ret = rte_hash_resize_start(handle, RESIZE_ENTRIES * 4);
+	RETURN_IF_ERROR(ret != 0, "failed to start resize (ret=%d)", ret);
+	ret = rte_hash_resize_start(handle, RESIZE_ENTRIES * 4);
+	RETURN_IF_ERROR(ret != -EBUSY,
+			"resize started while in progress (ret=%d)", ret);
+
+	do {
+		/* All keys are found while they are migrated */
+		for (i = 0; i < num_keys; i++) {
+			ret = rte_hash_lookup(handle, &rkeys[i]);
+			RETURN_IF_ERROR(ret != pos[i],
+				"failed to find key %u during resize (pos=%d)",
+				i, ret);
+		}
+		for (i = 0; i < num_keys; i += n) {
+			n = RTE_MIN(num_keys - i,
+				(unsigned int)RTE_HASH_LOOKUP_BULK_MAX);
+			for (j = 0; j < n; j++)
+				key_ptrs[j] = &rkeys[i + j];
+			ret = rte_hash_lookup_bulk(handle, key_ptrs, n,
+						bulk_pos);
+			RETURN_IF_ERROR(ret != 0, "bulk lookup failed");
+			for (j = 0; j < n; j++)
+				RETURN_IF_ERROR(bulk_pos[j] != pos[i + j],
+					"failed to bulk find key %u during "
+					"resize (pos=%d)", i + j, bulk_pos[j]);
+		}
+
+		/* New keys are added to the new table */
+		rkeys[num_keys] = num_keys;
+		pos[num_keys] = rte_hash_add_key(handle, &rkeys[num_keys]);
+		RETURN_IF_ERROR(pos[num_keys] < 0,
+			"failed to add key during resize (pos=%d)",
+			pos[num_keys]);
+		num_keys++;
+
+		ret = rte_hash_resize_step(handle, 1);
+		RETURN_IF_ERROR(ret < 0, "failed to migrate (ret=%d)", ret);
+	} while (ret > 0);
+
+	RETURN_IF_ERROR(rte_hash_count(handle) != (int32_t)num_keys,
+			"wrong key count after resize");
+
+	/* The bigger table takes more keys */
+	for (; num_keys < RESIZE_ENTRIES * 3; num_keys++) {
+		rkeys[num_keys] = num_keys;
+		pos[num_keys] = rte_hash_add_key(handle, &rkeys[num_keys]);
+		RETURN_IF_ERROR(pos[num_keys] < 0,
+			"failed to add key after resize (pos=%d)",
+			pos[num_keys]);
+	}
+
+	ret = rte_hash_resize_start(handle, RESIZE_ENTRIES);
+	RETURN_IF_ERROR(ret != -ENOSPC,
+			"shrink below key count started (ret=%d)", ret);
+
+	/* Delete most keys and shrink back */
+	for (i = RESIZE_ENTRIES / 2; i < num_keys; i++) {
+		ret = rte_hash_del_key(handle, &rkeys[i]);
+		RETURN_IF_ERROR(ret != pos[i],
+			"failed to delete key %u (pos=%d)", i, ret);
+		ret = rte_hash_free_key_with_position(handle, pos[i]);
+		RETURN_IF_ERROR(ret != 0, "failed to free key %u", i);
+	}
+
+	ret = rte_hash_resize_start(handle, RESIZE_ENTRIES);
+	RETURN_IF_ERROR(ret != 0, "failed to start shrink (ret=%d)", ret);
+	ret = rte_hash_resize_step(handle, UINT32_MAX);
+	RETURN_IF_ERROR(ret != 0, "failed to migrate (ret=%d)", ret);
+
+	for (i = 0; i < num_keys; i++) {
+		ret = rte_hash_lookup(handle, &rkeys[i]);
+		if (i < RESIZE_ENTRIES / 2)
+			RETURN_IF_ERROR(ret != pos[i],
+				"failed to find key %u after shrink (pos=%d)",
+				i, ret);
+		else
+			RETURN_IF_ERROR(ret != -ENOENT,
+				"found deleted key %u after shrink (pos=%d)",
+				i, ret);
+	}
+
+	rte_hash_free(handle);
+
+	return 0;
+}
+
+/*
+ * Check condition and return an error if true. Frees "handle" and the
+ * RCU QSBR variable "v".
+ */
+#define RETURN_IF_ERROR_RCU(cond, str, ...) do {			\
+	if (cond) {							\
+		printf("ERROR line %d: " str "\n", __LINE__, ##__VA_ARGS__); \
+		if (handle)						\
+			rte_hash_free(handle);				\
+		rte_free(v);						\
+		return -1;						\
+	}								\
+} while (0)
+
+static unsigned int rcu_freed_data;
+
+static void
+test_hash_rcu_free_key_data(void *p, void *key_data)
+{
+	RTE_SET_USED(p);
+	RTE_SET_USED(key_data);
+	rcu_freed_data++;
+}
+
+/*
+ * Sequence of operations for RCU QSBR reclamation, for each mode
+ *
+ *  - create table with lock free read-write concurrency and
+ *    extendable buckets, associate an RCU QSBR variable
+ *  - add keys until no key index is left
+ *  - delete a key while a reader is online
+ *  - DQ mode: check the key index is not reused before the reader
+ *    reports a quiescent state, and is reused after
+ *  - SYNC mode: the reader is offline, check the key index is reused
+ */
+#define RCU_ENTRIES 32
+static int test_hash_rcu_qsbr(enum rte_hash_qsbr_mode mode)
+{
+	struct rte_hash_parameters params_rcu = {
+		.name = "test_rcu",
+		.entries = RCU_ENTRIES,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF |
+				RTE_HASH_EXTRA_FLAGS_EXT_TABLE
+	};
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	struct rte_hash *handle = NULL;
+	struct rte_rcu_qsbr *v;
+	uint32_t rkeys[RCU_ENTRIES + 1];
+	int32_t pos[RCU_ENTRIES + 1];
+	uint32_t i, num_keys;
+	int32_t ret;
+
+	v = rte_zmalloc(NULL, rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE),
+			RTE_CACHE_LINE_SIZE);
+	RETURN_IF_ERROR_RCU(v == NULL, "RCU QSBR variable allocation failed");
+	rte_rcu_qsbr_init(v, RTE_MAX_LCORE);
+
+	handle = rte_hash_create(&params_rcu);
+	RETURN_IF_ERROR_RCU(handle == NULL, "hash creation failed");
+
+	rcu_cfg.v = v;
+	rcu_cfg.mode = mode;
+	rcu_cfg.free_key_data_func = test_hash_rcu_free_key_data;
+	rcu_freed_data = 0;
+	ret = rte_hash_rcu_qsbr_add(handle, &rcu_cfg);
+	RETURN_IF_ERROR_RCU(ret != 0, "failed to add RCU QSBR variable");
+	ret = rte_hash_rcu_qsbr_add(handle, &rcu_cfg);
+	RETURN_IF_ERROR_RCU(ret != -EEXIST, "RCU QSBR variable added twice");
+
+	/* A reader is online, until it goes offline in SYNC mode */
+	rte_rcu_qsbr_thread_register(v, 0);
+	rte_rcu_qsbr_thread_online(v, 0);
+
+	for (num_keys = 0; num_keys < RCU_ENTRIES; num_keys++) {
+		rkeys[num_keys] = num_keys;
+		pos[num_keys] = rte_hash_add_key(handle, &rkeys[num_keys]);
+		RETURN_IF_ERROR_RCU(pos[num_keys] < 0,
+				"failed to add key (pos=%d)", pos[num_keys]);
+	}
+	rkeys[num_keys] = num_keys;
+	ret = rte_hash_add_key(handle, &rkeys[num_keys]);
+	RETURN_IF_ERROR_RCU(ret != -ENOSPC, "added key to full table");
+
+	if (mode == RTE_HASH_QSBR_MODE_SYNC)
+		rte_rcu_qsbr_thread_offline(v, 0);
+
+	ret = rte_hash_del_key(handle, &rkeys[0]);
+	RETURN_IF_ERROR_RCU(ret != pos[0], "failed to delete key (ret=%d)",
+			ret);
+	ret = rte_hash_lookup(handle, &rkeys[0]);
+	RETURN_IF_ERROR_RCU(ret != -ENOENT, "found deleted key (ret=%d)", ret);
+
+	if (mode == RTE_HASH_QSBR_MODE_DQ) {
+		/* The reader may still reference the deleted key */
+		ret = rte_hash_add_key(handle, &rkeys[num_keys]);
+		RETURN_IF_ERROR_RCU(ret != -ENOSPC,
+			"key index reused before grace period (ret=%d)", ret);
+		RETURN_IF_ERROR_RCU(rcu_freed_data != 0,
+			"key data freed before grace period");
+		rte_rcu_qsbr_quiescent(v, 0);
+	}
+
+	ret = rte_hash_add_key(handle, &rkeys[num_keys]);
+	RETURN_IF_ERROR_RCU(ret != pos[0],
+			"deleted key index not reclaimed (ret=%d)", ret);
+	RETURN_IF_ERROR_RCU(rcu_freed_data != 1, "key data not freed");
+
+	for (i = 1; i <= num_keys; i++) {
+		ret = rte_hash_lookup(handle, &rkeys[i]);
+		RETURN_IF_ERROR_RCU(ret < 0, "failed to find key %u", i);
+	}
+
+	if (mode == RTE_HASH_QSBR_MODE_DQ)
+		rte_rcu_qsbr_thread_offline(v, 0);
+	rte_rcu_qsbr_thread_unregister(v, 0);
+	rte_hash_free(handle);
+	rte_free(v);
+
+	return 0;
+}
+
 /******************************************************************************/
 static int
 fbk_hash_unit_test(void)
@@ -1835,6 +2092,12 @@ test_hash(void)
 		return -1;
 	if (test_extendable_bucket() < 0)
 		return -1;
+	if (test_hash_resize() < 0)
+		return -1;
+	if (test_hash_rcu_qsbr(RTE_HASH_QSBR_MODE_DQ) < 0)
+		return -1;
+	if (test_hash_rcu_qsbr(RTE_HASH_QSBR_MODE_SYNC) < 0)
+		return -1;
 
 	if (test_fbk_hash_find_existing() < 0)
 		return -1;
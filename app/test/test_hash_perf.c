@@ -719,6 +719,103 @@ fbk_hash_perf_test(void)
 	return 0;
 }
 
+/* Control operation of performance testing of signature compare functions */
+#define SIG_CMP_ENTRIES (1 << 16)	/* How many entries. */
+#define SIG_CMP_KEY_LEN 16		/* Key length. */
+#define SIG_CMP_ITERATIONS 50	/* How many times to look up all keys. */
+
+static const char * const sig_cmp_names[RTE_HASH_COMPARE_NUM] = {
+	[RTE_HASH_COMPARE_SCALAR] = "Scalar",
+	[RTE_HASH_COMPARE_SSE] = "SSE",
+	[RTE_HASH_COMPARE_NEON] = "NEON",
+	[RTE_HASH_COMPARE_AVX512] = "AVX-512",
+};
+
+static int
+sig_cmp_perf_test(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "sig_cmp_perf",
+		.entries = SIG_CMP_ENTRIES,
+		.key_len = SIG_CMP_KEY_LEN,
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+	};
+	const void *keys_burst[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t positions_burst[RTE_HASH_LOOKUP_BULK_MAX];
+	struct rte_hash *handle;
+	uint8_t (*sig_keys)[SIG_CMP_KEY_LEN];
+	int32_t *sig_positions;
+	unsigned int added = 0;
+	uint64_t begin, lookup_time;
+	unsigned int i, j, k, fn;
+	int ret = -1;
+
+	handle = rte_hash_create(&params);
+	sig_keys = rte_zmalloc(NULL, SIG_CMP_ENTRIES * SIG_CMP_KEY_LEN, 0);
+	sig_positions = rte_zmalloc(NULL,
+			SIG_CMP_ENTRIES * sizeof(*sig_positions), 0);
+	if (handle == NULL || sig_keys == NULL || sig_positions == NULL) {
+		printf("signature compare: allocation failed\n");
+		goto end;
+	}
+
+	/* Fill the table to 75% with random keys */
+	while (added < SIG_CMP_ENTRIES * ADD_PERCENT) {
+		for (k = 0; k < SIG_CMP_KEY_LEN; k++)
+			sig_keys[added][k] = rte_rand() & 0xff;
+		sig_positions[added] = rte_hash_add_key(handle,
+				sig_keys[added]);
+		if (sig_positions[added] >= 0)
+			added++;
+	}
+	added -= added % RTE_HASH_LOOKUP_BULK_MAX;
+
+	printf("\n\n *** Bulk lookup signature compare performance ***\n");
+	printf("%-18s%-18s\n", "Function", "Lookup_bulk");
+	for (fn = 0; fn < RTE_HASH_COMPARE_NUM; fn++) {
+		if (rte_hash_set_sig_cmp_fn(handle,
+				(enum rte_hash_sig_compare_function)fn) != 0) {
+			printf("%-18s%-18s\n", sig_cmp_names[fn],
+				"not supported");
+			continue;
+		}
+
+		lookup_time = 0;
+		for (i = 0; i < SIG_CMP_ITERATIONS; i++) {
+			for (j = 0; j < added; j += RTE_HASH_LOOKUP_BULK_MAX) {
+				for (k = 0; k < RTE_HASH_LOOKUP_BULK_MAX; k++)
+					keys_burst[k] = sig_keys[j + k];
+				begin = rte_rdtsc();
+				rte_hash_lookup_bulk(handle, keys_burst,
+					RTE_HASH_LOOKUP_BULK_MAX,
+					positions_burst);
+				lookup_time += rte_rdtsc() - begin;
+				for (k = 0; k < RTE_HASH_LOOKUP_BULK_MAX; k++) {
+					if (positions_burst[k] !=
+							sig_positions[j + k]) {
+						printf("%s: key looked up in %d, should be in %d\n",
+							sig_cmp_names[fn],
+							positions_burst[k],
+							sig_positions[j + k]);
+						goto end;
+					}
+				}
+			}
+		}
+		printf("%-18s%-18"PRIu64"\n", sig_cmp_names[fn],
+			lookup_time / ((uint64_t)added * SIG_CMP_ITERATIONS));
+	}
+	ret = 0;
+
+end:
+	rte_hash_free(handle);
+	rte_free(sig_keys);
+	rte_free(sig_positions);
+	return ret;
+}
+
 static int
 test_hash_perf(void)
 {
@@ -743,6 +840,9 @@ test_hash_perf(void)
 	if (run_all_tbl_perf_tests(1, 0, 1) < 0)
 		return -1;
 
+	if (sig_cmp_perf_test() < 0)
+		return -1;
+
 	if (fbk_hash_perf_test() < 0)
 		return -1;
 
@@ -12,11 +12,13 @@
 #include <rte_cycles.h>
 #include <rte_bus_vdev.h>
 #include <rte_ip.h>
+#include <rte_udp.h>
 
 #include <rte_crypto.h>
 #include <rte_cryptodev.h>
 #include <rte_cryptodev_pmd.h>
 #include <rte_lcore.h>
+#include <rte_errno.h>
 #include <rte_ipsec.h>
 #include <rte_random.h>
 #include <rte_esp.h>
@@ -40,6 +42,7 @@
 #define ESN_DISABLED	0
 #define INBOUND_SPI		7
 #define OUTBOUND_SPI	17
+#define NATT_PORT		4500
 #define BURST_SIZE		32
 #define REORDER_PKTS	1
 #define DEQUEUE_COUNT	1000
@@ -71,6 +74,7 @@ struct ipsec_unitest_params {
 	struct rte_crypto_sym_xform *crypto_xforms;
 
 	struct rte_security_ipsec_xform ipsec_xform;
+	struct rte_ipsec_sa_lifetime lifetime;
 
 	struct rte_ipsec_sa_prm sa_prm;
 	struct rte_ipsec_session ss[MAX_NB_SAS];
@@ -543,6 +547,20 @@ struct rte_ipv4_hdr ipv4_outer  = {
 	.dst_addr = RTE_IPV4(192, 168, 2, 100),
 };
 
+struct rte_ipv4_hdr ipv4_outer_natt  = {
+	.version_ihl = IPVERSION << 4 |
+		sizeof(ipv4_outer_natt) / RTE_IPV4_IHL_MULTIPLIER,
+	.time_to_live = IPDEFTTL,
+	.next_proto_id = IPPROTO_UDP,
+	.src_addr = RTE_IPV4(192, 168, 1, 100),
+	.dst_addr = RTE_IPV4(192, 168, 2, 100),
+};
+
+static const struct rte_udp_hdr udp_natt = {
+	.src_port = RTE_BE16(NATT_PORT),
+	.dst_port = RTE_BE16(NATT_PORT),
+};
+
 static struct rte_mbuf *
 setup_test_string(struct rte_mempool *mpool,
 		const char *string, size_t len, uint8_t blocksize)
@@ -572,11 +590,15 @@ setup_test_string_tunneled(struct rte_mempool *mpool, const char *string,
 	size_t len, uint32_t spi, uint32_t seq)
 {
 	struct rte_mbuf *m = rte_pktmbuf_alloc(mpool);
+	uint32_t natt = unittest_params.ipsec_xform.options.udp_encap;
+	struct rte_ipv4_hdr *outer = natt ? &ipv4_outer_natt : &ipv4_outer;
 	uint32_t hdrlen = sizeof(struct rte_ipv4_hdr) +
+		(natt ? sizeof(struct rte_udp_hdr) : 0) +
 		sizeof(struct rte_esp_hdr);
 	uint32_t taillen = sizeof(struct rte_esp_tail);
 	uint32_t t_len = len + hdrlen + taillen;
 	uint32_t padlen;
+	struct rte_udp_hdr udph;
 
 	struct rte_esp_hdr esph  = {
 		.spi = rte_cpu_to_be_32(spi),
@@ -601,12 +623,18 @@ setup_test_string_tunneled(struct rte_mempool *mpool, const char *string,
 		rte_pktmbuf_free(m);
 		return NULL;
 	}
-	/* copy outer IP and ESP header */
-	ipv4_outer.total_length = rte_cpu_to_be_16(t_len);
-	ipv4_outer.packet_id = rte_cpu_to_be_16(seq);
-	rte_memcpy(dst, &ipv4_outer, sizeof(ipv4_outer));
-	dst += sizeof(ipv4_outer);
-	m->l3_len = sizeof(ipv4_outer);
+	/* copy outer IP, UDP encapsulation and ESP header */
+	outer->total_length = rte_cpu_to_be_16(t_len);
+	outer->packet_id = rte_cpu_to_be_16(seq);
+	rte_memcpy(dst, outer, sizeof(*outer));
+	dst += sizeof(*outer);
+	m->l3_len = sizeof(*outer);
+	if (natt) {
+		udph = udp_natt;
+		udph.dgram_len = rte_cpu_to_be_16(t_len - sizeof(*outer));
+		rte_memcpy(dst, &udph, sizeof(udph));
+		dst += sizeof(udph);
+	}
 	rte_memcpy(dst, &esph, sizeof(esph));
 	dst += sizeof(esph);
 
@@ -694,11 +722,17 @@ fill_ipsec_param(uint32_t replay_win_sz, uint64_t flags)
 	prm->ipsec_xform = ut_params->ipsec_xform;
 	prm->ipsec_xform.salt = (uint32_t)rte_rand();
 	prm->ipsec_xform.replay_win_sz = replay_win_sz;
+	prm->lifetime = ut_params->lifetime;
 
 	/* setup tunnel related fields */
 	prm->tun.hdr_len = sizeof(ipv4_outer);
 	prm->tun.next_proto = IPPROTO_IPIP;
 	prm->tun.hdr = &ipv4_outer;
+	if (prm->ipsec_xform.options.udp_encap) {
+		prm->tun.hdr = &ipv4_outer_natt;
+		prm->tun.udp.sport = udp_natt.src_port;
+		prm->tun.udp.dport = udp_natt.dst_port;
+	}
 
 	/* setup crypto section */
 	if (uparams.aead != 0) {
@@ -1411,6 +1445,156 @@ test_ipsec_crypto_outb_burst_null_null_wrapper(void)
 	return rc;
 }
 
+static int
+test_ipsec_crypto_inb_burst_natt_null_null_wrapper(void)
+{
+	int i;
+	int rc = 0;
+	struct ipsec_unitest_params *ut_params = &unittest_params;
+
+	ut_params->ipsec_xform.spi = INBOUND_SPI;
+	ut_params->ipsec_xform.direction = RTE_SECURITY_IPSEC_SA_DIR_INGRESS;
+	ut_params->ipsec_xform.proto = RTE_SECURITY_IPSEC_SA_PROTO_ESP;
+	ut_params->ipsec_xform.mode = RTE_SECURITY_IPSEC_SA_MODE_TUNNEL;
+	ut_params->ipsec_xform.tunnel.type = RTE_SECURITY_IPSEC_TUNNEL_IPV4;
+	ut_params->ipsec_xform.options.udp_encap = 1;
+
+	for (i = 0; i < num_cfg && rc == 0; i++) {
+		ut_params->ipsec_xform.options.esn = test_cfg[i].esn;
+		rc = test_ipsec_crypto_inb_burst_null_null(i);
+	}
+
+	return rc;
+}
+
+static int
+test_ipsec_crypto_outb_burst_natt_null_null_wrapper(void)
+{
+	int i;
+	int rc = 0;
+	struct ipsec_unitest_params *ut_params = &unittest_params;
+
+	ut_params->ipsec_xform.spi = OUTBOUND_SPI;
+	ut_params->ipsec_xform.direction = RTE_SECURITY_IPSEC_SA_DIR_EGRESS;
+	ut_params->ipsec_xform.proto = RTE_SECURITY_IPSEC_SA_PROTO_ESP;
+	ut_params->ipsec_xform.mode = RTE_SECURITY_IPSEC_SA_MODE_TUNNEL;
+	ut_params->ipsec_xform.tunnel.type = RTE_SECURITY_IPSEC_TUNNEL_IPV4;
+	ut_params->ipsec_xform.options.udp_encap = 1;
+
+	for (i = 0; i < num_cfg && rc == 0; i++) {
+		ut_params->ipsec_xform.options.esn = test_cfg[i].esn;
+		rc = test_ipsec_crypto_outb_burst_null_null(i);
+	}
+
+	return rc;
+}
+
+static int
+test_ipsec_crypto_outb_lifetime_null_null(int i)
+{
+	struct ipsec_testsuite_params *ts_params = &testsuite_params;
+	struct ipsec_unitest_params *ut_params = &unittest_params;
+	const struct rte_ipsec_sa *sa;
+	struct rte_ipsec_sa_stats stats;
+	uint16_t num_pkts = test_cfg[i].num_pkts;
+	uint64_t bytes;
+	uint16_t j, k;
+	int32_t rc;
+
+	/* SA expires right after the first burst */
+	ut_params->lifetime.packets_soft_limit = num_pkts;
+	ut_params->lifetime.packets_hard_limit = num_pkts;
+
+	/* create rte_ipsec_sa*/
+	rc = create_sa(RTE_SECURITY_ACTION_TYPE_NONE,
+			test_cfg[i].replay_win_sz, test_cfg[i].flags, 0);
+	if (rc != 0) {
+		RTE_LOG(ERR, USER1, "create_sa failed, cfg %d\n", i);
+		return TEST_FAILED;
+	}
+
+	/* Generate input mbuf data */
+	bytes = 0;
+	for (j = 0; j < num_pkts && rc == 0; j++) {
+		ut_params->ibuf[j] = setup_test_string(ts_params->mbuf_pool,
+			null_plain_data, test_cfg[i].pkt_sz, 0);
+		if (ut_params->ibuf[j] == NULL)
+			rc = TEST_FAILED;
+		else
+			bytes += ut_params->ibuf[j]->pkt_len;
+	}
+
+	if (rc == 0)
+		rc = test_ipsec_crypto_op_alloc(num_pkts);
+
+	if (rc == 0) {
+		sa = ut_params->ss[0].sa;
+
+		k = rte_ipsec_pkt_crypto_prepare(&ut_params->ss[0],
+			ut_params->ibuf, ut_params->cop, num_pkts);
+		if (k != num_pkts) {
+			RTE_LOG(ERR, USER1,
+				"rte_ipsec_pkt_crypto_prepare fail\n");
+			rc = TEST_FAILED;
+		}
+	}
+
+	if (rc == 0) {
+		rc = rte_ipsec_sa_stats_get(&sa, &stats, 1);
+		if (rc != 0 || stats.count != num_pkts ||
+				stats.bytes != bytes || stats.errors != 0 ||
+				stats.flags != (RTE_IPSEC_SA_STATS_SOFT_EXPIRED |
+				RTE_IPSEC_SA_STATS_HARD_EXPIRED)) {
+			RTE_LOG(ERR, USER1,
+				"wrong SA stats before expiry, cfg %d\n", i);
+			rc = TEST_FAILED;
+		}
+	}
+
+	/* expired SA has to drop packets */
+	if (rc == 0) {
+		k = rte_ipsec_pkt_crypto_prepare(&ut_params->ss[0],
+			ut_params->ibuf, ut_params->cop, 1);
+		if (k != 0 || rte_errno != EOVERFLOW) {
+			RTE_LOG(ERR, USER1, "expired SA prepared packets\n");
+			rc = TEST_FAILED;
+		}
+	}
+
+	if (rc == 0) {
+		rc = rte_ipsec_sa_stats_get(&sa, &stats, 1);
+		if (rc != 0 || stats.count != num_pkts || stats.errors != 1) {
+			RTE_LOG(ERR, USER1,
+				"wrong SA stats after expiry, cfg %d\n", i);
+			rc = TEST_FAILED;
+		}
+	}
+
+	destroy_sa(0);
+	return rc;
+}
+
+static int
+test_ipsec_crypto_outb_lifetime_null_null_wrapper(void)
+{
+	int i;
+	int rc = 0;
+	struct ipsec_unitest_params *ut_params = &unittest_params;
+
+	ut_params->ipsec_xform.spi = OUTBOUND_SPI;
+	ut_params->ipsec_xform.direction = RTE_SECURITY_IPSEC_SA_DIR_EGRESS;
+	ut_params->ipsec_xform.proto = RTE_SECURITY_IPSEC_SA_PROTO_ESP;
+	ut_params->ipsec_xform.mode = RTE_SECURITY_IPSEC_SA_MODE_TUNNEL;
+	ut_params->ipsec_xform.tunnel.type = RTE_SECURITY_IPSEC_TUNNEL_IPV4;
+
+	for (i = 0; i < num_cfg && rc == 0; i++) {
+		ut_params->ipsec_xform.options.esn = test_cfg[i].esn;
+		rc = test_ipsec_crypto_outb_lifetime_null_null(i);
+	}
+
+	return rc;
+}
+
 static int
 inline_inb_burst_null_null_check(struct ipsec_unitest_params *ut_params, int i,
 	uint16_t num_pkts)
@@ -2502,6 +2686,12 @@ static struct unit_test_suite ipsec_testsuite  = {
 			test_ipsec_crypto_inb_burst_null_null_wrapper),
 		TEST_CASE_ST(ut_setup, ut_teardown,
 			test_ipsec_crypto_outb_burst_null_null_wrapper),
+		TEST_CASE_ST(ut_setup, ut_teardown,
+			test_ipsec_crypto_inb_burst_natt_null_null_wrapper),
+		TEST_CASE_ST(ut_setup, ut_teardown,
+			test_ipsec_crypto_outb_burst_natt_null_null_wrapper),
+		TEST_CASE_ST(ut_setup, ut_teardown,
+			test_ipsec_crypto_outb_lifetime_null_null_wrapper),
 		TEST_CASE_ST(ut_setup, ut_teardown,
 			test_ipsec_inline_crypto_inb_burst_null_null_wrapper),
 		TEST_CASE_ST(ut_setup, ut_teardown,
@@ -13,7 +13,7 @@
 #include "sample_packet_forward.h"
 #include "test.h"
 
-#define NUM_STATS 4
+#define NUM_STATS 8
 #define LATENCY_NUM_PACKETS 10
 #define QUEUE_ID 0
 
@@ -25,6 +25,10 @@ static struct rte_metric_name lat_stats_strings[] = {
 	{"avg_latency_ns"},
 	{"max_latency_ns"},
 	{"jitter_ns"},
+	{"p50_latency_ns"},
+	{"p99_latency_ns"},
+	{"p99_9_latency_ns"},
+	{"p99_99_latency_ns"},
 };
 
 /* Test case for latency init with metrics init */
@@ -119,6 +123,18 @@ static int test_latencystats_get(void)
 	TEST_ASSERT((ret == NUM_STATS), "Test Failed to get latency metrics"
 			" values");
 
+	/* Percentiles are ordered and bounded by the min and max */
+	for (i = 4; i < NUM_STATS; i++) {
+		TEST_ASSERT(values[i].value <= values[2].value,
+			"Test Failed: %s above max latency",
+			lat_stats_strings[i].name);
+		TEST_ASSERT(values[i].value >= values[i - 1].value || i == 4,
+			"Test Failed: %s below previous percentile",
+			lat_stats_strings[i].name);
+	}
+	TEST_ASSERT(values[4].value >= values[0].value,
+		"Test Failed: median below min latency");
+
 	/* Failure Test: Invalid values and valid size */
 	ret = rte_latencystats_get(NULL, size);
 	TEST_ASSERT((ret == NUM_STATS), "Test Failed to get the stats count,"
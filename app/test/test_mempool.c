@@ -40,6 +40,8 @@
  *    - Get two objects, put two objects
  *    - Get all objects, test that their content is not modified and
  *      put them back in the pool.
+ *
+ * Cache statistics tests: done on one core with an adaptive cache.
  */
 
 #define MEMPOOL_ELT_SIZE 2048
@@ -188,6 +190,93 @@ test_mempool_basic(struct rte_mempool *mp, int use_external_cache)
 	return ret;
 }
 
+/*
+ * Check the cache statistics and the adaptive flush threshold on a
+ * sequence of operations with a known cache behavior.
+ */
+#define STATS_CACHE_SIZE 32
+#define STATS_BYPASS_NUM (STATS_CACHE_SIZE + 8)
+
+static int
+test_mempool_cache_stats(struct rte_mempool *mp_nocache)
+{
+	struct rte_mempool_cache_stats stats, sum;
+	struct rte_mempool_cache *cache;
+	struct rte_mempool *mp;
+	void *objs[STATS_BYPASS_NUM];
+	uint32_t flushthresh;
+	int ret = -1;
+
+	mp = rte_mempool_create("test_cache_stats", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, STATS_CACHE_SIZE, 0, NULL, NULL,
+		my_obj_init, NULL, SOCKET_ID_ANY, MEMPOOL_F_ADAPTIVE_CACHE);
+	if (mp == NULL)
+		RET_ERR();
+
+	cache = rte_mempool_default_cache(mp, rte_lcore_id());
+	if (cache == NULL)
+		GOTO_ERR(ret, out);
+	flushthresh = cache->flushthresh;
+
+	/* empty cache: the get refills it */
+	if (rte_mempool_get(mp, &objs[0]) < 0)
+		GOTO_ERR(ret, out);
+	rte_mempool_put(mp, objs[0]);
+
+	/* too large for the cache: goes directly to the pool */
+	if (rte_mempool_get_bulk(mp, objs, STATS_BYPASS_NUM) < 0)
+		GOTO_ERR(ret, out);
+
+	/* put in the cache, crossing the flush threshold */
+	rte_mempool_put_bulk(mp, objs, STATS_BYPASS_NUM);
+
+	if (rte_mempool_cache_stats_get(mp, rte_lcore_id(), &stats) < 0)
+		GOTO_ERR(ret, out);
+	if (stats.get_bulk != 1 || stats.get_objs != 1 ||
+			stats.refill_bulk != 1 ||
+			stats.refill_objs != STATS_CACHE_SIZE + 1 ||
+			stats.bypass_bulk != 1 ||
+			stats.bypass_objs != STATS_BYPASS_NUM ||
+			stats.put_bulk != 2 ||
+			stats.put_objs != STATS_BYPASS_NUM + 1 ||
+			stats.flush_bulk != 1 ||
+			stats.flush_objs != STATS_BYPASS_NUM + 1)
+		GOTO_ERR(ret, out);
+
+	/* the sum over all lcores matches, only this lcore is used */
+	if (rte_mempool_cache_stats_get(mp, LCORE_ID_ANY, &sum) < 0)
+		GOTO_ERR(ret, out);
+	if (memcmp(&stats, &sum, sizeof(stats)) != 0)
+		GOTO_ERR(ret, out);
+
+	/* a refill happened before the flush: threshold is raised */
+	if (cache->flushthresh <= flushthresh ||
+			cache->flushthresh > 2 * STATS_CACHE_SIZE)
+		GOTO_ERR(ret, out);
+
+	rte_mempool_dump(stdout, mp);
+
+	rte_mempool_cache_stats_reset(mp);
+	if (rte_mempool_cache_stats_get(mp, LCORE_ID_ANY, &sum) < 0 ||
+			sum.get_bulk != 0 || sum.put_bulk != 0 ||
+			sum.flush_bulk != 0)
+		GOTO_ERR(ret, out);
+
+	/* invalid parameters */
+	if (rte_mempool_cache_stats_get(mp, RTE_MAX_LCORE, &stats) !=
+			-EINVAL)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_cache_stats_get(mp_nocache, LCORE_ID_ANY, &stats) !=
+			-ENOTSUP)
+		GOTO_ERR(ret, out);
+
+	ret = 0;
+
+out:
+	rte_mempool_free(mp);
+	return ret;
+}
+
 static int test_mempool_creation_with_exceeded_cache_size(void)
 {
 	struct rte_mempool *mp_cov;
@@ -633,6 +722,10 @@ test_mempool(void)
 	if (test_mempool_basic_ex(mp_nocache) < 0)
 		GOTO_ERR(ret, err);
 
+	/* cache statistics and adaptive flush threshold */
+	if (test_mempool_cache_stats(mp_nocache) < 0)
+		GOTO_ERR(ret, err);
+
 	/* mempool operation test based on single producer and single comsumer */
 	if (test_mempool_sp_sc() < 0)
 		GOTO_ERR(ret, err);
@@ -40,6 +40,9 @@
  *    Some tests incorporate unaligned addresses for objects.
  *    The enqueued/dequeued data is validated for correctness.
  *
+ * #. Zero copy tests. Tests the SP/SC and HTS zero copy peek APIs
+ *    with reservations wrapping around the end of the ring.
+ *
  * #. Performance tests are in test_ring_perf.c
  */
 
@@ -993,6 +996,160 @@ test_ring_with_exact_size(void)
 	return -1;
 }
 
+/*
+ * Zero copy API tests. The reserved space is written and read in place,
+ * with enough iterations for the region to wrap around the ring.
+ */
+static unsigned int
+test_ring_zc_enq_start(struct rte_ring *r, int esize, unsigned int n,
+	unsigned int api_type, struct rte_ring_zc_data *zcd,
+	unsigned int *free_space)
+{
+	if (esize == -1) {
+		if (api_type & TEST_RING_ELEM_BULK)
+			return rte_ring_enqueue_zc_bulk_start(r, n, zcd,
+				free_space);
+		return rte_ring_enqueue_zc_burst_start(r, n, zcd, free_space);
+	}
+
+	if (api_type & TEST_RING_ELEM_BULK)
+		return rte_ring_enqueue_zc_bulk_elem_start(r, esize, n, zcd,
+			free_space);
+	return rte_ring_enqueue_zc_burst_elem_start(r, esize, n, zcd,
+		free_space);
+}
+
+static unsigned int
+test_ring_zc_deq_start(struct rte_ring *r, int esize, unsigned int n,
+	unsigned int api_type, struct rte_ring_zc_data *zcd,
+	unsigned int *available)
+{
+	if (esize == -1) {
+		if (api_type & TEST_RING_ELEM_BULK)
+			return rte_ring_dequeue_zc_bulk_start(r, n, zcd,
+				available);
+		return rte_ring_dequeue_zc_burst_start(r, n, zcd, available);
+	}
+
+	if (api_type & TEST_RING_ELEM_BULK)
+		return rte_ring_dequeue_zc_bulk_elem_start(r, esize, n, zcd,
+			available);
+	return rte_ring_dequeue_zc_burst_elem_start(r, esize, n, zcd,
+		available);
+}
+
+static int
+test_ring_zc(void)
+{
+	static const struct {
+		const char *desc;
+		uint32_t create_flags;
+	} zc_sync[] = {
+		{
+			.desc = "SP/SC",
+			.create_flags = RING_F_SP_ENQ | RING_F_SC_DEQ,
+		},
+		{
+			.desc = "MP_HTS/MC_HTS",
+			.create_flags = RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ,
+		},
+	};
+	static const uint32_t zc_api[] = {
+		TEST_RING_ELEM_BULK,
+		TEST_RING_ELEM_BURST,
+	};
+	const unsigned int ring_sz = 16;
+	const unsigned int nb_obj = 5;
+	struct rte_ring_zc_data zcd;
+	struct rte_ring *r = NULL;
+	void *src = NULL, *dst = NULL;
+	unsigned int i, j, k, m, n, esz, nb_wrap, free_space, avail;
+
+	for (i = 0; i != RTE_DIM(esize); i++) {
+	for (j = 0; j != RTE_DIM(zc_sync); j++) {
+	for (k = 0; k != RTE_DIM(zc_api); k++) {
+		test_ring_print_test_string("Test zero copy",
+			TEST_RING_IGNORE_API_TYPE, esize[i]);
+		printf("%s %s\n", zc_sync[j].desc,
+			(zc_api[k] & TEST_RING_ELEM_BULK) ? "bulk" : "burst");
+
+		src = test_ring_calloc(ring_sz, esize[i]);
+		dst = test_ring_calloc(ring_sz, esize[i]);
+		if (src == NULL || dst == NULL)
+			goto fail;
+		test_ring_mem_init(src, ring_sz, esize[i]);
+		esz = (esize[i] == -1) ? sizeof(void *) :
+			(unsigned int)esize[i];
+
+		r = test_ring_create("test_ring_zc", esize[i], ring_sz,
+			SOCKET_ID_ANY, zc_sync[j].create_flags);
+		if (r == NULL)
+			goto fail;
+
+		/* produce and consume in place, wrapping several times */
+		nb_wrap = 0;
+		for (m = 0; m != 2 * ring_sz; m++) {
+			n = test_ring_zc_enq_start(r, esize[i], nb_obj,
+				zc_api[k], &zcd, &free_space);
+			TEST_RING_VERIFY(n == nb_obj);
+			TEST_RING_VERIFY(free_space ==
+				rte_ring_get_capacity(r) - nb_obj);
+			TEST_RING_VERIFY((zcd.n1 == n) == (zcd.ptr2 == NULL));
+			nb_wrap += (zcd.n1 != n);
+			test_ring_copy_to(&zcd, src, esize[i], n);
+			rte_ring_enqueue_zc_elem_finish(r, n);
+
+			memset(dst, 0, ring_sz * esz);
+			n = test_ring_zc_deq_start(r, esize[i], nb_obj,
+				zc_api[k], &zcd, &avail);
+			TEST_RING_VERIFY(n == nb_obj);
+			TEST_RING_VERIFY(avail == 0);
+			test_ring_copy_from(&zcd, dst, esize[i], n);
+			rte_ring_dequeue_zc_elem_finish(r, n);
+
+			TEST_RING_VERIFY(memcmp(src, dst, nb_obj * esz) == 0);
+		}
+		TEST_RING_VERIFY(nb_wrap != 0);
+		TEST_RING_VERIFY(rte_ring_empty(r));
+
+		/* reservation larger than the free space */
+		n = rte_ring_get_capacity(r);
+		m = test_ring_zc_enq_start(r, esize[i], n + 1, zc_api[k],
+			&zcd, NULL);
+		TEST_RING_VERIFY(m == ((zc_api[k] & TEST_RING_ELEM_BULK) ?
+			0 : n));
+		rte_ring_enqueue_zc_finish(r, m);
+		TEST_RING_VERIFY(rte_ring_count(r) == m);
+
+		/* nothing is removed when finish is called with zero */
+		if (m != 0) {
+			n = test_ring_zc_deq_start(r, esize[i], 1, zc_api[k],
+				&zcd, NULL);
+			TEST_RING_VERIFY(n == 1);
+			rte_ring_dequeue_zc_finish(r, 0);
+			TEST_RING_VERIFY(rte_ring_count(r) == m);
+		}
+
+		rte_ring_free(r);
+		rte_free(src);
+		rte_free(dst);
+		r = NULL;
+		src = NULL;
+		dst = NULL;
+	}
+	}
+	}
+
+	return 0;
+
+fail:
+	printf("%s: failed to allocate test objects\n", __func__);
+	rte_ring_free(r);
+	rte_free(src);
+	rte_free(dst);
+	return -1;
+}
+
 static int
 test_ring(void)
 {
@@ -1010,6 +1167,9 @@ test_ring(void)
 	if (test_ring_with_exact_size() < 0)
 		goto test_fail;
 
+	if (test_ring_zc() < 0)
+		goto test_fail;
+
 	/* Burst and bulk operations with sp/sc, mp/mc and default.
 	 * The test cases are split into smaller test cases to
 	 * help clang compile faster.
@@ -27,6 +27,35 @@
 
 #define TEST_RING_IGNORE_API_TYPE ~0U
 
+/* Copy objects to/from the regions returned by the zero copy APIs.
+ * Used by both the functional and the stress tests.
+ */
+static inline void
+test_ring_copy_to(struct rte_ring_zc_data *zcd, const void *src, int esize,
+	unsigned int num)
+{
+	unsigned int sz;
+
+	sz = (esize == -1) ? sizeof(void *) : (unsigned int)esize;
+	memcpy(zcd->ptr1, src, zcd->n1 * sz);
+	if (zcd->n1 != num)
+		memcpy(zcd->ptr2, (const char *)src + zcd->n1 * sz,
+			(num - zcd->n1) * sz);
+}
+
+static inline void
+test_ring_copy_from(struct rte_ring_zc_data *zcd, void *dst, int esize,
+	unsigned int num)
+{
+	unsigned int sz;
+
+	sz = (esize == -1) ? sizeof(void *) : (unsigned int)esize;
+	memcpy(dst, zcd->ptr1, zcd->n1 * sz);
+	if (zcd->n1 != num)
+		memcpy((char *)dst + zcd->n1 * sz, zcd->ptr2,
+			(num - zcd->n1) * sz);
+}
+
 /* This function is placed here as it is required for both
  * performance and functional tests.
  */
@@ -37,3 +37,5 @@ extern const struct test test_ring_rts_stress;
 extern const struct test test_ring_hts_stress;
 extern const struct test test_ring_mt_peek_stress;
 extern const struct test test_ring_st_peek_stress;
+extern const struct test test_ring_mt_peek_stress_zc;
+extern const struct test test_ring_st_peek_stress_zc;
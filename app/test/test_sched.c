@@ -62,7 +62,81 @@ static struct rte_sched_port_params port_param = {
 	.n_pipes_per_subport = 1024,
 };
 
-#define NB_MBUF          32
+/* 8 strict priority traffic classes and 16 best-effort queues per pipe */
+#define BE16_N_TCS         9
+#define BE16_TC_BE         (BE16_N_TCS - 1)
+#define BE16_N_BE_QUEUES   16
+
+static struct rte_sched_pipe_params pipe_profile_be16[] = {
+	{ /* Profile #0 */
+		.tb_rate = 305175,
+		.tb_size = 1000000,
+
+		.tc_rate = {305175, 305175, 305175, 305175, 305175, 305175,
+			305175, 305175, 305175},
+		.tc_period = 40,
+		.tc_ov_weight = 1,
+	},
+};
+
+static uint8_t pipe_wrr_weights_be16[][RTE_SCHED_BE_QUEUES_PER_PIPE_MAX] = {
+	{1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}, /* Profile #0 */
+};
+
+static struct rte_sched_subport_params subport_param_be16[] = {
+	{
+		.tb_rate = 1250000000,
+		.tb_size = 1000000,
+
+		.tc_rate = {1250000000, 1250000000, 1250000000, 1250000000,
+			1250000000, 1250000000, 1250000000, 1250000000,
+			1250000000},
+		.tc_period = 10,
+		.n_pipes_per_subport_enabled = 64,
+		.qsize = {32, 32, 32, 32, 32, 32, 32, 32, 32},
+		.pipe_profiles = pipe_profile_be16,
+		.n_pipe_profiles = 1,
+		.n_max_pipe_profiles = 1,
+	},
+};
+
+static struct rte_sched_subport_ext_params subport_ext_param_be16 = {
+	.n_traffic_classes = BE16_N_TCS,
+	.n_be_queues = BE16_N_BE_QUEUES,
+	.pipe_wrr_weights = pipe_wrr_weights_be16,
+};
+
+static struct rte_sched_port_params port_param_be16 = {
+	.socket = 0, /* computed */
+	.rate = 0, /* computed */
+	.mtu = 1522,
+	.frame_overhead = RTE_SCHED_FRAME_OVERHEAD_DEFAULT,
+	.n_subports_per_port = 1,
+	.n_pipes_per_subport = 64,
+};
+
+static struct rte_sched_port_ext_params port_ext_param_be16 = {
+	.n_queues_per_pipe = 32,
+};
+
+/* Multi-core mode: subports scheduled separately, merged on dequeue */
+#define MC_N_SUBPORTS      4
+#define MC_PKTS_PER_SUBPORT 8
+
+static struct rte_sched_port_params port_param_mc = {
+	.socket = 0, /* computed */
+	.rate = 0, /* computed */
+	.mtu = 1522,
+	.frame_overhead = RTE_SCHED_FRAME_OVERHEAD_DEFAULT,
+	.n_subports_per_port = MC_N_SUBPORTS,
+	.n_pipes_per_subport = 1024,
+};
+
+static struct rte_sched_port_ext_params port_ext_param_mc = {
+	.mc_ring_size = 16,
+};
+
+#define NB_MBUF          64
 #define MBUF_DATA_SZ     (2048 + RTE_PKTMBUF_HEADROOM)
 #define MEMPOOL_CACHE_SZ 0
 #define SOCKET           0
@@ -114,6 +188,163 @@ prepare_pkt(struct rte_sched_port *port, struct rte_mbuf *mbuf)
 }
 
 
+static int
+test_sched_be16(struct rte_mempool *mp)
+{
+	struct rte_sched_port *port;
+	struct rte_mbuf *in_mbufs[BE16_N_TCS - 1 + BE16_N_BE_QUEUES];
+	struct rte_mbuf *out_mbufs[BE16_N_TCS - 1 + BE16_N_BE_QUEUES];
+	uint32_t n_pkts = RTE_DIM(in_mbufs);
+	uint32_t be_queues = 0, last_tc = 0;
+	uint32_t pipe, i;
+	int err;
+
+	port_param_be16.rate = (uint64_t) 10000 * 1000 * 1000 / 8;
+
+	port = rte_sched_port_config_ext(&port_param_be16,
+		&port_ext_param_be16);
+	TEST_ASSERT_NOT_NULL(port, "Error config sched port\n");
+
+	err = rte_sched_subport_config_ext(port, SUBPORT, subport_param_be16,
+		&subport_ext_param_be16);
+	TEST_ASSERT_SUCCESS(err, "Error config sched, err=%d\n", err);
+
+	for (pipe = 0; pipe < subport_param_be16[0].n_pipes_per_subport_enabled;
+			pipe++) {
+		err = rte_sched_pipe_config(port, SUBPORT, pipe, 0);
+		TEST_ASSERT_SUCCESS(err, "Error config sched pipe %u, err=%d\n",
+			pipe, err);
+	}
+
+	/* One packet per queue, best-effort queues enqueued first */
+	for (i = 0; i < n_pkts; i++) {
+		uint32_t tc = BE16_TC_BE, queue = i;
+
+		if (i >= BE16_N_BE_QUEUES) {
+			tc = i - BE16_N_BE_QUEUES;
+			queue = 0;
+		}
+
+		in_mbufs[i] = rte_pktmbuf_alloc(mp);
+		TEST_ASSERT_NOT_NULL(in_mbufs[i], "Packet allocation failed\n");
+		rte_sched_port_pkt_write(port, in_mbufs[i], SUBPORT, PIPE, tc,
+			queue, RTE_COLOR_GREEN);
+		in_mbufs[i]->pkt_len = 60;
+		in_mbufs[i]->data_len = 60;
+	}
+
+	err = rte_sched_port_enqueue(port, in_mbufs, n_pkts);
+	TEST_ASSERT_EQUAL(err, (int)n_pkts, "Wrong enqueue, err=%d\n", err);
+
+	err = rte_sched_port_dequeue(port, out_mbufs, n_pkts);
+	TEST_ASSERT_EQUAL(err, (int)n_pkts, "Wrong dequeue, err=%d\n", err);
+
+	/* Strict priority order, then every best-effort queue once */
+	for (i = 0; i < n_pkts; i++) {
+		uint32_t subport, traffic_class, queue;
+
+		rte_sched_port_pkt_read_tree_path(port, out_mbufs[i],
+				&subport, &pipe, &traffic_class, &queue);
+
+		TEST_ASSERT_EQUAL(subport, SUBPORT, "Wrong subport\n");
+		TEST_ASSERT_EQUAL(pipe, PIPE, "Wrong pipe\n");
+		TEST_ASSERT(traffic_class >= last_tc,
+			"Wrong traffic class order\n");
+		last_tc = traffic_class;
+
+		if (traffic_class == BE16_TC_BE)
+			be_queues |= 1 << queue;
+		else
+			TEST_ASSERT_EQUAL(queue, 0, "Wrong queue\n");
+
+		rte_pktmbuf_free(out_mbufs[i]);
+	}
+
+	TEST_ASSERT_EQUAL(be_queues, (1u << BE16_N_BE_QUEUES) - 1,
+		"Wrong best-effort queues\n");
+
+	rte_sched_port_free(port);
+
+	return 0;
+}
+
+static int
+test_sched_mc(struct rte_mempool *mp)
+{
+	struct rte_sched_port *port;
+	struct rte_mbuf *in_mbufs[MC_N_SUBPORTS * MC_PKTS_PER_SUBPORT];
+	struct rte_mbuf *out_mbufs[MC_N_SUBPORTS * MC_PKTS_PER_SUBPORT];
+	uint32_t n_pkts = RTE_DIM(in_mbufs);
+	uint32_t subport_pkts[MC_N_SUBPORTS] = {0};
+	uint32_t subport, pipe, i;
+	int err;
+
+	port_param_mc.rate = (uint64_t) 10000 * 1000 * 1000 / 8;
+
+	port = rte_sched_port_config_ext(&port_param_mc, &port_ext_param_mc);
+	TEST_ASSERT_NOT_NULL(port, "Error config sched port\n");
+
+	for (subport = 0; subport < MC_N_SUBPORTS; subport++) {
+		err = rte_sched_subport_config(port, subport, subport_param);
+		TEST_ASSERT_SUCCESS(err, "Error config sched, err=%d\n", err);
+
+		err = rte_sched_pipe_config(port, subport, PIPE, 0);
+		TEST_ASSERT_SUCCESS(err, "Error config sched pipe, err=%d\n",
+			err);
+	}
+
+	for (i = 0; i < n_pkts; i++) {
+		in_mbufs[i] = rte_pktmbuf_alloc(mp);
+		TEST_ASSERT_NOT_NULL(in_mbufs[i], "Packet allocation failed\n");
+		rte_sched_port_pkt_write(port, in_mbufs[i], i % MC_N_SUBPORTS,
+			PIPE, TC, QUEUE, RTE_COLOR_GREEN);
+		in_mbufs[i]->pkt_len = 60;
+		in_mbufs[i]->data_len = 60;
+	}
+
+	err = rte_sched_port_enqueue(port, in_mbufs, n_pkts);
+	TEST_ASSERT_EQUAL(err, (int)n_pkts, "Wrong enqueue, err=%d\n", err);
+
+	/* Nothing is dequeued until the subports are scheduled */
+	err = rte_sched_port_dequeue(port, out_mbufs, n_pkts);
+	TEST_ASSERT_EQUAL(err, 0, "Wrong dequeue, err=%d\n", err);
+
+	err = rte_sched_subport_schedule(port, MC_N_SUBPORTS, n_pkts);
+	TEST_ASSERT_EQUAL(err, -EINVAL, "Wrong subport schedule, err=%d\n",
+		err);
+
+	for (subport = 0; subport < MC_N_SUBPORTS; subport++) {
+		err = rte_sched_subport_schedule(port, subport, n_pkts);
+		TEST_ASSERT_EQUAL(err, MC_PKTS_PER_SUBPORT,
+			"Wrong subport schedule, err=%d\n", err);
+	}
+
+	err = rte_sched_port_dequeue(port, out_mbufs, n_pkts);
+	TEST_ASSERT_EQUAL(err, (int)n_pkts, "Wrong dequeue, err=%d\n", err);
+
+	for (i = 0; i < n_pkts; i++) {
+		uint32_t traffic_class, queue;
+
+		rte_sched_port_pkt_read_tree_path(port, out_mbufs[i],
+				&subport, &pipe, &traffic_class, &queue);
+
+		TEST_ASSERT(subport < MC_N_SUBPORTS, "Wrong subport\n");
+		TEST_ASSERT_EQUAL(pipe, PIPE, "Wrong pipe\n");
+		TEST_ASSERT_EQUAL(traffic_class, TC, "Wrong traffic_class\n");
+		subport_pkts[subport]++;
+
+		rte_pktmbuf_free(out_mbufs[i]);
+	}
+
+	for (subport = 0; subport < MC_N_SUBPORTS; subport++)
+		TEST_ASSERT_EQUAL(subport_pkts[subport], MC_PKTS_PER_SUBPORT,
+			"Wrong subport %u packets\n", subport);
+
+	rte_sched_port_free(port);
+
+	return 0;
+}
+
 /**
  * test main entrance for library sched
  */
@@ -156,6 +387,11 @@ test_sched(void)
 	err = rte_sched_port_enqueue(port, in_mbufs, 10);
 	TEST_ASSERT_EQUAL(err, 10, "Wrong enqueue, err=%d\n", err);
 
+	/* Subport schedule is only valid in multi-core mode */
+	err = rte_sched_subport_schedule(port, SUBPORT, 10);
+	TEST_ASSERT_EQUAL(err, -EINVAL, "Wrong subport schedule, err=%d\n",
+		err);
+
 	err = rte_sched_port_dequeue(port, out_mbufs, 10);
 	TEST_ASSERT_EQUAL(err, 10, "Wrong dequeue, err=%d\n", err);
 
@@ -192,7 +428,11 @@ test_sched(void)
 
 	rte_sched_port_free(port);
 
-	return 0;
+	err = test_sched_be16(mp);
+	if (err != 0)
+		return err;
+
+	return test_sched_mc(mp);
 }
 
 REGISTER_TEST_COMMAND(sched_autotest, test_sched);
@@ -0,0 +1,267 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_bitmap.h>
+#include <rte_sched.h>
+
+#include "test.h"
+
+/*
+ * Hierarchical scheduler performance test: measures the enqueue and dequeue
+ * cost per packet with many active pipes, for the default pipe layout and for
+ * a 16 best-effort queue layout, as well as the cost of the bitmap scan used
+ * by the dequeue to find the active queues.
+ */
+
+#define N_PIPES          4096
+#define N_PKTS           8192
+#define BURST_SIZE       64
+#define ITERATIONS       (1 << 14)
+#define PORT_RATE        ((uint64_t)10000 * 1000 * 1000 / 8)
+
+#define BMP_N_BITS       (1 << 20)
+#define BMP_N_BITS_SET   (1 << 10)
+#define BMP_ITERATIONS   (1 << 20)
+
+static struct rte_sched_pipe_params pipe_profile[] = {
+	{ /* Profile #0: never runs out of credits */
+		.tb_rate = PORT_RATE,
+		.tb_size = 1000000,
+
+		.tc_rate = {PORT_RATE, PORT_RATE, PORT_RATE, PORT_RATE,
+			PORT_RATE, PORT_RATE, PORT_RATE, PORT_RATE, PORT_RATE,
+			PORT_RATE, PORT_RATE, PORT_RATE, PORT_RATE},
+		.tc_period = 40,
+		.tc_ov_weight = 1,
+
+		.wrr_weights = {1, 2, 4, 8},
+	},
+};
+
+static uint8_t pipe_wrr_weights[][RTE_SCHED_BE_QUEUES_PER_PIPE_MAX] = {
+	{1, 2, 4, 8, 1, 2, 4, 8, 1, 2, 4, 8, 1, 2, 4, 8}, /* Profile #0 */
+};
+
+static struct rte_sched_subport_params subport_param = {
+	.tb_rate = PORT_RATE,
+	.tb_size = 1000000,
+
+	.tc_rate = {PORT_RATE, PORT_RATE, PORT_RATE, PORT_RATE,
+		PORT_RATE, PORT_RATE, PORT_RATE, PORT_RATE, PORT_RATE,
+		PORT_RATE, PORT_RATE, PORT_RATE, PORT_RATE},
+	.tc_period = 10,
+	.n_pipes_per_subport_enabled = N_PIPES,
+	.qsize = {64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64},
+	.pipe_profiles = pipe_profile,
+	.n_pipe_profiles = 1,
+	.n_max_pipe_profiles = 1,
+};
+
+static struct rte_sched_port_params port_param = {
+	.socket = 0, /* computed */
+	.rate = PORT_RATE,
+	.mtu = 1522,
+	.frame_overhead = RTE_SCHED_FRAME_OVERHEAD_DEFAULT,
+	.n_subports_per_port = 1,
+	.n_pipes_per_subport = N_PIPES,
+};
+
+static struct rte_sched_subport_ext_params subport_ext_param = {
+	.pipe_wrr_weights = pipe_wrr_weights,
+};
+
+static struct rte_sched_port_ext_params port_ext_param;
+
+struct sched_perf_layout {
+	const char *name;
+	uint32_t n_traffic_classes;
+	uint32_t n_be_queues;
+	uint32_t n_queues_per_pipe;
+};
+
+static const struct sched_perf_layout layouts[] = {
+	{"13 TCs, 4 BE queues", 0, 0, 0},
+	{"9 TCs, 16 BE queues", 9, 16, 32},
+};
+
+static int
+test_sched_perf_layout(struct rte_mempool *mp,
+	const struct sched_perf_layout *layout)
+{
+	static struct rte_mbuf *pkts[N_PKTS];
+	struct rte_sched_port *port;
+	uint32_t n_tcs, n_be_queues, n_in, i;
+	uint64_t enq_cycles = 0, deq_cycles = 0, n_enq = 0, n_deq = 0;
+	uint64_t start;
+	int ret = TEST_SUCCESS;
+	int k;
+
+	n_tcs = layout->n_traffic_classes ? layout->n_traffic_classes :
+		RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE;
+	n_be_queues = layout->n_be_queues ? layout->n_be_queues :
+		RTE_SCHED_BE_QUEUES_PER_PIPE;
+
+	port_param.socket = rte_socket_id();
+	port_ext_param.n_queues_per_pipe = layout->n_queues_per_pipe;
+	subport_ext_param.n_traffic_classes = layout->n_traffic_classes;
+	subport_ext_param.n_be_queues = layout->n_be_queues;
+	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++) {
+		uint64_t tc_rate = (i < n_tcs) ? PORT_RATE : 0;
+
+		subport_param.qsize[i] = (i < n_tcs) ? 64 : 0;
+		subport_param.tc_rate[i] = tc_rate;
+		pipe_profile[0].tc_rate[i] = tc_rate;
+	}
+
+	port = rte_sched_port_config_ext(&port_param, &port_ext_param);
+	TEST_ASSERT_NOT_NULL(port, "Error config sched port\n");
+
+	if (rte_sched_subport_config_ext(port, 0, &subport_param,
+			&subport_ext_param) != 0) {
+		printf("Error config sched subport\n");
+		ret = TEST_FAILED;
+		goto port_free;
+	}
+
+	for (i = 0; i < N_PIPES; i++)
+		if (rte_sched_pipe_config(port, 0, i, 0) != 0) {
+			printf("Error config sched pipe %u\n", i);
+			ret = TEST_FAILED;
+			goto port_free;
+		}
+
+	if (rte_pktmbuf_alloc_bulk(mp, pkts, N_PKTS) != 0) {
+		printf("Packet allocation failed\n");
+		ret = TEST_FAILED;
+		goto port_free;
+	}
+
+	/* Spread the packets over all the pipes and queues */
+	for (i = 0; i < N_PKTS; i++) {
+		uint32_t tc = (i / 3) % n_tcs;
+		uint32_t queue = (tc == n_tcs - 1) ? (i / 5) % n_be_queues : 0;
+
+		rte_sched_port_pkt_write(port, pkts[i], 0, i % N_PIPES, tc,
+			queue, RTE_COLOR_GREEN);
+		pkts[i]->pkt_len = 64;
+		pkts[i]->data_len = 64;
+	}
+
+	/* Fill the scheduler, then re-enqueue each dequeued burst */
+	k = rte_sched_port_enqueue(port, &pkts[BURST_SIZE],
+		N_PKTS - BURST_SIZE);
+	if (k != N_PKTS - BURST_SIZE) {
+		printf("Wrong enqueue: %d\n", k);
+		rte_pktmbuf_free_bulk(pkts, BURST_SIZE);
+		ret = TEST_FAILED;
+		goto port_free;
+	}
+
+	n_in = BURST_SIZE;
+	for (i = 0; i < ITERATIONS; i++) {
+		start = rte_rdtsc_precise();
+		k = rte_sched_port_enqueue(port, pkts, n_in);
+		enq_cycles += rte_rdtsc_precise() - start;
+		if (k != (int)n_in) {
+			printf("Wrong enqueue: %d out of %u\n", k, n_in);
+			n_in = 0;
+			ret = TEST_FAILED;
+			break;
+		}
+		n_enq += n_in;
+
+		start = rte_rdtsc_precise();
+		k = rte_sched_port_dequeue(port, pkts, BURST_SIZE);
+		deq_cycles += rte_rdtsc_precise() - start;
+		n_in = k;
+		n_deq += n_in;
+	}
+
+	if (ret == TEST_SUCCESS)
+		printf("%s: enqueue %.2f cycles/pkt, dequeue %.2f cycles/pkt\n",
+			layout->name, (double)enq_cycles / n_enq,
+			(double)deq_cycles / RTE_MAX(n_deq, (uint64_t)1));
+
+	/* The packets still in the scheduler are freed along with the port */
+	rte_pktmbuf_free_bulk(pkts, n_in);
+
+port_free:
+	rte_sched_port_free(port);
+
+	return ret;
+}
+
+static int
+test_sched_perf_bitmap_scan(void)
+{
+	struct rte_bitmap *bmp;
+	uint64_t start, cycles, sum = 0, slab = 0;
+	uint32_t bmp_size, pos = 0, i;
+	uint8_t *mem;
+
+	bmp_size = rte_bitmap_get_memory_footprint(BMP_N_BITS);
+	mem = rte_zmalloc("test_sched_perf_bmp", bmp_size, RTE_CACHE_LINE_SIZE);
+	TEST_ASSERT_NOT_NULL(mem, "Bitmap memory allocation failed\n");
+
+	bmp = rte_bitmap_init(BMP_N_BITS, mem, bmp_size);
+	if (bmp == NULL) {
+		rte_free(mem);
+		printf("Bitmap init failed\n");
+		return TEST_FAILED;
+	}
+
+	/* Sparse bitmap: one bit set every few cache lines */
+	for (i = 0; i < BMP_N_BITS_SET; i++)
+		rte_bitmap_set(bmp, i * (BMP_N_BITS / BMP_N_BITS_SET) +
+			(i % RTE_BITMAP_CL_BIT_SIZE));
+
+	start = rte_rdtsc_precise();
+	for (i = 0; i < BMP_ITERATIONS; i++) {
+		if (rte_bitmap_scan(bmp, &pos, &slab) == 0)
+			break;
+		sum += pos;
+	}
+	cycles = rte_rdtsc_precise() - start;
+
+	printf("bitmap scan: %.2f cycles/scan (%" PRIu64 ")\n",
+		(double)cycles / BMP_ITERATIONS, sum);
+
+	rte_bitmap_free(bmp);
+	rte_free(mem);
+
+	return (i == BMP_ITERATIONS) ? TEST_SUCCESS : TEST_FAILED;
+}
+
+static int
+test_sched_perf(void)
+{
+	struct rte_mempool *mp;
+	uint32_t i;
+	int ret;
+
+	mp = rte_pktmbuf_pool_create("test_sched_perf", N_PKTS, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
+	TEST_ASSERT_NOT_NULL(mp, "Error creating mempool\n");
+
+	for (i = 0; i < RTE_DIM(layouts); i++) {
+		ret = test_sched_perf_layout(mp, &layouts[i]);
+		if (ret != TEST_SUCCESS)
+			break;
+	}
+
+	rte_mempool_free(mp);
+	if (ret != TEST_SUCCESS)
+		return ret;
+
+	return test_sched_perf_bitmap_scan();
+}
+
+REGISTER_TEST_COMMAND(sched_perf_autotest, test_sched_perf);
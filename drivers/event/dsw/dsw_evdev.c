@@ -2,11 +2,14 @@
  * Copyright(c) 2018 Ericsson AB
  */
 
+#include <errno.h>
 #include <stdbool.h>
+#include <stdlib.h>
 
 #include <rte_cycles.h>
 #include <rte_eventdev_pmd.h>
 #include <rte_eventdev_pmd_vdev.h>
+#include <rte_kvargs.h>
 #include <rte_random.h>
 #include <rte_ring_elem.h>
 
@@ -14,6 +17,13 @@
 
 #define EVENTDEV_NAME_DSW_PMD event_dsw
 
+#define DSW_MIGRATION_INTERVAL_ARG "migration_interval"
+#define DSW_LOAD_UPDATE_INTERVAL_ARG "load_update_interval"
+#define DSW_OLD_LOAD_WEIGHT_ARG "old_load_weight"
+#define DSW_MIN_SOURCE_LOAD_ARG "min_source_load"
+#define DSW_MAX_TARGET_LOAD_ARG "max_target_load"
+#define DSW_REBALANCE_THRESHOLD_ARG "rebalance_threshold"
+
 static int
 dsw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 	       const struct rte_event_port_conf *conf)
@@ -65,10 +75,10 @@ dsw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 	rte_atomic32_init(&port->immigration_load);
 
 	port->load_update_interval =
-		(DSW_LOAD_UPDATE_INTERVAL * rte_get_timer_hz()) / US_PER_S;
+		(dsw->load_update_interval * rte_get_timer_hz()) / US_PER_S;
 
 	port->migration_interval =
-		(DSW_MIGRATION_INTERVAL * rte_get_timer_hz()) / US_PER_S;
+		(dsw->migration_interval * rte_get_timer_hz()) / US_PER_S;
 
 	dev->data->ports[port_id] = port;
 
@@ -391,12 +401,159 @@ static struct rte_eventdev_ops dsw_evdev_ops = {
 	.xstats_get_by_name = dsw_xstats_get_by_name
 };
 
+static int
+dsw_parse_uint(const char *value, unsigned long min, unsigned long max,
+	       unsigned long *result)
+{
+	char *end;
+
+	errno = 0;
+	*result = strtoul(value, &end, 0);
+
+	if (errno != 0 || end == value || *end != '\0' || *result < min ||
+	    *result > max)
+		return -EINVAL;
+
+	return 0;
+}
+
+static int
+dsw_set_interval(const char *key __rte_unused, const char *value,
+		 void *opaque)
+{
+	uint32_t *interval = opaque;
+	unsigned long v;
+
+	if (dsw_parse_uint(value, 1, DSW_MAX_MIGRATION_INTERVAL, &v) < 0)
+		return -EINVAL;
+
+	*interval = v;
+
+	return 0;
+}
+
+static int
+dsw_set_old_load_weight(const char *key __rte_unused, const char *value,
+			void *opaque)
+{
+	uint16_t *weight = opaque;
+	unsigned long v;
+
+	if (dsw_parse_uint(value, 0, DSW_MAX_OLD_LOAD_WEIGHT, &v) < 0)
+		return -EINVAL;
+
+	*weight = v;
+
+	return 0;
+}
+
+static int
+dsw_set_load(const char *key __rte_unused, const char *value, void *opaque)
+{
+	int16_t *load = opaque;
+	unsigned long percent;
+
+	if (dsw_parse_uint(value, 0, 100, &percent) < 0)
+		return -EINVAL;
+
+	*load = DSW_LOAD_FROM_PERCENT(percent);
+
+	return 0;
+}
+
+static int
+dsw_parse_args(const char *name, const char *params, struct dsw_evdev *dsw)
+{
+	static const char *const args[] = {
+		DSW_MIGRATION_INTERVAL_ARG,
+		DSW_LOAD_UPDATE_INTERVAL_ARG,
+		DSW_OLD_LOAD_WEIGHT_ARG,
+		DSW_MIN_SOURCE_LOAD_ARG,
+		DSW_MAX_TARGET_LOAD_ARG,
+		DSW_REBALANCE_THRESHOLD_ARG,
+		NULL
+	};
+	static const struct {
+		const char *key;
+		arg_handler_t handler;
+		size_t offset;
+	} handlers[] = {
+		{ DSW_MIGRATION_INTERVAL_ARG, dsw_set_interval,
+		  offsetof(struct dsw_evdev, migration_interval) },
+		{ DSW_LOAD_UPDATE_INTERVAL_ARG, dsw_set_interval,
+		  offsetof(struct dsw_evdev, load_update_interval) },
+		{ DSW_OLD_LOAD_WEIGHT_ARG, dsw_set_old_load_weight,
+		  offsetof(struct dsw_evdev, old_load_weight) },
+		{ DSW_MIN_SOURCE_LOAD_ARG, dsw_set_load,
+		  offsetof(struct dsw_evdev, min_source_load) },
+		{ DSW_MAX_TARGET_LOAD_ARG, dsw_set_load,
+		  offsetof(struct dsw_evdev, max_target_load) },
+		{ DSW_REBALANCE_THRESHOLD_ARG, dsw_set_load,
+		  offsetof(struct dsw_evdev, rebalance_threshold) }
+	};
+	struct rte_kvargs *kvlist;
+	bool load_update_interval_set;
+	unsigned int i;
+	int rc = 0;
+
+	dsw->migration_interval = DSW_MIGRATION_INTERVAL;
+	dsw->old_load_weight = DSW_OLD_LOAD_WEIGHT;
+	dsw->min_source_load = DSW_MIN_SOURCE_LOAD_FOR_MIGRATION;
+	dsw->max_target_load = DSW_MAX_TARGET_LOAD_FOR_MIGRATION;
+	dsw->rebalance_threshold = DSW_REBALANCE_THRESHOLD;
+
+	if (params == NULL || params[0] == '\0') {
+		dsw->load_update_interval = DSW_LOAD_UPDATE_INTERVAL;
+		return 0;
+	}
+
+	kvlist = rte_kvargs_parse(params, args);
+	if (kvlist == NULL) {
+		RTE_EDEV_LOG_ERR("%s: invalid device arguments \"%s\"\n",
+				 name, params);
+		return -EINVAL;
+	}
+
+	for (i = 0; i < RTE_DIM(handlers); i++) {
+		rc = rte_kvargs_process(kvlist, handlers[i].key,
+					handlers[i].handler,
+					(char *)dsw + handlers[i].offset);
+		if (rc != 0) {
+			RTE_EDEV_LOG_ERR("%s: invalid value for \"%s\"\n",
+					 name, handlers[i].key);
+			goto out;
+		}
+	}
+
+	/* Unless given explicitly, keep the load update interval
+	 * proportional to the migration interval.
+	 */
+	load_update_interval_set =
+		rte_kvargs_count(kvlist, DSW_LOAD_UPDATE_INTERVAL_ARG) > 0;
+	if (!load_update_interval_set)
+		dsw->load_update_interval =
+			RTE_MAX(dsw->migration_interval / 4, 1U);
+
+	if (dsw->load_update_interval > dsw->migration_interval) {
+		RTE_EDEV_LOG_ERR("%s: \"%s\" may not exceed \"%s\"\n", name,
+				 DSW_LOAD_UPDATE_INTERVAL_ARG,
+				 DSW_MIGRATION_INTERVAL_ARG);
+		rc = -EINVAL;
+	}
+
+out:
+	rte_kvargs_free(kvlist);
+
+	return rc;
+}
+
 static int
 dsw_probe(struct rte_vdev_device *vdev)
 {
 	const char *name;
 	struct rte_eventdev *dev;
 	struct dsw_evdev *dsw;
+	int rc;
 
 	name = rte_vdev_device_name(vdev);
 
@@ -419,6 +576,12 @@ dsw_probe(struct rte_vdev_device *vdev)
 	dsw = dev->data->dev_private;
 	dsw->data = dev->data;
 
+	rc = dsw_parse_args(name, rte_vdev_device_args(vdev), dsw);
+	if (rc < 0) {
+		rte_event_pmd_vdev_uninit(name);
+		return rc;
+	}
+
 	return 0;
 }
 
@@ -440,3 +603,10 @@ static struct rte_vdev_driver evdev_dsw_pmd_drv = {
 };
 
 RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_DSW_PMD, evdev_dsw_pmd_drv);
+RTE_PMD_REGISTER_PARAM_STRING(EVENTDEV_NAME_DSW_PMD,
+			      DSW_MIGRATION_INTERVAL_ARG "=<us> "
+			      DSW_LOAD_UPDATE_INTERVAL_ARG "=<us> "
+			      DSW_OLD_LOAD_WEIGHT_ARG "=<int> "
+			      DSW_MIN_SOURCE_LOAD_ARG "=<percent> "
+			      DSW_MAX_TARGET_LOAD_ARG "=<percent> "
+			      DSW_REBALANCE_THRESHOLD_ARG "=<percent>");
@@ -83,6 +83,7 @@
  */
 #define DSW_LOAD_UPDATE_INTERVAL (DSW_MIGRATION_INTERVAL/4)
 #define DSW_OLD_LOAD_WEIGHT (1)
+#define DSW_MAX_OLD_LOAD_WEIGHT (255)
 
 /* The minimum time (in us) between two flow migrations. What puts an
  * upper limit on the actual migration rate is primarily the pace in
@@ -95,6 +96,16 @@
 #define DSW_MAX_TARGET_LOAD_FOR_MIGRATION (DSW_LOAD_FROM_PERCENT(95))
 #define DSW_REBALANCE_THRESHOLD (DSW_LOAD_FROM_PERCENT(3))
 
+/* The above migration parameters are the defaults, which may be
+ * overridden per device with vdev arguments. A high old load weight
+ * makes the load estimate average over a longer window, and thus
+ * keeps short bursts from triggering migrations.
+ */
+#define DSW_MAX_MIGRATION_INTERVAL (10000000)
+
+/* Number of port load estimates kept for the xstats */
+#define DSW_LOAD_HISTORY_LEN (8)
+
 #define DSW_MAX_EVENTS_RECORDED (128)
 
 #define DSW_MAX_FLOWS_PER_MIGRATION (8)
@@ -172,6 +183,7 @@ struct dsw_port {
 	uint64_t emigration_start;
 	uint64_t emigrations;
 	uint64_t emigration_latency;
+	uint64_t emigration_latency_max;
 
 	uint8_t emigration_target_port_ids[DSW_MAX_FLOWS_PER_MIGRATION];
 	struct dsw_queue_flow
@@ -181,6 +193,9 @@ struct dsw_port {
 
 	uint64_t immigrations;
 
+	uint16_t load_history_idx;
+	int16_t load_history[DSW_LOAD_HISTORY_LEN];
+
 	uint16_t paused_flows_len;
 	struct dsw_queue_flow paused_flows[DSW_MAX_PAUSED_FLOWS];
 
@@ -241,6 +256,14 @@ struct dsw_evdev {
 	uint8_t num_queues;
 	int32_t max_inflight;
 
+	/* Migration parameters; intervals are in us. */
+	uint32_t migration_interval;
+	uint32_t load_update_interval;
+	uint16_t old_load_weight;
+	int16_t min_source_load;
+	int16_t max_target_load;
+	int16_t rebalance_threshold;
+
 	rte_atomic32_t credits_on_loan __rte_cache_aligned;
 };
 
@@ -148,6 +148,7 @@ dsw_port_load_close_period(struct dsw_port *port, uint64_t now)
 static void
 dsw_port_load_update(struct dsw_port *port, uint64_t now)
 {
+	int32_t old_load_weight = port->dsw->old_load_weight;
 	int16_t old_load;
 	int16_t period_load;
 	int16_t new_load;
@@ -156,11 +157,15 @@ dsw_port_load_update(struct dsw_port *port, uint64_t now)
 
 	period_load = dsw_port_load_close_period(port, now);
 
-	new_load = (period_load + old_load*DSW_OLD_LOAD_WEIGHT) /
-		(DSW_OLD_LOAD_WEIGHT+1);
+	new_load = (period_load + old_load*old_load_weight) /
+		(old_load_weight+1);
 
 	rte_atomic16_set(&port->load, new_load);
 
+	port->load_history[port->load_history_idx] = new_load;
+	port->load_history_idx =
+		(port->load_history_idx + 1) % DSW_LOAD_HISTORY_LEN;
+
 	/* The load of the recently immigrated flows should hopefully
 	 * be reflected the load estimate by now.
 	 */
@@ -389,18 +394,18 @@ dsw_flow_load(uint16_t num_events, int16_t port_load)
 }
 
 static int16_t
-dsw_evaluate_migration(int16_t source_load, int16_t target_load,
-		       int16_t flow_load)
+dsw_evaluate_migration(struct dsw_evdev *dsw, int16_t source_load,
+		       int16_t target_load, int16_t flow_load)
 {
 	int32_t res_target_load;
 	int32_t imbalance;
 
-	if (target_load > DSW_MAX_TARGET_LOAD_FOR_MIGRATION)
+	if (target_load > dsw->max_target_load)
 		return -1;
 
 	imbalance = source_load - target_load;
 
-	if (imbalance < DSW_REBALANCE_THRESHOLD)
+	if (imbalance < dsw->rebalance_threshold)
 		return -1;
 
 	res_target_load = target_load + flow_load;
@@ -448,7 +453,7 @@ dsw_select_emigration_target(struct dsw_evdev *dsw,
 	int16_t candidate_flow_load = -1;
 	uint16_t i;
 
-	if (source_port_load < DSW_MIN_SOURCE_LOAD_FOR_MIGRATION)
+	if (source_port_load < dsw->min_source_load)
 		return false;
 
 	for (i = 0; i < num_bursts; i++) {
@@ -472,7 +477,7 @@ dsw_select_emigration_target(struct dsw_evdev *dsw,
 			if (!dsw_is_serving_port(dsw, port_id, qf->queue_id))
 				continue;
 
-			weight = dsw_evaluate_migration(source_port_load,
+			weight = dsw_evaluate_migration(dsw, source_port_load,
 							port_loads[port_id],
 							flow_load);
 
@@ -720,6 +725,9 @@ dsw_port_emigration_stats(struct dsw_port *port, uint8_t finished)
 		(rte_get_timer_cycles() - port->emigration_start);
 	port->emigration_latency += (flow_migration_latency * finished);
 	port->emigrations += finished;
+
+	if (flow_migration_latency > port->emigration_latency_max)
+		port->emigration_latency_max = flow_migration_latency;
 }
 
 static void
@@ -851,11 +859,11 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 	}
 
 	source_port_load = rte_atomic16_read(&source_port->load);
-	if (source_port_load < DSW_MIN_SOURCE_LOAD_FOR_MIGRATION) {
+	if (source_port_load < dsw->min_source_load) {
 		DSW_LOG_DP_PORT(DEBUG, source_port->id,
 		      "Load %d is below threshold level %d.\n",
 		      DSW_LOAD_TO_PERCENT(source_port_load),
-		      DSW_LOAD_TO_PERCENT(DSW_MIN_SOURCE_LOAD_FOR_MIGRATION));
+		      DSW_LOAD_TO_PERCENT(dsw->min_source_load));
 		return;
 	}
 
@@ -864,7 +872,7 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 	 */
 	any_port_below_limit =
 		dsw_retrieve_port_loads(dsw, port_loads,
-					DSW_MAX_TARGET_LOAD_FOR_MIGRATION);
+					dsw->max_target_load);
 	if (!any_port_below_limit) {
 		DSW_LOG_DP_PORT(DEBUG, source_port->id,
 				"Candidate target ports are all too highly "
@@ -19,19 +19,34 @@
 #define NUMA_NODE_ARG "numa_node"
 #define SCHED_QUANTA_ARG "sched_quanta"
 #define CREDIT_QUANTA_ARG "credit_quanta"
+#define SCHED_SHARDS_ARG "sched_shards"
 
 static void
 sw_info_get(struct rte_eventdev *dev, struct rte_event_dev_info *info);
 
+/* Ring and queue names of shard 0 keep the plain "sw<dev_id>" prefix.
+ * Truncated names could collide across shards, so they are rejected.
+ */
 static int
-sw_port_link(struct rte_eventdev *dev, void *port, const uint8_t queues[],
-		const uint8_t priorities[], uint16_t num)
+sw_shard_name(const struct sw_evdev *sw, char *buf, size_t len)
+{
+	int n;
+
+	if (sw->shard_id == 0)
+		n = snprintf(buf, len, "sw%d", sw->data->dev_id);
+	else
+		n = snprintf(buf, len, "sw%d_s%u", sw->data->dev_id,
+				sw->shard_id);
+
+	return (n < 0 || (size_t)n >= len) ? -ENAMETOOLONG : 0;
+}
+
+static int
+sw_shard_port_link(struct sw_evdev *sw, struct sw_port *p,
+		const uint8_t queues[], uint16_t num)
 {
-	struct sw_port *p = port;
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	int i;
 
-	RTE_SET_USED(priorities);
 	for (i = 0; i < num; i++) {
 		struct sw_qid *q = &sw->qids[queues[i]];
 		unsigned int j;
@@ -86,11 +101,28 @@ sw_port_link(struct rte_eventdev *dev, void *port, const uint8_t queues[],
 }
 
 static int
-sw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
-		uint16_t nb_unlinks)
+sw_port_link(struct rte_eventdev *dev, void *port, const uint8_t queues[],
+		const uint8_t priorities[], uint16_t num)
 {
 	struct sw_port *p = port;
 	struct sw_evdev *sw = sw_pmd_priv(dev);
+	int i, ret;
+
+	RTE_SET_USED(priorities);
+	ret = sw_shard_port_link(sw, p, queues, num);
+
+	/* the shards hold identical links, so the same prefix succeeds */
+	for (i = 1; i < sw->nb_shards; i++)
+		sw_shard_port_link(sw->shards[i],
+				&sw->shards[i]->ports[p->id], queues, ret);
+
+	return ret;
+}
+
+static int
+sw_shard_port_unlink(struct sw_evdev *sw, struct sw_port *p,
+		uint8_t queues[], uint16_t nb_unlinks)
+{
 	unsigned int i, j;
 
 	int unlinked = 0;
@@ -120,53 +152,66 @@ sw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
 	return unlinked;
 }
 
+static int
+sw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
+		uint16_t nb_unlinks)
+{
+	struct sw_port *p = port;
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	int i;
+
+	for (i = 1; i < sw->nb_shards; i++)
+		sw_shard_port_unlink(sw->shards[i],
+				&sw->shards[i]->ports[p->id], queues,
+				nb_unlinks);
+
+	return sw_shard_port_unlink(sw, p, queues, nb_unlinks);
+}
+
 static int
 sw_port_unlinks_in_progress(struct rte_eventdev *dev, void *port)
 {
-	RTE_SET_USED(dev);
+	struct sw_evdev *sw = sw_pmd_priv(dev);
 	struct sw_port *p = port;
-	return p->unlinks_in_progress;
+	int i, unlinks = 0;
+
+	/* each shard acks the unlinks of its own copy of the port */
+	for (i = 0; i < sw->nb_shards; i++)
+		unlinks += sw->shards[i]->ports[p->id].unlinks_in_progress;
+
+	return unlinks;
 }
 
 static int
-sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
+sw_shard_port_setup(struct sw_evdev *sw, uint8_t port_id,
 		const struct rte_event_port_conf *conf)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	struct sw_port *p = &sw->ports[port_id];
+	char name[RTE_RING_NAMESIZE / 2];
 	char buf[RTE_RING_NAMESIZE];
 	unsigned int i;
-
-	struct rte_event_dev_info info;
-	sw_info_get(dev, &info);
-
-	/* detect re-configuring and return credits to instance if needed */
-	if (p->initialized) {
-		/* taking credits from pool is done one quanta at a time, and
-		 * credits may be spend (counted in p->inflights) or still
-		 * available in the port (p->inflight_credits). We must return
-		 * the sum to no leak credits
-		 */
-		int possible_inflights = p->inflight_credits + p->inflights;
-		rte_atomic32_sub(&sw->inflights, possible_inflights);
-	}
+	int n;
 
 	*p = (struct sw_port){0}; /* zero entire structure */
 	p->id = port_id;
 	p->sw = sw;
+	if (sw_shard_name(sw, name, sizeof(name)) < 0)
+		goto name_too_long;
 
 	/* check to see if rings exists - port_setup() can be called multiple
 	 * times legally (assuming device is stopped). If ring exists, free it
 	 * to so it gets re-created with the correct size
 	 */
-	snprintf(buf, sizeof(buf), "sw%d_p%u_%s", dev->data->dev_id,
-			port_id, "rx_worker_ring");
+	n = snprintf(buf, sizeof(buf), "%s_p%u_%s", name, port_id,
+			"rx_worker_ring");
+	if (n < 0 || n >= (int)sizeof(buf))
+		goto name_too_long;
 	struct rte_event_ring *existing_ring = rte_event_ring_lookup(buf);
 	if (existing_ring)
 		rte_event_ring_free(existing_ring);
 
 	p->rx_worker_ring = rte_event_ring_create(buf, MAX_SW_PROD_Q_DEPTH,
-			dev->data->socket_id,
+			sw->data->socket_id,
 			RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
 	if (p->rx_worker_ring == NULL) {
 		SW_LOG_ERR("Error creating RX worker ring for port %d\n",
@@ -174,18 +219,19 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 		return -1;
 	}
 
-	p->inflight_max = conf->new_event_threshold;
-	p->implicit_release = !conf->disable_implicit_release;
-
 	/* check if ring exists, same as rx_worker above */
-	snprintf(buf, sizeof(buf), "sw%d_p%u, %s", dev->data->dev_id,
-			port_id, "cq_worker_ring");
+	n = snprintf(buf, sizeof(buf), "%s_p%u, %s", name, port_id,
+			"cq_worker_ring");
+	if (n < 0 || n >= (int)sizeof(buf)) {
+		rte_event_ring_free(p->rx_worker_ring);
+		goto name_too_long;
+	}
 	existing_ring = rte_event_ring_lookup(buf);
 	if (existing_ring)
 		rte_event_ring_free(existing_ring);
 
 	p->cq_worker_ring = rte_event_ring_create(buf, conf->dequeue_depth,
-			dev->data->socket_id,
+			sw->data->socket_id,
 			RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
 	if (p->cq_worker_ring == NULL) {
 		rte_event_ring_free(p->rx_worker_ring);
@@ -200,10 +246,51 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 		p->hist_list[i].fid = -1;
 		p->hist_list[i].qid = -1;
 	}
+
+	return 0;
+
+name_too_long:
+	SW_LOG_ERR("Ring name too long for port %d\n", port_id);
+	return -1;
+}
+
+static int
+sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
+		const struct rte_event_port_conf *conf)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	struct sw_port *p = &sw->ports[port_id];
+	int i;
+
+	struct rte_event_dev_info info;
+	sw_info_get(dev, &info);
+
+	/* detect re-configuring and return credits to instance if needed */
+	if (p->initialized) {
+		/* taking credits from pool is done one quanta at a time, and
+		 * credits may be spend (counted in p->inflights of each shard)
+		 * or still available in the port (p->inflight_credits). We
+		 * must return the sum to no leak credits
+		 */
+		int possible_inflights = p->inflight_credits;
+
+		for (i = 0; i < sw->nb_shards; i++)
+			possible_inflights +=
+				sw->shards[i]->ports[port_id].inflights;
+		rte_atomic32_sub(&sw->inflights, possible_inflights);
+	}
+
+	for (i = 0; i < sw->nb_shards; i++)
+		if (sw_shard_port_setup(sw->shards[i], port_id, conf) < 0)
+			return -1;
+
+	p->inflight_max = conf->new_event_threshold;
+	p->implicit_release = !conf->disable_implicit_release;
 	dev->data->ports[port_id] = p;
 
 	rte_smp_wmb();
-	p->initialized = 1;
+	for (i = 0; i < sw->nb_shards; i++)
+		sw->shards[i]->ports[port_id].initialized = 1;
 	return 0;
 }
 
@@ -211,12 +298,21 @@ static void
 sw_port_release(void *port)
 {
 	struct sw_port *p = (void *)port;
-	if (p == NULL)
+	struct sw_evdev *sw;
+	int i;
+
+	if (p == NULL || p->sw == NULL)
 		return;
 
-	rte_event_ring_free(p->rx_worker_ring);
-	rte_event_ring_free(p->cq_worker_ring);
-	memset(p, 0, sizeof(*p));
+	/* shard 0 last, as it holds the pointers to the other shards */
+	sw = p->sw;
+	for (i = sw->nb_shards - 1; i >= 0; i--) {
+		struct sw_port *sp = &sw->shards[i]->ports[p->id];
+
+		rte_event_ring_free(sp->rx_worker_ring);
+		rte_event_ring_free(sp->cq_worker_ring);
+		memset(sp, 0, sizeof(*sp));
+	}
 }
 
 static int32_t
@@ -226,9 +322,15 @@ qid_init(struct sw_evdev *sw, unsigned int idx, int type,
 	unsigned int i;
 	int dev_id = sw->data->dev_id;
 	int socket_id = sw->data->socket_id;
+	char name[RTE_RING_NAMESIZE / 2];
 	char buf[IQ_ROB_NAMESIZE];
 	struct sw_qid *qid = &sw->qids[idx];
 
+	if (sw_shard_name(sw, name, sizeof(name)) < 0) {
+		SW_LOG_DBG("ring name too long for queue %u\n", idx);
+		return -EINVAL;
+	}
+
 	/* Initialize the FID structures to no pinning (-1), and zero packets */
 	const struct sw_fid_t fid = {.cq = -1, .pcount = 0};
 	for (i = 0; i < RTE_DIM(qid->fids); i++)
@@ -270,8 +372,11 @@ qid_init(struct sw_evdev *sw, unsigned int idx, int type,
 		       0,
 		       window_size * sizeof(qid->reorder_buffer[0]));
 
-		snprintf(ring_name, sizeof(ring_name), "sw%d_q%d_freelist",
-				dev_id, idx);
+		if (snprintf(ring_name, sizeof(ring_name), "%s_q%d_freelist",
+				name, idx) >= (int)sizeof(ring_name)) {
+			SW_LOG_DBG("freelist ring name too long\n");
+			goto cleanup;
+		}
 
 		/* lookup the ring, and if it already exists, free it */
 		struct rte_ring *cleanup = rte_ring_lookup(ring_name);
@@ -320,9 +425,8 @@ qid_init(struct sw_evdev *sw, unsigned int idx, int type,
 }
 
 static void
-sw_queue_release(struct rte_eventdev *dev, uint8_t id)
+qid_release(struct sw_evdev *sw, uint8_t id)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	struct sw_qid *qid = &sw->qids[id];
 
 	if (qid->type == RTE_SCHED_TYPE_ORDERED) {
@@ -332,6 +436,16 @@ sw_queue_release(struct rte_eventdev *dev, uint8_t id)
 	memset(qid, 0, sizeof(*qid));
 }
 
+static void
+sw_queue_release(struct rte_eventdev *dev, uint8_t id)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	int i;
+
+	for (i = 0; i < sw->nb_shards; i++)
+		qid_release(sw->shards[i], id);
+}
+
 static int
 sw_queue_setup(struct rte_eventdev *dev, uint8_t queue_id,
 		const struct rte_event_queue_conf *conf)
@@ -349,11 +463,18 @@ sw_queue_setup(struct rte_eventdev *dev, uint8_t queue_id,
 	}
 
 	struct sw_evdev *sw = sw_pmd_priv(dev);
+	int i, ret;
 
 	if (sw->qids[queue_id].initialized)
 		sw_queue_release(dev, queue_id);
 
-	return qid_init(sw, queue_id, type, conf);
+	for (i = 0; i < sw->nb_shards; i++) {
+		ret = qid_init(sw->shards[i], queue_id, type, conf);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
 }
 
 static void
@@ -385,6 +506,10 @@ sw_qids_empty(struct sw_evdev *sw)
 		}
 	}
 
+	/* events handed over from another shard are bound for the qids */
+	if (sw->handoff_ring && rte_event_ring_count(sw->handoff_ring))
+		return 0;
+
 	return 1;
 }
 
@@ -402,6 +527,19 @@ sw_ports_empty(struct sw_evdev *sw)
 	return 1;
 }
 
+static int
+sw_shards_empty(struct sw_evdev *sw)
+{
+	int i;
+
+	for (i = 0; i < sw->nb_shards; i++)
+		if (!(sw_qids_empty(sw->shards[i]) &&
+				sw_ports_empty(sw->shards[i])))
+			return 0;
+
+	return 1;
+}
+
 static void
 sw_drain_ports(struct rte_eventdev *dev)
 {
@@ -429,9 +567,9 @@ sw_drain_ports(struct rte_eventdev *dev)
 }
 
 static void
-sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
+sw_drain_queue(struct rte_eventdev *dev, struct sw_evdev *sw,
+		struct sw_iq *iq)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	eventdev_stop_flush_t flush;
 	uint8_t dev_id;
 	void *arg;
@@ -455,17 +593,22 @@ sw_drain_queues(struct rte_eventdev *dev)
 {
 	struct sw_evdev *sw = sw_pmd_priv(dev);
 	unsigned int i, j;
+	int s;
 
-	for (i = 0; i < sw->qid_count; i++) {
-		for (j = 0; j < SW_IQS_MAX; j++)
-			sw_drain_queue(dev, &sw->qids[i].iq[j]);
+	for (s = 0; s < sw->nb_shards; s++) {
+		struct sw_evdev *shard = sw->shards[s];
+
+		for (i = 0; i < shard->qid_count; i++) {
+			for (j = 0; j < SW_IQS_MAX; j++)
+				sw_drain_queue(dev, shard,
+						&shard->qids[i].iq[j]);
+		}
 	}
 }
 
 static void
-sw_clean_qid_iqs(struct rte_eventdev *dev)
+sw_clean_qid_iqs(struct sw_evdev *sw)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	int i, j;
 
 	/* Release the IQ memory of all configured qids */
@@ -512,11 +655,8 @@ sw_port_def_conf(struct rte_eventdev *dev, uint8_t port_id,
 }
 
 static int
-sw_dev_configure(const struct rte_eventdev *dev)
+sw_shard_configure(struct sw_evdev *sw, const struct rte_event_dev_config *conf)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
-	const struct rte_eventdev_data *data = dev->data;
-	const struct rte_event_dev_config *conf = &data->dev_conf;
 	int num_chunks, i;
 
 	sw->qid_count = conf->nb_event_queues;
@@ -547,6 +687,42 @@ sw_dev_configure(const struct rte_eventdev *dev)
 	for (i = 0; i < num_chunks; i++)
 		iq_free_chunk(sw, &sw->chunks[i]);
 
+	if (sw->nb_shards > 1) {
+		char name[RTE_RING_NAMESIZE / 2];
+		char buf[RTE_RING_NAMESIZE];
+
+		/* any shard hands over, only the owner dequeues. Every event
+		 * of the instance fits, so handing over never fails.
+		 */
+		if (sw_shard_name(sw, name, sizeof(name)) < 0 ||
+				snprintf(buf, sizeof(buf), "%s_handoff", name) >=
+				(int)sizeof(buf))
+			return -ENAMETOOLONG;
+		rte_event_ring_free(rte_event_ring_lookup(buf));
+		sw->handoff_ring = rte_event_ring_create(buf,
+				sw->nb_events_limit, sw->data->socket_id,
+				RING_F_SC_DEQ | RING_F_EXACT_SZ);
+		if (sw->handoff_ring == NULL)
+			return -ENOMEM;
+	}
+
+	return 0;
+}
+
+static int
+sw_dev_configure(const struct rte_eventdev *dev)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	const struct rte_eventdev_data *data = dev->data;
+	const struct rte_event_dev_config *conf = &data->dev_conf;
+	int i, ret;
+
+	for (i = 0; i < sw->nb_shards; i++) {
+		ret = sw_shard_configure(sw->shards[i], conf);
+		if (ret < 0)
+			return ret;
+	}
+
 	if (conf->event_dev_cfg & RTE_EVENT_DEV_CFG_PER_DEQUEUE_TIMEOUT)
 		return -ENOTSUP;
 
@@ -643,6 +819,19 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 	uint32_t credits = sw->nb_events_limit - inflights;
 	fprintf(f, "\tinflight %d, credits: %d\n", inflights, credits);
 
+	if (sw->nb_shards > 1) {
+		fprintf(f, "\tsched shards: %d, port and queue stats of shard 0\n",
+				sw->nb_shards);
+		for (i = 0; i < sw->nb_shards; i++) {
+			const struct sw_evdev *shard = sw->shards[i];
+
+			fprintf(f, "\t  Shard %d: rx %"PRIu64"\ttx %"PRIu64
+				"\tsched calls %"PRIu64"\thandoffs %"PRIu64"\n",
+				i, shard->stats.rx_pkts, shard->stats.tx_pkts,
+				shard->sched_called, shard->sched_handoffs);
+		}
+	}
+
 #define COL_RED "\x1b[31m"
 #define COL_RESET "\x1b[0m"
 
@@ -775,6 +964,7 @@ sw_start(struct rte_eventdev *dev)
 {
 	unsigned int i, j;
 	struct sw_evdev *sw = sw_pmd_priv(dev);
+	int s;
 
 	rte_service_component_runstate_set(sw->service_id, 1);
 
@@ -806,23 +996,29 @@ sw_start(struct rte_eventdev *dev)
 	 * "If two members compare as equal, their order in the sorted
 	 * array is undefined."
 	 */
-	uint32_t qidx = 0;
-	for (j = 0; j <= RTE_EVENT_DEV_PRIORITY_LOWEST; j++) {
-		for (i = 0; i < sw->qid_count; i++) {
-			if (sw->qids[i].priority == j) {
-				sw->qids_prioritized[qidx] = &sw->qids[i];
-				qidx++;
+	for (s = 0; s < sw->nb_shards; s++) {
+		struct sw_evdev *shard = sw->shards[s];
+		uint32_t qidx = 0;
+
+		for (j = 0; j <= RTE_EVENT_DEV_PRIORITY_LOWEST; j++) {
+			for (i = 0; i < shard->qid_count; i++) {
+				if (shard->qids[i].priority == j) {
+					shard->qids_prioritized[qidx] =
+						&shard->qids[i];
+					qidx++;
+				}
 			}
 		}
-	}
 
-	sw_init_qid_iqs(sw);
+		sw_init_qid_iqs(shard);
+	}
 
 	if (sw_xstats_init(sw) < 0)
 		return -EINVAL;
 
 	rte_smp_wmb();
-	sw->started = 1;
+	for (s = 0; s < sw->nb_shards; s++)
+		sw->shards[s]->started = 1;
 
 	return 0;
 }
@@ -832,6 +1028,7 @@ sw_stop(struct rte_eventdev *dev)
 {
 	struct sw_evdev *sw = sw_pmd_priv(dev);
 	int32_t runstate;
+	int i;
 
 	/* Stop the scheduler if it's running */
 	runstate = rte_service_runstate_get(sw->service_id);
@@ -842,15 +1039,18 @@ sw_stop(struct rte_eventdev *dev)
 		rte_pause();
 
 	/* Flush all events out of the device */
-	while (!(sw_qids_empty(sw) && sw_ports_empty(sw))) {
-		sw_event_schedule(dev);
+	while (!sw_shards_empty(sw)) {
+		for (i = 0; i < sw->nb_shards; i++)
+			sw_event_schedule(sw->shards[i]);
 		sw_drain_ports(dev);
 		sw_drain_queues(dev);
 	}
 
-	sw_clean_qid_iqs(dev);
+	for (i = 0; i < sw->nb_shards; i++) {
+		sw_clean_qid_iqs(sw->shards[i]);
+		sw->shards[i]->started = 0;
+	}
 	sw_xstats_uninit(sw);
-	sw->started = 0;
 	rte_smp_wmb();
 
 	if (runstate == 1)
@@ -862,20 +1062,30 @@ sw_close(struct rte_eventdev *dev)
 {
 	struct sw_evdev *sw = sw_pmd_priv(dev);
 	uint32_t i;
+	int s;
 
 	for (i = 0; i < sw->qid_count; i++)
 		sw_queue_release(dev, i);
-	sw->qid_count = 0;
 
 	for (i = 0; i < sw->port_count; i++)
 		sw_port_release(&sw->ports[i]);
-	sw->port_count = 0;
 
-	memset(&sw->stats, 0, sizeof(sw->stats));
-	sw->sched_called = 0;
-	sw->sched_no_iq_enqueues = 0;
-	sw->sched_no_cq_enqueues = 0;
-	sw->sched_cq_qid_called = 0;
+	for (s = 0; s < sw->nb_shards; s++) {
+		struct sw_evdev *shard = sw->shards[s];
+
+		shard->qid_count = 0;
+		shard->port_count = 0;
+
+		memset(&shard->stats, 0, sizeof(shard->stats));
+		shard->sched_called = 0;
+		shard->sched_no_iq_enqueues = 0;
+		shard->sched_no_cq_enqueues = 0;
+		shard->sched_cq_qid_called = 0;
+		shard->sched_handoffs = 0;
+
+		rte_event_ring_free(shard->handoff_ring);
+		shard->handoff_ring = NULL;
+	}
 
 	return 0;
 }
@@ -910,11 +1120,44 @@ set_credit_quanta(const char *key __rte_unused, const char *value, void *opaque)
 	return 0;
 }
 
+static int
+set_sched_shards(const char *key __rte_unused, const char *value, void *opaque)
+{
+	int *shards = opaque;
+	*shards = atoi(value);
+	if (*shards < 1 || *shards > SW_SHARDS_MAX)
+		return -1;
+	return 0;
+}
+
 
 static int32_t sw_sched_service_func(void *args)
 {
 	struct rte_eventdev *dev = args;
-	sw_event_schedule(dev);
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	uint32_t start;
+	int i;
+
+	if (sw->nb_shards == 1) {
+		sw_event_schedule(sw);
+		return 0;
+	}
+
+	/* The service is MT safe with shards: each service lcore schedules
+	 * the first shard it can lock, starting from a rotating index so
+	 * that a single lcore still serves every shard.
+	 */
+	start = __atomic_fetch_add(&sw->next_shard, 1, __ATOMIC_RELAXED);
+	for (i = 0; i < sw->nb_shards; i++) {
+		struct sw_evdev *shard =
+			sw->shards[(start + i) % sw->nb_shards];
+
+		if (rte_spinlock_trylock(&shard->lock)) {
+			sw_event_schedule(shard);
+			rte_spinlock_unlock(&shard->lock);
+			break;
+		}
+	}
 	return 0;
 }
 
@@ -957,6 +1200,7 @@ sw_probe(struct rte_vdev_device *vdev)
 		NUMA_NODE_ARG,
 		SCHED_QUANTA_ARG,
 		CREDIT_QUANTA_ARG,
+		SCHED_SHARDS_ARG,
 		NULL
 	};
 	const char *name;
@@ -966,6 +1210,8 @@ sw_probe(struct rte_vdev_device *vdev)
 	int socket_id = rte_socket_id();
 	int sched_quanta  = SW_DEFAULT_SCHED_QUANTA;
 	int credit_quanta = SW_DEFAULT_CREDIT_QUANTA;
+	int sched_shards = 1;
+	int i;
 
 	name = rte_vdev_device_name(vdev);
 	params = rte_vdev_device_args(vdev);
@@ -1007,13 +1253,24 @@ sw_probe(struct rte_vdev_device *vdev)
 				return ret;
 			}
 
+			ret = rte_kvargs_process(kvlist, SCHED_SHARDS_ARG,
+					set_sched_shards, &sched_shards);
+			if (ret != 0) {
+				SW_LOG_ERR(
+					"%s: Error parsing sched shards parameter",
+					name);
+				rte_kvargs_free(kvlist);
+				return ret;
+			}
+
 			rte_kvargs_free(kvlist);
 		}
 	}
 
 	SW_LOG_INFO(
-			"Creating eventdev sw device %s, numa_node=%d, sched_quanta=%d, credit_quanta=%d\n",
-			name, socket_id, sched_quanta, credit_quanta);
+			"Creating eventdev sw device %s, numa_node=%d, sched_quanta=%d, credit_quanta=%d, sched_shards=%d\n",
+			name, socket_id, sched_quanta, credit_quanta,
+			sched_shards);
 
 	dev = rte_event_pmd_vdev_init(name,
 			sizeof(struct sw_evdev), socket_id);
@@ -1028,6 +1285,14 @@ sw_probe(struct rte_vdev_device *vdev)
 	dev->enqueue_forward_burst = sw_event_enqueue_burst;
 	dev->dequeue = sw_event_dequeue;
 	dev->dequeue_burst = sw_event_dequeue_burst;
+	if (sched_shards > 1) {
+		dev->enqueue = sw_event_enqueue_dist;
+		dev->enqueue_burst = sw_event_enqueue_burst_dist;
+		dev->enqueue_new_burst = sw_event_enqueue_burst_dist;
+		dev->enqueue_forward_burst = sw_event_enqueue_burst_dist;
+		dev->dequeue = sw_event_dequeue_dist;
+		dev->dequeue_burst = sw_event_dequeue_burst_dist;
+	}
 
 	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
 		return 0;
@@ -1039,6 +1304,33 @@ sw_probe(struct rte_vdev_device *vdev)
 	sw->credit_update_quanta = credit_quanta;
 	sw->sched_quanta = sched_quanta;
 
+	/* shard 0 is the instance itself, the others are full copies of the
+	 * scheduler state
+	 */
+	sw->shards[0] = sw;
+	for (i = 1; i < sched_shards; i++) {
+		sw->shards[i] = rte_zmalloc_socket(NULL, sizeof(*sw),
+				RTE_CACHE_LINE_SIZE, socket_id);
+		if (sw->shards[i] == NULL) {
+			SW_LOG_ERR("%s: Error allocating sched shard %d",
+					name, i);
+			while (--i > 0)
+				rte_free(sw->shards[i]);
+			return -ENOMEM;
+		}
+	}
+	for (i = 0; i < sched_shards; i++) {
+		struct sw_evdev *shard = sw->shards[i];
+
+		memcpy(shard->shards, sw->shards, sizeof(sw->shards));
+		shard->nb_shards = sched_shards;
+		shard->shard_id = i;
+		shard->data = dev->data;
+		shard->credit_update_quanta = credit_quanta;
+		shard->sched_quanta = sched_quanta;
+		rte_spinlock_init(&shard->lock);
+	}
+
 	/* register service with EAL */
 	struct rte_service_spec service;
 	memset(&service, 0, sizeof(struct rte_service_spec));
@@ -1048,6 +1340,8 @@ sw_probe(struct rte_vdev_device *vdev)
 	service.socket_id = socket_id;
 	service.callback = sw_sched_service_func;
 	service.callback_userdata = (void *)dev;
+	if (sched_shards > 1)
+		service.capabilities = RTE_SERVICE_CAP_MT_SAFE;
 
 	int32_t ret = rte_service_component_register(&service, &sw->service_id);
 	if (ret) {
@@ -1064,7 +1358,9 @@ sw_probe(struct rte_vdev_device *vdev)
 static int
 sw_remove(struct rte_vdev_device *vdev)
 {
+	struct rte_eventdev *dev;
 	const char *name;
+	int i;
 
 	name = rte_vdev_device_name(vdev);
 	if (name == NULL)
@@ -1072,6 +1368,14 @@ sw_remove(struct rte_vdev_device *vdev)
 
 	SW_LOG_INFO("Closing eventdev sw device %s\n", name);
 
+	dev = rte_event_pmd_get_named_dev(name);
+	if (dev != NULL && rte_eal_process_type() == RTE_PROC_PRIMARY) {
+		struct sw_evdev *sw = sw_pmd_priv(dev);
+
+		for (i = 1; i < sw->nb_shards; i++)
+			rte_free(sw->shards[i]);
+	}
+
 	return rte_event_pmd_vdev_uninit(name);
 }
 
@@ -1082,5 +1386,6 @@ static struct rte_vdev_driver evdev_sw_pmd_drv = {
 
 RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_SW_PMD, evdev_sw_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(event_sw, NUMA_NODE_ARG "=<int> "
-		SCHED_QUANTA_ARG "=<int>" CREDIT_QUANTA_ARG "=<int>");
+		SCHED_QUANTA_ARG "=<int>" CREDIT_QUANTA_ARG "=<int>"
+		SCHED_SHARDS_ARG "=<int>");
 RTE_LOG_REGISTER(eventdev_sw_log_level, pmd.event.sw, NOTICE);
@@ -9,6 +9,7 @@
 #include <rte_eventdev.h>
 #include <rte_eventdev_pmd_vdev.h>
 #include <rte_atomic.h>
+#include <rte_spinlock.h>
 
 #define SW_DEFAULT_CREDIT_QUANTA 32
 #define SW_DEFAULT_SCHED_QUANTA 128
@@ -21,6 +22,10 @@
 /* allow for lots of over-provisioning */
 #define MAX_SW_PROD_Q_DEPTH 4096
 #define SW_FRAGMENTS_MAX 16
+/* max scheduling shards in distributed mode, each holds a copy of the
+ * scheduler state so keep this small
+ */
+#define SW_SHARDS_MAX 8
 
 /* Should be power-of-two minus one, to leave room for the next pointer */
 #define SW_EVS_PER_Q_CHUNK 255
@@ -42,6 +47,10 @@
 
 #define SW_NUM_POLL_BUCKETS (MAX_SW_CONS_Q_DEPTH >> SW_DEQ_STAT_BUCKET_SHIFT)
 
+#define FLOWID_MASK (SW_QID_NUM_FIDS-1)
+/* use cheap bit mixing, we only need to lose a few bits */
+#define SW_HASH_FLOWID(f) (((f) ^ (f >> 10)) & FLOWID_MASK)
+
 enum {
 	QE_FLAG_VALID_SHIFT = 0,
 	QE_FLAG_COMPLETE_SHIFT,
@@ -175,6 +184,9 @@ struct sw_port {
 	uint16_t inflight_max; /* app requested max inflights for this port */
 	uint16_t inflight_credits; /* num credits this port has right now */
 	uint8_t implicit_release; /* release events before dequeueing */
+	uint8_t next_shard; /* shard polled first on the next dequeue */
+	/* num releases yet to be completed per shard, in distributed mode */
+	uint16_t shard_releases[SW_SHARDS_MAX];
 
 	uint16_t last_dequeue_burst_sz; /* how big the burst was */
 	uint64_t last_dequeue_ticks; /* used to track burst processing time */
@@ -256,6 +268,19 @@ struct sw_evdev {
 
 	uint32_t service_id;
 	char service_name[SW_PMD_NAME_MAX];
+
+	/* Distributed scheduling: each shard is a copy of the scheduler state
+	 * owning the atomic and ordered flows that hash to it. shards[0] is
+	 * the instance itself, which also holds the worker side of the ports.
+	 */
+	struct sw_evdev *shards[SW_SHARDS_MAX];
+	uint8_t nb_shards;
+	uint8_t shard_id;
+	uint32_t next_shard; /* shard the next service call tries first */
+	rte_spinlock_t lock; /* taken by the service lcore running a shard */
+	/* events for flows owned by this shard, from the other shards */
+	struct rte_event_ring *handoff_ring;
+	uint64_t sched_handoffs;
 };
 
 static inline struct sw_evdev *
@@ -270,6 +295,15 @@ sw_pmd_priv_const(const struct rte_eventdev *eventdev)
 	return eventdev->data->dev_private;
 }
 
+/* Shard scheduling a flow. Derived from the FID so that all flows sharing
+ * a FID, and hence a pinned CQ, are scheduled by the same shard.
+ */
+static inline uint8_t
+sw_flow_shard(const struct sw_evdev *sw, uint32_t flow_id)
+{
+	return SW_HASH_FLOWID(flow_id) % sw->nb_shards;
+}
+
 uint16_t sw_event_enqueue(void *port, const struct rte_event *ev);
 uint16_t sw_event_enqueue_burst(void *port, const struct rte_event ev[],
 		uint16_t num);
@@ -277,7 +311,14 @@ uint16_t sw_event_enqueue_burst(void *port, const struct rte_event ev[],
 uint16_t sw_event_dequeue(void *port, struct rte_event *ev, uint64_t wait);
 uint16_t sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 			uint64_t wait);
-void sw_event_schedule(struct rte_eventdev *dev);
+uint16_t sw_event_enqueue_dist(void *port, const struct rte_event *ev);
+uint16_t sw_event_enqueue_burst_dist(void *port, const struct rte_event ev[],
+		uint16_t num);
+uint16_t sw_event_dequeue_dist(void *port, struct rte_event *ev,
+		uint64_t wait);
+uint16_t sw_event_dequeue_burst_dist(void *port, struct rte_event *ev,
+		uint16_t num, uint64_t wait);
+void sw_event_schedule(struct sw_evdev *sw);
 int sw_xstats_init(struct sw_evdev *dev);
 int sw_xstats_uninit(struct sw_evdev *dev);
 int sw_xstats_get_names(const struct rte_eventdev *dev,
@@ -22,9 +22,6 @@
 #define PRIO_TO_IQ(prio) (prio >> 6)
 
 #define MAX_PER_IQ_DEQUEUE 48
-#define FLOWID_MASK (SW_QID_NUM_FIDS-1)
-/* use cheap bit mixing, we only need to lose a few bits */
-#define SW_HASH_FLOWID(f) (((f) ^ (f >> 10)) & FLOWID_MASK)
 
 static inline uint32_t
 sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
@@ -254,6 +251,55 @@ sw_schedule_qid_to_cq(struct sw_evdev *sw)
 	return pkts;
 }
 
+/* In distributed mode the atomic and ordered flows are each scheduled by a
+ * single shard. Events for a flow owned by another shard are passed to it on
+ * its handoff ring, sized to hold every event of the instance so the enqueue
+ * cannot fail.
+ */
+static __rte_always_inline int
+sw_shard_handoff(struct sw_evdev *sw, const struct sw_qid *qid,
+		const struct rte_event *qe)
+{
+	struct sw_evdev *owner;
+	unsigned int n;
+
+	if (qid->type != RTE_SCHED_TYPE_ATOMIC &&
+			qid->type != RTE_SCHED_TYPE_ORDERED)
+		return 0;
+
+	owner = sw->shards[sw_flow_shard(sw, qe->flow_id)];
+	if (owner == sw)
+		return 0;
+
+	n = rte_event_ring_enqueue_burst(owner->handoff_ring, qe, 1, NULL);
+	RTE_ASSERT(n == 1);
+	RTE_SET_USED(n);
+	sw->sched_handoffs++;
+	return 1;
+}
+
+static uint32_t
+sw_schedule_pull_handoff(struct sw_evdev *sw)
+{
+	struct rte_event qes[SCHED_DEQUEUE_BURST_SIZE];
+	uint32_t i, n;
+
+	n = rte_event_ring_dequeue_burst(sw->handoff_ring, qes, RTE_DIM(qes),
+			NULL);
+	for (i = 0; i < n; i++) {
+		const struct rte_event *qe = &qes[i];
+		uint32_t iq_num = PRIO_TO_IQ(qe->priority);
+		struct sw_qid *qid = &sw->qids[qe->queue_id];
+
+		qid->iq_pkt_mask |= (1 << (iq_num));
+		iq_enqueue(sw, &qid->iq[iq_num], qe);
+		qid->iq_pkt_count[iq_num]++;
+		qid->stats.rx_pkts++;
+	}
+
+	return n;
+}
+
 /* This function will perform re-ordering of packets, and injecting into
  * the appropriate QID IQ. As LB and DIR QIDs are in the same array, but *NOT*
  * contiguous in that array, this function accepts a "range" of QIDs to scan.
@@ -299,11 +345,15 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 					continue;
 				}
 
-				pkts_iter++;
-
 				struct sw_qid *q = &sw->qids[dest_qid];
 				struct sw_iq *iq = &q->iq[dest_iq];
 
+				if (unlikely(sw->nb_shards > 1) &&
+						sw_shard_handoff(sw, q, qe))
+					continue;
+
+				pkts_iter++;
+
 				/* we checked for space above, so enqueue must
 				 * succeed
 				 */
@@ -430,6 +480,10 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 				goto end_qe;
 			}
 
+			if (unlikely(sw->nb_shards > 1) &&
+					sw_shard_handoff(sw, qid, qe))
+				goto end_qe;
+
 			/* Use the iq_num from above to push the QE
 			 * into the qid at the right priority
 			 */
@@ -484,6 +538,10 @@ sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
 
 		port->stats.rx_pkts++;
 
+		if (unlikely(sw->nb_shards > 1) &&
+				sw_shard_handoff(sw, qid, qe))
+			goto end_qe;
+
 		/* Use the iq_num from above to push the QE
 		 * into the qid at the right priority
 		 */
@@ -502,9 +560,8 @@ sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
 }
 
 void
-sw_event_schedule(struct rte_eventdev *dev)
+sw_event_schedule(struct sw_evdev *sw)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	uint32_t in_pkts, out_pkts;
 	uint32_t out_pkts_total = 0, in_pkts_total = 0;
 	int32_t sched_quanta = sw->sched_quanta;
@@ -533,6 +590,10 @@ sw_event_schedule(struct rte_eventdev *dev)
 					in_pkts += sw_schedule_pull_port_no_reorder(sw, i);
 			}
 
+			/* events handed over by the other shards */
+			if (sw->handoff_ring != NULL)
+				in_pkts += sw_schedule_pull_handoff(sw);
+
 			/* QID scan for re-ordered */
 			in_pkts += sw_schedule_reorder(sw, 0,
 					sw->qid_count);
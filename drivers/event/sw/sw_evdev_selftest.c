@@ -2951,6 +2951,178 @@ dev_stop_flush(struct test *t) /* test to check we can properly flush events */
 	return -1;
 }
 
+#define SHARD_TEST_FLOWS 16
+#define SHARD_TEST_PKTS (SHARD_TEST_FLOWS * 4)
+
+/* check a burst holds each flow on a single port and in sequence order */
+static int
+shard_check_flows(const struct rte_event ev[], const uint8_t port[], int num)
+{
+	int flow_port[SHARD_TEST_FLOWS + 1];
+	uint64_t flow_seq[SHARD_TEST_FLOWS + 1];
+	int i;
+
+	for (i = 0; i <= SHARD_TEST_FLOWS; i++) {
+		flow_port[i] = -1;
+		flow_seq[i] = 0;
+	}
+
+	for (i = 0; i < num; i++) {
+		uint32_t flow = ev[i].flow_id;
+
+		if (flow_port[flow] != -1 && flow_port[flow] != port[i]) {
+			printf("%d: flow %u on ports %d and %u\n", __LINE__,
+					flow, flow_port[flow], port[i]);
+			return -1;
+		}
+		if (ev[i].u64 < flow_seq[flow]) {
+			printf("%d: flow %u out of order\n", __LINE__, flow);
+			return -1;
+		}
+		flow_port[flow] = port[i];
+		flow_seq[flow] = ev[i].u64;
+	}
+
+	return 0;
+}
+
+static int
+sched_shards(struct test *t)
+{
+	static const char *shard_dev_name = "event_sw_shard_test";
+	struct rte_event ev[SHARD_TEST_PKTS];
+	uint8_t ev_port[SHARD_TEST_PKTS];
+	const uint32_t saved_service_id = t->service_id;
+	const int saved_evdev = evdev;
+	uint32_t service_id;
+	int nb_ev = 0;
+	int i, ret = -1;
+
+	/* Two shards, stage 0 flows n are scheduled by shard n % 2 and are
+	 * forwarded to stage 1 as flow n + 1, which the other shard owns.
+	 */
+	if (rte_vdev_init(shard_dev_name, "sched_shards=2") < 0) {
+		printf("%d: Error creating sharded eventdev\n", __LINE__);
+		return -1;
+	}
+	evdev = rte_event_dev_get_dev_id(shard_dev_name);
+	if (evdev < 0 ||
+			rte_event_dev_service_id_get(evdev, &service_id) < 0) {
+		printf("%d: Error finding sharded eventdev\n", __LINE__);
+		goto out;
+	}
+	rte_service_runstate_set(service_id, 1);
+	rte_service_set_runstate_mapped_check(service_id, 0);
+
+	if (init(t, 2, 4) < 0 ||
+			create_ports(t, 4) < 0 ||
+			create_atomic_qids(t, 2) < 0) {
+		printf("%d: Error initializing device\n", __LINE__);
+		goto out;
+	}
+	t->service_id = service_id;
+
+	if (rte_event_port_link(evdev, t->port[1], &t->qid[0], NULL, 1) != 1 ||
+			rte_event_port_link(evdev, t->port[2], &t->qid[0],
+				NULL, 1) != 1 ||
+			rte_event_port_link(evdev, t->port[3], &t->qid[1],
+				NULL, 1) != 1) {
+		printf("%d: Error linking queues\n", __LINE__);
+		goto err;
+	}
+
+	if (rte_event_dev_start(evdev) < 0) {
+		printf("%d: Error with start call\n", __LINE__);
+		goto err;
+	}
+
+	for (i = 0; i < SHARD_TEST_PKTS; i++) {
+		const struct rte_event new_ev = {
+			.op = RTE_EVENT_OP_NEW,
+			.queue_id = t->qid[0],
+			.flow_id = i % SHARD_TEST_FLOWS,
+			.u64 = i,
+		};
+
+		if (rte_event_enqueue_burst(evdev, t->port[0], &new_ev,
+				1) != 1) {
+			printf("%d: Error enqueuing events\n", __LINE__);
+			goto err;
+		}
+	}
+
+	/* each service call schedules one shard */
+	for (i = 0; i < 4; i++)
+		rte_service_run_iter_on_app_lcore(t->service_id, 1);
+
+	for (i = 1; i <= 2; i++) {
+		int n = rte_event_dequeue_burst(evdev, t->port[i],
+				&ev[nb_ev], SHARD_TEST_PKTS - nb_ev, 0);
+
+		memset(&ev_port[nb_ev], i, n);
+		nb_ev += n;
+	}
+	if (nb_ev != SHARD_TEST_PKTS) {
+		printf("%d: Stage 0 dequeued %d events\n", __LINE__, nb_ev);
+		goto err;
+	}
+	if (shard_check_flows(ev, ev_port, nb_ev) < 0)
+		goto err;
+
+	/* forward from the port each event came from to the other shard */
+	for (i = 0; i < nb_ev; i++) {
+		ev[i].op = RTE_EVENT_OP_FORWARD;
+		ev[i].queue_id = t->qid[1];
+		ev[i].flow_id++;
+		if (rte_event_enqueue_burst(evdev, ev_port[i], &ev[i],
+				1) != 1) {
+			printf("%d: Error forwarding events\n", __LINE__);
+			goto err;
+		}
+	}
+
+	for (i = 0; i < 8; i++)
+		rte_service_run_iter_on_app_lcore(t->service_id, 1);
+
+	nb_ev = rte_event_dequeue_burst(evdev, t->port[3], ev,
+			SHARD_TEST_PKTS, 0);
+	if (nb_ev != SHARD_TEST_PKTS) {
+		printf("%d: Stage 1 dequeued %d events\n", __LINE__, nb_ev);
+		goto err;
+	}
+	memset(ev_port, t->port[3], nb_ev);
+	if (shard_check_flows(ev, ev_port, nb_ev) < 0)
+		goto err;
+
+	/* the implicit release must reach the shard of each event */
+	rte_event_dequeue_burst(evdev, t->port[3], ev, 1, 0);
+	for (i = 0; i < 4; i++)
+		rte_service_run_iter_on_app_lcore(t->service_id, 1);
+
+	if (rte_event_dev_xstats_by_name_get(evdev, "dev_rx", NULL) !=
+			2 * SHARD_TEST_PKTS ||
+			rte_event_dev_xstats_by_name_get(evdev,
+				"port_1_inflight", NULL) != 0 ||
+			rte_event_dev_xstats_by_name_get(evdev,
+				"port_2_inflight", NULL) != 0 ||
+			rte_event_dev_xstats_by_name_get(evdev,
+				"port_3_inflight", NULL) != 0) {
+		printf("%d: Error in sharded device stats\n", __LINE__);
+		goto err;
+	}
+
+	ret = 0;
+err:
+	if (ret)
+		rte_event_dev_dump(evdev, stdout);
+	cleanup(t);
+out:
+	rte_vdev_uninit(shard_dev_name);
+	evdev = saved_evdev;
+	t->service_id = saved_service_id;
+	return ret;
+}
+
 static int
 worker_loopback_worker_fn(void *arg)
 {
@@ -3367,6 +3539,12 @@ test_sw_eventdev(void)
 		printf("ERROR - Stop Flush test FAILED.\n");
 		goto test_fail;
 	}
+	printf("*** Running Sched Shards test...\n");
+	ret = sched_shards(t);
+	if (ret != 0) {
+		printf("ERROR - Sched Shards test FAILED.\n");
+		goto test_fail;
+	}
 	if (rte_lcore_count() >= 3) {
 		printf("*** Running Worker loopback test...\n");
 		ret = worker_loopback(t, 0);
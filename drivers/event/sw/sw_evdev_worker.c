@@ -11,20 +11,19 @@
 #define PORT_ENQUEUE_MAX_BURST_SIZE 64
 
 static inline void
-sw_event_release(struct sw_port *p, uint8_t index)
+sw_event_release(struct sw_port *p, struct rte_event_ring *ring)
 {
 	/*
 	 * Drops the next outstanding event in our history. Used on dequeue
 	 * to clear any history before dequeuing more events.
 	 */
-	RTE_SET_USED(index);
 
 	/* create drop message */
 	struct rte_event ev;
 	ev.op = sw_qe_flag_map[RTE_EVENT_OP_RELEASE];
 
 	uint16_t free_count;
-	rte_event_ring_enqueue_burst(p->rx_worker_ring, &ev, 1, &free_count);
+	rte_event_ring_enqueue_burst(ring, &ev, 1, &free_count);
 
 	/* each release returns one credit */
 	p->outstanding_releases--;
@@ -152,7 +151,7 @@ sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 		uint16_t out_rels = p->outstanding_releases;
 		uint16_t i;
 		for (i = 0; i < out_rels; i++)
-			sw_event_release(p, i);
+			sw_event_release(p, p->rx_worker_ring);
 
 		/* Replenish credits if enough releases are performed */
 		if (p->inflight_credits >= credit_update_quanta * 2) {
@@ -184,3 +183,197 @@ sw_event_dequeue(void *port, struct rte_event *ev, uint64_t wait)
 {
 	return sw_event_dequeue_burst(port, ev, 1, wait);
 }
+
+/*
+ * Distributed mode: NEW events go to the shard owning their flow, while
+ * forwarded and released events go back to the shard they were dequeued
+ * from, which holds their history. The shard is carried in impl_opaque.
+ */
+uint16_t
+sw_event_enqueue_burst_dist(void *port, const struct rte_event ev[],
+		uint16_t num)
+{
+	int32_t i;
+	struct rte_event shard_evs[SW_SHARDS_MAX][PORT_ENQUEUE_MAX_BURST_SIZE];
+	uint16_t shard_cnt[SW_SHARDS_MAX] = {0};
+	uint32_t shard_free[SW_SHARDS_MAX];
+	uint8_t shard[PORT_ENQUEUE_MAX_BURST_SIZE];
+	struct sw_port *p = port;
+	struct sw_evdev *sw = (void *)p->sw;
+	const uint8_t nb_shards = sw->nb_shards;
+	uint32_t sw_inflights = rte_atomic32_read(&sw->inflights);
+	uint32_t credit_update_quanta = sw->credit_update_quanta;
+	uint32_t enq = 0;
+	int new = 0;
+
+	if (num > PORT_ENQUEUE_MAX_BURST_SIZE)
+		num = PORT_ENQUEUE_MAX_BURST_SIZE;
+
+	for (i = 0; i < nb_shards; i++)
+		shard_free[i] = rte_event_ring_free_count(
+				sw->shards[i]->ports[p->id].rx_worker_ring);
+
+	/* only take the events that fit in their shard's ring, the worker is
+	 * the single producer so the space cannot shrink before the enqueue
+	 */
+	for (i = 0; i < num; i++) {
+		uint8_t s = ev[i].impl_opaque;
+
+		if (ev[i].op == RTE_EVENT_OP_NEW || s >= nb_shards)
+			s = sw_flow_shard(sw, ev[i].flow_id);
+		if (shard_cnt[s] == shard_free[s])
+			break;
+		shard_cnt[s]++;
+		shard[i] = s;
+		new += (ev[i].op == RTE_EVENT_OP_NEW);
+	}
+	num = i;
+
+	if (unlikely(new > 0 && p->inflight_max < sw_inflights))
+		return 0;
+
+	if (p->inflight_credits < new) {
+		/* check if event enqueue brings port over max threshold */
+		if (sw_inflights + credit_update_quanta > sw->nb_events_limit)
+			return 0;
+
+		rte_atomic32_add(&sw->inflights, credit_update_quanta);
+		p->inflight_credits += (credit_update_quanta);
+
+		/* If there are fewer inflight credits than new events, limit
+		 * the number of enqueued events.
+		 */
+		num = (p->inflight_credits < new) ? p->inflight_credits : new;
+	}
+
+	memset(shard_cnt, 0, sizeof(shard_cnt));
+	for (i = 0; i < num; i++) {
+		int op = ev[i].op;
+		int outstanding = p->outstanding_releases > 0;
+		const uint8_t invalid_qid = (ev[i].queue_id >= sw->qid_count);
+		const uint8_t s = shard[i];
+		struct rte_event *qe = &shard_evs[s][shard_cnt[s]++];
+
+		p->inflight_credits -= (op == RTE_EVENT_OP_NEW);
+		p->inflight_credits += (op == RTE_EVENT_OP_RELEASE) *
+					outstanding;
+
+		*qe = ev[i];
+		qe->op = sw_qe_flag_map[op];
+		qe->op &= ~(invalid_qid << QE_FLAG_VALID_SHIFT);
+
+		if ((qe->op & QE_FLAG_COMPLETE) && outstanding) {
+			p->outstanding_releases--;
+			if (p->shard_releases[s] > 0)
+				p->shard_releases[s]--;
+		}
+
+		/* error case: branch to avoid touching p->stats */
+		if (unlikely(invalid_qid && op != RTE_EVENT_OP_RELEASE)) {
+			p->stats.rx_dropped++;
+			p->inflight_credits++;
+		}
+	}
+
+	for (i = 0; i < nb_shards; i++) {
+		if (shard_cnt[i] == 0)
+			continue;
+		enq += rte_event_ring_enqueue_burst(
+				sw->shards[i]->ports[p->id].rx_worker_ring,
+				shard_evs[i], shard_cnt[i], NULL);
+	}
+
+	if (p->outstanding_releases == 0 && p->last_dequeue_burst_sz != 0) {
+		uint64_t burst_ticks = rte_get_timer_cycles() -
+				p->last_dequeue_ticks;
+		uint64_t burst_pkt_ticks =
+			burst_ticks / p->last_dequeue_burst_sz;
+		p->avg_pkt_ticks -= p->avg_pkt_ticks / NUM_SAMPLES;
+		p->avg_pkt_ticks += burst_pkt_ticks / NUM_SAMPLES;
+		p->last_dequeue_ticks = 0;
+	}
+
+	/* Replenish credits if enough releases are performed */
+	if (p->inflight_credits >= credit_update_quanta * 2) {
+		rte_atomic32_sub(&sw->inflights, credit_update_quanta);
+		p->inflight_credits -= credit_update_quanta;
+	}
+
+	return enq;
+}
+
+uint16_t
+sw_event_enqueue_dist(void *port, const struct rte_event *ev)
+{
+	return sw_event_enqueue_burst_dist(port, ev, 1);
+}
+
+uint16_t
+sw_event_dequeue_burst_dist(void *port, struct rte_event *ev, uint16_t num,
+		uint64_t wait)
+{
+	RTE_SET_USED(wait);
+	struct sw_port *p = (void *)port;
+	struct sw_evdev *sw = (void *)p->sw;
+	const uint8_t nb_shards = sw->nb_shards;
+	uint8_t s = p->next_shard;
+	uint16_t ndeq = 0;
+	uint16_t i, j;
+
+	/* release each shard's events back to it */
+	if (p->implicit_release) {
+		uint32_t credit_update_quanta = sw->credit_update_quanta;
+
+		for (i = 0; i < nb_shards; i++) {
+			struct rte_event_ring *ring =
+				sw->shards[i]->ports[p->id].rx_worker_ring;
+
+			for (j = 0; j < p->shard_releases[i] &&
+					p->outstanding_releases > 0; j++)
+				sw_event_release(p, ring);
+			p->shard_releases[i] = 0;
+		}
+
+		/* Replenish credits if enough releases are performed */
+		if (p->inflight_credits >= credit_update_quanta * 2) {
+			rte_atomic32_sub(&sw->inflights, credit_update_quanta);
+			p->inflight_credits -= credit_update_quanta;
+		}
+	}
+
+	/* rotate the first shard polled so none is starved by the others */
+	p->next_shard = (s + 1 == nb_shards) ? 0 : s + 1;
+	for (i = 0; i < nb_shards && ndeq < num; i++) {
+		struct rte_event_ring *ring =
+			sw->shards[s]->ports[p->id].cq_worker_ring;
+		uint16_t n = rte_event_ring_dequeue_burst(ring, &ev[ndeq],
+				num - ndeq, NULL);
+
+		for (j = ndeq; j < ndeq + n; j++)
+			ev[j].impl_opaque = s;
+		p->shard_releases[s] += n;
+		ndeq += n;
+		s = (s + 1 == nb_shards) ? 0 : s + 1;
+	}
+
+	if (unlikely(ndeq == 0)) {
+		p->zero_polls++;
+		p->total_polls++;
+		goto end;
+	}
+
+	p->outstanding_releases += ndeq;
+	p->last_dequeue_burst_sz = ndeq;
+	p->last_dequeue_ticks = rte_get_timer_cycles();
+	p->poll_buckets[(ndeq - 1) >> SW_DEQ_STAT_BUCKET_SHIFT]++;
+	p->total_polls++;
+
+end:
+	return ndeq;
+}
+
+uint16_t
+sw_event_dequeue_dist(void *port, struct rte_event *ev, uint64_t wait)
+{
+	return sw_event_dequeue_burst_dist(port, ev, 1, wait);
+}
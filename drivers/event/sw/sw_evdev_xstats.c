@@ -156,6 +156,23 @@ get_qid_port_stat(const struct sw_evdev *sw, uint16_t obj_idx,
 	}
 }
 
+/* The scheduler side stats are spread over the shards of a distributed
+ * instance, while the worker side of a port is only kept in shard 0. Sum
+ * over all shards to get the instance wide value of any stat.
+ */
+static uint64_t
+sw_xstats_value(const struct sw_evdev *sw, const struct sw_xstats_entry *xs)
+{
+	uint64_t val = 0;
+	int i;
+
+	for (i = 0; i < sw->nb_shards; i++)
+		val += xs->fn(sw->shards[i], xs->obj_idx, xs->stat,
+				xs->extra_arg);
+
+	return val;
+}
+
 int
 sw_xstats_init(struct sw_evdev *sw)
 {
@@ -482,8 +499,7 @@ sw_xstats_update(struct sw_evdev *sw, enum rte_event_dev_xstats_mode mode,
 				queue_port_id != xs->obj_idx)
 			continue;
 
-		uint64_t val = xs->fn(sw, xs->obj_idx, xs->stat, xs->extra_arg)
-					- xs->reset_value;
+		uint64_t val = sw_xstats_value(sw, xs) - xs->reset_value;
 
 		if (values)
 			values[xidx] = val;
@@ -524,8 +540,7 @@ sw_xstats_get_by_name(const struct rte_eventdev *dev,
 				RTE_EVENT_DEV_XSTATS_NAME_SIZE) == 0){
 			if (id != NULL)
 				*id = i;
-			return xs->fn(sw, xs->obj_idx, xs->stat, xs->extra_arg)
-					- xs->reset_value;
+			return sw_xstats_value(sw, xs) - xs->reset_value;
 		}
 	}
 	if (id != NULL)
@@ -542,7 +557,7 @@ sw_xstats_reset_range(struct sw_evdev *sw, uint32_t start, uint32_t num)
 		if (!xs->reset_allowed)
 			continue;
 
-		uint64_t val = xs->fn(sw, xs->obj_idx, xs->stat, xs->extra_arg);
+		uint64_t val = sw_xstats_value(sw, xs);
 		xs->reset_value = val;
 	}
 }
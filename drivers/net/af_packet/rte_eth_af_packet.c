@@ -34,9 +34,13 @@
 #define ETH_AF_PACKET_FRAMESIZE_ARG	"framesz"
 #define ETH_AF_PACKET_FRAMECOUNT_ARG	"framecnt"
 #define ETH_AF_PACKET_QDISC_BYPASS_ARG	"qdisc_bypass"
+#define ETH_AF_PACKET_TPACKET_V3_ARG	"tpacket_v3"
+#define ETH_AF_PACKET_BLOCK_TMO_ARG	"block_tmo"
 
 #define DFLT_FRAME_SIZE		(1 << 11)
 #define DFLT_FRAME_COUNT	(1 << 9)
+/* TPACKET_V3 packs received frames into blocks, use bigger ones. */
+#define DFLT_BLOCK_SIZE_V3	(1 << 17)
 
 struct pkt_rx_queue {
 	int sockfd;
@@ -46,16 +50,23 @@ struct pkt_rx_queue {
 	unsigned int framecount;
 	unsigned int framenum;
 
+	/* TPACKET_V3 only: rd entries are blocks, not frames */
+	struct tpacket3_hdr *ppd3;	/* next frame in current block */
+	unsigned int pkts_left;		/* frames left in current block */
+
 	struct rte_mempool *mb_pool;
 	uint16_t in_port;
 
 	volatile unsigned long rx_pkts;
 	volatile unsigned long rx_bytes;
+	volatile unsigned long err_pkts;
 };
 
 struct pkt_tx_queue {
 	int sockfd;
+	int tpver;
 	unsigned int frame_data_size;
+	unsigned int frame_data_off;
 
 	struct iovec *rd;
 	uint8_t *map;
@@ -74,7 +85,8 @@ struct pmd_internals {
 	char *if_name;
 	struct rte_ether_addr eth_addr;
 
-	struct tpacket_req req;
+	int tpver;
+	struct tpacket_req3 req;
 
 	struct pkt_rx_queue *rx_queue;
 	struct pkt_tx_queue *tx_queue;
@@ -87,6 +99,8 @@ static const char *valid_arguments[] = {
 	ETH_AF_PACKET_FRAMESIZE_ARG,
 	ETH_AF_PACKET_FRAMECOUNT_ARG,
 	ETH_AF_PACKET_QDISC_BYPASS_ARG,
+	ETH_AF_PACKET_TPACKET_V3_ARG,
+	ETH_AF_PACKET_BLOCK_TMO_ARG,
 	NULL
 };
 
@@ -107,6 +121,13 @@ RTE_LOG_REGISTER(af_packet_logtype, pmd.net.packet, NOTICE);
 	rte_log(RTE_LOG_ ## level, af_packet_logtype, \
 		"%s(): " fmt ":%s\n", __func__, ##args, strerror(errno))
 
+/* Size of the frame header, frame data starts at hdrlen - sizeof(sll). */
+static inline unsigned int
+tpacket_hdrlen(int tpver)
+{
+	return (tpver == TPACKET_V3) ? TPACKET3_HDRLEN : TPACKET2_HDRLEN;
+}
+
 static uint16_t
 eth_af_packet_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
@@ -167,13 +188,139 @@ eth_af_packet_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return num_rx;
 }
 
+/*
+ * Release a TPACKET_V3 block back to the kernel once all its frames
+ * have been consumed and move to the next one.
+ */
+static inline void
+af_packet_rx_v3_block_done(struct pkt_rx_queue *pkt_q,
+		struct tpacket_block_desc *pbd)
+{
+	/* frame data must be read before the block is given back */
+	__atomic_store_n(&pbd->hdr.bh1.block_status, TP_STATUS_KERNEL,
+		__ATOMIC_RELEASE);
+	if (++pkt_q->framenum >= pkt_q->framecount)
+		pkt_q->framenum = 0;
+	pkt_q->ppd3 = NULL;
+}
+
+static uint16_t
+eth_af_packet_rx_v3(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct tpacket_block_desc *pbd;
+	struct tpacket3_hdr *ppd;
+	struct rte_mbuf *mbuf;
+	uint8_t *pbuf;
+	struct pkt_rx_queue *pkt_q = queue;
+	uint16_t num_rx = 0;
+	unsigned long num_rx_bytes = 0;
+	unsigned long num_err = 0;
+
+	if (unlikely(nb_pkts == 0))
+		return 0;
+
+	/*
+	 * The kernel hands over whole blocks of frames, walk the frames
+	 * of the current block and release it at once when all of them
+	 * are consumed.
+	 */
+	while (num_rx < nb_pkts) {
+		pbd = (struct tpacket_block_desc *)
+			pkt_q->rd[pkt_q->framenum].iov_base;
+
+		if (pkt_q->ppd3 == NULL) {
+			if ((__atomic_load_n(&pbd->hdr.bh1.block_status,
+					__ATOMIC_ACQUIRE) &
+					TP_STATUS_USER) == 0)
+				break;
+			pkt_q->pkts_left = pbd->hdr.bh1.num_pkts;
+			if (unlikely(pkt_q->pkts_left == 0)) {
+				af_packet_rx_v3_block_done(pkt_q, pbd);
+				continue;
+			}
+			pkt_q->ppd3 = (struct tpacket3_hdr *)((uint8_t *)pbd +
+				pbd->hdr.bh1.offset_to_first_pkt);
+		}
+		ppd = pkt_q->ppd3;
+
+		/* allocate the next mbuf */
+		mbuf = rte_pktmbuf_alloc(pkt_q->mb_pool);
+		if (unlikely(mbuf == NULL))
+			break;
+
+		/* frames are not bound to the frame size, drop too big ones */
+		if (unlikely(ppd->tp_snaplen > rte_pktmbuf_tailroom(mbuf))) {
+			rte_pktmbuf_free(mbuf);
+			num_err++;
+		} else {
+			rte_pktmbuf_pkt_len(mbuf) = ppd->tp_snaplen;
+			rte_pktmbuf_data_len(mbuf) = ppd->tp_snaplen;
+			pbuf = (uint8_t *)ppd + ppd->tp_mac;
+			memcpy(rte_pktmbuf_mtod(mbuf, void *), pbuf,
+				rte_pktmbuf_data_len(mbuf));
+
+			/* check for vlan info */
+			if (ppd->tp_status & TP_STATUS_VLAN_VALID) {
+				mbuf->vlan_tci = ppd->hv1.tp_vlan_tci;
+				mbuf->ol_flags |=
+					(PKT_RX_VLAN | PKT_RX_VLAN_STRIPPED);
+			}
+			mbuf->port = pkt_q->in_port;
+
+			/* account for the receive frame */
+			bufs[num_rx++] = mbuf;
+			num_rx_bytes += mbuf->pkt_len;
+		}
+
+		/* advance to the next frame or release the whole block */
+		if (--pkt_q->pkts_left == 0)
+			af_packet_rx_v3_block_done(pkt_q, pbd);
+		else
+			pkt_q->ppd3 = (struct tpacket3_hdr *)((uint8_t *)ppd +
+				ppd->tp_next_offset);
+	}
+
+	pkt_q->rx_pkts += num_rx;
+	pkt_q->rx_bytes += num_rx_bytes;
+	pkt_q->err_pkts += num_err;
+	return num_rx;
+}
+
+/*
+ * TPACKET_V2 and TPACKET_V3 Tx frames only differ in the header layout.
+ */
+static inline uint32_t
+tx_frame_status(const void *ppd, int tpver)
+{
+	if (tpver == TPACKET_V3)
+		return ((const struct tpacket3_hdr *)ppd)->tp_status;
+	return ((const struct tpacket2_hdr *)ppd)->tp_status;
+}
+
+static inline void
+tx_frame_send(void *ppd, int tpver, uint32_t len)
+{
+	struct tpacket2_hdr *ppd2 = ppd;
+	struct tpacket3_hdr *ppd3 = ppd;
+
+	if (tpver == TPACKET_V3) {
+		ppd3->tp_len = len;
+		ppd3->tp_snaplen = len;
+		ppd3->tp_status = TP_STATUS_SEND_REQUEST;
+	} else {
+		ppd2->tp_len = len;
+		ppd2->tp_snaplen = len;
+		ppd2->tp_status = TP_STATUS_SEND_REQUEST;
+	}
+}
+
 /*
  * Callback to handle sending packets through a real NIC.
  */
 static uint16_t
 eth_af_packet_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
-	struct tpacket2_hdr *ppd;
+	void *ppd;
 	struct rte_mbuf *mbuf;
 	uint8_t *pbuf;
 	unsigned int framecount, framenum;
@@ -193,7 +340,7 @@ eth_af_packet_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 
 	framecount = pkt_q->framecount;
 	framenum = pkt_q->framenum;
-	ppd = (struct tpacket2_hdr *) pkt_q->rd[framenum].iov_base;
+	ppd = pkt_q->rd[framenum].iov_base;
 	for (i = 0; i < nb_pkts; i++) {
 		mbuf = *bufs++;
 
@@ -212,13 +359,13 @@ eth_af_packet_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		}
 
 		/* point at the next incoming frame */
-		if ((ppd->tp_status != TP_STATUS_AVAILABLE) &&
+		if ((tx_frame_status(ppd, pkt_q->tpver) !=
+				TP_STATUS_AVAILABLE) &&
 		    (poll(&pfd, 1, -1) < 0))
 			break;
 
 		/* copy the tx frame data */
-		pbuf = (uint8_t *) ppd + TPACKET2_HDRLEN -
-			sizeof(struct sockaddr_ll);
+		pbuf = (uint8_t *)ppd + pkt_q->frame_data_off;
 
 		struct rte_mbuf *tmp_mbuf = mbuf;
 		while (tmp_mbuf) {
@@ -228,14 +375,11 @@ eth_af_packet_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 			tmp_mbuf = tmp_mbuf->next;
 		}
 
-		ppd->tp_len = mbuf->pkt_len;
-		ppd->tp_snaplen = mbuf->pkt_len;
-
 		/* release incoming frame and advance ring buffer */
-		ppd->tp_status = TP_STATUS_SEND_REQUEST;
+		tx_frame_send(ppd, pkt_q->tpver, mbuf->pkt_len);
 		if (++framenum >= framecount)
 			framenum = 0;
-		ppd = (struct tpacket2_hdr *) pkt_q->rd[framenum].iov_base;
+		ppd = pkt_q->rd[framenum].iov_base;
 
 		num_tx++;
 		num_tx_bytes += mbuf->pkt_len;
@@ -326,6 +470,7 @@ eth_stats_get(struct rte_eth_dev *dev, struct rte_eth_stats *igb_stats)
 {
 	unsigned i, imax;
 	unsigned long rx_total = 0, tx_total = 0, tx_err_total = 0;
+	unsigned long rx_err_total = 0;
 	unsigned long rx_bytes_total = 0, tx_bytes_total = 0;
 	const struct pmd_internals *internal = dev->data->dev_private;
 
@@ -335,6 +480,7 @@ eth_stats_get(struct rte_eth_dev *dev, struct rte_eth_stats *igb_stats)
 		igb_stats->q_ipackets[i] = internal->rx_queue[i].rx_pkts;
 		igb_stats->q_ibytes[i] = internal->rx_queue[i].rx_bytes;
 		rx_total += igb_stats->q_ipackets[i];
+		rx_err_total += internal->rx_queue[i].err_pkts;
 		rx_bytes_total += igb_stats->q_ibytes[i];
 	}
 
@@ -350,6 +496,7 @@ eth_stats_get(struct rte_eth_dev *dev, struct rte_eth_stats *igb_stats)
 
 	igb_stats->ipackets = rx_total;
 	igb_stats->ibytes = rx_bytes_total;
+	igb_stats->ierrors = rx_err_total;
 	igb_stats->opackets = tx_total;
 	igb_stats->oerrors = tx_err_total;
 	igb_stats->obytes = tx_bytes_total;
@@ -365,6 +512,7 @@ eth_stats_reset(struct rte_eth_dev *dev)
 	for (i = 0; i < internal->nb_queues; i++) {
 		internal->rx_queue[i].rx_pkts = 0;
 		internal->rx_queue[i].rx_bytes = 0;
+		internal->rx_queue[i].err_pkts = 0;
 	}
 
 	for (i = 0; i < internal->nb_queues; i++) {
@@ -411,7 +559,8 @@ eth_rx_queue_setup(struct rte_eth_dev *dev,
 	buf_size = rte_pktmbuf_data_room_size(pkt_q->mb_pool) -
 		RTE_PKTMBUF_HEADROOM;
 	data_size = internals->req.tp_frame_size;
-	data_size -= TPACKET2_HDRLEN - sizeof(struct sockaddr_ll);
+	data_size -= tpacket_hdrlen(internals->tpver) -
+		sizeof(struct sockaddr_ll);
 
 	if (data_size > buf_size) {
 		PMD_LOG(ERR,
@@ -448,7 +597,7 @@ eth_dev_mtu_set(struct rte_eth_dev *dev, uint16_t mtu)
 	int ret;
 	int s;
 	unsigned int data_size = internals->req.tp_frame_size -
-				 TPACKET2_HDRLEN;
+				 tpacket_hdrlen(internals->tpver);
 
 	if (mtu > data_size)
 		return -EINVAL;
@@ -584,6 +733,8 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
                        unsigned int framesize,
                        unsigned int framecnt,
 		       unsigned int qdisc_bypass,
+		       int tpver,
+		       unsigned int block_tmo,
                        struct pmd_internals **internals,
                        struct rte_eth_dev **eth_dev,
                        struct rte_kvargs *kvlist)
@@ -596,10 +747,11 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	size_t ifnamelen;
 	unsigned k_idx;
 	struct sockaddr_ll sockaddr;
-	struct tpacket_req *req;
+	struct tpacket_req3 *req;
 	struct pkt_rx_queue *rx_queue;
 	struct pkt_tx_queue *tx_queue;
-	int rc, tpver, discard;
+	int rc, discard;
+	socklen_t req_size;
 	int qsockfd = -1;
 	unsigned int i, q, rdsize;
 #if defined(PACKET_FANOUT)
@@ -653,6 +805,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	req->tp_block_nr = blockcnt;
 	req->tp_frame_size = framesize;
 	req->tp_frame_nr = framecnt;
+	(*internals)->tpver = tpver;
 
 	ifnamelen = strlen(pair->value);
 	if (ifnamelen < sizeof(ifr.ifr_name)) {
@@ -702,7 +855,6 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
-		tpver = TPACKET_V2;
 		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_VERSION,
 				&tpver, sizeof(tpver));
 		if (rc == -1) {
@@ -735,7 +887,15 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 		RTE_SET_USED(qdisc_bypass);
 #endif
 
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING, req, sizeof(*req));
+		if (tpver == TPACKET_V3) {
+			/* only Rx ring works with blocks */
+			req->tp_retire_blk_tov = block_tmo;
+			req_size = sizeof(struct tpacket_req3);
+		} else {
+			req_size = sizeof(struct tpacket_req);
+		}
+		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING,
+				req, req_size);
 		if (rc == -1) {
 			PMD_LOG_ERRNO(ERR,
 				"%s: could not set PACKET_RX_RING on AF_PACKET socket for %s",
@@ -743,7 +903,9 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_TX_RING, req, sizeof(*req));
+		req->tp_retire_blk_tov = 0;
+		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_TX_RING,
+				req, req_size);
 		if (rc == -1) {
 			PMD_LOG_ERRNO(ERR,
 				"%s: could not set PACKET_TX_RING on AF_PACKET "
@@ -752,7 +914,8 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 		}
 
 		rx_queue = &((*internals)->rx_queue[q]);
-		rx_queue->framecount = req->tp_frame_nr;
+		rx_queue->framecount = (tpver == TPACKET_V3) ?
+			req->tp_block_nr : req->tp_frame_nr;
 
 		rx_queue->map = mmap(NULL, 2 * req->tp_block_size * req->tp_block_nr,
 				    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED,
@@ -770,17 +933,28 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 		rx_queue->rd = rte_zmalloc_socket(name, rdsize, 0, numa_node);
 		if (rx_queue->rd == NULL)
 			goto error;
-		for (i = 0; i < req->tp_frame_nr; ++i) {
-			rx_queue->rd[i].iov_base = rx_queue->map + (i * framesize);
-			rx_queue->rd[i].iov_len = req->tp_frame_size;
+		if (tpver == TPACKET_V3) {
+			for (i = 0; i < req->tp_block_nr; ++i) {
+				rx_queue->rd[i].iov_base = rx_queue->map +
+					(i * blocksize);
+				rx_queue->rd[i].iov_len = req->tp_block_size;
+			}
+		} else {
+			for (i = 0; i < req->tp_frame_nr; ++i) {
+				rx_queue->rd[i].iov_base = rx_queue->map +
+					(i * framesize);
+				rx_queue->rd[i].iov_len = req->tp_frame_size;
+			}
 		}
 		rx_queue->sockfd = qsockfd;
 
 		tx_queue = &((*internals)->tx_queue[q]);
 		tx_queue->framecount = req->tp_frame_nr;
-		tx_queue->frame_data_size = req->tp_frame_size;
-		tx_queue->frame_data_size -= TPACKET2_HDRLEN -
+		tx_queue->tpver = tpver;
+		tx_queue->frame_data_off = tpacket_hdrlen(tpver) -
 			sizeof(struct sockaddr_ll);
+		tx_queue->frame_data_size = req->tp_frame_size -
+			tx_queue->frame_data_off;
 
 		tx_queue->map = rx_queue->map + req->tp_block_size * req->tp_block_nr;
 
@@ -877,6 +1051,10 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 	unsigned int framecount = DFLT_FRAME_COUNT;
 	unsigned int qpairs = 1;
 	unsigned int qdisc_bypass = 1;
+	unsigned int tpacket_v3 = 0;
+	unsigned int block_tmo = 0;
+	int blocksize_set = 0;
+	int block_tmo_set = 0;
 
 	/* do some parameter checking */
 	if (*sockfd < 0)
@@ -907,6 +1085,7 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 				        name);
 				return -1;
 			}
+			blocksize_set = 1;
 			continue;
 		}
 		if (strstr(pair->key, ETH_AF_PACKET_FRAMESIZE_ARG) != NULL) {
@@ -939,8 +1118,47 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 			}
 			continue;
 		}
+		if (strstr(pair->key, ETH_AF_PACKET_TPACKET_V3_ARG) != NULL) {
+			tpacket_v3 = atoi(pair->value);
+			if (tpacket_v3 > 1) {
+				PMD_LOG(ERR,
+					"%s: invalid tpacket_v3 value",
+					name);
+				return -1;
+			}
+			continue;
+		}
+		if (strstr(pair->key, ETH_AF_PACKET_BLOCK_TMO_ARG) != NULL) {
+			unsigned long value;
+			char *end;
+
+			/* The kernel keeps the timeout in 16 bits */
+			errno = 0;
+			value = strtoul(pair->value, &end, 10);
+			if (errno != 0 || end == pair->value || *end != '\0' ||
+			    pair->value[0] == '-' || value > UINT16_MAX) {
+				PMD_LOG(ERR,
+					"%s: invalid block_tmo value",
+					name);
+				return -1;
+			}
+			block_tmo = value;
+			block_tmo_set = 1;
+			continue;
+		}
 	}
 
+	if (block_tmo_set && !tpacket_v3) {
+		PMD_LOG(ERR,
+			"%s: block_tmo requires tpacket_v3",
+			name);
+		return -1;
+	}
+
+	if (tpacket_v3 && !blocksize_set)
+		blocksize = RTE_MAX(blocksize,
+			(unsigned int)DFLT_BLOCK_SIZE_V3);
+
 	if (framesize > blocksize) {
 		PMD_LOG(ERR,
 			"%s: AF_PACKET MMAP frame size exceeds block size!",
@@ -960,16 +1178,22 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 	PMD_LOG(INFO, "%s:\tblock count %d", name, blockcount);
 	PMD_LOG(INFO, "%s:\tframe size %d", name, framesize);
 	PMD_LOG(INFO, "%s:\tframe count %d", name, framecount);
+	if (tpacket_v3)
+		PMD_LOG(INFO, "%s:\tTPACKET_V3 block timeout %u ms",
+			name, block_tmo);
 
 	if (rte_pmd_init_internals(dev, *sockfd, qpairs,
 				   blocksize, blockcount,
 				   framesize, framecount,
 				   qdisc_bypass,
+				   tpacket_v3 ? TPACKET_V3 : TPACKET_V2,
+				   block_tmo,
 				   &internals, &eth_dev,
 				   kvlist) < 0)
 		return -1;
 
-	eth_dev->rx_pkt_burst = eth_af_packet_rx;
+	eth_dev->rx_pkt_burst = tpacket_v3 ? eth_af_packet_rx_v3 :
+		eth_af_packet_rx;
 	eth_dev->tx_pkt_burst = eth_af_packet_tx;
 
 	rte_eth_dev_probing_finish(eth_dev);
@@ -1034,7 +1258,7 @@ rte_pmd_af_packet_remove(struct rte_vdev_device *dev)
 {
 	struct rte_eth_dev *eth_dev = NULL;
 	struct pmd_internals *internals;
-	struct tpacket_req *req;
+	struct tpacket_req3 *req;
 	unsigned q;
 
 	PMD_LOG(INFO, "Closing AF_PACKET ethdev on numa socket %u",
@@ -1084,4 +1308,6 @@ RTE_PMD_REGISTER_PARAM_STRING(net_af_packet,
 	"blocksz=<int> "
 	"framesz=<int> "
 	"framecnt=<int> "
-	"qdisc_bypass=<0|1>");
+	"qdisc_bypass=<0|1> "
+	"tpacket_v3=<0|1> "
+	"block_tmo=<0-65535>");
@@ -177,6 +177,8 @@ struct rte_acl_ctx {
 	void               *mem;
 	size_t              mem_sz;
 	struct rte_acl_config config; /* copy of build config. */
+	struct acl_update  *upd;
+	/**< incremental update state, NULL if not enabled. */
 };
 
 int rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
@@ -186,6 +188,19 @@ int rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 typedef int (*rte_acl_classify_t)
 (const struct rte_acl_ctx *, const uint8_t **, uint32_t *, uint32_t, uint32_t);
 
+int acl_check_rule(const struct rte_acl_rule_data *rd);
+
+/*
+ * Incremental updates support.
+ */
+void acl_update_free(struct rte_acl_ctx *ctx);
+
+void acl_update_dump(const struct rte_acl_ctx *ctx);
+
+int acl_update_classify(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories,
+	rte_acl_classify_t classify);
+
 /*
  * Different implementations of ACL classify.
  */
@@ -201,6 +216,10 @@ int
 rte_acl_classify_avx2(const struct rte_acl_ctx *ctx, const uint8_t **data,
 	uint32_t *results, uint32_t num, uint32_t categories);
 
+int
+rte_acl_classify_avx512(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories);
+
 int
 rte_acl_classify_neon(const struct rte_acl_ctx *ctx, const uint8_t **data,
 	uint32_t *results, uint32_t num, uint32_t categories);
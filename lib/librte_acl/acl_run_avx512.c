@@ -0,0 +1,333 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include "acl_run_sse.h"
+
+/* Maximum number of flows processed by one AVX512 register. */
+#define MAX_SEARCHES_AVX512X16	16
+
+/* Maximum number of flows processed by two interleaved AVX512 registers. */
+#define MAX_SEARCHES_AVX512X32	(2 * MAX_SEARCHES_AVX512X16)
+
+typedef __m512i zmm_t;
+
+/* Even and odd 32-bit elements of two zmm registers holding 16 transitions */
+static const uint32_t zmm_idx_lo[MAX_SEARCHES_AVX512X16] = {
+	0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30,
+};
+
+static const uint32_t zmm_idx_hi[MAX_SEARCHES_AVX512X16] = {
+	1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31,
+};
+
+/*
+ * Holds trie traversal state for 16 flows.
+ * tr_lo contains low 32 bits for 16 transitions.
+ * tr_hi contains high 32 bits for 16 transitions.
+ */
+struct acl_flow_avx512 {
+	zmm_t tr_lo;
+	zmm_t tr_hi;
+};
+
+/*
+ * Per 128-bit lane constants, the same as used by SSE and AVX2 code paths.
+ */
+static __rte_always_inline zmm_t
+zmm_shuffle_input(void)
+{
+	return _mm512_broadcast_i32x4(_mm_set_epi32(0x0c0c0c0c, 0x08080808,
+		0x04040404, 0x00000000));
+}
+
+static __rte_always_inline zmm_t
+zmm_range_base(void)
+{
+	return _mm512_broadcast_i32x4(_mm_set_epi32(0xffffff0c, 0xffffff08,
+		0xffffff04, 0xffffff00));
+}
+
+/*
+ * Calculate the address of the next transition for 16 flows,
+ * following the same logic as ACL_TR_CALC_ADDR().
+ * Mask registers are used instead of blend/sign operations.
+ */
+static __rte_always_inline zmm_t
+calc_addr16(zmm_t next_input, zmm_t tr_lo, zmm_t tr_hi)
+{
+	__mmask16 dfa_msk;
+	__mmask64 quad_msk;
+	zmm_t addr, in, node_type, r, t, dfa_ofs, quad_ofs;
+	const zmm_t index_mask = _mm512_set1_epi32(RTE_ACL_NODE_INDEX);
+
+	in = _mm512_shuffle_epi8(next_input, zmm_shuffle_input());
+
+	/* Calc node type and node addr */
+	node_type = _mm512_andnot_si512(index_mask, tr_lo);
+	addr = _mm512_and_si512(index_mask, tr_lo);
+
+	/* mask for DFA type(0) nodes */
+	dfa_msk = _mm512_cmpeq_epi32_mask(node_type, _mm512_setzero_si512());
+
+	/* DFA calculations. */
+	r = _mm512_srli_epi32(in, 30);
+	r = _mm512_add_epi8(r, zmm_range_base());
+	t = _mm512_srli_epi32(in, 24);
+	r = _mm512_shuffle_epi8(tr_hi, r);
+
+	dfa_ofs = _mm512_sub_epi32(t, r);
+
+	/* QUAD/SINGLE calculations. */
+	quad_msk = _mm512_cmpgt_epi8_mask(in, tr_hi);
+	t = _mm512_maskz_set1_epi8(quad_msk, 1);
+	t = _mm512_maddubs_epi16(t, t);
+	quad_ofs = _mm512_madd_epi16(t, _mm512_set1_epi16(1));
+
+	/* blend DFA and QUAD/SINGLE. */
+	t = _mm512_mask_mov_epi32(quad_ofs, dfa_msk, dfa_ofs);
+
+	/* calculate address for next transitions. */
+	return _mm512_add_epi32(addr, t);
+}
+
+/*
+ * Process 16 transitions in parallel.
+ * next_input contains up to 4 input bytes for 16 flows.
+ */
+static __rte_always_inline zmm_t
+transition16(zmm_t next_input, const uint64_t *trans,
+	struct acl_flow_avx512 *fl)
+{
+	const int32_t *tr;
+	zmm_t addr;
+
+	tr = (const int32_t *)(uintptr_t)trans;
+
+	addr = calc_addr16(next_input, fl->tr_lo, fl->tr_hi);
+
+	/* load lower 32 bits of 16 transactions at once. */
+	fl->tr_lo = _mm512_i32gather_epi32(addr, tr, sizeof(trans[0]));
+
+	next_input = _mm512_srli_epi32(next_input, CHAR_BIT);
+
+	/* load high 32 bits of 16 transactions at once. */
+	fl->tr_hi = _mm512_i32gather_epi32(addr, tr + 1, sizeof(trans[0]));
+
+	return next_input;
+}
+
+/*
+ * Split 16 64-bit transitions into low and high 32-bit halves.
+ */
+static __rte_always_inline void
+acl_tr_hilo16(const uint64_t tr[MAX_SEARCHES_AVX512X16],
+	struct acl_flow_avx512 *fl)
+{
+	zmm_t t0, t1;
+
+	t0 = _mm512_loadu_si512(tr);
+	t1 = _mm512_loadu_si512(tr + MAX_SEARCHES_AVX512X16 / 2);
+
+	fl->tr_lo = _mm512_permutex2var_epi32(t0,
+		_mm512_loadu_si512(zmm_idx_lo), t1);
+	fl->tr_hi = _mm512_permutex2var_epi32(t0,
+		_mm512_loadu_si512(zmm_idx_hi), t1);
+}
+
+/*
+ * Check for matches in 16 flows and replace matched transitions
+ * with the start of the next trie (or an idle one).
+ */
+static inline void
+acl_match_check_avx512x16(const struct rte_acl_ctx *ctx, struct parms *parms,
+	struct acl_flow_data *flows, uint32_t slot, struct acl_flow_avx512 *fl)
+{
+	uint32_t i, msk;
+	uint64_t tr;
+	uint32_t lo[MAX_SEARCHES_AVX512X16];
+	const zmm_t match_mask = _mm512_set1_epi32(RTE_ACL_NODE_MATCH);
+
+	/* test for match node */
+	msk = _mm512_test_epi32_mask(fl->tr_lo, match_mask);
+
+	while (msk != 0) {
+
+		/*
+		 * Low 32 bits of the transition are enough
+		 * to process the match.
+		 */
+		_mm512_storeu_si512(lo, fl->tr_lo);
+
+		do {
+			i = __builtin_ctz(msk);
+			msk &= msk - 1;
+
+			tr = acl_match_check(lo[i], slot + i,
+				ctx, parms, flows, resolve_priority_sse);
+
+			/* Keep transitions with NOMATCH intact. */
+			fl->tr_lo = _mm512_mask_set1_epi32(fl->tr_lo, 1 << i,
+				(uint32_t)tr);
+			fl->tr_hi = _mm512_mask_set1_epi32(fl->tr_hi, 1 << i,
+				(uint32_t)(tr >> 32));
+		} while (msk != 0);
+
+		msk = _mm512_test_epi32_mask(fl->tr_lo, match_mask);
+	}
+}
+
+/*
+ * Gather 4 bytes of input data for 16 flows.
+ */
+static __rte_always_inline zmm_t
+acl_get_next_input16(struct parms *parms, uint32_t slot)
+{
+	xmm_t in[4];
+
+	in[0] = _mm_set_epi32(GET_NEXT_4BYTES(parms, slot + 3),
+		GET_NEXT_4BYTES(parms, slot + 2),
+		GET_NEXT_4BYTES(parms, slot + 1),
+		GET_NEXT_4BYTES(parms, slot + 0));
+	in[1] = _mm_set_epi32(GET_NEXT_4BYTES(parms, slot + 7),
+		GET_NEXT_4BYTES(parms, slot + 6),
+		GET_NEXT_4BYTES(parms, slot + 5),
+		GET_NEXT_4BYTES(parms, slot + 4));
+	in[2] = _mm_set_epi32(GET_NEXT_4BYTES(parms, slot + 11),
+		GET_NEXT_4BYTES(parms, slot + 10),
+		GET_NEXT_4BYTES(parms, slot + 9),
+		GET_NEXT_4BYTES(parms, slot + 8));
+	in[3] = _mm_set_epi32(GET_NEXT_4BYTES(parms, slot + 15),
+		GET_NEXT_4BYTES(parms, slot + 14),
+		GET_NEXT_4BYTES(parms, slot + 13),
+		GET_NEXT_4BYTES(parms, slot + 12));
+
+	return _mm512_inserti64x4(_mm512_castsi256_si512(
+		_mm256_set_m128i(in[1], in[0])),
+		_mm256_set_m128i(in[3], in[2]), 1);
+}
+
+/*
+ * Execute trie traversal for up to 16 flows in parallel.
+ */
+static inline int
+search_avx512x16(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t total_packets, uint32_t categories)
+{
+	uint32_t n;
+	struct acl_flow_data flows;
+	uint64_t index_array[MAX_SEARCHES_AVX512X16];
+	struct completion cmplt[MAX_SEARCHES_AVX512X16];
+	struct parms parms[MAX_SEARCHES_AVX512X16];
+	struct acl_flow_avx512 fl;
+	zmm_t input;
+
+	acl_set_flow(&flows, cmplt, RTE_DIM(cmplt), data, results,
+		total_packets, categories, ctx->trans_table);
+
+	for (n = 0; n < RTE_DIM(cmplt); n++) {
+		cmplt[n].count = 0;
+		index_array[n] = acl_start_next_trie(&flows, parms, n, ctx);
+	}
+
+	acl_tr_hilo16(index_array, &fl);
+
+	/* Check for any matches. */
+	acl_match_check_avx512x16(ctx, parms, &flows, 0, &fl);
+
+	while (flows.started > 0) {
+
+		input = acl_get_next_input16(parms, 0);
+
+		input = transition16(input, flows.trans, &fl);
+		input = transition16(input, flows.trans, &fl);
+		input = transition16(input, flows.trans, &fl);
+		input = transition16(input, flows.trans, &fl);
+
+		/* Check for any matches. */
+		acl_match_check_avx512x16(ctx, parms, &flows, 0, &fl);
+	}
+
+	return 0;
+}
+
+/*
+ * Execute trie traversal for up to 32 flows in parallel,
+ * interleaving two sets of 16 flows to hide gather latency.
+ */
+static inline int
+search_avx512x16x2(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t total_packets, uint32_t categories)
+{
+	uint32_t n;
+	struct acl_flow_data flows;
+	uint64_t index_array[MAX_SEARCHES_AVX512X32];
+	struct completion cmplt[MAX_SEARCHES_AVX512X32];
+	struct parms parms[MAX_SEARCHES_AVX512X32];
+	struct acl_flow_avx512 fl[2];
+	zmm_t input[2];
+
+	acl_set_flow(&flows, cmplt, RTE_DIM(cmplt), data, results,
+		total_packets, categories, ctx->trans_table);
+
+	for (n = 0; n < RTE_DIM(cmplt); n++) {
+		cmplt[n].count = 0;
+		index_array[n] = acl_start_next_trie(&flows, parms, n, ctx);
+	}
+
+	acl_tr_hilo16(index_array, &fl[0]);
+	acl_tr_hilo16(index_array + MAX_SEARCHES_AVX512X16, &fl[1]);
+
+	/* Check for any matches. */
+	acl_match_check_avx512x16(ctx, parms, &flows, 0, &fl[0]);
+	acl_match_check_avx512x16(ctx, parms, &flows,
+		MAX_SEARCHES_AVX512X16, &fl[1]);
+
+	while (flows.started > 0) {
+
+		input[0] = acl_get_next_input16(parms, 0);
+		input[1] = acl_get_next_input16(parms,
+			MAX_SEARCHES_AVX512X16);
+
+		input[0] = transition16(input[0], flows.trans, &fl[0]);
+		input[1] = transition16(input[1], flows.trans, &fl[1]);
+
+		input[0] = transition16(input[0], flows.trans, &fl[0]);
+		input[1] = transition16(input[1], flows.trans, &fl[1]);
+
+		input[0] = transition16(input[0], flows.trans, &fl[0]);
+		input[1] = transition16(input[1], flows.trans, &fl[1]);
+
+		input[0] = transition16(input[0], flows.trans, &fl[0]);
+		input[1] = transition16(input[1], flows.trans, &fl[1]);
+
+		/* Check for any matches. */
+		acl_match_check_avx512x16(ctx, parms, &flows, 0, &fl[0]);
+		acl_match_check_avx512x16(ctx, parms, &flows,
+			MAX_SEARCHES_AVX512X16, &fl[1]);
+	}
+
+	return 0;
+}
+
+/*
+ * Note, that to be able to use AVX512 classify method,
+ * both compiler and target cpu have to support AVX512F and AVX512BW
+ * instructions.
+ */
+int
+rte_acl_classify_avx512(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories)
+{
+	if (likely(num >= MAX_SEARCHES_AVX512X32))
+		return search_avx512x16x2(ctx, data, results, num, categories);
+	else if (num >= MAX_SEARCHES_AVX512X16)
+		return search_avx512x16(ctx, data, results, num, categories);
+	else if (num >= MAX_SEARCHES_SSE8)
+		return search_sse_8(ctx, data, results, num, categories);
+	else if (num >= MAX_SEARCHES_SSE4)
+		return search_sse_4(ctx, data, results, num, categories);
+	else
+		return rte_acl_classify_scalar(ctx, data, results, num,
+			categories);
+}
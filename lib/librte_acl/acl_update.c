@@ -0,0 +1,800 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <stdlib.h>
+
+#include <rte_acl.h>
+#include <rte_malloc.h>
+#include <rte_rcu_qsbr.h>
+
+#include "acl.h"
+
+/*
+ * Incremental updates of a built ACL context.
+ *
+ * The compiled trie can't be patched in place: all tries of the context
+ * share the same run-time memory layout. Instead, updates are collected
+ * into a small delta context searched alongside the main one:
+ * - added rules go into the delta context;
+ * - for each deleted rule of the main context, all still alive main rules
+ *   overlapping it are copied into the delta context. So for any input
+ *   matching a deleted rule, the delta context contains every alive rule
+ *   that could match it too.
+ * Results of the two contexts are merged on their priorities:
+ * a main result that refers to a deleted rule is replaced by the delta one.
+ * When the delta context grows too big, the main context is rebuilt
+ * from all alive rules instead.
+ * Each committed state (view) is published with a single atomic store,
+ * the previous one is released once the readers are quiescent.
+ */
+
+/* Number of inputs merged at once. */
+#define ACL_UPDATE_BURST	64
+
+/* Alive rule: userdata and priority, sorted by userdata. */
+struct acl_update_rule {
+	uint32_t userdata;
+	int32_t priority;
+	uint32_t main; /* rule is searched in the main context. */
+};
+
+/* Set of run-time structures used by the readers. */
+struct acl_update_view {
+	struct rte_acl_ctx *main;
+	struct rte_acl_ctx *delta;
+	/* alive rules, only when results have to be merged. */
+	struct acl_update_rule *alive;
+	uint32_t num_alive;
+	/* number of main rules deleted. */
+	uint32_t num_del;
+};
+
+struct acl_update {
+	struct rte_rcu_qsbr *v;
+	uint32_t max_delta;
+	/* view currently used by the readers. */
+	struct acl_update_view *view;
+
+	/* writer side state, main rules are in view->main->rules. */
+	struct acl_update_rule *main_idx; /* main rules sorted by userdata. */
+	uint8_t *main_del;        /* deleted flag for each main rule. */
+	uint32_t num_main_del;
+	uint8_t *add_rules;       /* rules added since last main build. */
+	uint32_t num_add;
+	uint32_t num_delta;       /* rules in the committed delta. */
+};
+
+static inline const struct rte_acl_rule *
+acl_rule_at(const void *rules, uint32_t rule_sz, uint32_t idx)
+{
+	return (const struct rte_acl_rule *)
+		((uintptr_t)rules + (uintptr_t)idx * rule_sz);
+}
+
+static int
+acl_update_rule_cmp(const void *a, const void *b)
+{
+	const struct acl_update_rule *ra = a;
+	const struct acl_update_rule *rb = b;
+
+	return (ra->userdata > rb->userdata) - (ra->userdata < rb->userdata);
+}
+
+static inline const struct acl_update_rule *
+acl_update_rule_find(const struct acl_update_rule *rules, uint32_t num,
+	uint32_t userdata)
+{
+	uint32_t lo, hi, mid;
+
+	lo = 0;
+	hi = num;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (rules[mid].userdata == userdata)
+			return rules + mid;
+		else if (rules[mid].userdata < userdata)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return NULL;
+}
+
+/*
+ * Check if two rules could match the same input.
+ */
+static int
+acl_rule_overlap(const struct rte_acl_config *cfg,
+	const struct rte_acl_rule *r1, const struct rte_acl_rule *r2)
+{
+	uint32_t i, bits, fi;
+	uint64_t m1, m2, msk;
+	const struct rte_acl_field *f1, *f2;
+
+	for (i = 0; i != cfg->num_fields; i++) {
+
+		fi = cfg->defs[i].field_index;
+		f1 = r1->field + fi;
+		f2 = r2->field + fi;
+		bits = cfg->defs[i].size * CHAR_BIT;
+		msk = RTE_LEN2MASK(bits, uint64_t);
+
+		switch (cfg->defs[i].type) {
+		case RTE_ACL_FIELD_TYPE_BITMASK:
+			m1 = f1->mask_range.u64 & msk;
+			m2 = f2->mask_range.u64 & msk;
+			break;
+		case RTE_ACL_FIELD_TYPE_MASK:
+			m1 = (f1->mask_range.u32 == 0) ? 0 :
+				(UINT64_MAX << (bits - f1->mask_range.u32)) &
+				msk;
+			m2 = (f2->mask_range.u32 == 0) ? 0 :
+				(UINT64_MAX << (bits - f2->mask_range.u32)) &
+				msk;
+			break;
+		case RTE_ACL_FIELD_TYPE_RANGE:
+			if ((f1->value.u64 & msk) >
+					(f2->mask_range.u64 & msk) ||
+					(f2->value.u64 & msk) >
+					(f1->mask_range.u64 & msk))
+				return 0;
+			continue;
+		default:
+			return 1;
+		}
+
+		if (((f1->value.u64 ^ f2->value.u64) & m1 & m2) != 0)
+			return 0;
+	}
+
+	return 1;
+}
+
+/*
+ * Allocate an internal context, not visible through rte_acl_find_existing(),
+ * and build it from the given rules.
+ */
+static struct rte_acl_ctx *
+acl_update_ctx_build(const struct rte_acl_ctx *ctx, const void *rules,
+	uint32_t num, uint32_t max_rules)
+{
+	int32_t rc;
+	struct rte_acl_ctx *nc;
+
+	nc = rte_zmalloc_socket(ctx->name,
+		sizeof(*nc) + (size_t)max_rules * ctx->rule_sz,
+		RTE_CACHE_LINE_SIZE, ctx->socket_id);
+	if (nc == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	nc->rules = nc + 1;
+	nc->max_rules = max_rules;
+	nc->rule_sz = ctx->rule_sz;
+	nc->socket_id = ctx->socket_id;
+	nc->alg = ctx->alg;
+	strlcpy(nc->name, ctx->name, sizeof(nc->name));
+
+	memcpy(nc->rules, rules, (size_t)num * ctx->rule_sz);
+	nc->num_rules = num;
+
+	rc = rte_acl_build(nc, &ctx->config);
+	if (rc != 0) {
+		RTE_LOG(ERR, ACL, "%s(%s): build of %u rules failed: %d\n",
+			__func__, ctx->name, num, rc);
+		rte_free(nc->mem);
+		rte_free(nc);
+		rte_errno = -rc;
+		return NULL;
+	}
+
+	return nc;
+}
+
+static void
+acl_update_ctx_free(struct rte_acl_ctx *ctx)
+{
+	if (ctx != NULL) {
+		rte_free(ctx->mem);
+		rte_free(ctx);
+	}
+}
+
+static void
+acl_update_view_free(struct acl_update_view *view)
+{
+	if (view != NULL) {
+		acl_update_ctx_free(view->delta);
+		rte_free(view->alive);
+		rte_free(view);
+	}
+}
+
+/*
+ * (Re)create writer side index of the main rules.
+ */
+static int
+acl_update_main_index(struct acl_update *upd, const struct rte_acl_ctx *mctx)
+{
+	uint32_t i;
+	struct acl_update_rule *idx;
+	uint8_t *del;
+	const struct rte_acl_rule *r;
+
+	idx = rte_malloc(NULL, (mctx->num_rules + 1) * sizeof(idx[0]), 0);
+	del = rte_zmalloc(NULL, mctx->num_rules + 1, 0);
+	if (idx == NULL || del == NULL) {
+		rte_free(idx);
+		rte_free(del);
+		return -ENOMEM;
+	}
+
+	/* priority field is reused to keep the rule position. */
+	for (i = 0; i != mctx->num_rules; i++) {
+		r = acl_rule_at(mctx->rules, mctx->rule_sz, i);
+		idx[i].userdata = r->data.userdata;
+		idx[i].priority = i;
+		idx[i].main = 1;
+	}
+
+	qsort(idx, mctx->num_rules, sizeof(idx[0]), acl_update_rule_cmp);
+
+	for (i = 0; i != mctx->num_rules; i++) {
+		if (idx[i].userdata == 0 || (i != 0 &&
+				idx[i].userdata == idx[i - 1].userdata)) {
+			RTE_LOG(ERR, ACL, "%s: userdata %u is not unique "
+				"or zero\n", __func__, idx[i].userdata);
+			rte_free(idx);
+			rte_free(del);
+			return -EEXIST;
+		}
+	}
+
+	rte_free(upd->main_idx);
+	rte_free(upd->main_del);
+	upd->main_idx = idx;
+	upd->main_del = del;
+	upd->num_main_del = 0;
+	return 0;
+}
+
+/*
+ * Publish new view and release the old one,
+ * once all the readers stopped referencing it.
+ */
+static void
+acl_update_publish(struct acl_update *upd, struct acl_update_view *nv)
+{
+	struct acl_update_view *ov;
+
+	ov = upd->view;
+	__atomic_store_n(&upd->view, nv, __ATOMIC_RELEASE);
+
+	if (upd->v != NULL)
+		rte_rcu_qsbr_synchronize(upd->v, RTE_QSBR_THRID_INVALID);
+
+	if (ov->main != nv->main)
+		acl_update_ctx_free(ov->main);
+	acl_update_view_free(ov);
+}
+
+void
+acl_update_free(struct rte_acl_ctx *ctx)
+{
+	struct acl_update *upd;
+
+	upd = ctx->upd;
+	if (upd == NULL)
+		return;
+
+	acl_update_ctx_free(upd->view->main);
+	acl_update_view_free(upd->view);
+	rte_free(upd->main_idx);
+	rte_free(upd->main_del);
+	rte_free(upd->add_rules);
+	rte_free(upd);
+	ctx->upd = NULL;
+}
+
+int
+rte_acl_update_enable(struct rte_acl_ctx *ctx,
+	const struct rte_acl_update_config *cfg)
+{
+	int32_t rc;
+	struct acl_update *upd;
+	struct acl_update_view *view;
+	struct rte_acl_ctx *mctx;
+
+	if (ctx == NULL || cfg == NULL || ctx->upd != NULL ||
+			ctx->mem == NULL)
+		return -EINVAL;
+
+	upd = rte_zmalloc_socket(ctx->name, sizeof(*upd), 0, ctx->socket_id);
+	view = rte_zmalloc_socket(ctx->name, sizeof(*view), 0,
+		ctx->socket_id);
+	mctx = rte_zmalloc_socket(ctx->name,
+		sizeof(*mctx) + (size_t)ctx->max_rules * ctx->rule_sz,
+		RTE_CACHE_LINE_SIZE, ctx->socket_id);
+	if (upd != NULL)
+		upd->add_rules = rte_malloc_socket(ctx->name,
+			(size_t)ctx->max_rules * ctx->rule_sz, 0,
+			ctx->socket_id);
+
+	if (upd == NULL || view == NULL || mctx == NULL ||
+			upd->add_rules == NULL) {
+		rc = -ENOMEM;
+		goto error;
+	}
+
+	/* main context takes over the rules and run-time structures. */
+	*mctx = *ctx;
+	mctx->rules = mctx + 1;
+	memcpy(mctx->rules, ctx->rules, (size_t)ctx->num_rules * ctx->rule_sz);
+
+	rc = acl_update_main_index(upd, mctx);
+	if (rc != 0)
+		goto error;
+
+	upd->v = cfg->v;
+	upd->max_delta = (cfg->max_delta_rules == 0) ?
+		RTE_ACL_UPDATE_DELTA_DEF : cfg->max_delta_rules;
+	view->main = mctx;
+	upd->view = view;
+
+	/* run-time structures are owned by the main context now. */
+	ctx->mem = NULL;
+	ctx->mem_sz = 0;
+	ctx->upd = upd;
+	return 0;
+
+error:
+	if (upd != NULL) {
+		rte_free(upd->add_rules);
+		rte_free(upd->main_idx);
+		rte_free(upd->main_del);
+	}
+	rte_free(upd);
+	rte_free(view);
+	rte_free(mctx);
+	return rc;
+}
+
+/*
+ * Find position of the rule with given userdata in added rules.
+ */
+static int32_t
+acl_update_find_added(const struct rte_acl_ctx *ctx,
+	const struct acl_update *upd, uint32_t userdata)
+{
+	uint32_t i;
+
+	for (i = 0; i != upd->num_add; i++) {
+		if (acl_rule_at(upd->add_rules, ctx->rule_sz, i)->data.userdata
+				== userdata)
+			return i;
+	}
+	return -ENOENT;
+}
+
+/*
+ * Find position of the alive main rule with given userdata.
+ */
+static int32_t
+acl_update_find_main(const struct acl_update *upd, uint32_t userdata)
+{
+	const struct acl_update_rule *r;
+
+	r = acl_update_rule_find(upd->main_idx, upd->view->main->num_rules,
+		userdata);
+	if (r == NULL || upd->main_del[r->priority] != 0)
+		return -ENOENT;
+	return r->priority;
+}
+
+int
+rte_acl_update_add_rules(struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num)
+{
+	int32_t rc;
+	uint32_t i, num_alive;
+	struct acl_update *upd;
+	const struct rte_acl_rule *rv;
+
+	if (ctx == NULL || rules == NULL || ctx->upd == NULL)
+		return -EINVAL;
+
+	upd = ctx->upd;
+	num_alive = upd->view->main->num_rules - upd->num_main_del +
+		upd->num_add;
+	if (num_alive + num > ctx->max_rules)
+		return -ENOMEM;
+
+	for (i = 0; i != num; i++) {
+		rv = acl_rule_at(rules, ctx->rule_sz, i);
+		rc = acl_check_rule(&rv->data);
+		if (rc != 0 || rv->data.userdata == 0) {
+			RTE_LOG(ERR, ACL, "%s(%s): rule #%u is invalid\n",
+				__func__, ctx->name, i + 1);
+			return -EINVAL;
+		}
+	}
+
+	for (i = 0; i != num; i++) {
+		rv = acl_rule_at(rules, ctx->rule_sz, i);
+		if (acl_update_find_main(upd, rv->data.userdata) >= 0 ||
+				acl_update_find_added(ctx, upd,
+				rv->data.userdata) >= 0) {
+			RTE_LOG(ERR, ACL, "%s(%s): rule #%u userdata %u "
+				"already exists\n", __func__, ctx->name,
+				i + 1, rv->data.userdata);
+			/* drop rules of this call added so far */
+			upd->num_add -= i;
+			return -EEXIST;
+		}
+
+		memcpy(upd->add_rules + (size_t)upd->num_add * ctx->rule_sz,
+			rv, ctx->rule_sz);
+		upd->num_add++;
+	}
+
+	return 0;
+}
+
+int
+rte_acl_update_del_rules(struct rte_acl_ctx *ctx, const uint32_t userdata[],
+	uint32_t num)
+{
+	int32_t k;
+	uint32_t i;
+	struct acl_update *upd;
+
+	if (ctx == NULL || userdata == NULL || ctx->upd == NULL)
+		return -EINVAL;
+
+	upd = ctx->upd;
+
+	/* check all the rules exist first. */
+	for (i = 0; i != num; i++) {
+		if (acl_update_find_main(upd, userdata[i]) < 0 &&
+				acl_update_find_added(ctx, upd,
+				userdata[i]) < 0)
+			return -ENOENT;
+	}
+
+	for (i = 0; i != num; i++) {
+
+		k = acl_update_find_added(ctx, upd, userdata[i]);
+		if (k >= 0) {
+			/* move the last added rule in place of deleted one. */
+			upd->num_add--;
+			memmove(upd->add_rules + (size_t)k * ctx->rule_sz,
+				upd->add_rules +
+				(size_t)upd->num_add * ctx->rule_sz,
+				ctx->rule_sz);
+			continue;
+		}
+
+		k = acl_update_find_main(upd, userdata[i]);
+		if (k >= 0) {
+			upd->main_del[k] = 1;
+			upd->num_main_del++;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Copy all alive rules into the dst buffer, main rules first.
+ */
+static uint32_t
+acl_update_copy_alive(const struct rte_acl_ctx *ctx,
+	const struct acl_update *upd, uint8_t *dst)
+{
+	uint32_t i, n;
+	const struct rte_acl_ctx *mctx;
+
+	mctx = upd->view->main;
+
+	n = 0;
+	for (i = 0; i != mctx->num_rules; i++) {
+		if (upd->main_del[i] == 0) {
+			memcpy(dst + (size_t)n * ctx->rule_sz,
+				acl_rule_at(mctx->rules, ctx->rule_sz, i),
+				ctx->rule_sz);
+			n++;
+		}
+	}
+
+	memcpy(dst + (size_t)n * ctx->rule_sz, upd->add_rules,
+		(size_t)upd->num_add * ctx->rule_sz);
+	return n + upd->num_add;
+}
+
+/*
+ * Collect rules for the delta context: added rules and alive main rules
+ * overlapping any of the deleted ones.
+ * Returns number of collected rules or UINT32_MAX if there are
+ * more than max.
+ */
+static uint32_t
+acl_update_collect_delta(const struct rte_acl_ctx *ctx,
+	const struct acl_update *upd, uint8_t *dst, uint32_t max)
+{
+	uint32_t i, j, k, n;
+	uint32_t *del;
+	const struct rte_acl_ctx *mctx;
+	const struct rte_acl_rule *r;
+
+	mctx = upd->view->main;
+
+	if (upd->num_add > max)
+		return UINT32_MAX;
+
+	memcpy(dst, upd->add_rules, (size_t)upd->num_add * ctx->rule_sz);
+	n = upd->num_add;
+
+	if (upd->num_main_del == 0)
+		return n;
+
+	del = rte_malloc(NULL, upd->num_main_del * sizeof(del[0]), 0);
+	if (del == NULL)
+		return UINT32_MAX;
+
+	for (i = 0, k = 0; i != mctx->num_rules; i++) {
+		if (upd->main_del[i] != 0)
+			del[k++] = i;
+	}
+
+	for (i = 0; i != mctx->num_rules && n != UINT32_MAX; i++) {
+
+		if (upd->main_del[i] != 0)
+			continue;
+
+		r = acl_rule_at(mctx->rules, ctx->rule_sz, i);
+		for (j = 0; j != k; j++) {
+			if (acl_rule_overlap(&ctx->config, r,
+					acl_rule_at(mctx->rules, ctx->rule_sz,
+					del[j])))
+				break;
+		}
+
+		if (j == k)
+			continue;
+		else if (n == max)
+			n = UINT32_MAX;
+		else {
+			memcpy(dst + (size_t)n * ctx->rule_sz, r,
+				ctx->rule_sz);
+			n++;
+		}
+	}
+
+	rte_free(del);
+	return n;
+}
+
+/*
+ * Rebuild main context from all alive rules.
+ */
+static int
+acl_update_commit_full(struct rte_acl_ctx *ctx, struct acl_update *upd)
+{
+	int32_t rc;
+	uint32_t n;
+	struct acl_update_view *nv;
+	struct rte_acl_ctx *mctx;
+	struct acl_update_rule *oidx;
+	uint8_t *odel;
+
+	n = acl_update_copy_alive(ctx, upd, ctx->rules);
+	ctx->num_rules = n;
+
+	nv = rte_zmalloc_socket(ctx->name, sizeof(*nv), 0, ctx->socket_id);
+	if (nv == NULL)
+		return -ENOMEM;
+
+	mctx = acl_update_ctx_build(ctx, ctx->rules, n, ctx->max_rules);
+	if (mctx == NULL) {
+		rte_free(nv);
+		return -rte_errno;
+	}
+
+	/* index the new main rules, keep the old index in case of failure. */
+	oidx = upd->main_idx;
+	odel = upd->main_del;
+	upd->main_idx = NULL;
+	upd->main_del = NULL;
+
+	rc = acl_update_main_index(upd, mctx);
+	if (rc != 0) {
+		upd->main_idx = oidx;
+		upd->main_del = odel;
+		acl_update_ctx_free(mctx);
+		rte_free(nv);
+		return rc;
+	}
+
+	rte_free(oidx);
+	rte_free(odel);
+
+	nv->main = mctx;
+	acl_update_publish(upd, nv);
+
+	upd->num_add = 0;
+	upd->num_delta = 0;
+	return 0;
+}
+
+int
+rte_acl_update_commit(struct rte_acl_ctx *ctx)
+{
+	uint32_t i, n, num_main;
+	struct acl_update *upd;
+	struct acl_update_view *nv;
+	const struct rte_acl_rule *r;
+	uint8_t *rules;
+
+	if (ctx == NULL || ctx->upd == NULL)
+		return -EINVAL;
+
+	upd = ctx->upd;
+
+	rules = rte_malloc(NULL, (size_t)(upd->max_delta + 1) * ctx->rule_sz,
+		0);
+	if (rules == NULL)
+		return -ENOMEM;
+
+	n = acl_update_collect_delta(ctx, upd, rules, upd->max_delta);
+	if (n == UINT32_MAX) {
+		rte_free(rules);
+		return acl_update_commit_full(ctx, upd);
+	}
+
+	nv = rte_zmalloc_socket(ctx->name, sizeof(*nv), 0, ctx->socket_id);
+	if (nv == NULL) {
+		rte_free(rules);
+		return -ENOMEM;
+	}
+
+	nv->main = upd->view->main;
+	nv->num_del = upd->num_main_del;
+
+	if (n != 0) {
+		nv->delta = acl_update_ctx_build(ctx, rules, n, n);
+		if (nv->delta == NULL) {
+			rte_free(rules);
+			rte_free(nv);
+			return -rte_errno;
+		}
+	}
+	rte_free(rules);
+
+	/* keep context rules in sync with the alive ones. */
+	ctx->num_rules = acl_update_copy_alive(ctx, upd, ctx->rules);
+
+	/* results need to be merged if something was added or deleted. */
+	if (n != 0 || nv->num_del != 0) {
+		nv->num_alive = ctx->num_rules;
+		nv->alive = rte_malloc_socket(ctx->name,
+			(nv->num_alive + 1) * sizeof(nv->alive[0]), 0,
+			ctx->socket_id);
+		if (nv->alive == NULL) {
+			acl_update_view_free(nv);
+			return -ENOMEM;
+		}
+
+		/* alive main rules go first, see acl_update_copy_alive(). */
+		num_main = nv->main->num_rules - upd->num_main_del;
+		for (i = 0; i != nv->num_alive; i++) {
+			r = acl_rule_at(ctx->rules, ctx->rule_sz, i);
+			nv->alive[i].userdata = r->data.userdata;
+			nv->alive[i].priority = r->data.priority;
+			nv->alive[i].main = (i < num_main);
+		}
+		qsort(nv->alive, nv->num_alive, sizeof(nv->alive[0]),
+			acl_update_rule_cmp);
+	}
+
+	acl_update_publish(upd, nv);
+	upd->num_delta = n;
+	return 0;
+}
+
+/*
+ * Merge delta results into the main ones.
+ */
+static inline void
+acl_update_merge(const struct acl_update_view *view, uint32_t *results,
+	const uint32_t *delta, uint32_t num)
+{
+	uint32_t i;
+	const struct acl_update_rule *rm, *rd;
+
+	for (i = 0; i != num; i++) {
+
+		if (results[i] == 0) {
+			results[i] = delta[i];
+			continue;
+		}
+
+		/* fast path: main rule can't be deleted or outranked. */
+		if (view->num_del == 0 && delta[i] == 0)
+			continue;
+
+		rm = acl_update_rule_find(view->alive, view->num_alive,
+			results[i]);
+
+		/*
+		 * main rule was deleted (and maybe re-added with the same
+		 * userdata), delta knows the right answer.
+		 */
+		if (rm == NULL || rm->main == 0) {
+			results[i] = delta[i];
+			continue;
+		}
+
+		if (delta[i] != 0) {
+			rd = acl_update_rule_find(view->alive,
+				view->num_alive, delta[i]);
+			if (rd != NULL && rd->priority > rm->priority)
+				results[i] = delta[i];
+		}
+	}
+}
+
+int
+acl_update_classify(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories,
+	rte_acl_classify_t classify)
+{
+	int32_t rc;
+	uint32_t i, n;
+	const struct acl_update_view *view;
+	uint32_t delta[ACL_UPDATE_BURST * RTE_ACL_MAX_CATEGORIES];
+
+	view = __atomic_load_n(&ctx->upd->view, __ATOMIC_ACQUIRE);
+
+	rc = classify(view->main, data, results, num, categories);
+	if (rc != 0 || view->alive == NULL)
+		return rc;
+
+	/* only deletions, no rules to search in delta. */
+	if (view->delta == NULL)
+		memset(delta, 0, sizeof(delta));
+
+	for (i = 0; i < num; i += n) {
+		n = RTE_MIN(num - i, (uint32_t)ACL_UPDATE_BURST);
+		if (view->delta != NULL) {
+			rc = classify(view->delta, data + i, delta, n,
+				categories);
+			if (rc != 0)
+				return rc;
+		}
+		acl_update_merge(view, results + i * categories, delta,
+			n * categories);
+	}
+
+	return 0;
+}
+
+void
+acl_update_dump(const struct rte_acl_ctx *ctx)
+{
+	const struct acl_update *upd;
+
+	upd = ctx->upd;
+	if (upd == NULL)
+		return;
+
+	printf("  update: main_rules=%"PRIu32", deleted=%"PRIu32
+		", added=%"PRIu32", delta_rules=%"PRIu32
+		", max_delta_rules=%"PRIu32"\n",
+		upd->view->main->num_rules, upd->num_main_del, upd->num_add,
+		upd->num_delta, upd->max_delta);
+	printf("  update: main num_tries=%"PRIu32", mem_sz=%zu\n",
+		upd->view->main->num_tries, upd->view->main->mem_sz);
+}
@@ -16,6 +16,22 @@ static struct rte_tailq_elem rte_acl_tailq = {
 };
 EAL_REGISTER_TAILQ(rte_acl_tailq)
 
+#ifndef CC_AVX512_SUPPORT
+/*
+ * If the compiler doesn't support AVX512 instructions,
+ * then the dummy one would be used instead for AVX512 classify method.
+ */
+int
+rte_acl_classify_avx512(__rte_unused const struct rte_acl_ctx *ctx,
+	__rte_unused const uint8_t **data,
+	__rte_unused uint32_t *results,
+	__rte_unused uint32_t num,
+	__rte_unused uint32_t categories)
+{
+	return -ENOTSUP;
+}
+#endif
+
 #ifndef RTE_ARCH_X86
 #ifndef CC_AVX2_SUPPORT
 /*
@@ -77,6 +93,7 @@ static const rte_acl_classify_t classify_fns[] = {
 	[RTE_ACL_CLASSIFY_AVX2] = rte_acl_classify_avx2,
 	[RTE_ACL_CLASSIFY_NEON] = rte_acl_classify_neon,
 	[RTE_ACL_CLASSIFY_ALTIVEC] = rte_acl_classify_altivec,
+	[RTE_ACL_CLASSIFY_AVX512] = rte_acl_classify_avx512,
 };
 
 /* by default, use always available scalar code path. */
@@ -89,12 +106,70 @@ rte_acl_set_default_classify(enum rte_acl_classify_alg alg)
 	rte_acl_default_classify = alg;
 }
 
+/*
+ * Check that vector classify method can be used:
+ * the compiler supports it and the target cpu has the required ISA.
+ */
+static int
+acl_check_alg(enum rte_acl_classify_alg alg)
+{
+	if (alg == RTE_ACL_CLASSIFY_NEON) {
+#if defined(RTE_ARCH_ARM64)
+		return 0;
+#elif defined(RTE_ARCH_ARM)
+		if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_NEON))
+			return 0;
+#endif
+		return -ENOTSUP;
+	}
+
+	if (alg == RTE_ACL_CLASSIFY_ALTIVEC) {
+#ifdef RTE_ARCH_PPC_64
+		return 0;
+#endif
+		return -ENOTSUP;
+	}
+
+	if (alg == RTE_ACL_CLASSIFY_AVX512) {
+#ifdef CC_AVX512_SUPPORT
+		if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+				rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW))
+			return 0;
+#endif
+		return -ENOTSUP;
+	}
+
+	if (alg == RTE_ACL_CLASSIFY_AVX2) {
+#ifdef CC_AVX2_SUPPORT
+		if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
+			return 0;
+#endif
+		return -ENOTSUP;
+	}
+
+	if (alg == RTE_ACL_CLASSIFY_SSE) {
+#ifdef RTE_ARCH_X86
+		if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE4_1))
+			return 0;
+#endif
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
 extern int
 rte_acl_set_ctx_classify(struct rte_acl_ctx *ctx, enum rte_acl_classify_alg alg)
 {
+	int rc;
+
 	if (ctx == NULL || (uint32_t)alg >= RTE_DIM(classify_fns))
 		return -EINVAL;
 
+	rc = acl_check_alg(alg);
+	if (rc != 0)
+		return rc;
+
 	ctx->alg = alg;
 	return 0;
 }
@@ -104,6 +179,9 @@ rte_acl_set_ctx_classify(struct rte_acl_ctx *ctx, enum rte_acl_classify_alg alg)
  * Note that CLASSIFY_AVX2 should be set as a default only
  * if both conditions are met:
  * at build time compiler supports AVX2 and target cpu supports AVX2.
+ * CLASSIFY_AVX512 is never selected by default, as heavy use of 512-bit
+ * instructions can lower the core frequency for the rest of the workload;
+ * it has to be requested explicitly via rte_acl_set_ctx_classify().
  */
 RTE_INIT(rte_acl_init)
 {
@@ -139,6 +217,10 @@ rte_acl_classify_alg(const struct rte_acl_ctx *ctx, const uint8_t **data,
 			((RTE_ACL_RESULTS_MULTIPLIER - 1) & categories) != 0)
 		return -EINVAL;
 
+	if (unlikely(ctx->upd != NULL))
+		return acl_update_classify(ctx, data, results, num,
+			categories, classify_fns[alg]);
+
 	return classify_fns[alg](ctx, data, results, num, categories);
 }
 
@@ -201,6 +283,7 @@ rte_acl_free(struct rte_acl_ctx *ctx)
 
 	rte_mcfg_tailq_write_unlock();
 
+	acl_update_free(ctx);
 	rte_free(ctx->mem);
 	rte_free(ctx);
 	rte_free(te);
@@ -291,7 +374,7 @@ acl_add_rules(struct rte_acl_ctx *ctx, const void *rules, uint32_t num)
 	return 0;
 }
 
-static int
+int
 acl_check_rule(const struct rte_acl_rule_data *rd)
 {
 	if ((RTE_LEN2MASK(RTE_ACL_MAX_CATEGORIES, typeof(rd->category_mask)) &
@@ -366,6 +449,7 @@ rte_acl_dump(const struct rte_acl_ctx *ctx)
 	printf("  num_rules=%"PRIu32"\n", ctx->num_rules);
 	printf("  num_categories=%"PRIu32"\n", ctx->num_categories);
 	printf("  num_tries=%"PRIu32"\n", ctx->num_tries);
+	acl_update_dump(ctx);
 }
 
 /*
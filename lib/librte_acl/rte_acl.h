@@ -12,6 +12,8 @@
  */
 
 #include <rte_acl_osdep.h>
+#include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -231,6 +233,125 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg);
 void
 rte_acl_reset(struct rte_acl_ctx *ctx);
 
+/** Default max number of rules in the delta of incremental updates. */
+#define RTE_ACL_UPDATE_DELTA_DEF	1024
+
+/**
+ * Incremental updates configuration.
+ */
+struct rte_acl_update_config {
+	struct rte_rcu_qsbr *v;
+	/**< RCU QSBR variable the classifying threads report to.
+	 * NULL if updates never run concurrently with classification.
+	 */
+	uint32_t max_delta_rules;
+	/**< Number of rules in the delta above which the whole
+	 * context is rebuilt on commit. 0 for RTE_ACL_UPDATE_DELTA_DEF.
+	 */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enable incremental rule updates for an already built ACL context.
+ * Once enabled, rules can be added and deleted with
+ * rte_acl_update_add_rules() and rte_acl_update_del_rules(), and made
+ * visible to rte_acl_classify() and rte_acl_classify_alg() with
+ * rte_acl_update_commit(), without rebuilding the whole context.
+ * The userdata of the rules is used to identify them: it has to be
+ * unique and non zero for every rule of the context.
+ * Calling rte_acl_build() or rte_acl_reset() disables incremental updates.
+ * This function is not multi-thread safe.
+ *
+ * @param ctx
+ *   ACL context, built with rte_acl_build().
+ * @param cfg
+ *   Incremental updates configuration.
+ * @return
+ *   - -EINVAL if the parameters are invalid or the context is not built.
+ *   - -EEXIST if the userdata of the rules is not unique or zero.
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_update_enable(struct rte_acl_ctx *ctx,
+	const struct rte_acl_update_config *cfg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Stage rules to be added to an ACL context with incremental updates
+ * enabled. The rules are not searched until rte_acl_update_commit().
+ * Only one thread is allowed to update the context at a time.
+ *
+ * @param ctx
+ *   ACL context to add rules to.
+ * @param rules
+ *   Array of rules to add.
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -EEXIST if a rule with the same userdata is already present.
+ *   - -ENOMEM if there is no space in the ACL context for these rules.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_update_add_rules(struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Stage rules to be deleted from an ACL context with incremental updates
+ * enabled. The rules are still searched until rte_acl_update_commit().
+ * Only one thread is allowed to update the context at a time.
+ *
+ * @param ctx
+ *   ACL context to delete rules from.
+ * @param userdata
+ *   Array of userdata of the rules to delete.
+ * @param num
+ *   Number of elements in the userdata array.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOENT if one of the rules is not present, nothing is deleted.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_update_del_rules(struct rte_acl_ctx *ctx, const uint32_t userdata[],
+	uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Make staged rule additions and deletions visible to the classifying
+ * threads. Only the delta is built, unless it has more rules than
+ * configured, in which case the context is rebuilt from all the rules.
+ * The new run-time structures are published atomically. If an RCU QSBR
+ * variable was configured, the function waits for the classifying
+ * threads to go through a quiescent state before freeing the old ones.
+ * Only one thread is allowed to update the context at a time.
+ *
+ * @param ctx
+ *   ACL context to commit updates for.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - Negative error code if the build failed, staged updates are kept.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_update_commit(struct rte_acl_ctx *ctx);
+
 /**
  *  Available implementations of ACL classify.
  */
@@ -241,6 +362,7 @@ enum rte_acl_classify_alg {
 	RTE_ACL_CLASSIFY_AVX2 = 3,    /**< requires AVX2 support. */
 	RTE_ACL_CLASSIFY_NEON = 4,    /**< requires NEON support. */
 	RTE_ACL_CLASSIFY_ALTIVEC = 5,    /**< requires ALTIVEC support. */
+	RTE_ACL_CLASSIFY_AVX512 = 6,  /**< requires AVX512F/BW support. */
 	RTE_ACL_CLASSIFY_NUM          /* should always be the last one. */
 };
 
@@ -326,10 +448,12 @@ rte_acl_classify_alg(const struct rte_acl_ctx *ctx,
  *   ACL context to change classify function for.
  * @param alg
  *   New default classify algorithm for given ACL context.
- *   It is the caller responsibility to ensure that the value refers to the
- *   existing algorithm, and that it could be run on the given CPU.
+ *   The function checks that the algorithm is supported by the build
+ *   and could be run on the given CPU.
  * @return
  *   - -EINVAL if the parameters are invalid.
+ *   - -ENOTSUP if the requested method is not supported by the build
+ *     or by the running CPU.
  *   - Zero if operation completed successfully.
  */
 extern int
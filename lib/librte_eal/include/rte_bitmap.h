@@ -43,6 +43,13 @@ extern "C" {
 #include <rte_branch_prediction.h>
 #include <rte_prefetch.h>
 
+#if RTE_CACHE_LINE_SIZE == 64 && \
+	(defined(RTE_MACHINE_CPUFLAG_AVX512F) || \
+	 defined(RTE_MACHINE_CPUFLAG_AVX2))
+#include <rte_vect.h>
+#define RTE_BITMAP_SCAN_VECTOR
+#endif
+
 /* Slab */
 #define RTE_BITMAP_SLAB_BIT_SIZE                 64
 #define RTE_BITMAP_SLAB_BIT_SIZE_LOG2            6
@@ -508,6 +515,65 @@ __rte_bitmap_scan_read_init(struct rte_bitmap *bmp)
 	rte_prefetch1((void *)(bmp->array2 + bmp->index2 + 8));
 }
 
+#ifdef RTE_BITMAP_SCAN_VECTOR
+
+/* Mask of the non-zero slabs of an array2 cache line, one bit per slab */
+static inline uint32_t
+__rte_bitmap_cl_nonzero_mask(const uint64_t *cl2)
+{
+#ifdef RTE_MACHINE_CPUFLAG_AVX512F
+	__m512i v = _mm512_load_si512((const void *)cl2);
+
+	return _mm512_test_epi64_mask(v, v);
+#else
+	__m256i zero = _mm256_setzero_si256();
+	__m256i lo = _mm256_load_si256((const __m256i *)cl2);
+	__m256i hi = _mm256_load_si256((const __m256i *)(cl2 + 4));
+	uint32_t zero_lo, zero_hi;
+
+	zero_lo = _mm256_movemask_pd(
+		_mm256_castsi256_pd(_mm256_cmpeq_epi64(lo, zero)));
+	zero_hi = _mm256_movemask_pd(
+		_mm256_castsi256_pd(_mm256_cmpeq_epi64(hi, zero)));
+
+	return ~(zero_lo | (zero_hi << 4)) & RTE_LEN2MASK(8, uint32_t);
+#endif
+}
+
+/*
+ * Same as the scalar version below, but finds the next non-zero slab of the
+ * current array2 cache line with a single vector compare of the whole line.
+ */
+static inline int
+__rte_bitmap_scan_read(struct rte_bitmap *bmp, uint32_t *pos, uint64_t *slab)
+{
+	uint32_t base2, offset2, mask2;
+
+	if (bmp->go2 == 0)
+		return 0;
+
+	offset2 = bmp->index2 & RTE_BITMAP_CL_SLAB_MASK;
+	base2 = bmp->index2 - offset2;
+	mask2 = __rte_bitmap_cl_nonzero_mask(bmp->array2 + base2) &
+		(RTE_LEN2MASK(RTE_BITMAP_CL_SLAB_SIZE, uint32_t) << offset2);
+
+	if (mask2 == 0) {
+		bmp->index2 = base2 + RTE_BITMAP_CL_SLAB_SIZE;
+		bmp->go2 = 0;
+		return 0;
+	}
+
+	bmp->index2 = base2 + rte_bsf32(mask2);
+	*pos = bmp->index2 << RTE_BITMAP_SLAB_BIT_SIZE_LOG2;
+	*slab = bmp->array2[bmp->index2];
+
+	bmp->index2 ++;
+	bmp->go2 = bmp->index2 & RTE_BITMAP_CL_SLAB_MASK;
+	return 1;
+}
+
+#else
+
 static inline int
 __rte_bitmap_scan_read(struct rte_bitmap *bmp, uint32_t *pos, uint64_t *slab)
 {
@@ -529,6 +595,8 @@ __rte_bitmap_scan_read(struct rte_bitmap *bmp, uint32_t *pos, uint64_t *slab)
 	return 0;
 }
 
+#endif /* RTE_BITMAP_SCAN_VECTOR */
+
 /**
  * Bitmap scan (with automatic wrap-around)
  *
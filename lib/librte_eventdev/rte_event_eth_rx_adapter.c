@@ -14,7 +14,9 @@
 #include <rte_ethdev.h>
 #include <rte_log.h>
 #include <rte_malloc.h>
+#include <rte_mempool.h>
 #include <rte_service_component.h>
+#include <rte_tailq.h>
 #include <rte_thash.h>
 #include <rte_interrupts.h>
 
@@ -59,6 +61,28 @@ struct eth_rx_poll_entry {
 	uint16_t eth_rx_qid;
 };
 
+/* Event vector aggregation state, instance per vectorized Rx queue */
+struct eth_rx_vector_data {
+	TAILQ_ENTRY(eth_rx_vector_data) next;
+	/* Eth port and Rx queue the vector is filled from */
+	uint16_t port;
+	uint16_t queue;
+	/* Maximum number of mbufs in a vector */
+	uint16_t max_vector_count;
+	/* Event template of the vector events */
+	uint64_t event;
+	/* Timestamp at which the pending vector was allocated */
+	uint64_t ts;
+	/* Cycles a vector may stay pending before it is enqueued */
+	uint64_t vector_timeout_ticks;
+	/* Pool the vectors are allocated from */
+	struct rte_mempool *vector_pool;
+	/* Pending vector, NULL if none */
+	struct rte_event_vector *vector_ev;
+} __rte_cache_aligned;
+
+TAILQ_HEAD(eth_rx_vector_data_list, eth_rx_vector_data);
+
 /* Instance per adapter */
 struct rte_eth_event_enqueue_buffer {
 	/* Count of events in this buffer */
@@ -67,37 +91,62 @@ struct rte_eth_event_enqueue_buffer {
 	struct rte_event events[ETH_EVENT_BUFFER_SIZE];
 };
 
-struct rte_event_eth_rx_adapter {
-	/* RSS key */
-	uint8_t rss_key_be[RSS_KEY_SIZE];
-	/* Event device identifier */
-	uint8_t eventdev_id;
-	/* Per ethernet device structure */
-	struct eth_device_info *eth_devices;
+/* Subset of the adapter Rx queues serviced by one service invocation */
+struct eth_rx_partition {
+	/* Lock to serialize config updates with service function */
+	rte_spinlock_t lock;
 	/* Event port identifier */
 	uint8_t event_port_id;
-	/* Lock to serialize config updates with service function */
-	rte_spinlock_t rx_lock;
 	/* Max mbufs processed in any service function invocation */
 	uint32_t max_nb_rx;
 	/* Receive queues that need to be polled */
 	struct eth_rx_poll_entry *eth_rx_poll;
-	/* Size of the eth_rx_poll array */
-	uint16_t num_rx_polled;
 	/* Weighted round robin schedule */
 	uint32_t *wrr_sched;
 	/* wrr_sched[] size */
 	uint32_t wrr_len;
 	/* Next entry in wrr[] to begin polling */
 	uint32_t wrr_pos;
+	/* Sum of the servicing weights of the polled queues */
+	uint32_t load;
+	/* Poll arrays allocated by a queue add/del, installed by
+	 * rxa_calc_wrr_sequence()
+	 */
+	struct eth_rx_poll_entry *new_rx_poll;
+	uint32_t *new_wrr_sched;
 	/* Event burst buffer */
 	struct rte_eth_event_enqueue_buffer event_enqueue_buffer;
-	/* Per adapter stats */
+	/* Per partition stats */
 	struct rte_event_eth_rx_adapter_stats stats;
 	/* Block count, counts up to BLOCK_CNT_THRESHOLD */
 	uint16_t enq_block_count;
 	/* Block start ts */
 	uint64_t rx_enq_block_start_ts;
+	/* Rx queues with a pending event vector */
+	struct eth_rx_vector_data_list vector_list;
+	/* Timestamp of the last pending vector expiry check */
+	uint64_t prev_expiry_ts;
+	/* Smallest vector timeout of the vectorized Rx queues */
+	uint64_t vector_tmo_ticks;
+} __rte_cache_aligned;
+
+struct rte_event_eth_rx_adapter {
+	/* RSS key */
+	uint8_t rss_key_be[RSS_KEY_SIZE];
+	/* Event device identifier */
+	uint8_t eventdev_id;
+	/* Per ethernet device structure */
+	struct eth_device_info *eth_devices;
+	/* Rx queue partitions, each one with its own event port */
+	struct eth_rx_partition *parts;
+	/* Size of the parts array */
+	uint16_t nb_parts;
+	/* Partition the next service invocation starts looking from */
+	uint16_t next_part;
+	/* Count of poll mode Rx queues */
+	uint16_t num_rx_polled;
+	/* sum(wrr(q)) for all polled queues */
+	uint32_t wrr_len;
 	/* epoll fd used to wait for Rx interrupts */
 	int epd;
 	/* Num of interrupt driven interrupt queues */
@@ -201,6 +250,10 @@ struct eth_rx_queue_info {
 	uint16_t wt;		/* Polling weight */
 	uint32_t flow_id_mask;	/* Set to ~0 if app provides flow id else 0 */
 	uint64_t event;
+	int vector_requested;	/* Added with the EVENT_VECTOR flag */
+	int ena_vector;		/* Event vectorization configured */
+	uint16_t part;		/* Index of the servicing partition */
+	struct eth_rx_vector_data vector_data;
 };
 
 static struct rte_event_eth_rx_adapter **event_eth_rx_adapter;
@@ -494,7 +547,7 @@ rxa_alloc_poll(struct rte_event_eth_rx_adapter *rx_adapter,
 {
 	size_t len;
 
-	len  = RTE_ALIGN(num_rx_polled * sizeof(*rx_adapter->eth_rx_poll),
+	len  = RTE_ALIGN(num_rx_polled * sizeof(struct eth_rx_poll_entry),
 							RTE_CACHE_LINE_SIZE);
 	return  rte_zmalloc_socket(rx_adapter->mem_name,
 				len,
@@ -510,7 +563,7 @@ rxa_alloc_wrr(struct rte_event_eth_rx_adapter *rx_adapter, int nb_wrr)
 {
 	size_t len;
 
-	len = RTE_ALIGN(nb_wrr * sizeof(*rx_adapter->wrr_sched),
+	len = RTE_ALIGN(nb_wrr * sizeof(uint32_t),
 			RTE_CACHE_LINE_SIZE);
 	return  rte_zmalloc_socket(rx_adapter->mem_name,
 				len,
@@ -518,40 +571,57 @@ rxa_alloc_wrr(struct rte_event_eth_rx_adapter *rx_adapter, int nb_wrr)
 				rx_adapter->socket_id);
 }
 
+/* Free the poll arrays allocated by rxa_alloc_poll_arrays() */
+static void
+rxa_free_poll_arrays(struct rte_event_eth_rx_adapter *rx_adapter)
+{
+	struct eth_rx_partition *part;
+	uint16_t i;
+
+	for (i = 0; i < rx_adapter->nb_parts; i++) {
+		part = &rx_adapter->parts[i];
+		rte_free(part->new_rx_poll);
+		rte_free(part->new_wrr_sched);
+		part->new_rx_poll = NULL;
+		part->new_wrr_sched = NULL;
+	}
+}
+
+/* Allocate the poll arrays of every partition, since the queues may be
+ * spread across partitions in any way, each array is sized for the total
+ * number of polled queues
+ */
 static int
 rxa_alloc_poll_arrays(struct rte_event_eth_rx_adapter *rx_adapter,
 		uint32_t nb_poll,
-		uint32_t nb_wrr,
-		struct eth_rx_poll_entry **rx_poll,
-		uint32_t **wrr_sched)
+		uint32_t nb_wrr)
 {
+	struct eth_rx_partition *part;
+	uint16_t i;
 
-	if (nb_poll == 0) {
-		*rx_poll = NULL;
-		*wrr_sched = NULL;
+	if (nb_poll == 0)
 		return 0;
-	}
 
-	*rx_poll = rxa_alloc_poll(rx_adapter, nb_poll);
-	if (*rx_poll == NULL) {
-		*wrr_sched = NULL;
-		return -ENOMEM;
-	}
-
-	*wrr_sched = rxa_alloc_wrr(rx_adapter, nb_wrr);
-	if (*wrr_sched == NULL) {
-		rte_free(*rx_poll);
-		return -ENOMEM;
+	for (i = 0; i < rx_adapter->nb_parts; i++) {
+		part = &rx_adapter->parts[i];
+		part->new_rx_poll = rxa_alloc_poll(rx_adapter, nb_poll);
+		part->new_wrr_sched = rxa_alloc_wrr(rx_adapter, nb_wrr);
+		if (part->new_rx_poll == NULL || part->new_wrr_sched == NULL) {
+			rxa_free_poll_arrays(rx_adapter);
+			return -ENOMEM;
+		}
 	}
 	return 0;
 }
 
-/* Precalculate WRR polling sequence for all queues in rx_adapter */
+/* Precalculate WRR polling sequence for the queues of a partition */
 static void
-rxa_calc_wrr_sequence(struct rte_event_eth_rx_adapter *rx_adapter,
-		struct eth_rx_poll_entry *rx_poll,
-		uint32_t *rx_wrr)
+rxa_calc_part_wrr_sequence(struct rte_event_eth_rx_adapter *rx_adapter,
+		uint16_t part_id)
 {
+	struct eth_rx_partition *part = &rx_adapter->parts[part_id];
+	struct eth_rx_poll_entry *rx_poll = part->new_rx_poll;
+	uint32_t *rx_wrr = part->new_wrr_sched;
 	uint16_t d;
 	uint16_t q;
 	unsigned int i;
@@ -579,13 +649,13 @@ rxa_calc_wrr_sequence(struct rte_event_eth_rx_adapter *rx_adapter,
 			continue;
 		if (dev_info->internal_event_port)
 			continue;
-		dev_info->wrr_len = 0;
 		for (q = 0; q < nb_rx_queues; q++) {
 			struct eth_rx_queue_info *queue_info =
 				&dev_info->rx_queue[q];
 			uint16_t wt;
 
-			if (!rxa_polled_queue(dev_info, q))
+			if (!rxa_polled_queue(dev_info, q) ||
+			    queue_info->part != part_id)
 				continue;
 			wt = queue_info->wt;
 			rx_poll[poll_q].eth_dev_id = d;
@@ -606,6 +676,91 @@ rxa_calc_wrr_sequence(struct rte_event_eth_rx_adapter *rx_adapter,
 				     rx_poll, max_wt, gcd, prev);
 		prev = rx_wrr[i];
 	}
+	part->wrr_len = max_wrr_pos;
+}
+
+/* Precalculate WRR polling sequence for all queues in rx_adapter and
+ * install the poll arrays allocated by rxa_alloc_poll_arrays()
+ */
+static void
+rxa_calc_wrr_sequence(struct rte_event_eth_rx_adapter *rx_adapter)
+{
+	struct eth_rx_partition *part;
+	uint16_t d;
+	uint16_t i;
+
+	RTE_ETH_FOREACH_DEV(d)
+		rx_adapter->eth_devices[d].wrr_len = 0;
+
+	for (i = 0; i < rx_adapter->nb_parts; i++) {
+		part = &rx_adapter->parts[i];
+		part->wrr_len = 0;
+		rxa_calc_part_wrr_sequence(rx_adapter, i);
+
+		rte_free(part->eth_rx_poll);
+		rte_free(part->wrr_sched);
+		part->eth_rx_poll = part->new_rx_poll;
+		part->wrr_sched = part->new_wrr_sched;
+		part->new_rx_poll = NULL;
+		part->new_wrr_sched = NULL;
+		/* The previous position may be past the new sequence */
+		part->wrr_pos = 0;
+	}
+}
+
+/* Return the partition with the lowest sum of polled queue weights */
+static uint16_t
+rxa_part_select(struct rte_event_eth_rx_adapter *rx_adapter)
+{
+	struct eth_rx_partition *parts = rx_adapter->parts;
+	struct eth_device_info *dev_info;
+	uint16_t min = 0;
+	uint16_t d;
+	uint16_t q;
+	uint16_t i;
+
+	if (rx_adapter->nb_parts == 1)
+		return 0;
+
+	for (i = 0; i < rx_adapter->nb_parts; i++)
+		parts[i].load = 0;
+
+	RTE_ETH_FOREACH_DEV(d) {
+		dev_info = &rx_adapter->eth_devices[d];
+		if (dev_info->rx_queue == NULL)
+			continue;
+		for (q = 0; q < dev_info->dev->data->nb_rx_queues; q++) {
+			if (!rxa_polled_queue(dev_info, q))
+				continue;
+			parts[dev_info->rx_queue[q].part].load +=
+						dev_info->rx_queue[q].wt;
+		}
+	}
+
+	for (i = 1; i < rx_adapter->nb_parts; i++)
+		if (parts[i].load < parts[min].load)
+			min = i;
+
+	return min;
+}
+
+/* Acquire the locks of all the partitions, in index order */
+static void
+rxa_lock_parts(struct rte_event_eth_rx_adapter *rx_adapter)
+{
+	uint16_t i;
+
+	for (i = 0; i < rx_adapter->nb_parts; i++)
+		rte_spinlock_lock(&rx_adapter->parts[i].lock);
+}
+
+static void
+rxa_unlock_parts(struct rte_event_eth_rx_adapter *rx_adapter)
+{
+	uint16_t i;
+
+	for (i = 0; i < rx_adapter->nb_parts; i++)
+		rte_spinlock_unlock(&rx_adapter->parts[i].lock);
 }
 
 static inline void
@@ -677,53 +832,54 @@ rxa_do_softrss(struct rte_mbuf *m, const uint8_t *rss_key_be)
 }
 
 static inline int
-rxa_enq_blocked(struct rte_event_eth_rx_adapter *rx_adapter)
+rxa_enq_blocked(struct eth_rx_partition *part)
 {
-	return !!rx_adapter->enq_block_count;
+	return !!part->enq_block_count;
 }
 
 static inline void
-rxa_enq_block_start_ts(struct rte_event_eth_rx_adapter *rx_adapter)
+rxa_enq_block_start_ts(struct eth_rx_partition *part)
 {
-	if (rx_adapter->rx_enq_block_start_ts)
+	if (part->rx_enq_block_start_ts)
 		return;
 
-	rx_adapter->enq_block_count++;
-	if (rx_adapter->enq_block_count < BLOCK_CNT_THRESHOLD)
+	part->enq_block_count++;
+	if (part->enq_block_count < BLOCK_CNT_THRESHOLD)
 		return;
 
-	rx_adapter->rx_enq_block_start_ts = rte_get_tsc_cycles();
+	part->rx_enq_block_start_ts = rte_get_tsc_cycles();
 }
 
 static inline void
-rxa_enq_block_end_ts(struct rte_event_eth_rx_adapter *rx_adapter,
+rxa_enq_block_end_ts(struct eth_rx_partition *part,
 		    struct rte_event_eth_rx_adapter_stats *stats)
 {
 	if (unlikely(!stats->rx_enq_start_ts))
 		stats->rx_enq_start_ts = rte_get_tsc_cycles();
 
-	if (likely(!rxa_enq_blocked(rx_adapter)))
+	if (likely(!rxa_enq_blocked(part)))
 		return;
 
-	rx_adapter->enq_block_count = 0;
-	if (rx_adapter->rx_enq_block_start_ts) {
+	part->enq_block_count = 0;
+	if (part->rx_enq_block_start_ts) {
 		stats->rx_enq_end_ts = rte_get_tsc_cycles();
 		stats->rx_enq_block_cycles += stats->rx_enq_end_ts -
-		    rx_adapter->rx_enq_block_start_ts;
-		rx_adapter->rx_enq_block_start_ts = 0;
+		    part->rx_enq_block_start_ts;
+		part->rx_enq_block_start_ts = 0;
 	}
 }
 
 /* Enqueue buffered events to event device */
 static inline uint16_t
-rxa_flush_event_buffer(struct rte_event_eth_rx_adapter *rx_adapter)
+rxa_flush_event_buffer(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_partition *part)
 {
 	struct rte_eth_event_enqueue_buffer *buf =
-	    &rx_adapter->event_enqueue_buffer;
-	struct rte_event_eth_rx_adapter_stats *stats = &rx_adapter->stats;
+	    &part->event_enqueue_buffer;
+	struct rte_event_eth_rx_adapter_stats *stats = &part->stats;
 
 	uint16_t n = rte_event_enqueue_new_burst(rx_adapter->eventdev_id,
-					rx_adapter->event_port_id,
+					part->event_port_id,
 					buf->events,
 					buf->count);
 	if (n != buf->count) {
@@ -733,8 +889,8 @@ rxa_flush_event_buffer(struct rte_event_eth_rx_adapter *rx_adapter)
 		stats->rx_enq_retry++;
 	}
 
-	n ? rxa_enq_block_end_ts(rx_adapter, stats) :
-		rxa_enq_block_start_ts(rx_adapter);
+	n ? rxa_enq_block_end_ts(part, stats) :
+		rxa_enq_block_start_ts(part);
 
 	buf->count -= n;
 	stats->rx_enq_count += n;
@@ -742,8 +898,68 @@ rxa_flush_event_buffer(struct rte_event_eth_rx_adapter *rx_adapter)
 	return n;
 }
 
+/* Move the pending vector of a queue to the event buffer */
+static inline void
+rxa_vector_enq(struct eth_rx_partition *part,
+	struct eth_rx_vector_data *vec,
+	struct rte_event *ev)
+{
+	ev->event = vec->event;
+	ev->vec = vec->vector_ev;
+	vec->vector_ev = NULL;
+	TAILQ_REMOVE(&part->vector_list, vec, next);
+}
+
+static inline uint16_t
+rxa_create_event_vector(struct eth_rx_partition *part,
+		struct eth_rx_queue_info *queue_info,
+		struct rte_event *ev,
+		struct rte_mbuf **mbufs,
+		uint16_t num)
+{
+	struct eth_rx_vector_data *vec = &queue_info->vector_data;
+	struct rte_event_vector *vector;
+	uint16_t filled = 0;
+	uint16_t space;
+	uint16_t sz;
+
+	while (num) {
+		if (vec->vector_ev == NULL) {
+			if (unlikely(rte_mempool_get(vec->vector_pool,
+					(void **)&vec->vector_ev) < 0)) {
+				vec->vector_ev = NULL;
+				rte_pktmbuf_free_bulk(mbufs, num);
+				part->stats.rx_dropped += num;
+				break;
+			}
+			vector = vec->vector_ev;
+			vector->nb_elem = 0;
+			vector->port = vec->port;
+			vector->queue = vec->queue;
+			vector->attr_valid = 1;
+			vec->ts = rte_rdtsc();
+			TAILQ_INSERT_TAIL(&part->vector_list, vec, next);
+		}
+
+		vector = vec->vector_ev;
+		space = vec->max_vector_count - vector->nb_elem;
+		sz = RTE_MIN(num, space);
+		memcpy(&vector->mbufs[vector->nb_elem], mbufs,
+		       sz * sizeof(mbufs[0]));
+		vector->nb_elem += sz;
+		mbufs += sz;
+		num -= sz;
+
+		if (vector->nb_elem == vec->max_vector_count)
+			rxa_vector_enq(part, vec, &ev[filled++]);
+	}
+
+	return filled;
+}
+
 static inline void
 rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_partition *part,
 		uint16_t eth_dev_id,
 		uint16_t rx_queue_id,
 		struct rte_mbuf **mbufs,
@@ -755,7 +971,7 @@ rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 	struct eth_rx_queue_info *eth_rx_queue_info =
 					&dev_info->rx_queue[rx_queue_id];
 	struct rte_eth_event_enqueue_buffer *buf =
-					&rx_adapter->event_enqueue_buffer;
+					&part->event_enqueue_buffer;
 	struct rte_event *ev = &buf->events[buf->count];
 	uint64_t event = eth_rx_queue_info->event;
 	uint32_t flow_id_mask = eth_rx_queue_info->flow_id_mask;
@@ -781,6 +997,12 @@ rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 		}
 	}
 
+	if (eth_rx_queue_info->ena_vector) {
+		buf->count += rxa_create_event_vector(part,
+					eth_rx_queue_info, ev, mbufs, num);
+		return;
+	}
+
 	for (i = 0; i < num; i++) {
 		m = mbufs[i];
 
@@ -806,7 +1028,7 @@ rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 		else
 			num = nb_cb;
 		if (dropped)
-			rx_adapter->stats.rx_dropped += dropped;
+			part->stats.rx_dropped += dropped;
 	}
 
 	buf->count += num;
@@ -815,6 +1037,7 @@ rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 /* Enqueue packets from  <port, q>  to event buffer */
 static inline uint32_t
 rxa_eth_rx(struct rte_event_eth_rx_adapter *rx_adapter,
+	struct eth_rx_partition *part,
 	uint16_t port_id,
 	uint16_t queue_id,
 	uint32_t rx_count,
@@ -823,9 +1046,8 @@ rxa_eth_rx(struct rte_event_eth_rx_adapter *rx_adapter,
 {
 	struct rte_mbuf *mbufs[BATCH_SIZE];
 	struct rte_eth_event_enqueue_buffer *buf =
-					&rx_adapter->event_enqueue_buffer;
-	struct rte_event_eth_rx_adapter_stats *stats =
-					&rx_adapter->stats;
+					&part->event_enqueue_buffer;
+	struct rte_event_eth_rx_adapter_stats *stats = &part->stats;
 	uint16_t n;
 	uint32_t nb_rx = 0;
 
@@ -836,7 +1058,7 @@ rxa_eth_rx(struct rte_event_eth_rx_adapter *rx_adapter,
 	 */
 	while (BATCH_SIZE <= (RTE_DIM(buf->events) - buf->count)) {
 		if (buf->count >= BATCH_SIZE)
-			rxa_flush_event_buffer(rx_adapter);
+			rxa_flush_event_buffer(rx_adapter, part);
 
 		stats->rx_poll_count++;
 		n = rte_eth_rx_burst(port_id, queue_id, mbufs, BATCH_SIZE);
@@ -845,14 +1067,15 @@ rxa_eth_rx(struct rte_event_eth_rx_adapter *rx_adapter,
 				*rxq_empty = 1;
 			break;
 		}
-		rxa_buffer_mbufs(rx_adapter, port_id, queue_id, mbufs, n);
+		rxa_buffer_mbufs(rx_adapter, part, port_id, queue_id, mbufs,
+				n);
 		nb_rx += n;
 		if (rx_count + nb_rx > max_rx)
 			break;
 	}
 
 	if (buf->count > 0)
-		rxa_flush_event_buffer(rx_adapter);
+		rxa_flush_event_buffer(rx_adapter, part);
 
 	return nb_rx;
 }
@@ -973,7 +1196,8 @@ rxa_intr_thread(void *arg)
  * mbufs to eventdev
  */
 static inline uint32_t
-rxa_intr_ring_dequeue(struct rte_event_eth_rx_adapter *rx_adapter)
+rxa_intr_ring_dequeue(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_partition *part)
 {
 	uint32_t n;
 	uint32_t nb_rx = 0;
@@ -989,11 +1213,11 @@ rxa_intr_ring_dequeue(struct rte_event_eth_rx_adapter *rx_adapter)
 		&& !rx_adapter->qd_valid)
 		return 0;
 
-	buf = &rx_adapter->event_enqueue_buffer;
+	buf = &part->event_enqueue_buffer;
 	ring_lock = &rx_adapter->intr_ring_lock;
 
 	if (buf->count >= BATCH_SIZE)
-		rxa_flush_event_buffer(rx_adapter);
+		rxa_flush_event_buffer(rx_adapter, part);
 
 	while (BATCH_SIZE <= (RTE_DIM(buf->events) - buf->count)) {
 		struct eth_device_info *dev_info;
@@ -1043,13 +1267,13 @@ rxa_intr_ring_dequeue(struct rte_event_eth_rx_adapter *rx_adapter)
 
 				if (!rxa_intr_queue(dev_info, i))
 					continue;
-				n = rxa_eth_rx(rx_adapter, port, i, nb_rx,
-					rx_adapter->max_nb_rx,
+				n = rxa_eth_rx(rx_adapter, part, port, i,
+					nb_rx, part->max_nb_rx,
 					&rxq_empty);
 				nb_rx += n;
 
 				enq_buffer_full = !rxq_empty && n == 0;
-				max_done = nb_rx > rx_adapter->max_nb_rx;
+				max_done = nb_rx > part->max_nb_rx;
 
 				if (enq_buffer_full || max_done) {
 					dev_info->next_q_idx = i;
@@ -1064,18 +1288,18 @@ rxa_intr_ring_dequeue(struct rte_event_eth_rx_adapter *rx_adapter)
 						RTE_MAX_RXTX_INTR_VEC_ID - 1 :
 						0;
 		} else {
-			n = rxa_eth_rx(rx_adapter, port, queue, nb_rx,
-				rx_adapter->max_nb_rx,
+			n = rxa_eth_rx(rx_adapter, part, port, queue, nb_rx,
+				part->max_nb_rx,
 				&rxq_empty);
 			rx_adapter->qd_valid = !rxq_empty;
 			nb_rx += n;
-			if (nb_rx > rx_adapter->max_nb_rx)
+			if (nb_rx > part->max_nb_rx)
 				break;
 		}
 	}
 
 done:
-	rx_adapter->stats.rx_intr_packets += nb_rx;
+	part->stats.rx_intr_packets += nb_rx;
 	return nb_rx;
 }
 
@@ -1093,7 +1317,8 @@ rxa_intr_ring_dequeue(struct rte_event_eth_rx_adapter *rx_adapter)
  * it.
  */
 static inline uint32_t
-rxa_poll(struct rte_event_eth_rx_adapter *rx_adapter)
+rxa_poll(struct rte_event_eth_rx_adapter *rx_adapter,
+	struct eth_rx_partition *part)
 {
 	uint32_t num_queue;
 	uint32_t nb_rx = 0;
@@ -1101,57 +1326,107 @@ rxa_poll(struct rte_event_eth_rx_adapter *rx_adapter)
 	uint32_t wrr_pos;
 	uint32_t max_nb_rx;
 
-	wrr_pos = rx_adapter->wrr_pos;
-	max_nb_rx = rx_adapter->max_nb_rx;
-	buf = &rx_adapter->event_enqueue_buffer;
+	wrr_pos = part->wrr_pos;
+	max_nb_rx = part->max_nb_rx;
+	buf = &part->event_enqueue_buffer;
 
 	/* Iterate through a WRR sequence */
-	for (num_queue = 0; num_queue < rx_adapter->wrr_len; num_queue++) {
-		unsigned int poll_idx = rx_adapter->wrr_sched[wrr_pos];
-		uint16_t qid = rx_adapter->eth_rx_poll[poll_idx].eth_rx_qid;
-		uint16_t d = rx_adapter->eth_rx_poll[poll_idx].eth_dev_id;
+	for (num_queue = 0; num_queue < part->wrr_len; num_queue++) {
+		unsigned int poll_idx = part->wrr_sched[wrr_pos];
+		uint16_t qid = part->eth_rx_poll[poll_idx].eth_rx_qid;
+		uint16_t d = part->eth_rx_poll[poll_idx].eth_dev_id;
 
 		/* Don't do a batch dequeue from the rx queue if there isn't
 		 * enough space in the enqueue buffer.
 		 */
 		if (buf->count >= BATCH_SIZE)
-			rxa_flush_event_buffer(rx_adapter);
+			rxa_flush_event_buffer(rx_adapter, part);
 		if (BATCH_SIZE > (ETH_EVENT_BUFFER_SIZE - buf->count)) {
-			rx_adapter->wrr_pos = wrr_pos;
+			part->wrr_pos = wrr_pos;
 			return nb_rx;
 		}
 
-		nb_rx += rxa_eth_rx(rx_adapter, d, qid, nb_rx, max_nb_rx,
+		nb_rx += rxa_eth_rx(rx_adapter, part, d, qid, nb_rx, max_nb_rx,
 				NULL);
 		if (nb_rx > max_nb_rx) {
-			rx_adapter->wrr_pos =
-				    (wrr_pos + 1) % rx_adapter->wrr_len;
+			part->wrr_pos = (wrr_pos + 1) % part->wrr_len;
 			break;
 		}
 
-		if (++wrr_pos == rx_adapter->wrr_len)
+		if (++wrr_pos == part->wrr_len)
 			wrr_pos = 0;
 	}
 	return nb_rx;
 }
 
+/* Enqueue the pending vectors that have timed out */
+static void
+rxa_vector_expire(struct rte_event_eth_rx_adapter *rx_adapter,
+	struct eth_rx_partition *part)
+{
+	struct rte_eth_event_enqueue_buffer *buf =
+					&part->event_enqueue_buffer;
+	struct eth_rx_vector_data *vec, *tmp;
+	uint64_t ts;
+
+	ts = rte_rdtsc();
+	if (ts - part->prev_expiry_ts < part->vector_tmo_ticks)
+		return;
+
+	TAILQ_FOREACH_SAFE(vec, &part->vector_list, next, tmp) {
+		if (ts - vec->ts < vec->vector_timeout_ticks)
+			continue;
+		/* Retry on the next invocation if the buffer is full */
+		if (buf->count == ETH_EVENT_BUFFER_SIZE)
+			break;
+		rxa_vector_enq(part, vec, &buf->events[buf->count++]);
+	}
+	part->prev_expiry_ts = ts;
+
+	if (buf->count > 0)
+		rxa_flush_event_buffer(rx_adapter, part);
+}
+
+/* The service may run on several lcores at once, each invocation services
+ * the first partition it can lock starting from a rotating index so that
+ * concurrent invocations spread across the partitions. Interrupt mode
+ * queues are always serviced by partition 0.
+ */
 static int
 rxa_service_func(void *args)
 {
 	struct rte_event_eth_rx_adapter *rx_adapter = args;
 	struct rte_event_eth_rx_adapter_stats *stats;
+	struct eth_rx_partition *part = NULL;
+	uint16_t nb_parts = rx_adapter->nb_parts;
+	uint16_t part_id;
+	uint16_t i;
 
-	if (rte_spinlock_trylock(&rx_adapter->rx_lock) == 0)
+	part_id = __atomic_fetch_add(&rx_adapter->next_part, 1,
+				__ATOMIC_RELAXED) % nb_parts;
+	for (i = 0; i < nb_parts; i++) {
+		if (rte_spinlock_trylock(&rx_adapter->parts[part_id].lock)) {
+			part = &rx_adapter->parts[part_id];
+			break;
+		}
+		if (++part_id == nb_parts)
+			part_id = 0;
+	}
+	if (part == NULL)
 		return 0;
 	if (!rx_adapter->rxa_started) {
-		rte_spinlock_unlock(&rx_adapter->rx_lock);
+		rte_spinlock_unlock(&part->lock);
 		return 0;
 	}
 
-	stats = &rx_adapter->stats;
-	stats->rx_packets += rxa_intr_ring_dequeue(rx_adapter);
-	stats->rx_packets += rxa_poll(rx_adapter);
-	rte_spinlock_unlock(&rx_adapter->rx_lock);
+	if (!TAILQ_EMPTY(&part->vector_list))
+		rxa_vector_expire(rx_adapter, part);
+
+	stats = &part->stats;
+	if (part_id == 0)
+		stats->rx_packets += rxa_intr_ring_dequeue(rx_adapter, part);
+	stats->rx_packets += rxa_poll(rx_adapter, part);
+	rte_spinlock_unlock(&part->lock);
 	return 0;
 }
 
@@ -1584,6 +1859,8 @@ rxa_init_service(struct rte_event_eth_rx_adapter *rx_adapter, uint8_t id)
 	int ret;
 	struct rte_service_spec service;
 	struct rte_event_eth_rx_adapter_conf rx_adapter_conf;
+	struct eth_rx_partition *part;
+	uint16_t i;
 
 	if (rx_adapter->service_inited)
 		return 0;
@@ -1603,15 +1880,19 @@ rxa_init_service(struct rte_event_eth_rx_adapter *rx_adapter, uint8_t id)
 		return ret;
 	}
 
-	ret = rx_adapter->conf_cb(id, rx_adapter->eventdev_id,
-		&rx_adapter_conf, rx_adapter->conf_arg);
-	if (ret) {
-		RTE_EDEV_LOG_ERR("configuration callback failed err = %" PRId32,
-			ret);
-		goto err_done;
+	/* Each partition enqueues through an event port of its own */
+	for (i = 0; i < rx_adapter->nb_parts; i++) {
+		ret = rx_adapter->conf_cb(id, rx_adapter->eventdev_id,
+			&rx_adapter_conf, rx_adapter->conf_arg);
+		if (ret) {
+			RTE_EDEV_LOG_ERR("configuration callback failed err = %"
+				PRId32, ret);
+			goto err_done;
+		}
+		part = &rx_adapter->parts[i];
+		part->event_port_id = rx_adapter_conf.event_port_id;
+		part->max_nb_rx = rx_adapter_conf.max_nb_rx;
 	}
-	rx_adapter->event_port_id = rx_adapter_conf.event_port_id;
-	rx_adapter->max_nb_rx = rx_adapter_conf.max_nb_rx;
 	rx_adapter->service_inited = 1;
 	rx_adapter->epd = INIT_FD;
 	return 0;
@@ -1651,6 +1932,48 @@ rxa_update_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 	}
 }
 
+/* Release the pending vector of a queue along with the mbufs it holds */
+static void
+rxa_vector_free(struct rte_event_eth_rx_adapter *rx_adapter,
+	struct eth_rx_queue_info *queue_info)
+{
+	struct eth_rx_vector_data *vec = &queue_info->vector_data;
+
+	if (vec->vector_ev == NULL)
+		return;
+
+	rte_pktmbuf_free_bulk(vec->vector_ev->mbufs, vec->vector_ev->nb_elem);
+	rte_mempool_put(vec->vector_pool, vec->vector_ev);
+	vec->vector_ev = NULL;
+	TAILQ_REMOVE(&rx_adapter->parts[queue_info->part].vector_list, vec,
+		next);
+}
+
+/* Lower the vector expiry check interval of a partition to tmo_ticks */
+static void
+rxa_part_vector_tmo_update(struct eth_rx_partition *part, uint64_t tmo_ticks)
+{
+	if (part->vector_tmo_ticks == 0 || tmo_ticks < part->vector_tmo_ticks)
+		part->vector_tmo_ticks = tmo_ticks;
+}
+
+/* Build the vector event template of a queue from its event template */
+static void
+rxa_vector_event_init(struct eth_rx_queue_info *queue_info,
+	uint16_t eth_dev_id,
+	uint16_t rx_queue_id)
+{
+	struct eth_rx_vector_data *vec = &queue_info->vector_data;
+	struct rte_event *vec_ev = (struct rte_event *)&vec->event;
+
+	vec_ev->event = queue_info->event;
+	vec_ev->event_type = RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR;
+	/* All the mbufs of a vector share the flow of their Rx queue */
+	if (!queue_info->flow_id_mask)
+		vec_ev->flow_id = (rx_queue_id & 0xFFF) |
+				  ((eth_dev_id & 0xFF) << 12);
+}
+
 static void
 rxa_sw_del(struct rte_event_eth_rx_adapter *rx_adapter,
 	struct eth_device_info *dev_info,
@@ -1677,6 +2000,9 @@ rxa_sw_del(struct rte_event_eth_rx_adapter *rx_adapter,
 	pollq = rxa_polled_queue(dev_info, rx_queue_id);
 	intrq = rxa_intr_queue(dev_info, rx_queue_id);
 	sintrq = rxa_shared_intr(dev_info, rx_queue_id);
+	rxa_vector_free(rx_adapter, &dev_info->rx_queue[rx_queue_id]);
+	dev_info->rx_queue[rx_queue_id].ena_vector = 0;
+	dev_info->rx_queue[rx_queue_id].vector_requested = 0;
 	rxa_update_queue(rx_adapter, dev_info, rx_queue_id, 0);
 	rx_adapter->num_rx_polled -= pollq;
 	dev_info->nb_rx_poll -= pollq;
@@ -1697,6 +2023,7 @@ rxa_add_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 	int intrq;
 	int sintrq;
 	struct rte_event *qi_ev;
+	uint16_t part;
 
 	if (rx_queue_id == -1) {
 		uint16_t nb_rx_queues;
@@ -1713,6 +2040,24 @@ rxa_add_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 	sintrq = rxa_shared_intr(dev_info, rx_queue_id);
 
 	queue_info = &dev_info->rx_queue[rx_queue_id];
+
+	/* Interrupt mode queues are serviced by partition 0, a queue that
+	 * is already polled stays in its partition
+	 */
+	if (conf->servicing_weight == 0)
+		part = 0;
+	else if (pollq)
+		part = queue_info->part;
+	else
+		part = rxa_part_select(rx_adapter);
+	if (part != queue_info->part) {
+		rxa_vector_free(rx_adapter, queue_info);
+		queue_info->part = part;
+		if (queue_info->ena_vector)
+			rxa_part_vector_tmo_update(&rx_adapter->parts[part],
+				queue_info->vector_data.vector_timeout_ticks);
+	}
+
 	queue_info->wt = conf->servicing_weight;
 
 	qi_ev = (struct rte_event *)&queue_info->event;
@@ -1727,6 +2072,17 @@ rxa_add_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 	} else
 		qi_ev->flow_id = 0;
 
+	queue_info->vector_requested = !!(conf->rx_queue_flags &
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR);
+	if (!queue_info->vector_requested) {
+		rxa_vector_free(rx_adapter, queue_info);
+		queue_info->ena_vector = 0;
+	} else if (queue_info->ena_vector) {
+		/* Re-added queue, vectors follow the new event template */
+		rxa_vector_event_init(queue_info, dev_info->dev->data->port_id,
+			rx_queue_id);
+	}
+
 	rxa_update_queue(rx_adapter, dev_info, rx_queue_id, 1);
 	if (rxa_polled_queue(dev_info, rx_queue_id)) {
 		rx_adapter->num_rx_polled += !pollq;
@@ -1760,9 +2116,7 @@ static int rxa_sw_add(struct rte_event_eth_rx_adapter *rx_adapter,
 	struct eth_device_info *dev_info = &rx_adapter->eth_devices[eth_dev_id];
 	struct rte_event_eth_rx_adapter_queue_conf temp_conf;
 	int ret;
-	struct eth_rx_poll_entry *rx_poll;
 	struct eth_rx_queue_info *rx_queue;
-	uint32_t *rx_wrr;
 	uint16_t nb_rx_queues;
 	uint32_t nb_rx_poll, nb_wrr;
 	uint32_t nb_rx_intr;
@@ -1793,8 +2147,6 @@ static int rxa_sw_add(struct rte_event_eth_rx_adapter *rx_adapter,
 		if (dev_info->rx_queue == NULL)
 			return -ENOMEM;
 	}
-	rx_wrr = NULL;
-	rx_poll = NULL;
 
 	rxa_calc_nb_post_add(rx_adapter, dev_info, rx_queue_id,
 			queue_conf->servicing_weight,
@@ -1804,8 +2156,7 @@ static int rxa_sw_add(struct rte_event_eth_rx_adapter *rx_adapter,
 		dev_info->multi_intr_cap =
 			rte_intr_cap_multiple(dev_info->dev->intr_handle);
 
-	ret = rxa_alloc_poll_arrays(rx_adapter, nb_rx_poll, nb_wrr,
-				&rx_poll, &rx_wrr);
+	ret = rxa_alloc_poll_arrays(rx_adapter, nb_rx_poll, nb_wrr);
 	if (ret)
 		goto err_free_rxqueue;
 
@@ -1858,13 +2209,8 @@ static int rxa_sw_add(struct rte_event_eth_rx_adapter *rx_adapter,
 
 
 	rxa_add_queue(rx_adapter, dev_info, rx_queue_id, queue_conf);
-	rxa_calc_wrr_sequence(rx_adapter, rx_poll, rx_wrr);
-
-	rte_free(rx_adapter->eth_rx_poll);
-	rte_free(rx_adapter->wrr_sched);
+	rxa_calc_wrr_sequence(rx_adapter);
 
-	rx_adapter->eth_rx_poll = rx_poll;
-	rx_adapter->wrr_sched = rx_wrr;
 	rx_adapter->wrr_len = nb_wrr;
 	rx_adapter->num_intr_vec += num_intr_vec;
 	return 0;
@@ -1875,8 +2221,7 @@ static int rxa_sw_add(struct rte_event_eth_rx_adapter *rx_adapter,
 		dev_info->rx_queue = NULL;
 	}
 
-	rte_free(rx_poll);
-	rte_free(rx_wrr);
+	rxa_free_poll_arrays(rx_adapter);
 
 	return 0;
 }
@@ -1917,19 +2262,20 @@ rxa_ctrl(uint8_t id, int start)
 	}
 
 	if (use_service) {
-		rte_spinlock_lock(&rx_adapter->rx_lock);
+		rxa_lock_parts(rx_adapter);
 		rx_adapter->rxa_started = start;
 		rte_service_runstate_set(rx_adapter->service_id, start);
-		rte_spinlock_unlock(&rx_adapter->rx_lock);
+		rxa_unlock_parts(rx_adapter);
 	}
 
 	return 0;
 }
 
-int
-rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
-				rte_event_eth_rx_adapter_conf_cb conf_cb,
-				void *conf_arg)
+static int
+rxa_create(uint8_t id, uint8_t dev_id,
+	rte_event_eth_rx_adapter_conf_cb conf_cb,
+	void *conf_arg,
+	uint16_t nb_parts)
 {
 	struct rte_event_eth_rx_adapter *rx_adapter;
 	int ret;
@@ -1992,7 +2338,22 @@ rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
 		rte_free(rx_adapter);
 		return -ENOMEM;
 	}
-	rte_spinlock_init(&rx_adapter->rx_lock);
+
+	rx_adapter->parts = rte_zmalloc_socket(rx_adapter->mem_name,
+					nb_parts *
+					sizeof(struct eth_rx_partition),
+					RTE_CACHE_LINE_SIZE, socket_id);
+	if (rx_adapter->parts == NULL) {
+		RTE_EDEV_LOG_ERR("failed to get mem for rx partitions\n");
+		rte_free(rx_adapter->eth_devices);
+		rte_free(rx_adapter);
+		return -ENOMEM;
+	}
+	rx_adapter->nb_parts = nb_parts;
+	for (i = 0; i < nb_parts; i++) {
+		rte_spinlock_init(&rx_adapter->parts[i].lock);
+		TAILQ_INIT(&rx_adapter->parts[i].vector_list);
+	}
 	for (i = 0; i < RTE_MAX_ETHPORTS; i++)
 		rx_adapter->eth_devices[i].dev = &rte_eth_devices[i];
 
@@ -2005,32 +2366,58 @@ rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
 }
 
 int
-rte_event_eth_rx_adapter_create(uint8_t id, uint8_t dev_id,
-		struct rte_event_port_conf *port_config)
+rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
+				rte_event_eth_rx_adapter_conf_cb conf_cb,
+				void *conf_arg)
+{
+	return rxa_create(id, dev_id, conf_cb, conf_arg, 1);
+}
+
+int
+rte_event_eth_rx_adapter_create_with_params(uint8_t id, uint8_t dev_id,
+		struct rte_event_port_conf *port_config,
+		struct rte_event_eth_rx_adapter_params *rxa_params)
 {
 	struct rte_event_port_conf *pc;
+	uint16_t nb_parts = 1;
 	int ret;
 
 	if (port_config == NULL)
 		return -EINVAL;
 	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
 
+	if (rxa_params != NULL && rxa_params->nb_partitions != 0) {
+		if (rxa_params->nb_partitions > RTE_MAX_LCORE) {
+			RTE_EDEV_LOG_ERR("Invalid number of Rx partitions %"
+				PRIu16, rxa_params->nb_partitions);
+			return -EINVAL;
+		}
+		nb_parts = rxa_params->nb_partitions;
+	}
+
 	pc = rte_malloc(NULL, sizeof(*pc), 0);
 	if (pc == NULL)
 		return -ENOMEM;
 	*pc = *port_config;
-	ret = rte_event_eth_rx_adapter_create_ext(id, dev_id,
-					rxa_default_conf_cb,
-					pc);
+	ret = rxa_create(id, dev_id, rxa_default_conf_cb, pc, nb_parts);
 	if (ret)
 		rte_free(pc);
 	return ret;
 }
 
+int
+rte_event_eth_rx_adapter_create(uint8_t id, uint8_t dev_id,
+		struct rte_event_port_conf *port_config)
+{
+	return rte_event_eth_rx_adapter_create_with_params(id, dev_id,
+						port_config, NULL);
+}
+
 int
 rte_event_eth_rx_adapter_free(uint8_t id)
 {
 	struct rte_event_eth_rx_adapter *rx_adapter;
+	uint16_t i;
 
 	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
 
@@ -2046,6 +2433,11 @@ rte_event_eth_rx_adapter_free(uint8_t id)
 
 	if (rx_adapter->default_cb_arg)
 		rte_free(rx_adapter->conf_arg);
+	for (i = 0; i < rx_adapter->nb_parts; i++) {
+		rte_free(rx_adapter->parts[i].eth_rx_poll);
+		rte_free(rx_adapter->parts[i].wrr_sched);
+	}
+	rte_free(rx_adapter->parts);
 	rte_free(rx_adapter->eth_devices);
 	rte_free(rx_adapter);
 	event_eth_rx_adapter[id] = NULL;
@@ -2092,6 +2484,15 @@ rte_event_eth_rx_adapter_queue_add(uint8_t id,
 		return -EINVAL;
 	}
 
+	if ((cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR) == 0
+		&& (queue_conf->rx_queue_flags &
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR)) {
+		RTE_EDEV_LOG_ERR("Event vectorization is not supported,"
+				" eth port: %" PRIu16 " adapter id: %" PRIu8,
+				eth_dev_id, id);
+		return -EINVAL;
+	}
+
 	if ((cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_MULTI_EVENTQ) == 0 &&
 		(rx_queue_id != -1)) {
 		RTE_EDEV_LOG_ERR("Rx queues can only be connected to single "
@@ -2133,7 +2534,7 @@ rte_event_eth_rx_adapter_queue_add(uint8_t id,
 					1);
 		}
 	} else {
-		rte_spinlock_lock(&rx_adapter->rx_lock);
+		rxa_lock_parts(rx_adapter);
 		dev_info->internal_event_port = 0;
 		ret = rxa_init_service(rx_adapter, id);
 		if (ret == 0) {
@@ -2143,7 +2544,7 @@ rte_event_eth_rx_adapter_queue_add(uint8_t id,
 			rte_service_component_runstate_set(service_id,
 				rxa_sw_adapter_queue_count(rx_adapter));
 		}
-		rte_spinlock_unlock(&rx_adapter->rx_lock);
+		rxa_unlock_parts(rx_adapter);
 	}
 
 	rte_eventdev_trace_eth_rx_adapter_queue_add(id, eth_dev_id,
@@ -2166,8 +2567,6 @@ rte_event_eth_rx_adapter_queue_del(uint8_t id, uint16_t eth_dev_id,
 	uint32_t nb_rx_poll = 0;
 	uint32_t nb_wrr = 0;
 	uint32_t nb_rx_intr;
-	struct eth_rx_poll_entry *rx_poll = NULL;
-	uint32_t *rx_wrr = NULL;
 	int num_intr_vec;
 
 	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
@@ -2213,12 +2612,11 @@ rte_event_eth_rx_adapter_queue_del(uint8_t id, uint16_t eth_dev_id,
 		rxa_calc_nb_post_del(rx_adapter, dev_info, rx_queue_id,
 			&nb_rx_poll, &nb_rx_intr, &nb_wrr);
 
-		ret = rxa_alloc_poll_arrays(rx_adapter, nb_rx_poll, nb_wrr,
-			&rx_poll, &rx_wrr);
-		if (ret)
-			return ret;
+		rxa_lock_parts(rx_adapter);
 
-		rte_spinlock_lock(&rx_adapter->rx_lock);
+		ret = rxa_alloc_poll_arrays(rx_adapter, nb_rx_poll, nb_wrr);
+		if (ret)
+			goto unlock_ret;
 
 		num_intr_vec = 0;
 		if (rx_adapter->num_rx_intr > nb_rx_intr) {
@@ -2238,18 +2636,13 @@ rte_event_eth_rx_adapter_queue_del(uint8_t id, uint16_t eth_dev_id,
 		}
 
 		rxa_sw_del(rx_adapter, dev_info, rx_queue_id);
-		rxa_calc_wrr_sequence(rx_adapter, rx_poll, rx_wrr);
-
-		rte_free(rx_adapter->eth_rx_poll);
-		rte_free(rx_adapter->wrr_sched);
+		rxa_calc_wrr_sequence(rx_adapter);
 
 		if (nb_rx_intr == 0) {
 			rte_free(dev_info->intr_queue);
 			dev_info->intr_queue = NULL;
 		}
 
-		rx_adapter->eth_rx_poll = rx_poll;
-		rx_adapter->wrr_sched = rx_wrr;
 		rx_adapter->wrr_len = nb_wrr;
 		rx_adapter->num_intr_vec += num_intr_vec;
 
@@ -2258,12 +2651,11 @@ rte_event_eth_rx_adapter_queue_del(uint8_t id, uint16_t eth_dev_id,
 			dev_info->rx_queue = NULL;
 		}
 unlock_ret:
-		rte_spinlock_unlock(&rx_adapter->rx_lock);
-		if (ret) {
-			rte_free(rx_poll);
-			rte_free(rx_wrr);
+		if (ret)
+			rxa_free_poll_arrays(rx_adapter);
+		rxa_unlock_parts(rx_adapter);
+		if (ret)
 			return ret;
-		}
 
 		rte_service_component_runstate_set(rx_adapter->service_id,
 				rxa_sw_adapter_queue_count(rx_adapter));
@@ -2288,6 +2680,32 @@ rte_event_eth_rx_adapter_stop(uint8_t id)
 	return rxa_ctrl(id, 0);
 }
 
+/* Accumulate the service stats of all the partitions */
+static void
+rxa_part_stats_sum(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct rte_event_eth_rx_adapter_stats *stats)
+{
+	struct rte_event_eth_rx_adapter_stats *part_stats;
+	uint16_t i;
+
+	for (i = 0; i < rx_adapter->nb_parts; i++) {
+		part_stats = &rx_adapter->parts[i].stats;
+		stats->rx_poll_count += part_stats->rx_poll_count;
+		stats->rx_packets += part_stats->rx_packets;
+		stats->rx_enq_count += part_stats->rx_enq_count;
+		stats->rx_enq_retry += part_stats->rx_enq_retry;
+		stats->rx_dropped += part_stats->rx_dropped;
+		stats->rx_enq_block_cycles += part_stats->rx_enq_block_cycles;
+		stats->rx_intr_packets += part_stats->rx_intr_packets;
+		if (part_stats->rx_enq_start_ts &&
+		    (stats->rx_enq_start_ts == 0 ||
+		     part_stats->rx_enq_start_ts < stats->rx_enq_start_ts))
+			stats->rx_enq_start_ts = part_stats->rx_enq_start_ts;
+		stats->rx_enq_end_ts = RTE_MAX(stats->rx_enq_end_ts,
+					part_stats->rx_enq_end_ts);
+	}
+}
+
 int
 rte_event_eth_rx_adapter_stats_get(uint8_t id,
 			       struct rte_event_eth_rx_adapter_stats *stats)
@@ -2323,7 +2741,7 @@ rte_event_eth_rx_adapter_stats_get(uint8_t id,
 	}
 
 	if (rx_adapter->service_inited)
-		*stats = rx_adapter->stats;
+		rxa_part_stats_sum(rx_adapter, stats);
 
 	stats->rx_packets += dev_stats_sum.rx_packets;
 	stats->rx_enq_count += dev_stats_sum.rx_enq_count;
@@ -2354,7 +2772,9 @@ rte_event_eth_rx_adapter_stats_reset(uint8_t id)
 							&rte_eth_devices[i]);
 	}
 
-	memset(&rx_adapter->stats, 0, sizeof(rx_adapter->stats));
+	for (i = 0; i < rx_adapter->nb_parts; i++)
+		memset(&rx_adapter->parts[i].stats, 0,
+			sizeof(rx_adapter->parts[i].stats));
 	return 0;
 }
 
@@ -2412,10 +2832,132 @@ rte_event_eth_rx_adapter_cb_register(uint8_t id,
 		return -EINVAL;
 	}
 
-	rte_spinlock_lock(&rx_adapter->rx_lock);
+	rxa_lock_parts(rx_adapter);
 	dev_info->cb_fn = cb_fn;
 	dev_info->cb_arg = cb_arg;
-	rte_spinlock_unlock(&rx_adapter->rx_lock);
+	rxa_unlock_parts(rx_adapter);
 
 	return 0;
 }
+
+static void
+rxa_config_vector(struct rte_event_eth_rx_adapter *rx_adapter,
+	uint16_t eth_dev_id,
+	uint16_t rx_queue_id,
+	struct rte_event_eth_rx_adapter_event_vector_config *config)
+{
+	struct eth_device_info *dev_info = &rx_adapter->eth_devices[eth_dev_id];
+	struct eth_rx_queue_info *queue_info = &dev_info->rx_queue[rx_queue_id];
+	struct eth_rx_vector_data *vec = &queue_info->vector_data;
+	uint64_t tmo_ticks;
+
+	/* Drop the vector filled with the previous configuration */
+	rxa_vector_free(rx_adapter, queue_info);
+
+	vec->port = eth_dev_id;
+	vec->queue = rx_queue_id;
+	vec->max_vector_count = config->vector_sz;
+	vec->vector_pool = config->vector_mp;
+	tmo_ticks = config->vector_timeout_ns * rte_get_timer_hz() / 1E9;
+	vec->vector_timeout_ticks = RTE_MAX(tmo_ticks, 1ULL);
+
+	rxa_vector_event_init(queue_info, eth_dev_id, rx_queue_id);
+
+	rxa_part_vector_tmo_update(&rx_adapter->parts[queue_info->part],
+				vec->vector_timeout_ticks);
+
+	queue_info->ena_vector = 1;
+}
+
+int
+rte_event_eth_rx_adapter_queue_event_vector_config(
+	uint8_t id, uint16_t eth_dev_id, int32_t rx_queue_id,
+	struct rte_event_eth_rx_adapter_event_vector_config *config)
+{
+	struct rte_event_eth_rx_adapter *rx_adapter;
+	struct eth_device_info *dev_info;
+	uint16_t nb_rx_queues;
+	uint32_t max_elem;
+	uint32_t cap;
+	uint16_t i;
+	int ret;
+
+	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(eth_dev_id, -EINVAL);
+
+	rx_adapter = rxa_id_to_adapter(id);
+	if ((rx_adapter == NULL) || (config == NULL))
+		return -EINVAL;
+
+	ret = rte_event_eth_rx_adapter_caps_get(rx_adapter->eventdev_id,
+						eth_dev_id,
+						&cap);
+	if (ret) {
+		RTE_EDEV_LOG_ERR("Failed to get adapter caps edev %" PRIu8
+			"eth port %" PRIu16, id, eth_dev_id);
+		return ret;
+	}
+
+	if (!(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR) ||
+	    (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT)) {
+		RTE_EDEV_LOG_ERR("Event vectorization is not supported,"
+				 " eth port: %" PRIu16 " adapter id: %" PRIu8,
+				 eth_dev_id, id);
+		return -ENOTSUP;
+	}
+
+	if (config->vector_mp == NULL || config->vector_sz == 0 ||
+	    config->vector_timeout_ns == 0) {
+		RTE_EDEV_LOG_ERR("Invalid event vector configuration,"
+				 " eth port: %" PRIu16 " adapter id: %" PRIu8,
+				 eth_dev_id, id);
+		return -EINVAL;
+	}
+
+	max_elem = 0;
+	if (config->vector_mp->elt_size > sizeof(struct rte_event_vector))
+		max_elem = (config->vector_mp->elt_size -
+			    sizeof(struct rte_event_vector)) / sizeof(void *);
+	if (config->vector_sz > max_elem) {
+		RTE_EDEV_LOG_ERR("Vector size %" PRIu16 " exceeds vector pool"
+				 " element capacity %" PRIu32,
+				 config->vector_sz, max_elem);
+		return -EINVAL;
+	}
+
+	dev_info = &rx_adapter->eth_devices[eth_dev_id];
+	nb_rx_queues = dev_info->dev->data->nb_rx_queues;
+	if (rx_queue_id != -1 && (uint16_t)rx_queue_id >= nb_rx_queues) {
+		RTE_EDEV_LOG_ERR("Invalid rx queue_id %" PRIu16,
+			 (uint16_t)rx_queue_id);
+		return -EINVAL;
+	}
+
+	if (dev_info->rx_queue == NULL)
+		return -EINVAL;
+
+	rxa_lock_parts(rx_adapter);
+	if (rx_queue_id == -1) {
+		for (i = 0; i < nb_rx_queues; i++)
+			if (!dev_info->rx_queue[i].vector_requested) {
+				ret = -EINVAL;
+				goto unlock;
+			}
+		for (i = 0; i < nb_rx_queues; i++)
+			rxa_config_vector(rx_adapter, eth_dev_id, i, config);
+	} else {
+		if (!dev_info->rx_queue[rx_queue_id].vector_requested) {
+			ret = -EINVAL;
+			goto unlock;
+		}
+		rxa_config_vector(rx_adapter, eth_dev_id, rx_queue_id, config);
+	}
+unlock:
+	rxa_unlock_parts(rx_adapter);
+
+	if (ret)
+		RTE_EDEV_LOG_ERR("Rx queue %" PRId32 " of eth port %" PRIu16
+				 " was not added with event vectorization",
+				 rx_queue_id, eth_dev_id);
+	return ret;
+}
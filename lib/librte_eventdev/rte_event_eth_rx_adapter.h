@@ -30,6 +30,7 @@
  * The ethernet Rx event adapter's functions are:
  *  - rte_event_eth_rx_adapter_create_ext()
  *  - rte_event_eth_rx_adapter_create()
+ *  - rte_event_eth_rx_adapter_create_with_params()
  *  - rte_event_eth_rx_adapter_free()
  *  - rte_event_eth_rx_adapter_queue_add()
  *  - rte_event_eth_rx_adapter_queue_del()
@@ -63,6 +64,12 @@
  * rte_event_eth_rx_adapter_service_id_get() function can be used to retrieve
  * the service function ID of the adapter in this case.
  *
+ * An adapter created with rte_event_eth_rx_adapter_create_with_params() can
+ * split its polled Rx queues into several partitions. Each partition has its
+ * own event port, event buffer and polling sequence, and the service function
+ * may then be mapped to as many service cores as there are partitions, each
+ * core servicing a different partition at any point in time.
+ *
  * For SW based packet transfers, i.e., when the
  * RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT is not set in the adapter's
  * capabilities flags for a particular ethernet device, the service function
@@ -96,6 +103,11 @@ extern "C" {
 /**< This flag indicates the flow identifier is valid
  * @see rte_event_eth_rx_adapter_queue_conf::rx_queue_flags
  */
+#define RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR	0x2
+/**< This flag indicates that mbufs arriving on the queue need to be vectorized
+ * @see rte_event_eth_rx_adapter_queue_conf::rx_queue_flags
+ * @see rte_event_eth_rx_adapter_queue_event_vector_config()
+ */
 
 /**
  * Adapter configuration structure that the adapter configuration callback
@@ -146,6 +158,7 @@ struct rte_event_eth_rx_adapter_queue_conf {
 	uint32_t rx_queue_flags;
 	 /**< Flags for handling received packets
 	  * @see RTE_EVENT_ETH_RX_ADAPTER_QUEUE_FLOW_ID_VALID
+	  * @see RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR
 	  */
 	uint16_t servicing_weight;
 	/**< Relative polling frequency of ethernet receive queue when the
@@ -169,7 +182,29 @@ struct rte_event_eth_rx_adapter_queue_conf {
 	 *		addresses.
 	 *
 	 * The event adapter sets ev.event_type to RTE_EVENT_TYPE_ETHDEV in the
-	 * enqueued event.
+	 * enqueued event, or to RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR when
+	 * RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR is set in rx_queue_flags.
+	 */
+};
+
+/**
+ * Rx queue event vector configuration structure
+ * @see rte_event_eth_rx_adapter_queue_event_vector_config()
+ */
+struct rte_event_eth_rx_adapter_event_vector_config {
+	uint16_t vector_sz;
+	/**< Indicates the maximum number for mbufs to combine and form a vector.
+	 * Should be within the nb_elem of the vector mempool.
+	 */
+	uint64_t vector_timeout_ns;
+	/**< Maximum number of nanoseconds to wait for aggregating mbufs.
+	 * A partially filled vector is enqueued to the event device once it
+	 * has been pending for longer than this timeout.
+	 */
+	struct rte_mempool *vector_mp;
+	/**< Indicates the mempool that should be used for allocating
+	 * rte_event_vector container.
+	 * @see rte_event_vector_pool_create()
 	 */
 };
 
@@ -203,6 +238,21 @@ struct rte_event_eth_rx_adapter_stats {
 	/**< Received packet count for interrupt mode Rx queues */
 };
 
+/**
+ * Adapter parameters passed to
+ * rte_event_eth_rx_adapter_create_with_params()
+ */
+struct rte_event_eth_rx_adapter_params {
+	uint16_t nb_partitions;
+	/**< Number of partitions the polled Rx queues are distributed
+	 * across, a value of 0 is treated as 1. Each partition is serviced
+	 * by at most one service core at a time and enqueues through an
+	 * event port of its own. A newly added polled Rx queue is assigned to
+	 * the partition with the lowest sum of servicing weights, interrupt
+	 * mode Rx queues are all assigned to the first partition.
+	 */
+};
+
 /**
  *
  * Callback function invoked by the SW adapter before it continues
@@ -303,6 +353,37 @@ int rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
 int rte_event_eth_rx_adapter_create(uint8_t id, uint8_t dev_id,
 				struct rte_event_port_conf *port_config);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a new ethernet Rx event adapter with the specified identifier and
+ * adapter parameters. The internal configuration function is invoked once
+ * per partition, adding an event port to the event device for each of them.
+ *
+ * @param id
+ *  The identifier of the ethernet Rx event adapter.
+ *
+ * @param dev_id
+ *  The identifier of the device to configure.
+ *
+ * @param port_config
+ *  Argument of type *rte_event_port_conf* that is passed to the conf_cb
+ *  function.
+ *
+ * @param rxa_params
+ *  Pointer to struct rte_event_eth_rx_adapter_params, NULL selects the
+ *  defaults, which are the same as rte_event_eth_rx_adapter_create().
+ *
+ * @return
+ *   - 0: Success
+ *   - <0: Error code on failure
+ */
+__rte_experimental
+int rte_event_eth_rx_adapter_create_with_params(uint8_t id, uint8_t dev_id,
+			struct rte_event_port_conf *port_config,
+			struct rte_event_eth_rx_adapter_params *rxa_params);
+
 /**
  * Free an event adapter
  *
@@ -471,6 +552,42 @@ int rte_event_eth_rx_adapter_cb_register(uint8_t id, uint16_t eth_dev_id,
 					 rte_event_eth_rx_adapter_cb_fn cb_fn,
 					 void *cb_arg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Configure event vectorization for a given ethernet device queue, that has
+ * been added to a event eth Rx adapter with the
+ * RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR flag set.
+ *
+ * The mbufs received on the queue are aggregated in a struct rte_event_vector
+ * until either *vector_sz* mbufs have been collected or the vector has been
+ * pending for *vector_timeout_ns*, at which point a single event of type
+ * RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR is enqueued to the event device.
+ * The callback registered with rte_event_eth_rx_adapter_cb_register() is not
+ * invoked for vectorized queues.
+ *
+ * @param id
+ *  The identifier of the ethernet Rx event adapter.
+ * @param eth_dev_id
+ *  The port identifier of the Ethernet device.
+ * @param rx_queue_id
+ *  Ethernet device receive queue index.
+ *  If rx_queue_id is -1, then all Rx queues configured for the ethernet device
+ *  are configured with event vectorization.
+ * @param config
+ *  Event vector configuration structure.
+ * @return
+ *  - 0: Success, Receive queue configured correctly.
+ *  - (-EINVAL) Invalid parameter, or the queue has not been added with the
+ *  RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR flag.
+ *  - (-ENOTSUP) The adapter doesn't support event vectorization.
+ */
+__rte_experimental
+int rte_event_eth_rx_adapter_queue_event_vector_config(
+	uint8_t id, uint16_t eth_dev_id, int32_t rx_queue_id,
+	struct rte_event_eth_rx_adapter_event_vector_config *config);
+
 #ifdef __cplusplus
 }
 #endif
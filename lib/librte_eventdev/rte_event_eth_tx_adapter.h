@@ -68,6 +68,12 @@
  * and rte_event_eth_tx_adapter_txq_get() functions to access the transmit
  * queue index, using these macros will help with minimizing application
  * impact due to a change in how the transmit queue index is specified.
+ *
+ * Events of type RTE_EVENT_TYPE_VECTOR carry a struct rte_event_vector of
+ * mbufs. If the vector attributes are valid, all the mbufs of the vector are
+ * transmitted on the port and queue held in the vector, otherwise the port
+ * and queue of every mbuf are used. The vector is returned to its mempool
+ * by the adapter once the mbufs have been transmitted.
  */
 
 #ifdef __cplusplus
@@ -21,6 +21,7 @@
 #include <rte_memory.h>
 #include <rte_memcpy.h>
 #include <rte_memzone.h>
+#include <rte_mempool.h>
 #include <rte_eal.h>
 #include <rte_per_lcore.h>
 #include <rte_lcore.h>
@@ -1200,6 +1201,27 @@ int rte_event_dev_selftest(uint8_t dev_id)
 	return -ENOTSUP;
 }
 
+struct rte_mempool *
+rte_event_vector_pool_create(const char *name, unsigned int n,
+			     unsigned int cache_size, uint16_t nb_elem,
+			     int socket_id)
+{
+	unsigned int elt_sz;
+
+	if (!nb_elem) {
+		RTE_EDEV_LOG_ERR("Invalid number of elements=%d requested",
+				 nb_elem);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	elt_sz = sizeof(struct rte_event_vector) +
+		 (nb_elem * sizeof(uintptr_t));
+
+	return rte_mempool_create(name, n, elt_sz, cache_size, 0, NULL, NULL,
+				  NULL, NULL, socket_id, 0);
+}
+
 int
 rte_event_dev_start(uint8_t dev_id)
 {
@@ -20,6 +20,7 @@
  */
 
 #include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -58,6 +59,34 @@ enum rte_fib_dir24_8_nh_sz {
 	RTE_FIB_DIR24_8_8B
 };
 
+/** Type of lookup function implementation for DIR24_8 based FIB */
+enum rte_fib_dir24_8_lookup_type {
+	RTE_FIB_DIR24_8_SCALAR_MACRO,
+	/**< Macro based lookup function */
+	RTE_FIB_DIR24_8_SCALAR_INLINE,
+	/**<
+	 * Lookup implemented using inlined functions
+	 * for different next hop sizes
+	 */
+	RTE_FIB_DIR24_8_SCALAR_UNI,
+	/**<
+	 * Unified lookup function for all next hop sizes
+	 */
+	RTE_FIB_DIR24_8_VECTOR_AVX512
+	/**< Vector implementation using AVX512 */
+};
+
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_FIB_RCU_DQ_RECLAIM_MAX	16
+
+/** RCU reclamation modes */
+enum rte_fib_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_FIB_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_FIB_QSBR_MODE_SYNC
+};
+
 /** FIB configuration structure */
 struct rte_fib_conf {
 	enum rte_fib_type type; /**< Type of FIB struct */
@@ -72,6 +101,22 @@ struct rte_fib_conf {
 	};
 };
 
+/** FIB RCU QSBR configuration structure. */
+struct rte_fib_rcu_config {
+	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
+	/* Mode of RCU QSBR. RTE_FIB_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_fib_qsbr_mode mode;
+	uint32_t dq_size;	/* RCU defer queue size.
+				 * default: number of tbl8s.
+				 */
+	uint32_t reclaim_thd;	/* Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/* Max entries to reclaim in one go.
+				 * default: RTE_FIB_RCU_DQ_RECLAIM_MAX.
+				 */
+};
+
 /**
  * Create FIB
  *
@@ -183,6 +228,56 @@ __rte_experimental
 void *
 rte_fib_get_dp(struct rte_fib *fib);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Set lookup function based on type
+ *
+ * @param fib
+ *   FIB object handle
+ * @param type
+ *   type of lookup function
+ *
+ * @return
+ *   -EINVAL if the FIB is not DIR24_8 based or type is invalid,
+ *   -ENOTSUP if the lookup function is not supported by the build
+ *   or by the running CPU, 0 on success.
+ *   This function is not multi-thread safe,
+ *   no lookups must be in progress on the FIB.
+ */
+__rte_experimental
+int
+rte_fib_set_lookup_fn(struct rte_fib *fib,
+	enum rte_fib_dir24_8_lookup_type type);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate RCU QSBR variable with a FIB object.
+ *
+ * Once associated, tbl8 groups released by rte_fib_add() and
+ * rte_fib_delete() are reused only after all the readers reporting
+ * to the QSBR variable went through a quiescent state. This allows
+ * the FIB to be modified while lookups are in progress on other
+ * lcores, as long as there is a single writer.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   0 on success
+ *   -EINVAL on invalid parameters
+ *   -EEXIST if a QSBR variable is already associated
+ *   -ENOTSUP if the FIB type does not support RCU reclamation
+ *   -ENOMEM if the defer queue can not be created
+ */
+__rte_experimental
+int
+rte_fib_rcu_qsbr_add(struct rte_fib *fib, struct rte_fib_rcu_config *cfg);
+
 /**
  * Get pointer to the RIB
  *
@@ -107,7 +107,8 @@ init_dataplane(struct rte_fib6 *fib, __rte_unused int socket_id,
 		fib->dp = trie_create(dp_name, socket_id, conf);
 		if (fib->dp == NULL)
 			return -rte_errno;
-		fib->lookup = rte_trie_get_lookup_fn(conf);
+		fib->lookup = trie_get_lookup_fn(fib->dp,
+			RTE_FIB6_TRIE_SCALAR);
 		fib->modify = trie_modify;
 		return 0;
 	default:
@@ -319,3 +320,35 @@ rte_fib6_get_rib(struct rte_fib6 *fib)
 {
 	return (fib == NULL) ? NULL : fib->rib;
 }
+
+int
+rte_fib6_set_lookup_fn(struct rte_fib6 *fib,
+	enum rte_fib_trie_lookup_type type)
+{
+	rte_fib6_lookup_fn_t fn;
+
+	if ((fib == NULL) || (fib->type != RTE_FIB6_TRIE) ||
+			(type > RTE_FIB6_TRIE_VECTOR_AVX512))
+		return -EINVAL;
+
+	fn = trie_get_lookup_fn(fib->dp, type);
+	if (fn == NULL)
+		return -ENOTSUP;
+
+	fib->lookup = fn;
+	return 0;
+}
+
+int
+rte_fib6_rcu_qsbr_add(struct rte_fib6 *fib, struct rte_fib6_rcu_config *cfg)
+{
+	if ((fib == NULL) || (cfg == NULL) || (cfg->v == NULL))
+		return -EINVAL;
+
+	switch (fib->type) {
+	case RTE_FIB6_TRIE:
+		return trie_rcu_qsbr_add(fib->dp, cfg, fib->name);
+	default:
+		return -ENOTSUP;
+	}
+}
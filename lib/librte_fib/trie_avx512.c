@@ -0,0 +1,228 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <rte_vect.h>
+#include <rte_fib6.h>
+
+#include "trie.h"
+#include "trie_avx512.h"
+
+/*
+ * Load 16 IPv6 addresses and transpose them, so that each output register
+ * holds the same 4 byte chunk of all the addresses, in address order.
+ */
+static __rte_always_inline void
+transpose_x16(uint8_t ips[16][RTE_FIB6_IPV6_ADDR_SIZE],
+	__m512i *first, __m512i *second, __m512i *third, __m512i *fourth)
+{
+	__m512i tmp1, tmp2, tmp3, tmp4;
+	__m512i tmp5, tmp6, tmp7, tmp8;
+	const __m512i perm_idxes = _mm512_setr_epi32(0, 4, 8, 12,
+		2, 6, 10, 14, 1, 5, 9, 13, 3, 7, 11, 15);
+
+	/* each 128-bit lane holds one address */
+	tmp1 = _mm512_loadu_si512(&ips[0][0]);
+	tmp2 = _mm512_loadu_si512(&ips[4][0]);
+	tmp3 = _mm512_loadu_si512(&ips[8][0]);
+	tmp4 = _mm512_loadu_si512(&ips[12][0]);
+
+	/* transpose 4 byte chunks inside the lanes */
+	tmp5 = _mm512_unpacklo_epi32(tmp1, tmp2);
+	tmp7 = _mm512_unpackhi_epi32(tmp1, tmp2);
+	tmp6 = _mm512_unpacklo_epi32(tmp3, tmp4);
+	tmp8 = _mm512_unpackhi_epi32(tmp3, tmp4);
+
+	tmp1 = _mm512_unpacklo_epi32(tmp5, tmp6);
+	tmp3 = _mm512_unpackhi_epi32(tmp5, tmp6);
+	tmp2 = _mm512_unpacklo_epi32(tmp7, tmp8);
+	tmp4 = _mm512_unpackhi_epi32(tmp7, tmp8);
+
+	/* restore the order of the addresses */
+	*first = _mm512_permutexvar_epi32(perm_idxes, tmp1);
+	*second = _mm512_permutexvar_epi32(perm_idxes, tmp3);
+	*third = _mm512_permutexvar_epi32(perm_idxes, tmp2);
+	*fourth = _mm512_permutexvar_epi32(perm_idxes, tmp4);
+}
+
+/*
+ * Load 8 IPv6 addresses and transpose them, so that each output register
+ * holds the same 8 byte half of all the addresses, in address order.
+ */
+static __rte_always_inline void
+transpose_x8(uint8_t ips[8][RTE_FIB6_IPV6_ADDR_SIZE],
+	__m512i *first, __m512i *second)
+{
+	__m512i tmp1, tmp2, tmp3, tmp4;
+	const __m512i perm_idxes = _mm512_setr_epi64(0, 2, 4, 6,
+		1, 3, 5, 7);
+
+	tmp1 = _mm512_loadu_si512(&ips[0][0]);
+	tmp2 = _mm512_loadu_si512(&ips[4][0]);
+
+	tmp3 = _mm512_unpacklo_epi64(tmp1, tmp2);
+	*first = _mm512_permutexvar_epi64(perm_idxes, tmp3);
+	tmp4 = _mm512_unpackhi_epi64(tmp1, tmp2);
+	*second = _mm512_permutexvar_epi64(perm_idxes, tmp4);
+}
+
+/*
+ * Lookup 16 IPv6 addresses at once with 2B or 4B next hops.
+ */
+static __rte_always_inline void
+trie_vec_lookup_x16(void *p, uint8_t ips[16][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, int size)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+	const __m512i zero = _mm512_set1_epi32(0);
+	const __m512i lsb = _mm512_set1_epi32(1);
+	const __m512i lsbyte_msk = _mm512_set1_epi32(UINT8_MAX);
+	/* used to mask gather values if size is 2 (16 bit next hops) */
+	const __m512i res_msk = _mm512_set1_epi32(UINT16_MAX);
+	/* first 3 bytes of each address in host order, see get_tbl24_idx() */
+	const __m512i bswap = _mm512_broadcast_i32x4(_mm_setr_epi8(
+		2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12, -1));
+	__m512i first, second, third, fourth; /* 4 byte chunks */
+	__m512i idxes, res, tmp, bytes, chunk;
+	__mmask16 msk_ext;
+	uint32_t i;
+
+	transpose_x16(ips, &first, &second, &third, &fourth);
+
+	idxes = _mm512_shuffle_epi8(first, bswap);
+
+	/*
+	 * lookup in tbl24,
+	 * the gather scale has to be a compile time constant.
+	 */
+	if (size == sizeof(uint16_t)) {
+		res = _mm512_i32gather_epi32(idxes,
+			(const int *)dp->tbl24, 2);
+		res = _mm512_and_epi32(res, res_msk);
+	} else
+		res = _mm512_i32gather_epi32(idxes,
+			(const int *)dp->tbl24, 4);
+
+	/* get extended entries */
+	msk_ext = _mm512_test_epi32_mask(res, lsb);
+
+	/* traverse down the trie, one address byte per level */
+	for (i = 3; msk_ext != 0 && i != RTE_FIB6_IPV6_ADDR_SIZE; i++) {
+		chunk = (i < 8) ? ((i < 4) ? first : second) :
+			((i < 12) ? third : fourth);
+		bytes = _mm512_srl_epi32(chunk,
+			_mm_cvtsi32_si128((i % 4) * CHAR_BIT));
+		bytes = _mm512_and_epi32(bytes, lsbyte_msk);
+
+		idxes = _mm512_srli_epi32(res, 1);
+		idxes = _mm512_slli_epi32(idxes, 8);
+		idxes = _mm512_maskz_add_epi32(msk_ext, idxes, bytes);
+		if (size == sizeof(uint16_t)) {
+			tmp = _mm512_mask_i32gather_epi32(zero, msk_ext,
+				idxes, (const int *)dp->tbl8, 2);
+			tmp = _mm512_and_epi32(tmp, res_msk);
+		} else
+			tmp = _mm512_mask_i32gather_epi32(zero, msk_ext,
+				idxes, (const int *)dp->tbl8, 4);
+
+		res = _mm512_mask_blend_epi32(msk_ext, res, tmp);
+		msk_ext = _mm512_mask_test_epi32_mask(msk_ext, res, lsb);
+	}
+
+	/* zero extend next hops to 64 bits */
+	res = _mm512_srli_epi32(res, 1);
+	_mm512_storeu_si512(next_hops,
+		_mm512_cvtepu32_epi64(_mm512_castsi512_si256(res)));
+	_mm512_storeu_si512(next_hops + 8,
+		_mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(res, 1)));
+}
+
+/*
+ * Lookup 8 IPv6 addresses at once with 8B next hops.
+ */
+static __rte_always_inline void
+trie_vec_lookup_x8_8b(void *p, uint8_t ips[8][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops)
+{
+	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
+	const __m512i zero = _mm512_set1_epi32(0);
+	const __m512i lsb = _mm512_set1_epi64(1);
+	const __m512i lsbyte_msk = _mm512_set1_epi64(UINT8_MAX);
+	/* first 3 bytes of each address in host order, see get_tbl24_idx() */
+	const __m512i bswap = _mm512_broadcast_i32x4(_mm_setr_epi8(
+		2, 1, 0, -1, -1, -1, -1, -1, 10, 9, 8, -1, -1, -1, -1, -1));
+	__m512i first, second; /* 8 byte chunks */
+	__m512i idxes, res, tmp, bytes;
+	__mmask8 msk_ext;
+	uint32_t i;
+
+	transpose_x8(ips, &first, &second);
+
+	idxes = _mm512_shuffle_epi8(first, bswap);
+
+	/* lookup in tbl24 */
+	res = _mm512_i64gather_epi64(idxes, (const void *)dp->tbl24, 8);
+
+	/* get extended entries */
+	msk_ext = _mm512_test_epi64_mask(res, lsb);
+
+	/* traverse down the trie, one address byte per level */
+	for (i = 3; msk_ext != 0 && i != RTE_FIB6_IPV6_ADDR_SIZE; i++) {
+		bytes = _mm512_srl_epi64((i < 8) ? first : second,
+			_mm_cvtsi32_si128((i % 8) * CHAR_BIT));
+		bytes = _mm512_and_epi64(bytes, lsbyte_msk);
+
+		idxes = _mm512_srli_epi64(res, 1);
+		idxes = _mm512_slli_epi64(idxes, 8);
+		idxes = _mm512_maskz_add_epi64(msk_ext, idxes, bytes);
+		tmp = _mm512_mask_i64gather_epi64(zero, msk_ext, idxes,
+			(const void *)dp->tbl8, 8);
+
+		res = _mm512_mask_blend_epi64(msk_ext, res, tmp);
+		msk_ext = _mm512_mask_test_epi64_mask(msk_ext, res, lsb);
+	}
+
+	res = _mm512_srli_epi64(res, 1);
+	_mm512_storeu_si512(next_hops, res);
+}
+
+void
+rte_trie_vec_lookup_bulk_2b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 16); i++)
+		trie_vec_lookup_x16(p, &ips[i * 16], next_hops + i * 16,
+			sizeof(uint16_t));
+
+	rte_trie_lookup_bulk_2b(p, &ips[i * 16], next_hops + i * 16,
+		n - i * 16);
+}
+
+void
+rte_trie_vec_lookup_bulk_4b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 16); i++)
+		trie_vec_lookup_x16(p, &ips[i * 16], next_hops + i * 16,
+			sizeof(uint32_t));
+
+	rte_trie_lookup_bulk_4b(p, &ips[i * 16], next_hops + i * 16,
+		n - i * 16);
+}
+
+void
+rte_trie_vec_lookup_bulk_8b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 8); i++)
+		trie_vec_lookup_x8_8b(p, &ips[i * 8], next_hops + i * 8);
+
+	rte_trie_lookup_bulk_8b(p, &ips[i * 8], next_hops + i * 8,
+		n - i * 8);
+}
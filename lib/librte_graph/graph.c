@@ -257,16 +257,15 @@ rte_graph_lookup(const char *name)
 	return graph_mem_fixup_secondary(rc);
 }
 
-rte_graph_t
-rte_graph_create(const char *name, struct rte_graph_param *prm)
+static rte_graph_t
+graph_create(const char *name, struct rte_graph_param *prm,
+	     struct graph *parent)
 {
 	rte_node_t src_node_count;
 	struct graph *graph;
 	const char *pattern;
 	uint16_t i;
 
-	graph_spinlock_lock();
-
 	/* Check arguments sanity */
 	if (prm == NULL)
 		SET_ERR_JMP(EINVAL, fail, "Param should not be NULL");
@@ -327,6 +326,7 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	graph->src_node_count = src_node_count;
 	graph->node_count = graph_nodes_count(graph);
 	graph->id = graph_id;
+	graph->parent = parent;
 
 	/* Allocate the Graph fast path memory and populate the data */
 	if (graph_fp_mem_create(graph))
@@ -340,7 +340,6 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	graph_id++;
 	STAILQ_INSERT_TAIL(&graph_list, graph, next);
 
-	graph_spinlock_unlock();
 	return graph->id;
 
 graph_mem_destroy:
@@ -350,10 +349,190 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 free:
 	free(graph);
 fail:
+	return RTE_GRAPH_ID_INVALID;
+}
+
+rte_graph_t
+rte_graph_create(const char *name, struct rte_graph_param *prm)
+{
+	rte_graph_t rc;
+
+	graph_spinlock_lock();
+	rc = graph_create(name, prm, NULL);
+	graph_spinlock_unlock();
+
+	return rc;
+}
+
+static bool
+graph_has_clone(struct graph *parent)
+{
+	struct graph *graph;
+
+	STAILQ_FOREACH(graph, &graph_list, next)
+		if (graph->parent == parent)
+			return true;
+
+	return false;
+}
+
+static int
+graph_clone_name(char *dst, struct graph *parent, const char *name)
+{
+	ssize_t sz, rc;
+
+#define SZ RTE_GRAPH_NAMESIZE
+	rc = rte_strscpy(dst, parent->name, SZ);
+	if (rc < 0)
+		goto fail;
+	sz = rc;
+	rc = rte_strscpy(dst + sz, "-", RTE_MAX((int16_t)(SZ - sz), 0));
+	if (rc < 0)
+		goto fail;
+	sz += rc;
+	sz = rte_strscpy(dst + sz, name, RTE_MAX((int16_t)(SZ - sz), 0));
+	if (sz < 0)
+		goto fail;
+#undef SZ
+
+	return 0;
+fail:
+	rte_errno = E2BIG;
+	return -rte_errno;
+}
+
+rte_graph_t
+rte_graph_clone(rte_graph_t id, const char *name)
+{
+	char clone[RTE_GRAPH_NAMESIZE];
+	struct rte_graph_param prm;
+	struct graph_node *graph_node;
+	const char **patterns = NULL;
+	struct graph *parent;
+	rte_graph_t rc;
+	uint16_t i = 0;
+
+	GRAPH_ID_CHECK(id);
+	if (name == NULL)
+		SET_ERR_JMP(EINVAL, fail, "Clone name should not be NULL");
+
+	graph_spinlock_lock();
+	STAILQ_FOREACH(parent, &graph_list, next)
+		if (parent->id == id)
+			break;
+	if (parent == NULL)
+		SET_ERR_JMP(ENOENT, unlock, "Graph %u not found", id);
+
+	/* Clone of a clone shares the nodes of the original graph */
+	while (parent->parent != NULL)
+		parent = parent->parent;
+
+	/* Naming ceremony of the clone. name is parent->name + "-" + name */
+	if (graph_clone_name(clone, parent, name))
+		goto unlock;
+
+	/*
+	 * Create the clone from the exact node list of the parent, so that
+	 * the nodes are laid out at the same offsets in both graph reels.
+	 */
+	patterns = calloc(parent->node_count, sizeof(*patterns));
+	if (patterns == NULL)
+		SET_ERR_JMP(ENOMEM, unlock, "Failed to calloc patterns");
+	STAILQ_FOREACH(graph_node, &parent->node_list, next)
+		patterns[i++] = graph_node->node->name;
+
+	memset(&prm, 0, sizeof(prm));
+	prm.socket_id = parent->socket;
+	prm.nb_node_patterns = i;
+	prm.node_patterns = patterns;
+
+	rc = graph_create(clone, &prm, parent);
 	graph_spinlock_unlock();
+	free(patterns);
+	return rc;
+
+unlock:
+	graph_spinlock_unlock();
+fail:
 	return RTE_GRAPH_ID_INVALID;
 }
 
+int
+rte_graph_dispatch_core_bind(rte_graph_t id, unsigned int lcore_id)
+{
+	struct graph *graph;
+	int rc = -ENOENT;
+
+	GRAPH_ID_CHECK(id);
+	if (lcore_id >= RTE_MAX_LCORE)
+		goto fail;
+
+	graph_spinlock_lock();
+	STAILQ_FOREACH(graph, &graph_list, next)
+		if (graph->id == id) {
+			rc = graph_dispatch_core_bind(graph, lcore_id);
+			break;
+		}
+	graph_spinlock_unlock();
+
+	return rc;
+fail:
+	return -EINVAL;
+}
+
+void
+rte_graph_dispatch_core_unbind(rte_graph_t id)
+{
+	struct graph *graph;
+
+	graph_spinlock_lock();
+	STAILQ_FOREACH(graph, &graph_list, next)
+		if (graph->id == id) {
+			graph_dispatch_core_unbind(graph);
+			break;
+		}
+	graph_spinlock_unlock();
+}
+
+int
+rte_graph_hist_enable(rte_graph_t id, uint16_t sample_interval)
+{
+	struct graph *graph;
+	int rc = -ENOENT;
+
+	GRAPH_ID_CHECK(id);
+	if (!rte_graph_has_stats_feature() ||
+	    !rte_is_power_of_2(sample_interval))
+		goto fail;
+
+	graph_spinlock_lock();
+	STAILQ_FOREACH(graph, &graph_list, next)
+		if (graph->id == id) {
+			graph->graph->hist_interval = sample_interval;
+			rc = 0;
+			break;
+		}
+	graph_spinlock_unlock();
+
+	return rc;
+fail:
+	return -EINVAL;
+}
+
+void
+rte_graph_hist_disable(rte_graph_t id)
+{
+	struct graph *graph;
+
+	graph_spinlock_lock();
+	STAILQ_FOREACH(graph, &graph_list, next)
+		if (graph->id == id) {
+			graph->graph->hist_interval = 0;
+			break;
+		}
+	graph_spinlock_unlock();
+}
+
 int
 rte_graph_destroy(rte_graph_t id)
 {
@@ -366,6 +545,11 @@ rte_graph_destroy(rte_graph_t id)
 	while (graph != NULL) {
 		tmp = STAILQ_NEXT(graph, next);
 		if (graph->id == id) {
+			/* Clones share the dispatch list of their parent */
+			if (graph_has_clone(graph))
+				SET_ERR_JMP(EBUSY, busy, "Graph %s has clones",
+					    graph->name);
+			graph_dispatch_core_unbind(graph);
 			/* Call fini() of the all the nodes in the graph */
 			graph_node_fini(graph);
 			/* Destroy graph fast path memory */
@@ -385,6 +569,9 @@ rte_graph_destroy(rte_graph_t id)
 done:
 	graph_spinlock_unlock();
 	return rc;
+busy:
+	graph_spinlock_unlock();
+	return -rte_errno;
 }
 
 rte_graph_t
@@ -38,6 +38,7 @@ node_dump(FILE *f, struct node *n)
 	fprintf(f, "  addr=%p\n", n);
 	fprintf(f, "  process=%p\n", n->process);
 	fprintf(f, "  nb_edges=%d\n", n->nb_edges);
+	fprintf(f, "  lcore_id=%u\n", n->lcore_id);
 
 	for (i = 0; i < n->nb_edges; i++)
 		fprintf(f, "     edge[%d] <%s>\n", i, n->next_nodes[i]);
@@ -61,6 +62,8 @@ rte_graph_obj_dump(FILE *f, struct rte_graph *g, bool all)
 	fprintf(f, "  fence=0x%" PRIx64 "\n", g->fence);
 	fprintf(f, "  nodes_start=0x%" PRIx32 "\n", g->nodes_start);
 	fprintf(f, "  cir_start=%p\n", g->cir_start);
+	fprintf(f, "  lcore_id=%u\n", g->lcore_id);
+	fprintf(f, "  wq=%p\n", g->wq);
 
 	rte_graph_foreach_node(count, off, g, n) {
 		if (!all && n->idx == 0)
@@ -72,6 +75,7 @@ rte_graph_obj_dump(FILE *f, struct rte_graph *g, bool all)
 		fprintf(f, "       id=0x%" PRIx32 "\n", n->id);
 		fprintf(f, "       offset=0x%" PRIx32 "\n", n->off);
 		fprintf(f, "       nb_edges=%" PRId32 "\n", n->nb_edges);
+		fprintf(f, "       lcore_id=%u\n", n->lcore_id);
 		fprintf(f, "       realloc_count=%d\n", n->realloc_count);
 		fprintf(f, "       size=%d\n", n->size);
 		fprintf(f, "       idx=%d\n", n->idx);
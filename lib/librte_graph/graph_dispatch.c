@@ -0,0 +1,169 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2020 Marvell International Ltd.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_memcpy.h>
+#include <rte_mempool.h>
+#include <rte_ring.h>
+
+#include "graph_private.h"
+
+#define GRAPH_DISPATCH_DEQ_BURST 32
+
+static struct rte_graph *
+graph_dispatch_lookup(struct rte_graph *graph, unsigned int lcore_id)
+{
+	struct rte_graph *peer;
+
+	SLIST_FOREACH(peer, graph->rq, rq_next)
+		if (peer->lcore_id == lcore_id)
+			return peer;
+
+	return NULL;
+}
+
+int
+graph_dispatch_core_bind(struct graph *_graph, unsigned int lcore_id)
+{
+	struct rte_graph *graph = _graph->graph;
+	char name[RTE_RING_NAMESIZE];
+	struct rte_mempool *mp;
+	struct rte_ring *wq;
+	unsigned int sz;
+
+	if (graph->wq != NULL)
+		SET_ERR_JMP(EBUSY, fail, "Graph %s already bound to lcore %u",
+			    _graph->name, graph->lcore_id);
+
+	if (graph_dispatch_lookup(graph, lcore_id) != NULL)
+		SET_ERR_JMP(EEXIST, fail, "Lcore %u already has a graph bound",
+			    lcore_id);
+
+	sz = rte_align32pow2(_graph->node_count *
+			     GRAPH_DISPATCH_WQ_SIZE_MULTIPLIER);
+
+	snprintf(name, sizeof(name), "GRAPH_WQ_%u", _graph->id);
+	/* Any lcore may hand over streams, only the bound one dequeues */
+	wq = rte_ring_create(name, sz, _graph->socket, RING_F_SC_DEQ);
+	if (wq == NULL)
+		SET_ERR_JMP(ENOMEM, fail, "Failed to create ring %s", name);
+
+	snprintf(name, sizeof(name), "GRAPH_MP_%u", _graph->id);
+	mp = rte_mempool_create(name, sz, sizeof(struct graph_dispatch_wq_node),
+				0, 0, NULL, NULL, NULL, NULL, _graph->socket,
+				0);
+	if (mp == NULL)
+		SET_ERR_JMP(ENOMEM, free_wq, "Failed to create mempool %s",
+			    name);
+
+	graph->lcore_id = lcore_id;
+	graph->mp = mp;
+	/* Switch the walk to dispatch mode last */
+	graph->wq = wq;
+	SLIST_INSERT_HEAD(graph->rq, graph, rq_next);
+
+	return 0;
+free_wq:
+	rte_ring_free(wq);
+fail:
+	return -rte_errno;
+}
+
+void
+graph_dispatch_core_unbind(struct graph *_graph)
+{
+	struct rte_graph *graph = _graph->graph;
+	struct rte_ring *wq = graph->wq;
+
+	if (wq == NULL)
+		return;
+
+	SLIST_REMOVE(graph->rq, graph, rte_graph, rq_next);
+	graph->wq = NULL;
+	graph->lcore_id = RTE_MAX_LCORE;
+	rte_ring_free(wq);
+	rte_mempool_free(graph->mp);
+	graph->mp = NULL;
+}
+
+bool __rte_noinline
+__rte_graph_dispatch_node_enqueue(struct rte_graph *graph,
+				  struct rte_node *node)
+{
+	struct graph_dispatch_wq_node *wq_node;
+	uint16_t off = 0, nb_objs;
+	struct rte_graph *dst;
+
+	dst = graph_dispatch_lookup(graph, node->lcore_id);
+	if (unlikely(dst == NULL))
+		return false;
+
+	while (off < node->idx) {
+		if (unlikely(rte_mempool_get(dst->mp, (void **)&wq_node) < 0))
+			break;
+
+		nb_objs = RTE_MIN(node->idx - off, RTE_GRAPH_BURST_SIZE);
+		wq_node->node_off = node->off;
+		wq_node->nb_objs = nb_objs;
+		rte_memcpy(wq_node->objs, &node->objs[off],
+			   nb_objs * sizeof(void *));
+
+		if (unlikely(rte_ring_enqueue(dst->wq, wq_node) < 0)) {
+			rte_mempool_put(dst->mp, wq_node);
+			break;
+		}
+		off += nb_objs;
+	}
+
+	if (likely(off == node->idx)) {
+		node->idx = 0;
+		return true;
+	}
+
+	/* Leave the objects which could not be handed over to the caller */
+	memmove(node->objs, &node->objs[off],
+		(node->idx - off) * sizeof(void *));
+	node->idx -= off;
+	return false;
+}
+
+void __rte_noinline
+__rte_graph_dispatch_wq_process(struct rte_graph *graph)
+{
+	void *wq_nodes[GRAPH_DISPATCH_DEQ_BURST];
+	struct graph_dispatch_wq_node *wq_node;
+	struct rte_node *node;
+	unsigned int i, n;
+	uint16_t idx;
+
+	n = rte_ring_sc_dequeue_burst(graph->wq, wq_nodes, RTE_DIM(wq_nodes),
+				      NULL);
+	if (n == 0)
+		return;
+
+	for (i = 0; i < n; i++) {
+		wq_node = wq_nodes[i];
+		node = RTE_PTR_ADD(graph, wq_node->node_off);
+		RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
+		idx = node->idx;
+
+		/* Add to the pending stream list if the node is new */
+		if (idx == 0)
+			__rte_node_enqueue_tail_update(graph, node);
+		if (unlikely(node->size < idx + wq_node->nb_objs))
+			__rte_node_stream_alloc_size(graph, node,
+						     idx + wq_node->nb_objs);
+
+		rte_memcpy(&node->objs[idx], wq_node->objs,
+			   wq_node->nb_objs * sizeof(void *));
+		node->idx = idx + wq_node->nb_objs;
+	}
+
+	rte_mempool_put_bulk(graph->mp, wq_nodes, n);
+}
@@ -58,7 +58,18 @@ graph_header_popluate(struct graph *_graph)
 	graph->nodes_start = _graph->nodes_start;
 	graph->socket = _graph->socket;
 	graph->id = _graph->id;
+	graph->hist_interval = 0;
 	memcpy(graph->name, _graph->name, RTE_GRAPH_NAMESIZE);
+	graph->wq = NULL;
+	graph->mp = NULL;
+	graph->lcore_id = RTE_MAX_LCORE;
+	/* Clones share the dispatch list of their parent */
+	if (_graph->parent != NULL) {
+		graph->rq = _graph->parent->graph->rq;
+	} else {
+		SLIST_INIT(&graph->rq_head);
+		graph->rq = &graph->rq_head;
+	}
 	graph->fence = RTE_GRAPH_FENCE;
 }
 
@@ -86,6 +97,7 @@ graph_nodes_populate(struct graph *_graph)
 		}
 		node->id = graph_node->node->id;
 		node->parent_id = pid;
+		node->lcore_id = graph_node->node->lcore_id;
 		nb_edges = graph_node->node->nb_edges;
 		node->nb_edges = nb_edges;
 		off += sizeof(struct rte_node);
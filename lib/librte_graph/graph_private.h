@@ -55,6 +55,7 @@ struct node {
 	rte_node_t id;		      /**< Allocated identifier for the node. */
 	rte_node_t parent_id;	      /**< Parent node identifier. */
 	rte_edge_t nb_edges;	      /**< Number of edges from this node. */
+	unsigned int lcore_id;	      /**< Lcore affinity in dispatch mode. */
 	char next_nodes[][RTE_NODE_NAMESIZE]; /**< Names of next nodes. */
 };
 
@@ -100,10 +101,33 @@ struct graph {
 	/**< Memory size of the graph. */
 	int socket;
 	/**< Socket identifier where memory is allocated. */
+	struct graph *parent;
+	/**< Graph this graph was cloned from, NULL if not a clone. */
 	STAILQ_HEAD(gnode_list, graph_node) node_list;
 	/**< Nodes in a graph. */
 };
 
+/**
+ * @internal
+ *
+ * Number of work queue entries per node of a graph bound in dispatch mode.
+ */
+#define GRAPH_DISPATCH_WQ_SIZE_MULTIPLIER 8
+
+/**
+ * @internal
+ *
+ * Work queue entry holding a stream handed over to another lcore.
+ */
+struct graph_dispatch_wq_node {
+	rte_graph_off_t node_off;
+	/**< Offset of the node in the graph reel. */
+	uint16_t nb_objs;
+	/**< Number of objects in the entry. */
+	void *objs[RTE_GRAPH_BURST_SIZE];
+	/**< Objects handed over. */
+} __rte_cache_aligned;
+
 /* Node functions */
 STAILQ_HEAD(node_head, node);
 
@@ -286,6 +310,35 @@ int graph_fp_mem_create(struct graph *graph);
  */
 int graph_fp_mem_destroy(struct graph *graph);
 
+/* Dispatch mode functions */
+/**
+ * @internal
+ *
+ * Bind the graph to an lcore and allocate its work queue.
+ *
+ * @param graph
+ *   Pointer to the internal graph object.
+ * @param lcore_id
+ *   Lcore to bind the graph to.
+ *
+ * @return
+ *   - 0: Success.
+ *   - -EBUSY: Graph is already bound.
+ *   - -EEXIST: Another graph sharing the nodes is bound to the lcore.
+ *   - -ENOMEM: Not enough memory for the work queue.
+ */
+int graph_dispatch_core_bind(struct graph *graph, unsigned int lcore_id);
+
+/**
+ * @internal
+ *
+ * Unbind the graph from its lcore and free its work queue.
+ *
+ * @param graph
+ *   Pointer to the internal graph object.
+ */
+void graph_dispatch_core_unbind(struct graph *graph);
+
 /* Lookup functions */
 /**
  * @internal
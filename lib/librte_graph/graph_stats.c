@@ -4,10 +4,12 @@
 
 #include <fnmatch.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include <rte_common.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
+#include <rte_telemetry.h>
 
 #include "graph_private.h"
 
@@ -332,7 +334,10 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 	struct rte_graph_cluster_node_stats *stat = &cluster->stat;
 	struct rte_node *node;
 	rte_node_t count;
+	unsigned int i;
 
+	memset(stat->hist_burst, 0, sizeof(stat->hist_burst));
+	memset(stat->hist_cycles, 0, sizeof(stat->hist_cycles));
 	for (count = 0; count < cluster->nb_nodes; count++) {
 		node = cluster->nodes[count];
 
@@ -340,6 +345,10 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 		objs += node->total_objs;
 		cycles += node->total_cycles;
 		realloc_count += node->realloc_count;
+		for (i = 0; i < RTE_GRAPH_HIST_BURST_BUCKETS; i++)
+			stat->hist_burst[i] += node->hist_burst[i];
+		for (i = 0; i < RTE_GRAPH_HIST_CYCLES_BUCKETS; i++)
+			stat->hist_cycles[i] += node->hist_cycles[i];
 	}
 
 	stat->calls = calls;
@@ -401,6 +410,98 @@ rte_graph_cluster_stats_reset(struct rte_graph_cluster_stats *stat)
 		node->prev_objs = 0;
 		node->prev_cycles = 0;
 		node->realloc_count = 0;
+		memset(node->hist_burst, 0, sizeof(node->hist_burst));
+		memset(node->hist_cycles, 0, sizeof(node->hist_cycles));
 		cluster = RTE_PTR_ADD(cluster, stat->cluster_node_size);
 	}
 }
+
+static int
+graph_handle_list(const char *cmd __rte_unused,
+		  const char *params __rte_unused, struct rte_tel_data *d)
+{
+	struct graph_head *graph_head = graph_list_head_get();
+	struct graph *graph;
+
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+	graph_spinlock_lock();
+	STAILQ_FOREACH(graph, graph_head, next)
+		rte_tel_data_add_array_string(d, graph->name);
+	graph_spinlock_unlock();
+
+	return 0;
+}
+
+static void
+graph_tel_hist_add(struct rte_tel_data *d, const char *prefix,
+		   const uint64_t *hist, unsigned int nb_buckets)
+{
+	char name[RTE_TEL_MAX_STRING_LEN];
+	unsigned int i;
+
+	/* Name each bucket after its lower bound */
+	for (i = 0; i < nb_buckets; i++) {
+		snprintf(name, sizeof(name), "%s_%" PRIu64, prefix,
+			 i ? UINT64_C(1) << (i - 1) : 0);
+		rte_tel_data_add_dict_u64(d, name, hist[i]);
+	}
+}
+
+static int
+graph_handle_node_stats(const char *cmd __rte_unused, const char *params,
+			struct rte_tel_data *d)
+{
+	struct graph_head *graph_head = graph_list_head_get();
+	struct rte_graph_cluster_node_stats stat;
+	struct rte_node *node;
+	struct graph *graph;
+	bool found = false;
+	unsigned int i;
+
+	if (params == NULL || strlen(params) == 0)
+		return -1;
+
+	/* Aggregate the node across all the graphs, as the cluster stats do */
+	memset(&stat, 0, sizeof(stat));
+	graph_spinlock_lock();
+	STAILQ_FOREACH(graph, graph_head, next) {
+		node = graph_node_name_to_ptr(graph->graph, params);
+		if (node == NULL)
+			continue;
+
+		stat.calls += node->total_calls;
+		stat.objs += node->total_objs;
+		stat.cycles += node->total_cycles;
+		stat.realloc_count += node->realloc_count;
+		for (i = 0; i < RTE_GRAPH_HIST_BURST_BUCKETS; i++)
+			stat.hist_burst[i] += node->hist_burst[i];
+		for (i = 0; i < RTE_GRAPH_HIST_CYCLES_BUCKETS; i++)
+			stat.hist_cycles[i] += node->hist_cycles[i];
+		found = true;
+	}
+	graph_spinlock_unlock();
+
+	if (!found)
+		return -1;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_u64(d, "calls", stat.calls);
+	rte_tel_data_add_dict_u64(d, "objs", stat.objs);
+	rte_tel_data_add_dict_u64(d, "cycles", stat.cycles);
+	rte_tel_data_add_dict_u64(d, "realloc_count", stat.realloc_count);
+	graph_tel_hist_add(d, "burst", stat.hist_burst,
+			   RTE_GRAPH_HIST_BURST_BUCKETS);
+	graph_tel_hist_add(d, "cycles_per_obj", stat.hist_cycles,
+			   RTE_GRAPH_HIST_CYCLES_BUCKETS);
+
+	return 0;
+}
+
+RTE_INIT(graph_init_telemetry)
+{
+	rte_telemetry_register_cmd("/graph/list", graph_handle_list,
+		"Returns list of available graphs. Takes no parameters");
+	rte_telemetry_register_cmd("/graph/node_stats",
+		graph_handle_node_stats,
+		"Returns node stats across graphs. Parameters: string node");
+}
@@ -96,6 +96,7 @@ __rte_node_register(const struct rte_node_register *reg)
 	node->fini = reg->fini;
 	node->nb_edges = reg->nb_edges;
 	node->parent_id = reg->parent_id;
+	node->lcore_id = RTE_MAX_LCORE;
 	for (i = 0; i < reg->nb_edges; i++) {
 		if (rte_strscpy(node->next_nodes[i], reg->next_nodes[i],
 				RTE_NODE_NAMESIZE) < 0) {
@@ -227,6 +228,30 @@ rte_node_id_to_name(rte_node_t id)
 	return NULL;
 }
 
+int
+rte_node_lcore_affinity_set(rte_node_t id, unsigned int lcore_id)
+{
+	struct node *node;
+	int rc = -ENOENT;
+
+	NODE_ID_CHECK(id);
+	if (lcore_id > RTE_MAX_LCORE)
+		goto fail;
+
+	graph_spinlock_lock();
+	STAILQ_FOREACH(node, &node_list, next)
+		if (node->id == id) {
+			node->lcore_id = lcore_id;
+			rc = 0;
+			break;
+		}
+	graph_spinlock_unlock();
+
+	return rc;
+fail:
+	return -EINVAL;
+}
+
 rte_edge_t
 rte_node_edge_count(rte_node_t id)
 {
@@ -40,6 +40,10 @@ extern "C" {
 #define RTE_EDGE_ID_INVALID UINT16_MAX   /**< Invalid edge id. */
 #define RTE_GRAPH_ID_INVALID UINT16_MAX  /**< Invalid graph id. */
 #define RTE_GRAPH_FENCE 0xdeadbeef12345678ULL /**< Graph fence data. */
+#define RTE_GRAPH_HIST_BURST_BUCKETS 10
+/**< Number of buckets of the node burst size histogram. */
+#define RTE_GRAPH_HIST_CYCLES_BUCKETS 16
+/**< Number of buckets of the node cycles per object histogram. */
 
 typedef uint32_t rte_graph_off_t;  /**< Graph offset type. */
 typedef uint32_t rte_node_t;       /**< Node id type. */
@@ -206,6 +210,19 @@ struct rte_graph_cluster_node_stats {
 
 	uint64_t realloc_count; /**< Realloc count. */
 
+	uint64_t hist_burst[RTE_GRAPH_HIST_BURST_BUCKETS];
+	/**< Sampled burst sizes, bucket n counts the calls which processed
+	 *   [2^(n-1), 2^n) objects, bucket 0 the calls with no object and the
+	 *   last bucket the larger bursts.
+	 *
+	 *   @see rte_graph_hist_enable()
+	 */
+	uint64_t hist_cycles[RTE_GRAPH_HIST_CYCLES_BUCKETS];
+	/**< Sampled cycles per object, bucket n counts the calls which spent
+	 *   [2^(n-1), 2^n) cycles per object, the last bucket the slower calls.
+	 *   Calls with no object are not accounted.
+	 */
+
 	rte_node_t id;	/**< Node identifier of stats. */
 	uint64_t hz;	/**< Cycles per seconds. */
 	char name[RTE_NODE_NAMESIZE];	/**< Name of the node. */
@@ -242,6 +259,72 @@ rte_graph_t rte_graph_create(const char *name, struct rte_graph_param *prm);
 __rte_experimental
 int rte_graph_destroy(rte_graph_t id);
 
+/**
+ * Clone Graph.
+ *
+ * Create a graph with the same nodes as an existing graph, for a worker
+ * running on another lcore. The nodes are laid out identically in both
+ * graphs, which allows to hand over streams between them in dispatch mode.
+ *
+ * @param id
+ *   id of the graph to clone from.
+ * @param name
+ *   Name of the new graph. The library prepends the parent graph name to the
+ * user-specified name. The final graph name will be,
+ * "parent graph name" + "-" + name.
+ *
+ * @return
+ *   Valid graph id on success, RTE_GRAPH_ID_INVALID otherwise.
+ *
+ * @see rte_graph_dispatch_core_bind()
+ */
+__rte_experimental
+rte_graph_t rte_graph_clone(rte_graph_t id, const char *name);
+
+/**
+ * Bind a graph to an lcore for the dispatch mode.
+ *
+ * Once bound, rte_graph_walk() on this graph only processes the nodes
+ * with no lcore affinity or with affinity to this lcore. The streams of the
+ * other nodes are handed over through a lock-free ring to the graph, among
+ * the ones cloned from the same parent, bound to the lcore those nodes
+ * have affinity with, or processed locally if there is no such graph.
+ * Source nodes pinned to another lcore are not run at all.
+ *
+ * The graph must be walked from the given lcore only. Binding and unbinding
+ * must not be done while any graph cloned from the same parent is walked.
+ *
+ * @param id
+ *   id of the graph to bind.
+ * @param lcore_id
+ *   Lcore the graph is walked on.
+ *
+ * @return
+ *   0 on success, error otherwise:
+ *   - -EINVAL: Invalid graph id or lcore id.
+ *   - -ENOENT: Graph not found.
+ *   - -EBUSY: Graph is already bound.
+ *   - -EEXIST: A graph cloned from the same parent is bound to the lcore.
+ *   - -ENOMEM: Not enough memory for the ring.
+ *
+ * @see rte_graph_clone()
+ * @see rte_node_lcore_affinity_set()
+ */
+__rte_experimental
+int rte_graph_dispatch_core_bind(rte_graph_t id, unsigned int lcore_id);
+
+/**
+ * Unbind a graph from its lcore.
+ *
+ * The streams still pending in the ring of the graph are dropped, so the
+ * sources should be stopped and the graphs drained before unbinding.
+ *
+ * @param id
+ *   id of the graph to unbind.
+ */
+__rte_experimental
+void rte_graph_dispatch_core_unbind(rte_graph_t id);
+
 /**
  * Get graph id from graph name.
  *
@@ -419,6 +502,39 @@ void rte_graph_cluster_stats_get(struct rte_graph_cluster_stats *stat,
 __rte_experimental
 void rte_graph_cluster_stats_reset(struct rte_graph_cluster_stats *stat);
 
+/**
+ * Enable the burst size and cycles per object histograms of the nodes of a
+ * graph.
+ *
+ * To keep the overhead low, only one out of *sample_interval* calls of each
+ * node is accounted in the histograms. The histograms are reported through
+ * rte_graph_cluster_stats_get() and the /graph/node_stats telemetry command.
+ *
+ * @param id
+ *   Graph id to enable the histograms.
+ * @param sample_interval
+ *   Number of node calls per histogram sample, must be a power of 2.
+ *
+ * @return
+ *   0 on success, -EINVAL if the stats feature is disabled or the interval is
+ *   invalid, -ENOENT if the graph is not found.
+ *
+ * @see struct rte_graph_cluster_node_stats
+ */
+__rte_experimental
+int rte_graph_hist_enable(rte_graph_t id, uint16_t sample_interval);
+
+/**
+ * Disable the node histograms of a graph.
+ *
+ * The samples collected so far are kept.
+ *
+ * @param id
+ *   Graph id to disable the histograms.
+ */
+__rte_experimental
+void rte_graph_hist_disable(rte_graph_t id);
+
 /**
  * Structure defines the node registration parameters.
  *
@@ -485,6 +601,25 @@ rte_node_t __rte_node_register(const struct rte_node_register *node);
 __rte_experimental
 rte_node_t rte_node_clone(rte_node_t id, const char *name);
 
+/**
+ * Set the lcore affinity of a node for the dispatch mode.
+ *
+ * Applies to the graphs created after the call.
+ *
+ * @param id
+ *   Node id.
+ * @param lcore_id
+ *   Lcore the node runs on, RTE_MAX_LCORE to run it on any lcore.
+ *
+ * @return
+ *   0 on success, -EINVAL on invalid node id or lcore id, -ENOENT if the
+ *   node is not found.
+ *
+ * @see rte_graph_dispatch_core_bind()
+ */
+__rte_experimental
+int rte_node_lcore_affinity_set(rte_node_t id, unsigned int lcore_id);
+
 /**
  * Get node id from node name.
  *
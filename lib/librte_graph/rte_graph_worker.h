@@ -16,6 +16,8 @@
  * process, enqueue and move streams of objects to the next nodes.
  */
 
+#include <sys/queue.h>
+
 #include <rte_common.h>
 #include <rte_cycles.h>
 #include <rte_prefetch.h>
@@ -28,6 +30,17 @@
 extern "C" {
 #endif
 
+struct rte_ring;
+struct rte_mempool;
+
+/**
+ * @internal
+ *
+ * List of the graphs, sharing the same nodes, bound to lcores in
+ * dispatch mode.
+ */
+SLIST_HEAD(rte_graph_rq_head, rte_graph);
+
 /**
  * @internal
  *
@@ -41,8 +54,16 @@ struct rte_graph {
 	rte_graph_off_t *cir_start;  /**< Pointer to circular buffer. */
 	rte_graph_off_t nodes_start; /**< Offset at which node memory starts. */
 	rte_graph_t id;	/**< Graph identifier. */
+	uint16_t hist_interval;	/**< Histogram sampling interval, 0 if off. */
 	int socket;	/**< Socket ID where memory is allocated. */
 	char name[RTE_GRAPH_NAMESIZE];	/**< Name of the graph. */
+	/* Dispatch mode area */
+	struct rte_ring *wq;	/**< Streams handed over by other lcores. */
+	struct rte_mempool *mp;	/**< Pool of the handed over streams. */
+	unsigned int lcore_id;	/**< Lcore the graph is bound to. */
+	struct rte_graph_rq_head *rq;	/**< Graphs sharing the nodes. */
+	struct rte_graph_rq_head rq_head;	/**< List head, parent only. */
+	SLIST_ENTRY(rte_graph) rq_next;	/**< Next graph in the list. */
 	uint64_t fence;			/**< Fence. */
 } __rte_cache_aligned;
 
@@ -59,9 +80,14 @@ struct rte_node {
 	rte_node_t parent_id;	/**< Parent Node identifier. */
 	rte_edge_t nb_edges;	/**< Number of edges from this node. */
 	uint32_t realloc_count;	/**< Number of times realloced. */
+	unsigned int lcore_id;	/**< Lcore affinity in dispatch mode. */
 
 	char parent[RTE_NODE_NAMESIZE];	/**< Parent node name. */
 	char name[RTE_NODE_NAMESIZE];	/**< Name of the node. */
+	uint64_t hist_burst[RTE_GRAPH_HIST_BURST_BUCKETS];
+	/**< Sampled burst sizes. */
+	uint64_t hist_cycles[RTE_GRAPH_HIST_CYCLES_BUCKETS];
+	/**< Sampled cycles per object. */
 
 	/* Fast path area  */
 #define RTE_NODE_CTX_SZ 16
@@ -118,14 +144,153 @@ __rte_experimental
 void __rte_node_stream_alloc_size(struct rte_graph *graph,
 				  struct rte_node *node, uint16_t req_size);
 
+/**
+ * @internal
+ *
+ * Hand over the pending stream of a node to the graph bound to the lcore
+ * the node has affinity with.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ * @param node
+ *   Pointer to the node object.
+ *
+ * @return
+ *   true if all the objects of the stream were handed over, false otherwise.
+ *   On false, the objects left in the stream must be processed locally.
+ */
+__rte_experimental
+bool __rte_graph_dispatch_node_enqueue(struct rte_graph *graph,
+				       struct rte_node *node);
+
+/**
+ * @internal
+ *
+ * Move the streams handed over by the other lcores to the pending streams
+ * of the graph.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ */
+__rte_experimental
+void __rte_graph_dispatch_wq_process(struct rte_graph *graph);
+
+/**
+ * @internal
+ *
+ * Account a node call in the node histograms.
+ *
+ * @param node
+ *   Pointer to the node object.
+ * @param objs
+ *   Number of objects processed by the call.
+ * @param cycles
+ *   Cycles spent in the call.
+ */
+static __rte_always_inline void
+__rte_node_hist_update(struct rte_node *node, uint16_t objs, uint64_t cycles)
+{
+	node->hist_burst[RTE_MIN(rte_fls_u32(objs),
+				 RTE_GRAPH_HIST_BURST_BUCKETS - 1)]++;
+	if (objs)
+		node->hist_cycles[RTE_MIN(rte_fls_u64(cycles / objs),
+					  RTE_GRAPH_HIST_CYCLES_BUCKETS - 1)]++;
+}
+
+/**
+ * @internal
+ *
+ * Invoke the process function of the node on its pending stream and collect
+ * the stats.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ * @param node
+ *   Pointer to the node object.
+ */
+static __rte_always_inline void
+__rte_node_process(struct rte_graph *graph, struct rte_node *node)
+{
+	uint64_t start, cycles;
+	uint16_t rc;
+	void **objs;
+
+	RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
+	objs = node->objs;
+	rte_prefetch0(objs);
+
+	if (rte_graph_has_stats_feature()) {
+		start = rte_rdtsc();
+		rc = node->process(graph, node, objs, node->idx);
+		cycles = rte_rdtsc() - start;
+		node->total_cycles += cycles;
+		node->total_calls++;
+		node->total_objs += rc;
+		if (unlikely(graph->hist_interval != 0) &&
+		    (node->total_calls & (graph->hist_interval - 1)) == 0)
+			__rte_node_hist_update(node, rc, cycles);
+	} else {
+		node->process(graph, node, objs, node->idx);
+	}
+	node->idx = 0;
+}
+
+/**
+ * @internal
+ *
+ * Graph walk of a graph bound to an lcore in dispatch mode.
+ *
+ * Same as the default walk, except that the streams of the nodes pinned to
+ * another lcore are handed over to the graph bound to that lcore, and the
+ * streams handed over by the other lcores are processed first.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ */
+static inline void
+__rte_graph_walk_dispatch(struct rte_graph *graph)
+{
+	const rte_graph_off_t *cir_start = graph->cir_start;
+	const unsigned int lcore_id = graph->lcore_id;
+	const rte_node_t mask = graph->cir_mask;
+	uint32_t head = graph->head;
+	struct rte_node *node;
+	bool src;
+
+	__rte_graph_dispatch_wq_process(graph);
+
+	while (likely(head != graph->tail)) {
+		src = (int32_t)head < 0;
+		node = RTE_PTR_ADD(graph, cir_start[(int32_t)head++]);
+
+		if (node->lcore_id != lcore_id &&
+		    node->lcore_id != RTE_MAX_LCORE) {
+			/* Source nodes only run on the lcore they are pinned */
+			if (src)
+				continue;
+			if (!__rte_graph_dispatch_node_enqueue(graph, node))
+				__rte_node_process(graph, node);
+		} else {
+			__rte_node_process(graph, node);
+		}
+		head = likely((int32_t)head > 0) ? head & mask : head;
+	}
+	graph->tail = 0;
+}
+
 /**
  * Perform graph walk on the circular buffer and invoke the process function
  * of the nodes and collect the stats.
  *
+ * If the graph is bound to an lcore with rte_graph_dispatch_core_bind(),
+ * the streams of the nodes pinned to another lcore are handed over to the
+ * graph bound to that lcore instead of being processed.
+ *
  * @param graph
  *   Graph pointer returned from rte_graph_lookup function.
  *
  * @see rte_graph_lookup()
+ * @see rte_graph_dispatch_core_bind()
  */
 __rte_experimental
 static inline void
@@ -135,9 +300,11 @@ rte_graph_walk(struct rte_graph *graph)
 	const rte_node_t mask = graph->cir_mask;
 	uint32_t head = graph->head;
 	struct rte_node *node;
-	uint64_t start;
-	uint16_t rc;
-	void **objs;
+
+	if (unlikely(graph->wq != NULL)) {
+		__rte_graph_walk_dispatch(graph);
+		return;
+	}
 
 	/*
 	 * Walk on the source node(s) ((cir_start - head) -> cir_start) and then
@@ -156,20 +323,7 @@ rte_graph_walk(struct rte_graph *graph)
 	 */
 	while (likely(head != graph->tail)) {
 		node = RTE_PTR_ADD(graph, cir_start[(int32_t)head++]);
-		RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
-		objs = node->objs;
-		rte_prefetch0(objs);
-
-		if (rte_graph_has_stats_feature()) {
-			start = rte_rdtsc();
-			rc = node->process(graph, node, objs, node->idx);
-			node->total_cycles += rte_rdtsc() - start;
-			node->total_calls++;
-			node->total_objs += rc;
-		} else {
-			node->process(graph, node, objs, node->idx);
-		}
-		node->idx = 0;
+		__rte_node_process(graph, node);
 		head = likely((int32_t)head > 0) ? head & mask : head;
 	}
 	graph->tail = 0;
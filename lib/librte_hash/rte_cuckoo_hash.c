@@ -117,16 +117,55 @@ get_short_sig(const hash_sig_t hash)
 }
 
 static inline uint32_t
-get_prim_bucket_index(const struct rte_hash *h, const hash_sig_t hash)
+get_prim_bucket_index(const struct rte_hash_bkt_tbl *tbl, const hash_sig_t hash)
 {
-	return hash & h->bucket_bitmask;
+	return hash & tbl->bucket_bitmask;
 }
 
 static inline uint32_t
-get_alt_bucket_index(const struct rte_hash *h,
+get_alt_bucket_index(const struct rte_hash_bkt_tbl *tbl,
 			uint32_t cur_bkt_idx, uint16_t sig)
 {
-	return (cur_bkt_idx ^ sig) & h->bucket_bitmask;
+	return (cur_bkt_idx ^ sig) & tbl->bucket_bitmask;
+}
+
+/* Bucket table new keys are inserted to. Writer side only. */
+static inline const struct rte_hash_bkt_tbl *
+get_cur_tbl(const struct rte_hash *h)
+{
+	return &h->tbls[h->tbl_state & RTE_HASH_TBL_CUR_MASK];
+}
+
+/* Bucket table being migrated by a resize. Only valid if
+ * RTE_HASH_TBL_RESIZING is set in the table state.
+ */
+static inline const struct rte_hash_bkt_tbl *
+get_old_tbl(const struct rte_hash *h, uint32_t tbl_state)
+{
+	return &h->tbls[(tbl_state & RTE_HASH_TBL_CUR_MASK) ^ 1];
+}
+
+/* Table state as seen by readers. The acquire pairs with the release
+ * store done by a resize, so that the fields of the selected tables are
+ * visible.
+ */
+static inline uint32_t
+get_tbl_state(const struct rte_hash *h)
+{
+	return __atomic_load_n(&h->tbl_state, __ATOMIC_ACQUIRE);
+}
+
+/* Get the key slot of a key index read by a lock free reader. The key
+ * store has to be loaded after the key index: an index published after
+ * the key store was grown must not be used with the old key store.
+ */
+static inline struct rte_hash_key *
+get_key_slot_lf(const struct rte_hash *h, uint32_t key_idx)
+{
+	void *keys = __atomic_load_n(&h->key_store, __ATOMIC_RELAXED);
+
+	return (struct rte_hash_key *)((char *)keys +
+			key_idx * h->key_entry_size);
 }
 
 struct rte_hash *
@@ -403,13 +442,14 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	/* Setup hash context */
 	strlcpy(h->name, params->name, sizeof(h->name));
 	h->entries = params->entries;
+	h->socket_id = params->socket_id;
 	h->key_len = params->key_len;
 	h->key_entry_size = key_entry_size;
 	h->hash_func_init_val = params->hash_func_init_val;
 
-	h->num_buckets = num_buckets;
-	h->bucket_bitmask = h->num_buckets - 1;
-	h->buckets = buckets;
+	h->tbls[0].num_buckets = num_buckets;
+	h->tbls[0].bucket_bitmask = num_buckets - 1;
+	h->tbls[0].buckets = buckets;
 	h->buckets_ext = buckets_ext;
 	h->free_ext_bkts = r_ext;
 	h->hash_func = (params->hash_func == NULL) ?
@@ -429,6 +469,12 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->readwrite_concur_lf_support = readwrite_concur_lf_support;
 
 #if defined(RTE_ARCH_X86)
+#if defined(CC_AVX512_SUPPORT)
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW))
+		h->sig_cmp_fn = RTE_HASH_COMPARE_AVX512;
+	else
+#endif
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
 		h->sig_cmp_fn = RTE_HASH_COMPARE_SSE;
 	else
@@ -505,6 +551,9 @@ rte_hash_free(struct rte_hash *h)
 
 	rte_mcfg_tailq_write_unlock();
 
+	if (h->dq)
+		rte_rcu_qsbr_dq_delete(h->dq);
+
 	if (h->use_local_cache)
 		rte_free(h->local_free_slots);
 	if (h->writer_takes_lock)
@@ -512,14 +561,53 @@ rte_hash_free(struct rte_hash *h)
 	rte_ring_free(h->free_slots);
 	rte_ring_free(h->free_ext_bkts);
 	rte_free(h->key_store);
-	rte_free(h->buckets);
+	rte_free(h->key_store_retired);
+	rte_free(h->tbls[0].buckets);
+	rte_free(h->tbls[1].buckets);
 	rte_free(h->buckets_ext);
 	rte_free(h->tbl_chng_cnt);
 	rte_free(h->ext_bkt_to_free);
+	rte_free(h->hash_rcu_cfg);
 	rte_free(h);
 	rte_free(te);
 }
 
+int
+rte_hash_set_sig_cmp_fn(struct rte_hash *h,
+		enum rte_hash_sig_compare_function sig_cmp_fn)
+{
+	if (h == NULL)
+		return -EINVAL;
+
+	switch (sig_cmp_fn) {
+	case RTE_HASH_COMPARE_SCALAR:
+		break;
+#if defined(RTE_MACHINE_CPUFLAG_SSE2)
+	case RTE_HASH_COMPARE_SSE:
+		if (!rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
+			return -ENOTSUP;
+		break;
+#elif defined(RTE_MACHINE_CPUFLAG_NEON)
+	case RTE_HASH_COMPARE_NEON:
+		if (!rte_cpu_get_flag_enabled(RTE_CPUFLAG_NEON))
+			return -ENOTSUP;
+		break;
+#endif
+#if defined(CC_AVX512_SUPPORT)
+	case RTE_HASH_COMPARE_AVX512:
+		if (!rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) ||
+				!rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW))
+			return -ENOTSUP;
+		break;
+#endif
+	default:
+		return (sig_cmp_fn < RTE_HASH_COMPARE_NUM) ? -ENOTSUP : -EINVAL;
+	}
+
+	h->sig_cmp_fn = sig_cmp_fn;
+	return 0;
+}
+
 hash_sig_t
 rte_hash_hash(const struct rte_hash *h, const void *key)
 {
@@ -606,13 +694,27 @@ __hash_rw_reader_unlock(const struct rte_hash *h)
 void
 rte_hash_reset(struct rte_hash *h)
 {
+	const struct rte_hash_bkt_tbl *tbl;
 	uint32_t tot_ring_cnt, i;
+	unsigned int pending;
 
 	if (h == NULL)
 		return;
 
 	__hash_rw_writer_lock(h);
-	memset(h->buckets, 0, h->num_buckets * sizeof(struct rte_hash_bucket));
+
+	if (h->dq) {
+		/* Reclaim all the resources */
+		rte_rcu_qsbr_dq_reclaim(h->dq, ~0, NULL, &pending, NULL);
+		if (pending != 0)
+			RTE_LOG(ERR, HASH, "RCU reclaim all resources failed\n");
+	}
+
+	/* Drop the table being migrated, if any, all keys are gone */
+	h->tbl_state &= RTE_HASH_TBL_CUR_MASK;
+	tbl = get_cur_tbl(h);
+	memset(tbl->buckets, 0, tbl->num_buckets *
+					sizeof(struct rte_hash_bucket));
 	memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
 	*h->tbl_chng_cnt = 0;
 
@@ -621,7 +723,7 @@ rte_hash_reset(struct rte_hash *h)
 
 	/* flush free extendable bucket ring and memory */
 	if (h->ext_table_support) {
-		memset(h->buckets_ext, 0, h->num_buckets *
+		memset(h->buckets_ext, 0, tbl->num_buckets *
 						sizeof(struct rte_hash_bucket));
 		rte_ring_reset(h->free_ext_bkts);
 	}
@@ -638,7 +740,7 @@ rte_hash_reset(struct rte_hash *h)
 
 	/* Repopulate the free ext bkt ring. */
 	if (h->ext_table_support) {
-		for (i = 1; i <= h->num_buckets; i++)
+		for (i = 1; i <= tbl->num_buckets; i++)
 			rte_ring_sp_enqueue_elem(h->free_ext_bkts, &i,
 							sizeof(uint32_t));
 	}
@@ -669,6 +771,42 @@ enqueue_slot_back(const struct rte_hash *h,
 						sizeof(uint32_t));
 }
 
+/*
+ * Get a free key index from the cache/ring. Returns EMPTY_SLOT if
+ * none is left.
+ */
+static inline uint32_t
+alloc_slot(const struct rte_hash *h, struct lcore_cache *cached_free_slots)
+{
+	unsigned int n_slots;
+	uint32_t slot_id;
+
+	if (h->use_local_cache) {
+		/* Try to get a free slot from the local cache */
+		if (cached_free_slots->len == 0) {
+			/* Need to get another burst of free slots from global ring */
+			n_slots = rte_ring_mc_dequeue_burst_elem(h->free_slots,
+					cached_free_slots->objs,
+					sizeof(uint32_t),
+					LCORE_CACHE_SIZE, NULL);
+			if (n_slots == 0)
+				return EMPTY_SLOT;
+
+			cached_free_slots->len += n_slots;
+		}
+
+		/* Get a free slot from the local cache */
+		cached_free_slots->len--;
+		slot_id = cached_free_slots->objs[cached_free_slots->len];
+	} else {
+		if (rte_ring_sc_dequeue_elem(h->free_slots, &slot_id,
+						sizeof(uint32_t)) != 0)
+			return EMPTY_SLOT;
+	}
+
+	return slot_id;
+}
+
 /* Search a key from bucket and update its data.
  * Writer holds the lock before calling this.
  */
@@ -704,6 +842,28 @@ search_and_update(const struct rte_hash *h, void *data, const void *key,
 	return -1;
 }
 
+/* Search a key in the bucket table being migrated by a resize and update
+ * its data. Writer holds the lock before calling this.
+ */
+static inline int32_t
+search_and_update_old(const struct rte_hash *h, void *data, const void *key,
+	hash_sig_t sig, uint16_t short_sig)
+{
+	const struct rte_hash_bkt_tbl *old = get_old_tbl(h, h->tbl_state);
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	int32_t ret;
+
+	prim_bucket_idx = get_prim_bucket_index(old, sig);
+	ret = search_and_update(h, data, key,
+			&old->buckets[prim_bucket_idx], short_sig);
+	if (ret != -1)
+		return ret;
+
+	sec_bucket_idx = get_alt_bucket_index(old, prim_bucket_idx, short_sig);
+	return search_and_update(h, data, key,
+			&old->buckets[sec_bucket_idx], short_sig);
+}
+
 /* Only tries to insert at one bucket (@prim_bkt) without trying to push
  * buckets around.
  * return 1 if matching existing key, return 0 if succeeds, return -1 for no
@@ -782,6 +942,7 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 			uint16_t sig, uint32_t new_idx,
 			int32_t *ret_val)
 {
+	const struct rte_hash_bkt_tbl *tbl = get_cur_tbl(h);
 	uint32_t prev_alt_bkt_idx;
 	struct rte_hash_bucket *cur_bkt;
 	struct queue_node *prev_node, *curr_node = leaf;
@@ -821,11 +982,11 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 		prev_bkt = prev_node->bkt;
 		prev_slot = curr_node->prev_slot;
 
-		prev_alt_bkt_idx = get_alt_bucket_index(h,
+		prev_alt_bkt_idx = get_alt_bucket_index(tbl,
 					prev_node->cur_bkt_idx,
 					prev_bkt->sig_current[prev_slot]);
 
-		if (unlikely(&h->buckets[prev_alt_bkt_idx]
+		if (unlikely(&tbl->buckets[prev_alt_bkt_idx]
 				!= curr_bkt)) {
 			/* revert it to empty, otherwise duplicated keys */
 			__atomic_store_n(&curr_bkt->key_idx[curr_slot],
@@ -907,6 +1068,7 @@ rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
 			uint16_t sig, uint32_t bucket_idx,
 			uint32_t new_idx, int32_t *ret_val)
 {
+	const struct rte_hash_bkt_tbl *tbl = get_cur_tbl(h);
 	unsigned int i;
 	struct queue_node queue[RTE_HASH_BFS_QUEUE_MAX_LEN];
 	struct queue_node *tail, *head;
@@ -937,9 +1099,9 @@ rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
 			}
 
 			/* Enqueue new node and keep prev node info */
-			alt_idx = get_alt_bucket_index(h, cur_idx,
+			alt_idx = get_alt_bucket_index(tbl, cur_idx,
 						curr_bkt->sig_current[i]);
-			alt_bkt = &(h->buckets[alt_idx]);
+			alt_bkt = &(tbl->buckets[alt_idx]);
 			head->bkt = alt_bkt;
 			head->cur_bkt_idx = alt_idx;
 			head->prev = tail;
@@ -956,6 +1118,7 @@ static inline int32_t
 __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig, void *data)
 {
+	const struct rte_hash_bkt_tbl *tbl = get_cur_tbl(h);
 	uint16_t short_sig;
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
@@ -963,7 +1126,6 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	uint32_t ext_bkt_id = 0;
 	uint32_t slot_id;
 	int ret;
-	unsigned n_slots;
 	unsigned lcore_id;
 	unsigned int i;
 	struct lcore_cache *cached_free_slots = NULL;
@@ -971,10 +1133,10 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	struct rte_hash_bucket *last;
 
 	short_sig = get_short_sig(sig);
-	prim_bucket_idx = get_prim_bucket_index(h, sig);
-	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
-	prim_bkt = &h->buckets[prim_bucket_idx];
-	sec_bkt = &h->buckets[sec_bucket_idx];
+	prim_bucket_idx = get_prim_bucket_index(tbl, sig);
+	sec_bucket_idx = get_alt_bucket_index(tbl, prim_bucket_idx, short_sig);
+	prim_bkt = &tbl->buckets[prim_bucket_idx];
+	sec_bkt = &tbl->buckets[sec_bucket_idx];
 	rte_prefetch0(prim_bkt);
 	rte_prefetch0(sec_bkt);
 
@@ -995,35 +1157,34 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
+	/* Check if key is still in the table being migrated */
+	if (h->tbl_state & RTE_HASH_TBL_RESIZING) {
+		ret = search_and_update_old(h, data, key, sig, short_sig);
+		if (ret != -1) {
+			__hash_rw_writer_unlock(h);
+			return ret;
+		}
+	}
+
 	__hash_rw_writer_unlock(h);
 
 	/* Did not find a match, so get a new slot for storing the new key */
 	if (h->use_local_cache) {
 		lcore_id = rte_lcore_id();
 		cached_free_slots = &h->local_free_slots[lcore_id];
-		/* Try to get a free slot from the local cache */
-		if (cached_free_slots->len == 0) {
-			/* Need to get another burst of free slots from global ring */
-			n_slots = rte_ring_mc_dequeue_burst_elem(h->free_slots,
-					cached_free_slots->objs,
-					sizeof(uint32_t),
-					LCORE_CACHE_SIZE, NULL);
-			if (n_slots == 0) {
-				return -ENOSPC;
-			}
-
-			cached_free_slots->len += n_slots;
-		}
-
-		/* Get a free slot from the local cache */
-		cached_free_slots->len--;
-		slot_id = cached_free_slots->objs[cached_free_slots->len];
-	} else {
-		if (rte_ring_sc_dequeue_elem(h->free_slots, &slot_id,
-						sizeof(uint32_t)) != 0) {
-			return -ENOSPC;
-		}
 	}
+	slot_id = alloc_slot(h, cached_free_slots);
+	if (slot_id == EMPTY_SLOT && h->dq != NULL) {
+		/* No free key index, try to reclaim deleted ones */
+		__hash_rw_writer_lock(h);
+		if (rte_rcu_qsbr_dq_reclaim(h->dq,
+				h->hash_rcu_cfg->reclaim_max,
+				NULL, NULL, NULL) == 0)
+			slot_id = alloc_slot(h, cached_free_slots);
+		__hash_rw_writer_unlock(h);
+	}
+	if (slot_id == EMPTY_SLOT)
+		return -ENOSPC;
 
 	new_k = RTE_PTR_ADD(keys, slot_id * h->key_entry_size);
 	/* The store to application data (by the application) at *data should
@@ -1118,8 +1279,16 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	if (rte_ring_sc_dequeue_elem(h->free_ext_bkts, &ext_bkt_id,
 						sizeof(uint32_t)) != 0 ||
 					ext_bkt_id == 0) {
-		ret = -ENOSPC;
-		goto failure;
+		/* Deleted keys may hold back empty extendable buckets */
+		if (h->dq == NULL || rte_rcu_qsbr_dq_reclaim(h->dq,
+				h->hash_rcu_cfg->reclaim_max,
+				NULL, NULL, NULL) != 0 ||
+				rte_ring_sc_dequeue_elem(h->free_ext_bkts,
+					&ext_bkt_id, sizeof(uint32_t)) != 0 ||
+				ext_bkt_id == 0) {
+			ret = -ENOSPC;
+			goto failure;
+		}
 	}
 
 	/* Use the first location of the new bucket */
@@ -1222,7 +1391,7 @@ search_one_bucket_lf(const struct rte_hash *h, const void *key, uint16_t sig,
 {
 	int i;
 	uint32_t key_idx;
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_key *k;
 
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 		/* Signature comparison is done before the acquire-load
@@ -1236,8 +1405,7 @@ search_one_bucket_lf(const struct rte_hash *h, const void *key, uint16_t sig,
 			key_idx = __atomic_load_n(&bkt->key_idx[i],
 					  __ATOMIC_ACQUIRE);
 			if (key_idx != EMPTY_SLOT) {
-				k = (struct rte_hash_key *) ((char *)keys +
-						key_idx * h->key_entry_size);
+				k = get_key_slot_lf(h, key_idx);
 
 				if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 					if (data != NULL) {
@@ -1257,22 +1425,68 @@ search_one_bucket_lf(const struct rte_hash *h, const void *key, uint16_t sig,
 	return -1;
 }
 
+/* Search the bucket table being migrated by a resize. It has no
+ * extendable buckets.
+ */
+static inline int32_t
+search_old_tbl_l(const struct rte_hash *h, const void *key, hash_sig_t sig,
+		uint16_t short_sig, void **data, uint32_t tbl_state)
+{
+	const struct rte_hash_bkt_tbl *old = get_old_tbl(h, tbl_state);
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	int32_t ret;
+
+	prim_bucket_idx = get_prim_bucket_index(old, sig);
+	ret = search_one_bucket_l(h, key, short_sig, data,
+			&old->buckets[prim_bucket_idx]);
+	if (ret != -1)
+		return ret;
+
+	sec_bucket_idx = get_alt_bucket_index(old, prim_bucket_idx, short_sig);
+	return search_one_bucket_l(h, key, short_sig, data,
+			&old->buckets[sec_bucket_idx]);
+}
+
+static inline int32_t
+search_old_tbl_lf(const struct rte_hash *h, const void *key, hash_sig_t sig,
+		uint16_t short_sig, void **data, uint32_t tbl_state)
+{
+	const struct rte_hash_bkt_tbl *old = get_old_tbl(h, tbl_state);
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	int32_t ret;
+
+	prim_bucket_idx = get_prim_bucket_index(old, sig);
+	ret = search_one_bucket_lf(h, key, short_sig, data,
+			&old->buckets[prim_bucket_idx]);
+	if (ret != -1)
+		return ret;
+
+	sec_bucket_idx = get_alt_bucket_index(old, prim_bucket_idx, short_sig);
+	return search_one_bucket_lf(h, key, short_sig, data,
+			&old->buckets[sec_bucket_idx]);
+}
+
 static inline int32_t
 __rte_hash_lookup_with_hash_l(const struct rte_hash *h, const void *key,
 				hash_sig_t sig, void **data)
 {
+	const struct rte_hash_bkt_tbl *tbl;
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *bkt, *cur_bkt;
+	uint32_t tbl_state;
 	int ret;
 	uint16_t short_sig;
 
-	short_sig = get_short_sig(sig);
-	prim_bucket_idx = get_prim_bucket_index(h, sig);
-	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
+	__hash_rw_reader_lock(h);
 
-	bkt = &h->buckets[prim_bucket_idx];
+	tbl_state = get_tbl_state(h);
+	tbl = &h->tbls[tbl_state & RTE_HASH_TBL_CUR_MASK];
 
-	__hash_rw_reader_lock(h);
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = get_prim_bucket_index(tbl, sig);
+	sec_bucket_idx = get_alt_bucket_index(tbl, prim_bucket_idx, short_sig);
+
+	bkt = &tbl->buckets[prim_bucket_idx];
 
 	/* Check if key is in primary location */
 	ret = search_one_bucket_l(h, key, short_sig, data, bkt);
@@ -1281,7 +1495,7 @@ __rte_hash_lookup_with_hash_l(const struct rte_hash *h, const void *key,
 		return ret;
 	}
 	/* Calculate secondary hash */
-	bkt = &h->buckets[sec_bucket_idx];
+	bkt = &tbl->buckets[sec_bucket_idx];
 
 	/* Check if key is in secondary location */
 	FOR_EACH_BUCKET(cur_bkt, bkt) {
@@ -1293,6 +1507,16 @@ __rte_hash_lookup_with_hash_l(const struct rte_hash *h, const void *key,
 		}
 	}
 
+	/* Check if key is not migrated yet */
+	if (tbl_state & RTE_HASH_TBL_RESIZING) {
+		ret = search_old_tbl_l(h, key, sig, short_sig, data,
+					tbl_state);
+		if (ret != -1) {
+			__hash_rw_reader_unlock(h);
+			return ret;
+		}
+	}
+
 	__hash_rw_reader_unlock(h);
 
 	return -ENOENT;
@@ -1302,15 +1526,15 @@ static inline int32_t
 __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 					hash_sig_t sig, void **data)
 {
+	const struct rte_hash_bkt_tbl *tbl;
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *bkt, *cur_bkt;
 	uint32_t cnt_b, cnt_a;
+	uint32_t tbl_state;
 	int ret;
 	uint16_t short_sig;
 
 	short_sig = get_short_sig(sig);
-	prim_bucket_idx = get_prim_bucket_index(h, sig);
-	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
 
 	do {
 		/* Load the table change counter before the lookup
@@ -1320,13 +1544,22 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
 				__ATOMIC_ACQUIRE);
 
+		/* A resize may have started or completed since the
+		 * last attempt, pick up the current bucket tables.
+		 */
+		tbl_state = get_tbl_state(h);
+		tbl = &h->tbls[tbl_state & RTE_HASH_TBL_CUR_MASK];
+		prim_bucket_idx = get_prim_bucket_index(tbl, sig);
+		sec_bucket_idx = get_alt_bucket_index(tbl, prim_bucket_idx,
+							short_sig);
+
 		/* Check if key is in primary location */
-		bkt = &h->buckets[prim_bucket_idx];
+		bkt = &tbl->buckets[prim_bucket_idx];
 		ret = search_one_bucket_lf(h, key, short_sig, data, bkt);
 		if (ret != -1)
 			return ret;
 		/* Calculate secondary hash */
-		bkt = &h->buckets[sec_bucket_idx];
+		bkt = &tbl->buckets[sec_bucket_idx];
 
 		/* Check if key is in secondary location */
 		FOR_EACH_BUCKET(cur_bkt, bkt) {
@@ -1336,6 +1569,14 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 				return ret;
 		}
 
+		/* Check if key is not migrated yet */
+		if (tbl_state & RTE_HASH_TBL_RESIZING) {
+			ret = search_old_tbl_lf(h, key, sig, short_sig, data,
+						tbl_state);
+			if (ret != -1)
+				return ret;
+		}
+
 		/* The loads of sig_current in search_one_bucket
 		 * should not move below the load from tbl_chng_cnt.
 		 */
@@ -1426,6 +1667,68 @@ remove_entry(const struct rte_hash *h, struct rte_hash_bucket *bkt, unsigned i)
 	}
 }
 
+/* Return a key index to the cache/ring of free slots */
+static inline int
+free_slot(const struct rte_hash *h, uint32_t key_idx)
+{
+	unsigned int lcore_id, n_slots;
+	struct lcore_cache *cached_free_slots;
+
+	if (h->use_local_cache) {
+		lcore_id = rte_lcore_id();
+		cached_free_slots = &h->local_free_slots[lcore_id];
+		/* Cache full, need to free it. */
+		if (cached_free_slots->len == LCORE_CACHE_SIZE) {
+			/* Need to enqueue the free slots in global ring. */
+			n_slots = rte_ring_mp_enqueue_burst_elem(h->free_slots,
+						cached_free_slots->objs,
+						sizeof(uint32_t),
+						LCORE_CACHE_SIZE, NULL);
+			RETURN_IF_TRUE((n_slots == 0), -EFAULT);
+			cached_free_slots->len -= n_slots;
+		}
+		/* Put index of new free slot in cache. */
+		cached_free_slots->objs[cached_free_slots->len] = key_idx;
+		cached_free_slots->len++;
+	} else {
+		rte_ring_sp_enqueue_elem(h->free_slots, &key_idx,
+						sizeof(uint32_t));
+	}
+
+	return 0;
+}
+
+/* Free the key index and ext bkt of a deleted key once the readers
+ * went through a quiescent state. Writer holds the lock.
+ */
+static void
+__hash_rcu_qsbr_free_resource(void *p, void *e, unsigned int n)
+{
+	struct rte_hash *h = (struct rte_hash *)p;
+	struct __rte_hash_rcu_dq_entry rcu_dq_entry =
+			*((struct __rte_hash_rcu_dq_entry *)e);
+	struct rte_hash_key *k;
+
+	RTE_SET_USED(n);
+	if (h->hash_rcu_cfg->free_key_data_func != NULL) {
+		k = (struct rte_hash_key *)((char *)h->key_store +
+				rcu_dq_entry.key_idx * h->key_entry_size);
+		h->hash_rcu_cfg->free_key_data_func(
+				h->hash_rcu_cfg->key_data_ptr, k->pdata);
+	}
+
+	if (rcu_dq_entry.ext_bkt_idx != EMPTY_SLOT)
+		/* Recycle empty ext bkt to free list. */
+		rte_ring_sp_enqueue_elem(h->free_ext_bkts,
+				&rcu_dq_entry.ext_bkt_idx, sizeof(uint32_t));
+
+	/* Return key index to the free slots */
+	if (free_slot(h, rcu_dq_entry.key_idx) < 0)
+		RTE_LOG(ERR, HASH,
+			"%s: could not enqueue free slots in global ring\n",
+			__func__);
+}
+
 /* Compact the linked list by moving key from last entry in linked list to the
  * empty slot.
  */
@@ -1490,9 +1793,11 @@ search_and_remove(const struct rte_hash *h, const void *key,
 			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 				bkt->sig_current[i] = NULL_SIGNATURE;
 				/* Free the key store index if
-				 * no_free_on_del is disabled.
+				 * no_free_on_del is disabled and it is not
+				 * reclaimed through RCU.
 				 */
-				if (!h->no_free_on_del)
+				if (!h->no_free_on_del &&
+						h->hash_rcu_cfg == NULL)
 					remove_entry(h, bkt, i);
 
 				__atomic_store_n(&bkt->key_idx[i],
@@ -1515,17 +1820,21 @@ static inline int32_t
 __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig)
 {
+	const struct rte_hash_bkt_tbl *tbl = get_cur_tbl(h);
+	const struct rte_hash_bkt_tbl *old;
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *prim_bkt, *sec_bkt, *prev_bkt, *last_bkt;
 	struct rte_hash_bucket *cur_bkt;
+	struct __rte_hash_rcu_dq_entry rcu_dq_entry;
+	uint32_t index = EMPTY_SLOT;
 	int pos;
 	int32_t ret, i;
 	uint16_t short_sig;
 
 	short_sig = get_short_sig(sig);
-	prim_bucket_idx = get_prim_bucket_index(h, sig);
-	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
-	prim_bkt = &h->buckets[prim_bucket_idx];
+	prim_bucket_idx = get_prim_bucket_index(tbl, sig);
+	sec_bucket_idx = get_alt_bucket_index(tbl, prim_bucket_idx, short_sig);
+	prim_bkt = &tbl->buckets[prim_bucket_idx];
 
 	__hash_rw_writer_lock(h);
 	/* look for key in primary bucket */
@@ -1538,7 +1847,7 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	}
 
 	/* Calculate secondary hash */
-	sec_bkt = &h->buckets[sec_bucket_idx];
+	sec_bkt = &tbl->buckets[sec_bucket_idx];
 
 	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
 		ret = search_and_remove(h, key, cur_bkt, short_sig, &pos);
@@ -1550,15 +1859,31 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
+	/* Look for key in the table being migrated, which has no
+	 * extendable buckets to recycle.
+	 */
+	if (h->tbl_state & RTE_HASH_TBL_RESIZING) {
+		old = get_old_tbl(h, h->tbl_state);
+		prim_bucket_idx = get_prim_bucket_index(old, sig);
+		sec_bucket_idx = get_alt_bucket_index(old, prim_bucket_idx,
+							short_sig);
+		ret = search_and_remove(h, key, &old->buckets[prim_bucket_idx],
+					short_sig, &pos);
+		if (ret == -1)
+			ret = search_and_remove(h, key,
+					&old->buckets[sec_bucket_idx],
+					short_sig, &pos);
+		if (ret != -1)
+			goto return_key;
+	}
+
 	__hash_rw_writer_unlock(h);
 	return -ENOENT;
 
 /* Search last bucket to see if empty to be recycled */
 return_bkt:
-	if (!last_bkt) {
-		__hash_rw_writer_unlock(h);
-		return ret;
-	}
+	if (!last_bkt)
+		goto return_key;
 	while (last_bkt->next) {
 		prev_bkt = last_bkt;
 		last_bkt = last_bkt->next;
@@ -1571,25 +1896,53 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	/* found empty bucket and recycle */
 	if (i == RTE_HASH_BUCKET_ENTRIES) {
 		prev_bkt->next = NULL;
-		uint32_t index = last_bkt - h->buckets_ext + 1;
+		index = last_bkt - h->buckets_ext + 1;
 		/* Recycle the empty bkt if
-		 * no_free_on_del is disabled.
+		 * no_free_on_del is disabled. With RCU, it is recycled
+		 * along with the key index once the readers are done.
 		 */
-		if (h->no_free_on_del)
-			/* Store index of an empty ext bkt to be recycled
-			 * on calling rte_hash_del_xxx APIs.
-			 * When lock free read-write concurrency is enabled,
-			 * an empty ext bkt cannot be put into free list
-			 * immediately (as readers might be using it still).
-			 * Hence freeing of the ext bkt is piggy-backed to
-			 * freeing of the key index.
-			 */
-			h->ext_bkt_to_free[ret] = index;
-		else
-			rte_ring_sp_enqueue_elem(h->free_ext_bkts, &index,
-							sizeof(uint32_t));
+		if (h->hash_rcu_cfg == NULL) {
+			if (h->no_free_on_del)
+				/* Store index of an empty ext bkt to be
+				 * recycled on calling rte_hash_del_xxx APIs.
+				 * When lock free read-write concurrency is
+				 * enabled, an empty ext bkt cannot be put into
+				 * free list immediately (as readers might be
+				 * using it still). Hence freeing of the ext
+				 * bkt is piggy-backed to freeing of the key
+				 * index.
+				 */
+				h->ext_bkt_to_free[ret] = index;
+			else
+				rte_ring_sp_enqueue_elem(h->free_ext_bkts,
+						&index, sizeof(uint32_t));
+		}
+	}
+
+return_key:
+	if (h->dq != NULL) {
+		/* Push into QSBR defer queue */
+		rcu_dq_entry.key_idx = ret + 1;
+		rcu_dq_entry.ext_bkt_idx = index;
+		if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0)
+			RTE_LOG(ERR, HASH, "Failed to push QSBR FIFO\n");
 	}
 	__hash_rw_writer_unlock(h);
+
+	if (h->hash_rcu_cfg != NULL &&
+			h->hash_rcu_cfg->mode == RTE_HASH_QSBR_MODE_SYNC) {
+		/* Wait for quiescent state change, out of the lock as
+		 * readers may be waiting for it.
+		 */
+		rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v,
+					 RTE_QSBR_THRID_INVALID);
+		rcu_dq_entry.key_idx = ret + 1;
+		rcu_dq_entry.ext_bkt_idx = index;
+		__hash_rw_writer_lock(h);
+		__hash_rcu_qsbr_free_resource((void *)((uintptr_t)h),
+					      &rcu_dq_entry, 1);
+		__hash_rw_writer_unlock(h);
+	}
 	return ret;
 }
 
@@ -1637,8 +1990,6 @@ rte_hash_free_key_with_position(const struct rte_hash *h,
 
 	RETURN_IF_TRUE(((h == NULL) || (key_idx == EMPTY_SLOT)), -EINVAL);
 
-	unsigned int lcore_id, n_slots;
-	struct lcore_cache *cached_free_slots;
 	const uint32_t total_entries = h->use_local_cache ?
 		h->entries + (RTE_MAX_LCORE - 1) * (LCORE_CACHE_SIZE - 1) + 1
 							: h->entries + 1;
@@ -1656,25 +2007,313 @@ rte_hash_free_key_with_position(const struct rte_hash *h,
 		}
 	}
 
-	if (h->use_local_cache) {
-		lcore_id = rte_lcore_id();
-		cached_free_slots = &h->local_free_slots[lcore_id];
-		/* Cache full, need to free it. */
-		if (cached_free_slots->len == LCORE_CACHE_SIZE) {
-			/* Need to enqueue the free slots in global ring. */
-			n_slots = rte_ring_mp_enqueue_burst_elem(h->free_slots,
-						cached_free_slots->objs,
-						sizeof(uint32_t),
-						LCORE_CACHE_SIZE, NULL);
-			RETURN_IF_TRUE((n_slots == 0), -EFAULT);
-			cached_free_slots->len -= n_slots;
+	return free_slot(h, key_idx);
+}
+
+/* Associate QSBR variable with a hash table.
+ */
+int
+rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+	struct rte_hash_rcu_config *hash_rcu_cfg;
+	uint32_t total_entries;
+
+	if (h == NULL || cfg == NULL || cfg->v == NULL)
+		return -EINVAL;
+
+	if (h->hash_rcu_cfg != NULL)
+		return -EEXIST;
+
+	if (cfg->mode != RTE_HASH_QSBR_MODE_SYNC &&
+			cfg->mode != RTE_HASH_QSBR_MODE_DQ)
+		return -EINVAL;
+
+	hash_rcu_cfg = rte_zmalloc(NULL, sizeof(struct rte_hash_rcu_config), 0);
+	if (hash_rcu_cfg == NULL) {
+		RTE_LOG(ERR, HASH, "memory allocation failed\n");
+		return -ENOMEM;
+	}
+
+	if (cfg->mode == RTE_HASH_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"HASH_RCU_%s", h->name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0) {
+			/* Every key index may be pending */
+			total_entries = h->use_local_cache ?
+				h->entries + (RTE_MAX_LCORE - 1) *
+				(LCORE_CACHE_SIZE - 1) : h->entries;
+			params.size = total_entries;
 		}
-		/* Put index of new free slot in cache. */
-		cached_free_slots->objs[cached_free_slots->len] = key_idx;
-		cached_free_slots->len++;
-	} else {
-		rte_ring_sp_enqueue_elem(h->free_slots, &key_idx,
-						sizeof(uint32_t));
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_HASH_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(struct __rte_hash_rcu_dq_entry);
+		params.free_fn = __hash_rcu_qsbr_free_resource;
+		params.p = h;
+		params.v = cfg->v;
+		h->dq = rte_rcu_qsbr_dq_create(&params);
+		if (h->dq == NULL) {
+			rte_free(hash_rcu_cfg);
+			RTE_LOG(ERR, HASH, "HASH defer queue creation failed\n");
+			return -rte_errno;
+		}
+	}
+
+	hash_rcu_cfg->v = cfg->v;
+	hash_rcu_cfg->mode = cfg->mode;
+	hash_rcu_cfg->dq_size = params.size;
+	hash_rcu_cfg->reclaim_thd = params.trigger_reclaim_limit;
+	hash_rcu_cfg->reclaim_max = params.max_reclaim_size;
+	hash_rcu_cfg->key_data_ptr = cfg->key_data_ptr;
+	hash_rcu_cfg->free_key_data_func = cfg->free_key_data_func;
+
+	h->hash_rcu_cfg = hash_rcu_cfg;
+
+	return 0;
+}
+
+/* Grow the key store and the ring of free key slots to @entries keys.
+ * Lock free readers may still use the old key store, it is kept until
+ * the next resize. Writer holds the lock before calling this.
+ */
+static int
+rte_hash_grow_key_store(struct rte_hash *h, uint32_t entries)
+{
+	char ring_name[RTE_RING_NAMESIZE];
+	struct rte_ring *r;
+	const uint32_t num_key_slots = entries + 1;
+	const uint32_t old_num_key_slots = h->entries + 1;
+	uint32_t i, slot_id;
+	void *k;
+
+	k = rte_zmalloc_socket(NULL, (uint64_t)h->key_entry_size * num_key_slots,
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+	if (k == NULL) {
+		RTE_LOG(ERR, HASH, "memory allocation failed\n");
+		return -ENOMEM;
+	}
+
+	if (rte_ring_get_capacity(h->free_slots) < entries) {
+		/* The old ring still exists, alternate between two names */
+		if (strncmp(h->free_slots->name, "HT_", 3) == 0)
+			snprintf(ring_name, sizeof(ring_name), "HTR_%s", h->name);
+		else
+			snprintf(ring_name, sizeof(ring_name), "HT_%s", h->name);
+		r = rte_ring_create_elem(ring_name, sizeof(uint32_t),
+				rte_align32pow2(num_key_slots), h->socket_id, 0);
+		if (r == NULL) {
+			RTE_LOG(ERR, HASH, "memory allocation failed\n");
+			rte_free(k);
+			return -ENOMEM;
+		}
+		while (rte_ring_sc_dequeue_elem(h->free_slots, &slot_id,
+						sizeof(uint32_t)) == 0)
+			rte_ring_sp_enqueue_elem(r, &slot_id, sizeof(uint32_t));
+		rte_ring_free(h->free_slots);
+		h->free_slots = r;
+	}
+
+	memcpy(k, h->key_store, (uint64_t)h->key_entry_size * old_num_key_slots);
+	rte_free(h->key_store_retired);
+	h->key_store_retired = h->key_store;
+	/* The new key slots are handed out only after the new key store
+	 * is visible to the readers.
+	 */
+	__atomic_store_n(&h->key_store, k, __ATOMIC_RELEASE);
+
+	for (i = old_num_key_slots; i < num_key_slots; i++)
+		rte_ring_sp_enqueue_elem(h->free_slots, &i, sizeof(uint32_t));
+	h->entries = entries;
+
+	return 0;
+}
+
+int
+rte_hash_resize_start(struct rte_hash *h, uint32_t entries)
+{
+	struct rte_hash_bkt_tbl *new_tbl;
+	struct rte_hash_bucket *buckets;
+	uint32_t num_buckets, cur;
+	int ret;
+
+	if ((h == NULL) || (entries > RTE_HASH_ENTRIES_MAX) ||
+			(entries < RTE_HASH_BUCKET_ENTRIES))
+		return -EINVAL;
+
+	/* Extendable buckets and lcore caches of free slots are sized
+	 * at creation time.
+	 */
+	if (h->ext_table_support || h->use_local_cache)
+		return -ENOTSUP;
+
+	if (h->tbl_state & RTE_HASH_TBL_RESIZING)
+		return -EBUSY;
+
+	if ((uint32_t)rte_hash_count(h) > entries)
+		return -ENOSPC;
+
+	num_buckets = rte_align32pow2(entries) / RTE_HASH_BUCKET_ENTRIES;
+	buckets = rte_zmalloc_socket(NULL,
+			num_buckets * sizeof(struct rte_hash_bucket),
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+	if (buckets == NULL) {
+		RTE_LOG(ERR, HASH, "buckets memory allocation failed\n");
+		return -ENOMEM;
+	}
+
+	__hash_rw_writer_lock(h);
+
+	/* Key slots are never given back, as positions of existing keys
+	 * must not change. Shrinking only releases bucket memory.
+	 */
+	if (entries > h->entries) {
+		ret = rte_hash_grow_key_store(h, entries);
+		if (ret != 0) {
+			__hash_rw_writer_unlock(h);
+			rte_free(buckets);
+			return ret;
+		}
+	}
+
+	cur = h->tbl_state & RTE_HASH_TBL_CUR_MASK;
+	new_tbl = &h->tbls[cur ^ 1];
+	/* Free the buckets retired by the previous resize */
+	rte_free(new_tbl->buckets);
+	new_tbl->buckets = buckets;
+	new_tbl->num_buckets = num_buckets;
+	new_tbl->bucket_bitmask = num_buckets - 1;
+	h->resize_next = 0;
+
+	/* New keys go to the new table from now on, the current one
+	 * becomes the table to migrate. The release makes the new table
+	 * visible to the readers before they start searching it.
+	 */
+	__atomic_store_n(&h->tbl_state, (cur ^ 1) | RTE_HASH_TBL_RESIZING,
+			__ATOMIC_RELEASE);
+
+	__hash_rw_writer_unlock(h);
+
+	return 0;
+}
+
+int
+rte_hash_resize_step(struct rte_hash *h, uint32_t num_buckets)
+{
+	const struct rte_hash_bkt_tbl *tbl, *old;
+	struct rte_hash_bkt_tbl *retired;
+	struct rte_hash_bucket *bkt, *prim_bkt, *sec_bkt;
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	struct rte_hash_key *k;
+	const void *key;
+	uint32_t key_idx, done;
+	uint16_t short_sig;
+	hash_sig_t sig;
+	int32_t ret_val;
+	unsigned int i;
+	int ret;
+
+	if (h == NULL)
+		return -EINVAL;
+
+	if (!(h->tbl_state & RTE_HASH_TBL_RESIZING))
+		return 0;
+
+	tbl = get_cur_tbl(h);
+	old = get_old_tbl(h, h->tbl_state);
+
+	for (done = 0; done < num_buckets &&
+			h->resize_next < old->num_buckets; done++) {
+		bkt = &old->buckets[h->resize_next];
+
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			key_idx = bkt->key_idx[i];
+			if (key_idx == EMPTY_SLOT)
+				continue;
+
+			k = (struct rte_hash_key *)((char *)h->key_store +
+					key_idx * h->key_entry_size);
+			key = k->key;
+			/* Only the bucket index bits of the old table are
+			 * known, hash the key again.
+			 */
+			sig = rte_hash_hash(h, key);
+			short_sig = get_short_sig(sig);
+			prim_bucket_idx = get_prim_bucket_index(tbl, sig);
+			sec_bucket_idx = get_alt_bucket_index(tbl,
+					prim_bucket_idx, short_sig);
+			prim_bkt = &tbl->buckets[prim_bucket_idx];
+			sec_bkt = &tbl->buckets[sec_bucket_idx];
+
+			/* Insert the same key index in the new table. The
+			 * key is found in both tables until it is removed
+			 * from the old one.
+			 */
+			ret = rte_hash_cuckoo_insert_mw(h, prim_bkt, sec_bkt,
+					key, k->pdata, short_sig, key_idx,
+					&ret_val);
+			if (ret == -1)
+				ret = rte_hash_cuckoo_make_space_mw(h,
+					prim_bkt, sec_bkt, key, k->pdata,
+					short_sig, prim_bucket_idx, key_idx,
+					&ret_val);
+			if (ret < 0)
+				ret = rte_hash_cuckoo_make_space_mw(h,
+					sec_bkt, prim_bkt, key, k->pdata,
+					short_sig, sec_bucket_idx, key_idx,
+					&ret_val);
+			/* Key stays in the old table, retry on next call */
+			if (ret < 0)
+				return -ENOSPC;
+
+			__hash_rw_writer_lock(h);
+			if (h->readwrite_concur_lf_support) {
+				/* Inform the readers that the key moved.
+				 * Since there is one writer, load acquire on
+				 * tbl_chng_cnt is not required.
+				 */
+				__atomic_store_n(h->tbl_chng_cnt,
+					 *h->tbl_chng_cnt + 1,
+					 __ATOMIC_RELEASE);
+				/* The store to sig_current should
+				 * not move above the store to tbl_chng_cnt.
+				 */
+				__atomic_thread_fence(__ATOMIC_RELEASE);
+			}
+			bkt->sig_current[i] = NULL_SIGNATURE;
+			__atomic_store_n(&bkt->key_idx[i],
+					 EMPTY_SLOT,
+					 __ATOMIC_RELEASE);
+			__hash_rw_writer_unlock(h);
+		}
+		h->resize_next++;
+	}
+
+	if (h->resize_next < old->num_buckets)
+		return old->num_buckets - h->resize_next;
+
+	/* All keys are in the new table, readers can stop searching the
+	 * old one. Its buckets are kept until the next resize starts.
+	 */
+	__hash_rw_writer_lock(h);
+	__atomic_store_n(&h->tbl_state, h->tbl_state & RTE_HASH_TBL_CUR_MASK,
+			__ATOMIC_RELEASE);
+	__hash_rw_writer_unlock(h);
+
+	if (h->hash_rcu_cfg != NULL) {
+		/* Wait for the readers of the old table and key store */
+		rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v,
+					 RTE_QSBR_THRID_INVALID);
+		retired = &h->tbls[(h->tbl_state & RTE_HASH_TBL_CUR_MASK) ^ 1];
+		rte_free(retired->buckets);
+		retired->buckets = NULL;
+		rte_free(h->key_store_retired);
+		h->key_store_retired = NULL;
 	}
 
 	return 0;
@@ -1722,6 +2361,11 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 		*sec_hash_matches = (uint32_t)(vaddvq_u16(x));
 		}
 		break;
+#endif
+#if defined(CC_AVX512_SUPPORT)
+	case RTE_HASH_COMPARE_AVX512:
+		/* Done for the whole burst by compare_signatures_bulk() */
+		break;
 #endif
 	default:
 		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
@@ -1733,11 +2377,62 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 	}
 }
 
+/*
+ * Compare the signatures of a burst of keys at once, when the signature
+ * compare function supports it. compare_signatures() does nothing for
+ * such functions.
+ */
+static inline void
+compare_signatures_bulk(uint32_t *prim_hash_matches,
+			uint32_t *sec_hash_matches,
+			const struct rte_hash_bucket **primary_bkt,
+			const struct rte_hash_bucket **secondary_bkt,
+			const uint16_t *sig, int32_t num_keys,
+			enum rte_hash_sig_compare_function sig_cmp_fn)
+{
+#if defined(CC_AVX512_SUPPORT)
+	if (sig_cmp_fn == RTE_HASH_COMPARE_AVX512)
+		rte_hash_compare_signatures_avx512(prim_hash_matches,
+			sec_hash_matches, primary_bkt, secondary_bkt,
+			sig, num_keys);
+#else
+	RTE_SET_USED(prim_hash_matches);
+	RTE_SET_USED(sec_hash_matches);
+	RTE_SET_USED(primary_bkt);
+	RTE_SET_USED(secondary_bkt);
+	RTE_SET_USED(sig);
+	RTE_SET_USED(num_keys);
+	RTE_SET_USED(sig_cmp_fn);
+#endif
+}
+
+/* Calculate the buckets of the keys again after the bucket table changed */
+static inline void
+__bulk_lookup_calc_bkts(const struct rte_hash *h, uint32_t tbl_state,
+		const hash_sig_t *prim_hash, const uint16_t *sig,
+		int32_t num_keys,
+		const struct rte_hash_bucket **primary_bkt,
+		const struct rte_hash_bucket **secondary_bkt)
+{
+	const struct rte_hash_bkt_tbl *tbl =
+			&h->tbls[tbl_state & RTE_HASH_TBL_CUR_MASK];
+	uint32_t prim_index, sec_index;
+	int32_t i;
+
+	for (i = 0; i < num_keys; i++) {
+		prim_index = get_prim_bucket_index(tbl, prim_hash[i]);
+		sec_index = get_alt_bucket_index(tbl, prim_index, sig[i]);
+		primary_bkt[i] = &tbl->buckets[prim_index];
+		secondary_bkt[i] = &tbl->buckets[sec_index];
+	}
+}
+
 static inline void
 __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 		const struct rte_hash_bucket **primary_bkt,
 		const struct rte_hash_bucket **secondary_bkt,
-		uint16_t *sig, int32_t num_keys, int32_t *positions,
+		const hash_sig_t *prim_hash, uint16_t *sig,
+		uint32_t tbl_state, int32_t num_keys, int32_t *positions,
 		uint64_t *hit_mask, void *data[])
 {
 	uint64_t hits = 0;
@@ -1746,14 +2441,30 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
 	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
 	struct rte_hash_bucket *cur_bkt, *next_bkt;
+	uint32_t cur_tbl_state;
+	/* Read once, compare_signatures_bulk() and compare_signatures()
+	 * must agree.
+	 */
+	const enum rte_hash_sig_compare_function sig_cmp_fn = h->sig_cmp_fn;
 
 	__hash_rw_reader_lock(h);
 
+	/* Buckets were calculated before taking the lock */
+	cur_tbl_state = get_tbl_state(h);
+	if (unlikely(cur_tbl_state != tbl_state)) {
+		tbl_state = cur_tbl_state;
+		__bulk_lookup_calc_bkts(h, tbl_state, prim_hash, sig,
+				num_keys, primary_bkt, secondary_bkt);
+	}
+
 	/* Compare signatures and prefetch key slot of first hit */
+	compare_signatures_bulk(prim_hitmask, sec_hitmask,
+			primary_bkt, secondary_bkt, sig, num_keys,
+			sig_cmp_fn);
 	for (i = 0; i < num_keys; i++) {
 		compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
 			primary_bkt[i], secondary_bkt[i],
-			sig[i], h->sig_cmp_fn);
+			sig[i], sig_cmp_fn);
 
 		if (prim_hitmask[i]) {
 			uint32_t first_hit =
@@ -1847,7 +2558,9 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 	}
 
 	/* all found, do not need to go through ext bkt */
-	if ((hits == ((1ULL << num_keys) - 1)) || !h->ext_table_support) {
+	if ((hits == (UINT64_MAX >> (64 - num_keys))) ||
+			(!h->ext_table_support &&
+			!(tbl_state & RTE_HASH_TBL_RESIZING))) {
 		if (hit_mask != NULL)
 			*hit_mask = hits;
 		__hash_rw_reader_unlock(h);
@@ -1855,7 +2568,7 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 	}
 
 	/* need to check ext buckets for match */
-	for (i = 0; i < num_keys; i++) {
+	for (i = 0; i < num_keys && h->ext_table_support; i++) {
 		if ((hits & (1ULL << i)) != 0)
 			continue;
 		next_bkt = secondary_bkt[i]->next;
@@ -1874,6 +2587,18 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 		}
 	}
 
+	/* need to check keys not migrated yet */
+	for (i = 0; i < num_keys && (tbl_state & RTE_HASH_TBL_RESIZING); i++) {
+		if ((hits & (1ULL << i)) != 0)
+			continue;
+		ret = search_old_tbl_l(h, keys[i], prim_hash[i], sig[i],
+				data != NULL ? &data[i] : NULL, tbl_state);
+		if (ret != -1) {
+			positions[i] = ret;
+			hits |= 1ULL << i;
+		}
+	}
+
 	__hash_rw_reader_unlock(h);
 
 	if (hit_mask != NULL)
@@ -1884,7 +2609,8 @@ static inline void
 __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 		const struct rte_hash_bucket **primary_bkt,
 		const struct rte_hash_bucket **secondary_bkt,
-		uint16_t *sig, int32_t num_keys, int32_t *positions,
+		const hash_sig_t *prim_hash, uint16_t *sig,
+		uint32_t tbl_state, int32_t num_keys, int32_t *positions,
 		uint64_t *hit_mask, void *data[])
 {
 	uint64_t hits = 0;
@@ -1894,6 +2620,11 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
 	struct rte_hash_bucket *cur_bkt, *next_bkt;
 	uint32_t cnt_b, cnt_a;
+	uint32_t cur_tbl_state;
+	/* Read once, compare_signatures_bulk() and compare_signatures()
+	 * must agree.
+	 */
+	const enum rte_hash_sig_compare_function sig_cmp_fn = h->sig_cmp_fn;
 
 	for (i = 0; i < num_keys; i++)
 		positions[i] = -ENOENT;
@@ -1906,11 +2637,24 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
 					__ATOMIC_ACQUIRE);
 
+		/* A resize may have started or completed since the
+		 * buckets were calculated.
+		 */
+		cur_tbl_state = get_tbl_state(h);
+		if (unlikely(cur_tbl_state != tbl_state)) {
+			tbl_state = cur_tbl_state;
+			__bulk_lookup_calc_bkts(h, tbl_state, prim_hash, sig,
+				num_keys, primary_bkt, secondary_bkt);
+		}
+
 		/* Compare signatures and prefetch key slot of first hit */
+		compare_signatures_bulk(prim_hitmask, sec_hitmask,
+				primary_bkt, secondary_bkt, sig, num_keys,
+				sig_cmp_fn);
 		for (i = 0; i < num_keys; i++) {
 			compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
 				primary_bkt[i], secondary_bkt[i],
-				sig[i], h->sig_cmp_fn);
+				sig[i], sig_cmp_fn);
 
 			if (prim_hitmask[i]) {
 				uint32_t first_hit =
@@ -1951,9 +2695,7 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 					&primary_bkt[i]->key_idx[hit_index],
 					__ATOMIC_ACQUIRE);
 				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
+					get_key_slot_lf(h, key_idx);
 
 				/*
 				 * If key index is 0, do not compare key,
@@ -1983,9 +2725,7 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 					&secondary_bkt[i]->key_idx[hit_index],
 					__ATOMIC_ACQUIRE);
 				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
+					get_key_slot_lf(h, key_idx);
 
 				/*
 				 * If key index is 0, do not compare key,
@@ -2011,7 +2751,7 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 		}
 
 		/* all found, do not need to go through ext bkt */
-		if (hits == ((1ULL << num_keys) - 1)) {
+		if (hits == (UINT64_MAX >> (64 - num_keys))) {
 			if (hit_mask != NULL)
 				*hit_mask = hits;
 			return;
@@ -2039,6 +2779,21 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 				}
 			}
 		}
+		/* need to check keys not migrated yet */
+		if (tbl_state & RTE_HASH_TBL_RESIZING) {
+			for (i = 0; i < num_keys; i++) {
+				if ((hits & (1ULL << i)) != 0)
+					continue;
+				ret = search_old_tbl_lf(h, keys[i],
+					prim_hash[i], sig[i],
+					data != NULL ? &data[i] : NULL,
+					tbl_state);
+				if (ret != -1) {
+					positions[i] = ret;
+					hits |= 1ULL << i;
+				}
+			}
+		}
 		/* The loads of sig_current in compare_signatures
 		 * should not move below the load from tbl_chng_cnt.
 		 */
@@ -2063,12 +2818,13 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 static inline void
 __bulk_lookup_prefetching_loop(const struct rte_hash *h,
 	const void **keys, int32_t num_keys,
-	uint16_t *sig,
+	hash_sig_t *prim_hash, uint16_t *sig, uint32_t tbl_state,
 	const struct rte_hash_bucket **primary_bkt,
 	const struct rte_hash_bucket **secondary_bkt)
 {
+	const struct rte_hash_bkt_tbl *tbl =
+			&h->tbls[tbl_state & RTE_HASH_TBL_CUR_MASK];
 	int32_t i;
-	uint32_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
 	uint32_t prim_index[RTE_HASH_LOOKUP_BULK_MAX];
 	uint32_t sec_index[RTE_HASH_LOOKUP_BULK_MAX];
 
@@ -2086,11 +2842,11 @@ __bulk_lookup_prefetching_loop(const struct rte_hash *h,
 		prim_hash[i] = rte_hash_hash(h, keys[i]);
 
 		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
+		prim_index[i] = get_prim_bucket_index(tbl, prim_hash[i]);
+		sec_index[i] = get_alt_bucket_index(tbl, prim_index[i], sig[i]);
 
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		primary_bkt[i] = &tbl->buckets[prim_index[i]];
+		secondary_bkt[i] = &tbl->buckets[sec_index[i]];
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
@@ -2101,11 +2857,11 @@ __bulk_lookup_prefetching_loop(const struct rte_hash *h,
 		prim_hash[i] = rte_hash_hash(h, keys[i]);
 
 		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
+		prim_index[i] = get_prim_bucket_index(tbl, prim_hash[i]);
+		sec_index[i] = get_alt_bucket_index(tbl, prim_index[i], sig[i]);
 
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		primary_bkt[i] = &tbl->buckets[prim_index[i]];
+		secondary_bkt[i] = &tbl->buckets[sec_index[i]];
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
@@ -2118,15 +2874,17 @@ __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 			int32_t num_keys, int32_t *positions,
 			uint64_t *hit_mask, void *data[])
 {
+	hash_sig_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
 	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t tbl_state = get_tbl_state(h);
 
-	__bulk_lookup_prefetching_loop(h, keys, num_keys, sig,
-		primary_bkt, secondary_bkt);
+	__bulk_lookup_prefetching_loop(h, keys, num_keys, prim_hash, sig,
+		tbl_state, primary_bkt, secondary_bkt);
 
-	__bulk_lookup_l(h, keys, primary_bkt, secondary_bkt, sig, num_keys,
-		positions, hit_mask, data);
+	__bulk_lookup_l(h, keys, primary_bkt, secondary_bkt, prim_hash, sig,
+		tbl_state, num_keys, positions, hit_mask, data);
 }
 
 static inline void
@@ -2134,15 +2892,17 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 			int32_t num_keys, int32_t *positions,
 			uint64_t *hit_mask, void *data[])
 {
+	hash_sig_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
 	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t tbl_state = get_tbl_state(h);
 
-	__bulk_lookup_prefetching_loop(h, keys, num_keys, sig,
-		primary_bkt, secondary_bkt);
+	__bulk_lookup_prefetching_loop(h, keys, num_keys, prim_hash, sig,
+		tbl_state, primary_bkt, secondary_bkt);
 
-	__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt, sig, num_keys,
-		positions, hit_mask, data);
+	__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt, prim_hash, sig,
+		tbl_state, num_keys, positions, hit_mask, data);
 }
 
 static inline void
@@ -2199,6 +2959,9 @@ __rte_hash_lookup_with_hash_bulk_l(const struct rte_hash *h,
 	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t tbl_state = get_tbl_state(h);
+	const struct rte_hash_bkt_tbl *tbl =
+			&h->tbls[tbl_state & RTE_HASH_TBL_CUR_MASK];
 
 	/*
 	 * Prefetch keys, calculate primary and
@@ -2208,18 +2971,18 @@ __rte_hash_lookup_with_hash_bulk_l(const struct rte_hash *h,
 		rte_prefetch0(keys[i]);
 
 		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
+		prim_index[i] = get_prim_bucket_index(tbl, prim_hash[i]);
+		sec_index[i] = get_alt_bucket_index(tbl, prim_index[i], sig[i]);
 
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		primary_bkt[i] = &tbl->buckets[prim_index[i]];
+		secondary_bkt[i] = &tbl->buckets[sec_index[i]];
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
 	}
 
-	__bulk_lookup_l(h, keys, primary_bkt, secondary_bkt, sig, num_keys,
-		positions, hit_mask, data);
+	__bulk_lookup_l(h, keys, primary_bkt, secondary_bkt, prim_hash, sig,
+		tbl_state, num_keys, positions, hit_mask, data);
 }
 
 static inline void
@@ -2234,6 +2997,9 @@ __rte_hash_lookup_with_hash_bulk_lf(const struct rte_hash *h,
 	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t tbl_state = get_tbl_state(h);
+	const struct rte_hash_bkt_tbl *tbl =
+			&h->tbls[tbl_state & RTE_HASH_TBL_CUR_MASK];
 
 	/*
 	 * Prefetch keys, calculate primary and
@@ -2243,18 +3009,18 @@ __rte_hash_lookup_with_hash_bulk_lf(const struct rte_hash *h,
 		rte_prefetch0(keys[i]);
 
 		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
+		prim_index[i] = get_prim_bucket_index(tbl, prim_hash[i]);
+		sec_index[i] = get_alt_bucket_index(tbl, prim_index[i], sig[i]);
 
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		primary_bkt[i] = &tbl->buckets[prim_index[i]];
+		secondary_bkt[i] = &tbl->buckets[sec_index[i]];
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
 	}
 
-	__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt, sig, num_keys,
-		positions, hit_mask, data);
+	__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt, prim_hash, sig,
+		tbl_state, num_keys, positions, hit_mask, data);
 }
 
 static inline void
@@ -2306,12 +3072,17 @@ rte_hash_lookup_with_hash_bulk_data(const struct rte_hash *h,
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next)
 {
+	const struct rte_hash_bkt_tbl *tbl, *old;
 	uint32_t bucket_idx, idx, position;
 	struct rte_hash_key *next_key;
+	uint32_t tbl_state;
 
 	RETURN_IF_TRUE(((h == NULL) || (next == NULL)), -EINVAL);
 
-	const uint32_t total_entries_main = h->num_buckets *
+	tbl_state = get_tbl_state(h);
+	tbl = &h->tbls[tbl_state & RTE_HASH_TBL_CUR_MASK];
+
+	const uint32_t total_entries_main = tbl->num_buckets *
 							RTE_HASH_BUCKET_ENTRIES;
 	const uint32_t total_entries = total_entries_main << 1;
 
@@ -2324,7 +3095,7 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	idx = *next % RTE_HASH_BUCKET_ENTRIES;
 
 	/* If current position is empty, go to the next one */
-	while ((position = __atomic_load_n(&h->buckets[bucket_idx].key_idx[idx],
+	while ((position = __atomic_load_n(&tbl->buckets[bucket_idx].key_idx[idx],
 					__ATOMIC_ACQUIRE)) == EMPTY_SLOT) {
 		(*next)++;
 		/* End of table */
@@ -2350,6 +3121,12 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 
 /* Begin to iterate extendable buckets */
 extend_table:
+	/* While a resize is in progress, the table being migrated is
+	 * iterated after the main table. It has no extendable buckets.
+	 */
+	if (tbl_state & RTE_HASH_TBL_RESIZING)
+		goto old_table;
+
 	/* Out of total bound or if ext bucket feature is not enabled */
 	if (*next >= total_entries || !h->ext_table_support)
 		return -ENOENT;
@@ -2374,6 +3151,42 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 
 	__hash_rw_reader_unlock(h);
 
+	/* Increment iterator */
+	(*next)++;
+	return position - 1;
+
+/* Keys moved by the resize in between two calls may be missed or
+ * returned twice.
+ */
+old_table:
+	old = get_old_tbl(h, tbl_state);
+	const uint32_t total_entries_old = total_entries_main +
+			old->num_buckets * RTE_HASH_BUCKET_ENTRIES;
+
+	if (*next >= total_entries_old)
+		return -ENOENT;
+
+	bucket_idx = (*next - total_entries_main) / RTE_HASH_BUCKET_ENTRIES;
+	idx = (*next - total_entries_main) % RTE_HASH_BUCKET_ENTRIES;
+
+	while ((position = __atomic_load_n(&old->buckets[bucket_idx].key_idx[idx],
+					__ATOMIC_ACQUIRE)) == EMPTY_SLOT) {
+		(*next)++;
+		if (*next == total_entries_old)
+			return -ENOENT;
+		bucket_idx = (*next - total_entries_main) /
+						RTE_HASH_BUCKET_ENTRIES;
+		idx = (*next - total_entries_main) % RTE_HASH_BUCKET_ENTRIES;
+	}
+	__hash_rw_reader_lock(h);
+	next_key = (struct rte_hash_key *) ((char *)h->key_store +
+				position * h->key_entry_size);
+	/* Return key and data */
+	*key = next_key->key;
+	*data = next_key->pdata;
+
+	__hash_rw_reader_unlock(h);
+
 	/* Increment iterator */
 	(*next)++;
 	return position - 1;
@@ -66,7 +66,7 @@ enum cmp_jump_table_case {
  * Table storing all different key compare functions
  * (multi-process supported)
  */
-const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
+static const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 	NULL,
 	rte_hash_k16_cmp_eq,
 	rte_hash_k32_cmp_eq,
@@ -93,7 +93,7 @@ enum cmp_jump_table_case {
  * Table storing all different key compare functions
  * (multi-process supported)
  */
-const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
+static const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 	NULL,
 	memcmp
 };
@@ -137,14 +137,6 @@ struct rte_hash_key {
 	char key[0];
 };
 
-/* All different signature compare functions */
-enum rte_hash_sig_compare_function {
-	RTE_HASH_COMPARE_SCALAR = 0,
-	RTE_HASH_COMPARE_SSE,
-	RTE_HASH_COMPARE_NEON,
-	RTE_HASH_COMPARE_NUM
-};
-
 /** Bucket structure */
 struct rte_hash_bucket {
 	uint16_t sig_current[RTE_HASH_BUCKET_ENTRIES];
@@ -156,11 +148,29 @@ struct rte_hash_bucket {
 	void *next;
 } __rte_cache_aligned;
 
+/** Bucket table. Replaced as a whole by an online resize. */
+struct rte_hash_bkt_tbl {
+	struct rte_hash_bucket *buckets;
+	/**< Table with buckets storing all the	hash values and key indexes
+	 * to the key table.
+	 */
+	uint32_t num_buckets;           /**< Number of buckets in table. */
+	uint32_t bucket_bitmask;
+	/**< Bitmask for getting bucket index from hash signature. */
+};
+
+/* Bit of tbl_state selecting the current bucket table in tbls[] */
+#define RTE_HASH_TBL_CUR_MASK		0x1
+/* Set in tbl_state while the other bucket table is being migrated into
+ * the current one. Readers have to search both tables.
+ */
+#define RTE_HASH_TBL_RESIZING		0x2
+
 /** A hash table structure. */
 struct rte_hash {
 	char name[RTE_HASH_NAMESIZE];   /**< Name of the hash. */
 	uint32_t entries;               /**< Total table entries. */
-	uint32_t num_buckets;           /**< Number of buckets in table. */
+	int socket_id;                  /**< NUMA socket of table memory. */
 
 	struct rte_ring *free_slots;
 	/**< Ring that stores all indexes of the free slots in the key table */
@@ -199,14 +209,15 @@ struct rte_hash {
 	/**< Indicates which compare function to use. */
 	enum rte_hash_sig_compare_function sig_cmp_fn;
 	/**< Indicates which signature compare function to use. */
-	uint32_t bucket_bitmask;
-	/**< Bitmask for getting bucket index from hash signature. */
 	uint32_t key_entry_size;         /**< Size of each key entry. */
+	uint32_t tbl_state;
+	/**< Current bucket table and resize in progress flag. */
 
 	void *key_store;                /**< Table storing all keys and data */
-	struct rte_hash_bucket *buckets;
-	/**< Table with buckets storing all the	hash values and key indexes
-	 * to the key table.
+	struct rte_hash_bkt_tbl tbls[2];
+	/**< Current bucket table and, while resizing, the table being
+	 * migrated. The non current entry keeps the retired buckets of the
+	 * last resize until the next one starts or the hash is freed.
 	 */
 	rte_rwlock_t *readwrite_lock; /**< Read-write lock thread-safety. */
 	struct rte_hash_bucket *buckets_ext; /**< Extra buckets array */
@@ -220,8 +231,31 @@ struct rte_hash {
 	uint32_t *ext_bkt_to_free;
 	uint32_t *tbl_chng_cnt;
 	/**< Indicates if the hash table changed from last read. */
+	uint32_t resize_next;
+	/**< Next bucket of the old table to be migrated by a resize. */
+	void *key_store_retired;
+	/**< Key store replaced by the last resize, freed by the next one. */
+	struct rte_hash_rcu_config *hash_rcu_cfg;
+	/**< HASH RCU QSBR configuration structure */
+	struct rte_rcu_qsbr_dq *dq;	/**< RCU QSBR defer queue. */
 } __rte_cache_aligned;
 
+/* Resources of a deleted key reclaimed after the RCU grace period */
+struct __rte_hash_rcu_dq_entry {
+	uint32_t key_idx;
+	uint32_t ext_bkt_idx; /**< Extended bkt index */
+};
+
+#if defined(CC_AVX512_SUPPORT)
+/* Compare the signatures of a burst of keys, see rte_cuckoo_hash_avx512.c */
+void
+rte_hash_compare_signatures_avx512(uint32_t *prim_hash_matches,
+		uint32_t *sec_hash_matches,
+		const struct rte_hash_bucket **primary_bkt,
+		const struct rte_hash_bucket **secondary_bkt,
+		const uint16_t *sig, int32_t num_keys);
+#endif
+
 struct queue_node {
 	struct rte_hash_bucket *bkt; /* Current bucket on the bfs search */
 	uint32_t cur_bkt_idx;
@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 Intel Corporation
+ */
+
+#include <x86intrin.h>
+
+#include <rte_common.h>
+#include <rte_branch_prediction.h>
+#include <rte_rwlock.h>
+
+#include "rte_hash.h"
+#include "rte_cuckoo_hash.h"
+
+/*
+ * Load the signatures of the primary and secondary buckets of one key
+ * in a 256-bit half of a zmm register.
+ */
+#define BKT_PAIR_SIGS(prim, sec) \
+	_mm256_inserti128_si256(_mm256_castsi128_si256( \
+		_mm_load_si128((__m128i const *)(prim)->sig_current)), \
+		_mm_load_si128((__m128i const *)(sec)->sig_current), 1)
+
+/*
+ * Compare the signatures of the primary and secondary buckets of two keys
+ * at a time, 32 signatures in one instruction. The match masks use the
+ * same layout as the SSE version: two bits per bucket entry, the first
+ * one indicating the match.
+ */
+void
+rte_hash_compare_signatures_avx512(uint32_t *prim_hash_matches,
+		uint32_t *sec_hash_matches,
+		const struct rte_hash_bucket **primary_bkt,
+		const struct rte_hash_bucket **secondary_bkt,
+		const uint16_t *sig, int32_t num_keys)
+{
+	__m512i bkt_sigs, key_sigs;
+	__mmask32 hits;
+	uint64_t matches;
+	int32_t i;
+
+	for (i = 0; i < num_keys; i += 2) {
+		if (likely(i + 1 < num_keys)) {
+			bkt_sigs = _mm512_inserti64x4(_mm512_castsi256_si512(
+				BKT_PAIR_SIGS(primary_bkt[i],
+					secondary_bkt[i])),
+				BKT_PAIR_SIGS(primary_bkt[i + 1],
+					secondary_bkt[i + 1]), 1);
+			key_sigs = _mm512_inserti64x4(_mm512_castsi256_si512(
+				_mm256_set1_epi16(sig[i])),
+				_mm256_set1_epi16(sig[i + 1]), 1);
+		} else {
+			/* Last odd key, the upper half is ignored */
+			bkt_sigs = _mm512_castsi256_si512(
+				BKT_PAIR_SIGS(primary_bkt[i],
+					secondary_bkt[i]));
+			key_sigs = _mm512_set1_epi16(sig[i]);
+		}
+
+		hits = _mm512_cmpeq_epi16_mask(bkt_sigs, key_sigs);
+		/* Expand each signature match to two bits */
+		matches = _mm512_movepi8_mask(_mm512_movm_epi16(hits));
+
+		prim_hash_matches[i] = (uint32_t)(matches & 0xffff);
+		sec_hash_matches[i] = (uint32_t)((matches >> 16) & 0xffff);
+		if (likely(i + 1 < num_keys)) {
+			prim_hash_matches[i + 1] =
+				(uint32_t)((matches >> 32) & 0xffff);
+			sec_hash_matches[i + 1] = (uint32_t)(matches >> 48);
+		}
+	}
+}
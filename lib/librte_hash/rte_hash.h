@@ -15,6 +15,7 @@
 #include <stddef.h>
 
 #include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -81,6 +82,52 @@ struct rte_hash_parameters {
 	uint8_t extra_flag;		/**< Indicate if additional parameters are present. */
 };
 
+/** RCU reclamation modes */
+enum rte_hash_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_HASH_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_HASH_QSBR_MODE_SYNC
+};
+
+/** Max number of deleted keys reclaimed in one go by default. */
+#define RTE_HASH_RCU_DQ_RECLAIM_MAX	16
+
+/**
+ * Type of function used to free the data of a deleted key once
+ * no reader references it anymore.
+ */
+typedef void (*rte_hash_free_key_data)(void *p, void *key_data);
+
+/** HASH RCU QSBR configuration structure. */
+struct rte_hash_rcu_config {
+	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
+	/* Mode of RCU QSBR. RTE_HASH_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_hash_qsbr_mode mode;
+	uint32_t dq_size;	/* RCU defer queue size.
+				 * default: total hash table entries.
+				 */
+	uint32_t reclaim_thd;	/* Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/* Max entries to reclaim in one go.
+				 * default: RTE_HASH_RCU_DQ_RECLAIM_MAX.
+				 */
+	void *key_data_ptr;	/* Pointer passed to free_key_data_func. */
+	/* Function called on the data of a reclaimed key, can be NULL. */
+	rte_hash_free_key_data free_key_data_func;
+};
+
+/** Signature compare functions used by the bulk lookups */
+enum rte_hash_sig_compare_function {
+	RTE_HASH_COMPARE_SCALAR = 0,	/**< Scalar compare */
+	RTE_HASH_COMPARE_SSE,		/**< SSE2 compare */
+	RTE_HASH_COMPARE_NEON,		/**< NEON compare */
+	RTE_HASH_COMPARE_AVX512,
+	/**< AVX-512 compare of two keys at a time */
+	RTE_HASH_COMPARE_NUM
+};
+
 /** @internal A hash table structure. */
 struct rte_hash;
 
@@ -130,6 +177,29 @@ void rte_hash_set_cmp_func(struct rte_hash *h, rte_hash_cmp_eq_t func);
 struct rte_hash *
 rte_hash_find_existing(const char *name);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Set the signature compare function used by the bulk lookups.
+ * By default, the best function supported by the build and the CPU is
+ * selected at table creation. This should not be called while lookups
+ * are in progress.
+ *
+ * @param h
+ *   Hash table to change.
+ * @param sig_cmp_fn
+ *   Signature compare function to use.
+ * @return
+ *   - 0 on success
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOTSUP if the function is not supported by the build or the CPU.
+ */
+__rte_experimental
+int
+rte_hash_set_sig_cmp_fn(struct rte_hash *h,
+		enum rte_hash_sig_compare_function sig_cmp_fn);
+
 /**
  * De-allocate all memory used by hash table.
  * @param h
@@ -287,13 +357,16 @@ rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t
  * Thread safety can be enabled by setting flag during
  * table creation.
  * If RTE_HASH_EXTRA_FLAGS_NO_FREE_ON_DEL or
- * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF is enabled,
- * the key index returned by rte_hash_add_key_xxx APIs will not be
- * freed by this API. rte_hash_free_key_with_position API must be called
+ * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF is enabled and no RCU QSBR
+ * variable is associated with the table, the key index returned by
+ * rte_hash_add_key_xxx APIs will not be freed by this API.
+ * rte_hash_free_key_with_position API must be called
  * additionally to free the index associated with the key.
  * rte_hash_free_key_with_position API should be called after all
  * the readers have stopped referencing the entry corresponding to
  * this key. RCU mechanisms could be used to determine such a state.
+ * If an RCU QSBR variable is associated using rte_hash_rcu_qsbr_add(),
+ * the key index is freed by the library once the grace period is over.
  *
  * @param h
  *   Hash table to remove the key from.
@@ -316,13 +389,16 @@ rte_hash_del_key(const struct rte_hash *h, const void *key);
  * Thread safety can be enabled by setting flag during
  * table creation.
  * If RTE_HASH_EXTRA_FLAGS_NO_FREE_ON_DEL or
- * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF is enabled,
- * the key index returned by rte_hash_add_key_xxx APIs will not be
- * freed by this API. rte_hash_free_key_with_position API must be called
+ * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF is enabled and no RCU QSBR
+ * variable is associated with the table, the key index returned by
+ * rte_hash_add_key_xxx APIs will not be freed by this API.
+ * rte_hash_free_key_with_position API must be called
  * additionally to free the index associated with the key.
  * rte_hash_free_key_with_position API should be called after all
  * the readers have stopped referencing the entry corresponding to
  * this key. RCU mechanisms could be used to determine such a state.
+ * If an RCU QSBR variable is associated using rte_hash_rcu_qsbr_add(),
+ * the key index is freed by the library once the grace period is over.
  *
  * @param h
  *   Hash table to remove the key from.
@@ -376,6 +452,8 @@ rte_hash_get_key_with_position(const struct rte_hash *h, const int32_t position,
  * have stopped referencing the entry corresponding to this key.
  * RCU mechanisms could be used to determine such a state.
  * This API does not validate if the key is already freed.
+ * It must not be used if an RCU QSBR variable is associated with the
+ * table using rte_hash_rcu_qsbr_add().
  *
  * @param h
  *   Hash table to free the key from.
@@ -390,6 +468,75 @@ int
 rte_hash_free_key_with_position(const struct rte_hash *h,
 				const int32_t position);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Start an online resize of the hash table to hold 'entries' keys.
+ * A new bucket table is allocated and used for all additions from now on,
+ * while the keys of the current bucket table are migrated to it by
+ * rte_hash_resize_step(). Lookups keep being served from both bucket tables
+ * during the migration, including lock free lookups when
+ * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF is enabled.
+ *
+ * When growing, the key store is extended as well. Positions of the keys
+ * already in the table do not change, hence shrinking only releases bucket
+ * memory.
+ *
+ * The bucket table and key store replaced by a resize are freed when the
+ * next resize starts or the hash table is freed. With lock free readers,
+ * the application must make sure no reader still references them at that
+ * point. If an RCU QSBR variable is associated with the table using
+ * rte_hash_rcu_qsbr_add(), they are freed by rte_hash_resize_step() as
+ * soon as the migration completes and the readers went through a
+ * quiescent state.
+ *
+ * This operation is a writer operation. It is not multi-thread safe with
+ * regard to other writer operations and is not supported with
+ * RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD or RTE_HASH_EXTRA_FLAGS_EXT_TABLE.
+ *
+ * @param h
+ *   Hash table to resize.
+ * @param entries
+ *   New number of entries of the hash table.
+ * @return
+ *   - 0 if the resize was started
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOTSUP if the hash table does not support online resize.
+ *   - -EBUSY if a resize is already in progress.
+ *   - -ENOSPC if the table holds more than 'entries' keys.
+ *   - -ENOMEM if memory allocation failed.
+ */
+__rte_experimental
+int
+rte_hash_resize_start(struct rte_hash *h, uint32_t entries);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Migrate keys of up to 'num_buckets' buckets of the old bucket table to the
+ * new one, as part of a resize started by rte_hash_resize_start(). It is
+ * meant to be called repeatedly, e.g. from a control thread, until it
+ * returns 0. The resize is then complete.
+ * This operation is a writer operation, it is not multi-thread safe with
+ * regard to other writer operations.
+ *
+ * @param h
+ *   Hash table being resized.
+ * @param num_buckets
+ *   Maximum number of buckets to migrate.
+ * @return
+ *   - 0 if no resize is in progress anymore.
+ *   - A positive value, the number of buckets still to be migrated.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOSPC if a key did not fit in the new bucket table. The key is
+ *     kept in the old bucket table and the migration can be retried.
+ */
+__rte_experimental
+int
+rte_hash_resize_step(struct rte_hash *h, uint32_t num_buckets);
+
 /**
  * Find a key-value pair in the hash table.
  * This operation is multi-thread safe with regarding to other lookup threads.
@@ -625,6 +772,35 @@ rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
  */
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate RCU QSBR variable with a hash table.
+ * Once associated, the key indexes and extendable buckets released by
+ * rte_hash_del_key_xxx APIs are reclaimed by the library after the
+ * readers reporting to the QSBR variable went through a quiescent state.
+ * In RTE_HASH_QSBR_MODE_DQ mode, they are queued on a defer queue which is
+ * reclaimed when it fills up or when no free key index is left on
+ * addition. In RTE_HASH_QSBR_MODE_SYNC mode, deletion waits for the
+ * quiescent state.
+ * This API should be called right after creating the hash table, before
+ * any key is deleted.
+ *
+ * @param h
+ *   the hash table to add RCU QSBR
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   0 on success, or a negative value on error:
+ *   - -EINVAL - invalid pointer or mode
+ *   - -EEXIST - already added QSBR
+ *   - -ENOMEM - memory allocation failure
+ */
+__rte_experimental
+int rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg);
+
 #ifdef __cplusplus
 }
 #endif
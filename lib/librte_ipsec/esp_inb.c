@@ -206,7 +206,8 @@ inb_get_sqn(const struct rte_ipsec_sa *sa, const struct replay_sqn *rsn,
 	 */
 	sqn = rte_be_to_cpu_32(esph->seq);
 	if (IS_ESN(sa))
-		sqn = reconstruct_esn(rsn->sqn, sqn, sa->replay.win_sz);
+		sqn = reconstruct_esn(__atomic_load_n(&rsn->sqn,
+			__ATOMIC_RELAXED), sqn, sa->replay.win_sz);
 	*sqc = rte_cpu_to_be_64(sqn);
 
 	/* check IPsec window */
@@ -315,12 +316,12 @@ esp_inb_pkt_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 
 	sa = ss->sa;
 	cs = ss->crypto.ses;
-	rsn = rsn_acquire(sa);
+	rsn = sa->sqn.inb.rsn;
 
 	k = 0;
 	for (i = 0; i != num; i++) {
 
-		hl = mb[i]->l2_len + mb[i]->l3_len;
+		hl = mb[i]->l2_len + mb[i]->l3_len + sa->natt_len;
 		rc = inb_pkt_prepare(sa, rsn, mb[i], hl, &icv);
 		if (rc >= 0) {
 			lksd_none_cop_prepare(cop[k], cs, mb[i]);
@@ -332,8 +333,6 @@ esp_inb_pkt_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 		}
 	}
 
-	rsn_release(sa, rsn);
-
 	/* copy not prepared mbufs beyond good ones */
 	if (k != num && k != 0)
 		move_bad_mbufs(mb, dr, num, num - k);
@@ -347,18 +346,19 @@ esp_inb_pkt_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
  * Extract information that will be needed later from mbuf metadata and
  * actual packet data:
  * - mbuf for packet's last segment
- * - length of the L2/L3 headers
+ * - length of the L2/L3 headers, plus UDP header for NAT-T
  * - esp tail structure
  */
 static inline void
-process_step1(struct rte_mbuf *mb, uint32_t tlen, struct rte_mbuf **ml,
-	struct rte_esp_tail *espt, uint32_t *hlen, uint32_t *tofs)
+process_step1(struct rte_mbuf *mb, uint32_t tlen, uint32_t natt_len,
+	struct rte_mbuf **ml, struct rte_esp_tail *espt, uint32_t *hlen,
+	uint32_t *tofs)
 {
 	const struct rte_esp_tail *pt;
 	uint32_t ofs;
 
 	ofs = mb->pkt_len - tlen;
-	hlen[0] = mb->l2_len + mb->l3_len;
+	hlen[0] = mb->l2_len + mb->l3_len + natt_len;
 	ml[0] = mbuf_get_seg_ofs(mb, &ofs);
 	pt = rte_pktmbuf_mtod_offset(ml[0], const struct rte_esp_tail *, ofs);
 	tofs[0] = ofs;
@@ -535,7 +535,8 @@ tun_process(const struct rte_ipsec_sa *sa, struct rte_mbuf *mb[],
 	 * read mbufs metadata and esp tail first.
 	 */
 	for (i = 0; i != num; i++)
-		process_step1(mb[i], tlen, &ml[i], &espt[i], &hl[i], &to[i]);
+		process_step1(mb[i], tlen, sa->natt_len, &ml[i], &espt[i],
+			&hl[i], &to[i]);
 
 	k = 0;
 	for (i = 0; i != num; i++) {
@@ -593,7 +594,8 @@ trs_process(const struct rte_ipsec_sa *sa, struct rte_mbuf *mb[],
 	 * read mbufs metadata and esp tail first.
 	 */
 	for (i = 0; i != num; i++)
-		process_step1(mb[i], tlen, &ml[i], &espt[i], &hl[i], &to[i]);
+		process_step1(mb[i], tlen, sa->natt_len, &ml[i], &espt[i],
+			&hl[i], &to[i]);
 
 	k = 0;
 	for (i = 0; i != num; i++) {
@@ -635,7 +637,7 @@ esp_inb_rsn_update(struct rte_ipsec_sa *sa, const uint32_t sqn[],
 	if (sa->replay.win_sz == 0)
 		return num;
 
-	rsn = rsn_update_start(sa);
+	rsn = sa->sqn.inb.rsn;
 
 	k = 0;
 	for (i = 0; i != num; i++) {
@@ -645,7 +647,6 @@ esp_inb_rsn_update(struct rte_ipsec_sa *sa, const uint32_t sqn[],
 			dr[i - k] = i;
 	}
 
-	rsn_update_finish(sa, rsn);
 	return k;
 }
 
@@ -656,16 +657,20 @@ static inline uint16_t
 esp_inb_pkt_process(struct rte_ipsec_sa *sa, struct rte_mbuf *mb[],
 	uint16_t num, uint8_t sqh_len, esp_inb_process_t process)
 {
-	uint32_t k, n;
+	uint32_t i, k, m, n;
+	uint64_t bytes;
 	uint32_t sqn[num];
 	uint32_t dr[num];
 
+	/* drop packets beyond SA hard lifetime limits */
+	m = sa_lifetime_check(sa, num);
+
 	/* process packets, extract seq numbers */
-	k = process(sa, mb, sqn, dr, num, sqh_len);
+	k = process(sa, mb, sqn, dr, m, sqh_len);
 
 	/* handle unprocessed mbufs */
-	if (k != num && k != 0)
-		move_bad_mbufs(mb, dr, num, num - k);
+	if (k != m && k != 0)
+		move_bad_mbufs(mb, dr, m, m - k);
 
 	/* update SQN and replay window */
 	n = esp_inb_rsn_update(sa, sqn, dr, k);
@@ -674,7 +679,15 @@ esp_inb_pkt_process(struct rte_ipsec_sa *sa, struct rte_mbuf *mb[],
 	if (n != k && n != 0)
 		move_bad_mbufs(mb, dr, k, k - n);
 
-	if (n != num)
+	/* update SA statistics */
+	bytes = 0;
+	for (i = 0; i != n; i++)
+		bytes += mb[i]->pkt_len;
+	sa_stats_update(sa, n, bytes, num - n);
+
+	if (m != num)
+		rte_errno = EOVERFLOW;
+	else if (n != num)
 		rte_errno = EBADMSG;
 
 	return n;
@@ -703,14 +716,13 @@ cpu_inb_pkt_prepare(const struct rte_ipsec_session *ss,
 
 	sa = ss->sa;
 
-	/* grab rsn lock */
-	rsn = rsn_acquire(sa);
+	rsn = sa->sqn.inb.rsn;
 
 	/* do preparation for all packets */
 	for (i = 0, k = 0; i != num; i++) {
 
 		/* calculate ESP header offset */
-		l4ofs[k] = mb[i]->l2_len + mb[i]->l3_len;
+		l4ofs[k] = mb[i]->l2_len + mb[i]->l3_len + sa->natt_len;
 
 		/* prepare ESP packet for processing */
 		rc = inb_pkt_prepare(sa, rsn, mb[i], l4ofs[k], &icv);
@@ -729,9 +741,6 @@ cpu_inb_pkt_prepare(const struct rte_ipsec_session *ss,
 		}
 	}
 
-	/* release rsn lock */
-	rsn_release(sa, rsn);
-
 	/* copy not prepared mbufs beyond good ones */
 	if (k != num && k != 0)
 		move_bad_mbufs(mb, dr, num, num - k);
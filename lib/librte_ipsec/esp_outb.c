@@ -5,6 +5,7 @@
 #include <rte_ipsec.h>
 #include <rte_esp.h>
 #include <rte_ip.h>
+#include <rte_udp.h>
 #include <rte_errno.h>
 #include <rte_cryptodev.h>
 
@@ -113,6 +114,7 @@ outb_tun_pkt_prepare(struct rte_ipsec_sa *sa, rte_be64_t sqc,
 	struct rte_mbuf *ml;
 	struct rte_esp_hdr *esph;
 	struct rte_esp_tail *espt;
+	struct rte_udp_hdr *udph;
 	char *ph, *pt;
 	uint64_t *iv;
 
@@ -158,6 +160,13 @@ outb_tun_pkt_prepare(struct rte_ipsec_sa *sa, rte_be64_t sqc,
 	update_tun_outb_l3hdr(sa, ph + sa->hdr_l3_off, ph + hlen,
 			mb->pkt_len - sqh_len, sa->hdr_l3_off, sqn_low16(sqc));
 
+	/* update UDP encapsulation header length */
+	if (sa->natt_len != 0) {
+		udph = (struct rte_udp_hdr *)(ph + sa->hdr_len - sa->natt_len);
+		udph->dgram_len = rte_cpu_to_be_16(mb->pkt_len - sqh_len -
+				sa->hdr_len + sa->natt_len);
+	}
+
 	/* update spi, seqn and iv */
 	esph = (struct rte_esp_hdr *)(ph + sa->hdr_len);
 	iv = (uint64_t *)(esph + 1);
@@ -222,8 +231,8 @@ esp_outb_tun_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 	struct rte_crypto_op *cop[], uint16_t num)
 {
 	int32_t rc;
-	uint32_t i, k, n;
-	uint64_t sqn;
+	uint32_t i, k, n, plen;
+	uint64_t bytes, sqn;
 	rte_be64_t sqc;
 	struct rte_ipsec_sa *sa;
 	struct rte_cryptodev_sym_session *cs;
@@ -234,14 +243,16 @@ esp_outb_tun_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 	sa = ss->sa;
 	cs = ss->crypto.ses;
 
-	n = num;
+	n = sa_lifetime_check(sa, num);
 	sqn = esn_outb_update_sqn(sa, &n);
 	if (n != num)
 		rte_errno = EOVERFLOW;
 
 	k = 0;
+	bytes = 0;
 	for (i = 0; i != n; i++) {
 
+		plen = mb[i]->pkt_len;
 		sqc = rte_cpu_to_be_64(sqn + i);
 		gen_iv(iv, sqc);
 
@@ -253,6 +264,7 @@ esp_outb_tun_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 			outb_pkt_xprepare(sa, sqc, &icv);
 			lksd_none_cop_prepare(cop[k], cs, mb[i]);
 			outb_cop_prepare(cop[k], sa, iv, &icv, 0, rc);
+			bytes += plen;
 			k++;
 		/* failure, put packet into the death-row */
 		} else {
@@ -265,6 +277,8 @@ esp_outb_tun_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 	if (k != n && k != 0)
 		move_bad_mbufs(mb, dr, n, n - k);
 
+	sa_stats_update(sa, k, bytes, num - k);
+
 	return k;
 }
 
@@ -362,8 +376,8 @@ esp_outb_trs_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 	struct rte_crypto_op *cop[], uint16_t num)
 {
 	int32_t rc;
-	uint32_t i, k, n, l2, l3;
-	uint64_t sqn;
+	uint32_t i, k, n, l2, l3, plen;
+	uint64_t bytes, sqn;
 	rte_be64_t sqc;
 	struct rte_ipsec_sa *sa;
 	struct rte_cryptodev_sym_session *cs;
@@ -374,16 +388,18 @@ esp_outb_trs_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 	sa = ss->sa;
 	cs = ss->crypto.ses;
 
-	n = num;
+	n = sa_lifetime_check(sa, num);
 	sqn = esn_outb_update_sqn(sa, &n);
 	if (n != num)
 		rte_errno = EOVERFLOW;
 
 	k = 0;
+	bytes = 0;
 	for (i = 0; i != n; i++) {
 
 		l2 = mb[i]->l2_len;
 		l3 = mb[i]->l3_len;
+		plen = mb[i]->pkt_len;
 
 		sqc = rte_cpu_to_be_64(sqn + i);
 		gen_iv(iv, sqc);
@@ -396,6 +412,7 @@ esp_outb_trs_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 			outb_pkt_xprepare(sa, sqc, &icv);
 			lksd_none_cop_prepare(cop[k], cs, mb[i]);
 			outb_cop_prepare(cop[k], sa, iv, &icv, l2 + l3, rc);
+			bytes += plen;
 			k++;
 		/* failure, put packet into the death-row */
 		} else {
@@ -408,6 +425,8 @@ esp_outb_trs_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 	if (k != n && k != 0)
 		move_bad_mbufs(mb, dr, n, n - k);
 
+	sa_stats_update(sa, k, bytes, num - k);
+
 	return k;
 }
 
@@ -443,11 +462,11 @@ cpu_outb_pkt_prepare(const struct rte_ipsec_session *ss,
 		esp_outb_prepare_t prepare, uint32_t cofs_mask)
 {
 	int32_t rc;
-	uint64_t sqn;
+	uint64_t bytes, sqn;
 	rte_be64_t sqc;
 	struct rte_ipsec_sa *sa;
 	uint32_t i, k, n;
-	uint32_t l2, l3;
+	uint32_t l2, l3, plen;
 	union sym_op_data icv;
 	void *iv[num];
 	void *aad[num];
@@ -459,15 +478,17 @@ cpu_outb_pkt_prepare(const struct rte_ipsec_session *ss,
 
 	sa = ss->sa;
 
-	n = num;
+	n = sa_lifetime_check(sa, num);
 	sqn = esn_outb_update_sqn(sa, &n);
 	if (n != num)
 		rte_errno = EOVERFLOW;
 
+	bytes = 0;
 	for (i = 0, k = 0; i != n; i++) {
 
 		l2 = mb[i]->l2_len;
 		l3 = mb[i]->l3_len;
+		plen = mb[i]->pkt_len;
 
 		/* calculate ESP header offset */
 		l4ofs[k] = (l2 + l3) & cofs_mask;
@@ -491,6 +512,7 @@ cpu_outb_pkt_prepare(const struct rte_ipsec_session *ss,
 			iv[k] = ivbuf[k];
 			aad[k] = icv.va + sa->icv_len;
 			dgst[k++] = icv.va;
+			bytes += plen;
 		} else {
 			dr[i - k] = i;
 			rte_errno = -rc;
@@ -501,6 +523,8 @@ cpu_outb_pkt_prepare(const struct rte_ipsec_session *ss,
 	if (k != n && k != 0)
 		move_bad_mbufs(mb, dr, n, n - k);
 
+	sa_stats_update(sa, k, bytes, num - k);
+
 	/* convert mbufs to iovecs and do actual crypto/auth processing */
 	if (k != 0)
 		cpu_crypto_bulk(ss, sa->cofs, mb, iv, aad, dgst,
@@ -596,8 +620,8 @@ inline_outb_tun_pkt_process(const struct rte_ipsec_session *ss,
 	struct rte_mbuf *mb[], uint16_t num)
 {
 	int32_t rc;
-	uint32_t i, k, n;
-	uint64_t sqn;
+	uint32_t i, k, n, plen;
+	uint64_t bytes, sqn;
 	rte_be64_t sqc;
 	struct rte_ipsec_sa *sa;
 	union sym_op_data icv;
@@ -606,14 +630,16 @@ inline_outb_tun_pkt_process(const struct rte_ipsec_session *ss,
 
 	sa = ss->sa;
 
-	n = num;
+	n = sa_lifetime_check(sa, num);
 	sqn = esn_outb_update_sqn(sa, &n);
 	if (n != num)
 		rte_errno = EOVERFLOW;
 
 	k = 0;
+	bytes = 0;
 	for (i = 0; i != n; i++) {
 
+		plen = mb[i]->pkt_len;
 		sqc = rte_cpu_to_be_64(sqn + i);
 		gen_iv(iv, sqc);
 
@@ -626,6 +652,8 @@ inline_outb_tun_pkt_process(const struct rte_ipsec_session *ss,
 		if (rc < 0) {
 			dr[i - k] = i;
 			rte_errno = -rc;
+		} else {
+			bytes += plen;
 		}
 	}
 
@@ -633,6 +661,8 @@ inline_outb_tun_pkt_process(const struct rte_ipsec_session *ss,
 	if (k != n && k != 0)
 		move_bad_mbufs(mb, dr, n, n - k);
 
+	sa_stats_update(sa, k, bytes, num - k);
+
 	inline_outb_mbuf_prepare(ss, mb, k);
 	return k;
 }
@@ -646,8 +676,8 @@ inline_outb_trs_pkt_process(const struct rte_ipsec_session *ss,
 	struct rte_mbuf *mb[], uint16_t num)
 {
 	int32_t rc;
-	uint32_t i, k, n;
-	uint64_t sqn;
+	uint32_t i, k, n, plen;
+	uint64_t bytes, sqn;
 	rte_be64_t sqc;
 	struct rte_ipsec_sa *sa;
 	union sym_op_data icv;
@@ -656,14 +686,16 @@ inline_outb_trs_pkt_process(const struct rte_ipsec_session *ss,
 
 	sa = ss->sa;
 
-	n = num;
+	n = sa_lifetime_check(sa, num);
 	sqn = esn_outb_update_sqn(sa, &n);
 	if (n != num)
 		rte_errno = EOVERFLOW;
 
 	k = 0;
+	bytes = 0;
 	for (i = 0; i != n; i++) {
 
+		plen = mb[i]->pkt_len;
 		sqc = rte_cpu_to_be_64(sqn + i);
 		gen_iv(iv, sqc);
 
@@ -676,6 +708,8 @@ inline_outb_trs_pkt_process(const struct rte_ipsec_session *ss,
 		if (rc < 0) {
 			dr[i - k] = i;
 			rte_errno = -rc;
+		} else {
+			bytes += plen;
 		}
 	}
 
@@ -683,6 +717,8 @@ inline_outb_trs_pkt_process(const struct rte_ipsec_session *ss,
 	if (k != n && k != 0)
 		move_bad_mbufs(mb, dr, n, n - k);
 
+	sa_stats_update(sa, k, bytes, num - k);
+
 	inline_outb_mbuf_prepare(ss, mb, k);
 	return k;
 }
@@ -13,6 +13,15 @@
 #define WINDOW_BUCKET_MIN		2
 #define WINDOW_BUCKET_MAX		(INT16_MAX + 1)
 
+/*
+ * For SA shared by multiple threads each bucket holds 32 bits of the window
+ * in its low half, and the index of the block of SQNs they belong to
+ * in its high half.
+ */
+#define WINDOW_MT_BUCKET_BITS		5 /* uint32_t */
+#define WINDOW_MT_BUCKET_SIZE		(1 << WINDOW_MT_BUCKET_BITS)
+#define WINDOW_MT_BIT_LOC_MASK		(WINDOW_MT_BUCKET_SIZE - 1)
+
 #define IS_ESN(sa)	((sa)->sqn_mask == UINT64_MAX)
 
 #define	SQN_ATOMIC(sa)	((sa)->type & RTE_IPSEC_SATP_SQN_ATOM)
@@ -89,6 +98,36 @@ reconstruct_esn(uint64_t t, uint32_t sqn, uint32_t w)
  * Based on RFC 6479.
  * Blocks are 64 bits unsigned integers
  */
+static inline int32_t
+esn_inb_check_sqn_mt(const struct replay_sqn *rsn,
+	const struct rte_ipsec_sa *sa, uint64_t sqn)
+{
+	uint32_t blk, bucket;
+	uint64_t bit, top, val;
+
+	top = __atomic_load_n(&rsn->sqn, __ATOMIC_RELAXED);
+
+	/* seq is larger than lastseq */
+	if (sqn > top)
+		return 0;
+
+	/* seq is outside window */
+	if (sqn == 0 || sqn + sa->replay.win_sz < top)
+		return -EINVAL;
+
+	/* seq is inside the window */
+	blk = sqn >> WINDOW_MT_BUCKET_BITS;
+	bucket = blk & sa->replay.bucket_index_mask;
+	bit = (uint64_t)1 << (sqn & WINDOW_MT_BIT_LOC_MASK);
+
+	/* already seen packet */
+	val = __atomic_load_n(&rsn->window[bucket], __ATOMIC_RELAXED);
+	if ((uint32_t)(val >> 32) == blk && (val & bit) != 0)
+		return -EINVAL;
+
+	return 0;
+}
+
 static inline int32_t
 esn_inb_check_sqn(const struct replay_sqn *rsn, const struct rte_ipsec_sa *sa,
 	uint64_t sqn)
@@ -99,6 +138,9 @@ esn_inb_check_sqn(const struct replay_sqn *rsn, const struct rte_ipsec_sa *sa,
 	if (sa->replay.win_sz == 0)
 		return 0;
 
+	if (SQN_ATOMIC(sa))
+		return esn_inb_check_sqn_mt(rsn, sa, sqn);
+
 	/* seq is larger than lastseq */
 	if (sqn > rsn->sqn)
 		return 0;
@@ -143,6 +185,60 @@ esn_outb_update_sqn(struct rte_ipsec_sa *sa, uint32_t *num)
 	return sqn - n;
 }
 
+/**
+ * For inbound SA shared by multiple threads perform the sequence number
+ * and replay window update, lock-free.
+ * Window buckets are never cleared: a bucket that holds bits of an older
+ * block of SQNs is simply reused for the current one. The highest SQN is
+ * updated before the bucket, so a thread that sees a bucket taken by a newer
+ * block also sees the highest SQN that puts its own SQN out of the window.
+ */
+static inline int32_t
+esn_inb_update_sqn_mt(struct replay_sqn *rsn, const struct rte_ipsec_sa *sa,
+	uint64_t sqn)
+{
+	uint32_t blk, bucket;
+	uint64_t bit, top, val, nval;
+
+	top = __atomic_load_n(&rsn->sqn, __ATOMIC_RELAXED);
+
+	/* handle ESN */
+	if (IS_ESN(sa))
+		sqn = reconstruct_esn(top, sqn, sa->replay.win_sz);
+
+	/* move the window forward */
+	while (sqn > top && __atomic_compare_exchange_n(&rsn->sqn, &top, sqn,
+			0, __ATOMIC_RELAXED, __ATOMIC_RELAXED) == 0)
+		;
+
+	/* seq is outside window */
+	if (sqn == 0 || sqn + sa->replay.win_sz < top)
+		return -EINVAL;
+
+	blk = sqn >> WINDOW_MT_BUCKET_BITS;
+	bucket = blk & sa->replay.bucket_index_mask;
+	bit = (uint64_t)1 << (sqn & WINDOW_MT_BIT_LOC_MASK);
+
+	val = __atomic_load_n(&rsn->window[bucket], __ATOMIC_ACQUIRE);
+	do {
+		if ((uint32_t)(val >> 32) == blk) {
+			/* already seen packet */
+			if ((val & bit) != 0)
+				return -EINVAL;
+			nval = val | bit;
+		} else {
+			/* bucket is used by another block, recheck the window */
+			top = __atomic_load_n(&rsn->sqn, __ATOMIC_RELAXED);
+			if (sqn + sa->replay.win_sz < top)
+				return -EINVAL;
+			nval = (uint64_t)blk << 32 | bit;
+		}
+	} while (__atomic_compare_exchange_n(&rsn->window[bucket], &val, nval,
+			0, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE) == 0);
+
+	return 0;
+}
+
 /**
  * For inbound SA perform the sequence number and replay window update.
  */
@@ -152,6 +248,9 @@ esn_inb_update_sqn(struct replay_sqn *rsn, const struct rte_ipsec_sa *sa,
 {
 	uint32_t bit, bucket, last_bucket, new_bucket, diff, i;
 
+	if (SQN_ATOMIC(sa))
+		return esn_inb_update_sqn_mt(rsn, sa, sqn);
+
 	/* handle ESN */
 	if (IS_ESN(sa))
 		sqn = reconstruct_esn(rsn->sqn, sqn, sa->replay.win_sz);
@@ -190,120 +289,5 @@ esn_inb_update_sqn(struct replay_sqn *rsn, const struct rte_ipsec_sa *sa,
 	return 0;
 }
 
-/**
- * To achieve ability to do multiple readers single writer for
- * SA replay window information and sequence number (RSN)
- * basic RCU schema is used:
- * SA have 2 copies of RSN (one for readers, another for writers).
- * Each RSN contains a rwlock that has to be grabbed (for read/write)
- * to avoid races between readers and writer.
- * Writer is responsible to make a copy or reader RSN, update it
- * and mark newly updated RSN as readers one.
- * That approach is intended to minimize contention and cache sharing
- * between writer and readers.
- */
-
-/**
- * Copy replay window and SQN.
- */
-static inline void
-rsn_copy(const struct rte_ipsec_sa *sa, uint32_t dst, uint32_t src)
-{
-	uint32_t i, n;
-	struct replay_sqn *d;
-	const struct replay_sqn *s;
-
-	d = sa->sqn.inb.rsn[dst];
-	s = sa->sqn.inb.rsn[src];
-
-	n = sa->replay.nb_bucket;
-
-	d->sqn = s->sqn;
-	for (i = 0; i != n; i++)
-		d->window[i] = s->window[i];
-}
-
-/**
- * Get RSN for read-only access.
- */
-static inline struct replay_sqn *
-rsn_acquire(struct rte_ipsec_sa *sa)
-{
-	uint32_t n;
-	struct replay_sqn *rsn;
-
-	n = sa->sqn.inb.rdidx;
-	rsn = sa->sqn.inb.rsn[n];
-
-	if (!SQN_ATOMIC(sa))
-		return rsn;
-
-	/* check there are no writers */
-	while (rte_rwlock_read_trylock(&rsn->rwl) < 0) {
-		rte_pause();
-		n = sa->sqn.inb.rdidx;
-		rsn = sa->sqn.inb.rsn[n];
-		rte_compiler_barrier();
-	}
-
-	return rsn;
-}
-
-/**
- * Release read-only access for RSN.
- */
-static inline void
-rsn_release(struct rte_ipsec_sa *sa, struct replay_sqn *rsn)
-{
-	if (SQN_ATOMIC(sa))
-		rte_rwlock_read_unlock(&rsn->rwl);
-}
-
-/**
- * Start RSN update.
- */
-static inline struct replay_sqn *
-rsn_update_start(struct rte_ipsec_sa *sa)
-{
-	uint32_t k, n;
-	struct replay_sqn *rsn;
-
-	n = sa->sqn.inb.wridx;
-
-	/* no active writers */
-	RTE_ASSERT(n == sa->sqn.inb.rdidx);
-
-	if (!SQN_ATOMIC(sa))
-		return sa->sqn.inb.rsn[n];
-
-	k = REPLAY_SQN_NEXT(n);
-	sa->sqn.inb.wridx = k;
-
-	rsn = sa->sqn.inb.rsn[k];
-	rte_rwlock_write_lock(&rsn->rwl);
-	rsn_copy(sa, k, n);
-
-	return rsn;
-}
-
-/**
- * Finish RSN update.
- */
-static inline void
-rsn_update_finish(struct rte_ipsec_sa *sa, struct replay_sqn *rsn)
-{
-	uint32_t n;
-
-	if (!SQN_ATOMIC(sa))
-		return;
-
-	n = sa->sqn.inb.wridx;
-	RTE_ASSERT(n != sa->sqn.inb.rdidx);
-	RTE_ASSERT(rsn == sa->sqn.inb.rsn[n]);
-
-	rte_rwlock_write_unlock(&rsn->rwl);
-	sa->sqn.inb.rdidx = n;
-}
-
 
 #endif /* _IPSEC_SQN_H_ */
@@ -38,6 +38,47 @@ move_bad_mbufs(struct rte_mbuf *mb[], const uint32_t bad_idx[], uint32_t nb_mb,
 		mb[k + i] = drb[i];
 }
 
+/*
+ * Check SA hard lifetime limits for the burst of *num* packets,
+ * returns number of packets that can still be processed.
+ * Limits are checked against the SA counters at the start of the burst,
+ * so the bytes limit can be exceeded by the last burst, and for SA
+ * shared by multiple threads both limits can be exceeded by the bursts
+ * processed concurrently.
+ */
+static inline uint32_t
+sa_lifetime_check(const struct rte_ipsec_sa *sa, uint32_t num)
+{
+	uint64_t count, bytes;
+
+	count = __atomic_load_n(&sa->stats.count, __ATOMIC_RELAXED);
+	bytes = __atomic_load_n(&sa->stats.bytes, __ATOMIC_RELAXED);
+
+	if (count >= sa->lifetime.packets_hard_limit ||
+			bytes >= sa->lifetime.bytes_hard_limit)
+		return 0;
+
+	return RTE_MIN((uint64_t)num, sa->lifetime.packets_hard_limit - count);
+}
+
+/*
+ * Update SA statistics, called once per burst.
+ */
+static inline void
+sa_stats_update(struct rte_ipsec_sa *sa, uint32_t count, uint64_t bytes,
+	uint32_t errors)
+{
+	if (SQN_ATOMIC(sa)) {
+		__atomic_fetch_add(&sa->stats.count, count, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&sa->stats.bytes, bytes, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&sa->stats.errors, errors, __ATOMIC_RELAXED);
+	} else {
+		sa->stats.count += count;
+		sa->stats.bytes += bytes;
+		sa->stats.errors += errors;
+	}
+}
+
 /*
  * Find packet's segment for the specified offset.
  * ofs - at input should contain required offset, at output would contain
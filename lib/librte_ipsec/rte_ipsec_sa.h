@@ -25,6 +25,21 @@ extern "C" {
  */
 struct rte_ipsec_sa;
 
+/**
+ * SA lifetime limits, zero value means no limit.
+ * Packet and byte counts are the ones reported by rte_ipsec_sa_stats_get().
+ * When a soft limit is reached, the SA keeps processing packets and
+ * reports RTE_IPSEC_SA_STATS_SOFT_EXPIRED, so the user can start a rekey.
+ * When a hard limit is reached, the SA drops all packets and reports
+ * RTE_IPSEC_SA_STATS_HARD_EXPIRED.
+ */
+struct rte_ipsec_sa_lifetime {
+	uint64_t packets_soft_limit; /**< soft limit in packets */
+	uint64_t bytes_soft_limit;   /**< soft limit in bytes */
+	uint64_t packets_hard_limit; /**< hard limit in packets */
+	uint64_t bytes_hard_limit;   /**< hard limit in bytes */
+};
+
 /**
  * SA initialization parameters.
  */
@@ -41,12 +56,25 @@ struct rte_ipsec_sa_prm {
 			uint8_t hdr_len;     /**< tunnel header len */
 			uint8_t hdr_l3_off;  /**< offset for IPv4/IPv6 header */
 			uint8_t next_proto;  /**< next header protocol */
+			/**
+			 * UDP encapsulation (RFC 3948) ports, in network
+			 * byte order, used when ipsec_xform.options.udp_encap
+			 * is set. The UDP header is inserted by the library
+			 * after the tunnel header template, whose next
+			 * protocol has to be UDP.
+			 */
+			struct {
+				rte_be16_t sport; /**< UDP source port */
+				rte_be16_t dport; /**< UDP destination port */
+			} udp;
 			const void *hdr;     /**< tunnel header template */
 		} tun; /**< tunnel mode related parameters */
 		struct {
 			uint8_t proto;  /**< next header protocol */
 		} trs; /**< transport mode related parameters */
 	};
+	/** SA lifetime limits */
+	struct rte_ipsec_sa_lifetime lifetime;
 };
 
 /**
@@ -56,17 +84,14 @@ struct rte_ipsec_sa_prm {
  * functions:
  *  - rte_ipsec_pkt_crypto_prepare
  *  - rte_ipsec_pkt_process
- * can be safely used in MT environment, as long as the user can guarantee
- * that they obey multiple readers/single writer model for SQN+replay_window
- * operations.
- * To be more specific:
- * for outbound SA there are no restrictions.
- * for inbound SA the caller has to guarantee that at any given moment
- * only one thread is executing rte_ipsec_pkt_process() for given SA.
- * Note that it is caller responsibility to maintain correct order
- * of packets to be processed.
- * In other words - it is a caller responsibility to serialize process()
- * invocations.
+ * can be safely used in MT environment for the same SA, without any
+ * extra synchronization from the caller.
+ * For inbound SA the replay window is updated lock-free, so packets of
+ * one SA can be processed by multiple threads concurrently. Packets
+ * reordered between threads are accepted as long as they stay within
+ * the replay window.
+ * Note that the replay window of such SA uses twice as many buckets as
+ * the one of the non 'atomic' SA of the same window size.
  */
 #define	RTE_IPSEC_SAFLAG_SQN_ATOM	(1ULL << 0)
 
@@ -79,6 +104,7 @@ struct rte_ipsec_sa_prm {
  * - for TUNNEL outer IP version (IPv4/IPv6)
  * - are SA SQN operations 'atomic'
  * - ESN enabled/disabled
+ * - UDP encapsulation (NAT-T) enabled/disabled
  * ...
  */
 
@@ -91,6 +117,7 @@ enum {
 	RTE_SATP_LOG2_ESN,
 	RTE_SATP_LOG2_ECN,
 	RTE_SATP_LOG2_DSCP,
+	RTE_SATP_LOG2_NATT,
 	RTE_SATP_LOG2_NUM
 };
 
@@ -127,6 +154,10 @@ enum {
 #define RTE_IPSEC_SATP_DSCP_DISABLE	(0ULL << RTE_SATP_LOG2_DSCP)
 #define RTE_IPSEC_SATP_DSCP_ENABLE	(1ULL << RTE_SATP_LOG2_DSCP)
 
+#define RTE_IPSEC_SATP_NATT_MASK	(1ULL << RTE_SATP_LOG2_NATT)
+#define RTE_IPSEC_SATP_NATT_DISABLE	(0ULL << RTE_SATP_LOG2_NATT)
+#define RTE_IPSEC_SATP_NATT_ENABLE	(1ULL << RTE_SATP_LOG2_NATT)
+
 /**
  * get type of given SA
  * @return
@@ -166,6 +197,48 @@ int
 rte_ipsec_sa_init(struct rte_ipsec_sa *sa, const struct rte_ipsec_sa_prm *prm,
 	uint32_t size);
 
+/**
+ * SA statistics, see rte_ipsec_sa_stats_get().
+ */
+struct rte_ipsec_sa_stats {
+	uint64_t count;  /**< number of packets processed successfully */
+	uint64_t bytes;  /**< number of bytes processed successfully */
+	uint64_t errors; /**< number of packets failed or dropped */
+	uint64_t flags;  /**< lifetime state, see RTE_IPSEC_SA_STATS_* */
+};
+
+/** SA soft lifetime limit is reached */
+#define RTE_IPSEC_SA_STATS_SOFT_EXPIRED	(1ULL << 0)
+/** SA hard lifetime limit is reached, SA drops all packets */
+#define RTE_IPSEC_SA_STATS_HARD_EXPIRED	(1ULL << 1)
+
+/**
+ * Retrieve statistics and lifetime state for a group of SAs.
+ * Statistics are updated once per burst by the data-path functions:
+ * - for outbound SA by rte_ipsec_pkt_crypto_prepare(),
+ *   rte_ipsec_pkt_cpu_prepare() or rte_ipsec_pkt_process() for
+ *   RTE_SECURITY_ACTION_TYPE_INLINE_CRYPTO; bytes are counted before
+ *   the ESP encapsulation.
+ * - for inbound SA by rte_ipsec_pkt_process(); bytes are counted after
+ *   the ESP decapsulation.
+ * Sessions of type RTE_SECURITY_ACTION_TYPE_INLINE_PROTOCOL and
+ * RTE_SECURITY_ACTION_TYPE_LOOKASIDE_PROTOCOL are not accounted.
+ * Can be called concurrently with the data-path.
+ * @param sa
+ *   Array of pointers to the SA objects.
+ * @param stats
+ *   Array of *num* statistics structures to fill.
+ * @param num
+ *   Number of elements in both arrays.
+ * @return
+ *   - Zero if operation completed successfully.
+ *   - -EINVAL if the parameters are invalid.
+ */
+__rte_experimental
+int
+rte_ipsec_sa_stats_get(const struct rte_ipsec_sa * const sa[],
+	struct rte_ipsec_sa_stats stats[], uint32_t num);
+
 /**
  * cleanup SA
  * @param sa
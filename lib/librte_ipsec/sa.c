@@ -5,6 +5,7 @@
 #include <rte_ipsec.h>
 #include <rte_esp.h>
 #include <rte_ip.h>
+#include <rte_udp.h>
 #include <rte_errno.h>
 #include <rte_cryptodev.h>
 
@@ -102,12 +103,20 @@ rsn_size(uint32_t nb_bucket)
  * for given size, calculate required number of buckets.
  */
 static uint32_t
-replay_num_bucket(uint32_t wsz)
+replay_num_bucket(uint64_t type, uint32_t wsz)
 {
 	uint32_t nb;
 
-	nb = rte_align32pow2(RTE_ALIGN_MUL_CEIL(wsz, WINDOW_BUCKET_SIZE) /
-		WINDOW_BUCKET_SIZE);
+	/*
+	 * for SA shared by multiple threads bucket holds 32 bits of window,
+	 * plus one extra bucket for the block of SQNs being filled.
+	 */
+	if ((type & RTE_IPSEC_SATP_SQN_MASK) == RTE_IPSEC_SATP_SQN_ATOM)
+		nb = rte_align32pow2(RTE_ALIGN_MUL_CEIL(wsz,
+			WINDOW_MT_BUCKET_SIZE) / WINDOW_MT_BUCKET_SIZE + 1);
+	else
+		nb = rte_align32pow2(RTE_ALIGN_MUL_CEIL(wsz,
+			WINDOW_BUCKET_SIZE) / WINDOW_BUCKET_SIZE);
 	nb = RTE_MAX(nb, (uint32_t)WINDOW_BUCKET_MIN);
 
 	return nb;
@@ -132,7 +141,7 @@ ipsec_sa_size(uint64_t type, uint32_t *wnd_sz, uint32_t *nb_bucket)
 			RTE_IPSEC_SATP_ESN_DISABLE) ?
 			wsz : RTE_MAX(wsz, (uint32_t)WINDOW_BUCKET_SIZE);
 		if (wsz != 0)
-			n = replay_num_bucket(wsz);
+			n = replay_num_bucket(type, wsz);
 	}
 
 	if (n > WINDOW_BUCKET_MAX)
@@ -142,9 +151,6 @@ ipsec_sa_size(uint64_t type, uint32_t *wnd_sz, uint32_t *nb_bucket)
 	*nb_bucket = n;
 
 	sz = rsn_size(n);
-	if ((type & RTE_IPSEC_SATP_SQN_MASK) == RTE_IPSEC_SATP_SQN_ATOM)
-		sz *= REPLAY_SQN_NUM;
-
 	sz += sizeof(struct rte_ipsec_sa);
 	return sz;
 }
@@ -226,6 +232,14 @@ fill_sa_type(const struct rte_ipsec_sa_prm *prm, uint64_t *type)
 	else
 		tp |= RTE_IPSEC_SATP_DSCP_ENABLE;
 
+	/* check for UDP encapsulation flag, supported in tunnel mode only */
+	if (prm->ipsec_xform.options.udp_encap == 0)
+		tp |= RTE_IPSEC_SATP_NATT_DISABLE;
+	else if ((tp & RTE_IPSEC_SATP_MODE_MASK) != RTE_IPSEC_SATP_MODE_TRANS)
+		tp |= RTE_IPSEC_SATP_NATT_ENABLE;
+	else
+		return -EINVAL;
+
 	/* interpret flags */
 	if (prm->flags & RTE_IPSEC_SAFLAG_SQN_ATOM)
 		tp |= RTE_IPSEC_SATP_SQN_ATOM;
@@ -272,6 +286,11 @@ static void
 esp_inb_tun_init(struct rte_ipsec_sa *sa, const struct rte_ipsec_sa_prm *prm)
 {
 	sa->proto = prm->tun.next_proto;
+
+	/* ESP header follows the UDP header for encapsulated packets */
+	if ((sa->type & RTE_IPSEC_SATP_NATT_MASK) == RTE_IPSEC_SATP_NATT_ENABLE)
+		sa->natt_len = sizeof(struct rte_udp_hdr);
+
 	esp_inb_init(sa);
 }
 
@@ -344,6 +363,21 @@ esp_outb_tun_init(struct rte_ipsec_sa *sa, const struct rte_ipsec_sa_prm *prm)
 
 	memcpy(sa->hdr, prm->tun.hdr, sa->hdr_len);
 
+	/* append UDP header to the template, its length is set per packet */
+	if ((sa->type & RTE_IPSEC_SATP_NATT_MASK) ==
+			RTE_IPSEC_SATP_NATT_ENABLE) {
+		struct rte_udp_hdr *udph;
+
+		udph = (struct rte_udp_hdr *)(sa->hdr + sa->hdr_len);
+		udph->src_port = prm->tun.udp.sport;
+		udph->dst_port = prm->tun.udp.dport;
+		udph->dgram_len = 0;
+		udph->dgram_cksum = 0;
+
+		sa->natt_len = sizeof(*udph);
+		sa->hdr_len += sa->natt_len;
+	}
+
 	esp_outb_init(sa, sa->hdr_len);
 }
 
@@ -443,6 +477,39 @@ esp_sa_init(struct rte_ipsec_sa *sa, const struct rte_ipsec_sa_prm *prm,
 	return 0;
 }
 
+/*
+ * helper function, check SA lifetime limits.
+ */
+static int
+check_sa_lifetime(const struct rte_ipsec_sa_lifetime *lt)
+{
+	if (lt->packets_soft_limit != 0 && lt->packets_hard_limit != 0 &&
+			lt->packets_soft_limit > lt->packets_hard_limit)
+		return -EINVAL;
+	if (lt->bytes_soft_limit != 0 && lt->bytes_hard_limit != 0 &&
+			lt->bytes_soft_limit > lt->bytes_hard_limit)
+		return -EINVAL;
+	return 0;
+}
+
+/*
+ * helper function, init SA lifetime limits,
+ * replace zero (no limit) values with UINT64_MAX.
+ */
+static void
+fill_sa_lifetime(struct rte_ipsec_sa *sa,
+	const struct rte_ipsec_sa_lifetime *lt)
+{
+	sa->lifetime.packets_soft_limit = (lt->packets_soft_limit == 0) ?
+		UINT64_MAX : lt->packets_soft_limit;
+	sa->lifetime.bytes_soft_limit = (lt->bytes_soft_limit == 0) ?
+		UINT64_MAX : lt->bytes_soft_limit;
+	sa->lifetime.packets_hard_limit = (lt->packets_hard_limit == 0) ?
+		UINT64_MAX : lt->packets_hard_limit;
+	sa->lifetime.bytes_hard_limit = (lt->bytes_hard_limit == 0) ?
+		UINT64_MAX : lt->bytes_hard_limit;
+}
+
 /*
  * helper function, init SA replay structure.
  */
@@ -452,10 +519,7 @@ fill_sa_replay(struct rte_ipsec_sa *sa, uint32_t wnd_sz, uint32_t nb_bucket)
 	sa->replay.win_sz = wnd_sz;
 	sa->replay.nb_bucket = nb_bucket;
 	sa->replay.bucket_index_mask = nb_bucket - 1;
-	sa->sqn.inb.rsn[0] = (struct replay_sqn *)(sa + 1);
-	if ((sa->type & RTE_IPSEC_SATP_SQN_MASK) == RTE_IPSEC_SATP_SQN_ATOM)
-		sa->sqn.inb.rsn[1] = (struct replay_sqn *)
-			((uintptr_t)sa->sqn.inb.rsn[0] + rsn_size(nb_bucket));
+	sa->sqn.inb.rsn = (struct replay_sqn *)(sa + 1);
 }
 
 int
@@ -483,7 +547,7 @@ rte_ipsec_sa_init(struct rte_ipsec_sa *sa, const struct rte_ipsec_sa_prm *prm,
 	uint32_t size)
 {
 	int32_t rc, sz;
-	uint32_t nb, wsz;
+	uint32_t hlen, nb, wsz;
 	uint64_t type;
 	struct crypto_xform cxf;
 
@@ -507,10 +571,19 @@ rte_ipsec_sa_init(struct rte_ipsec_sa *sa, const struct rte_ipsec_sa_prm *prm,
 	if (prm->ipsec_xform.proto != RTE_SECURITY_IPSEC_SA_PROTO_ESP)
 		return -EINVAL;
 
+	/* tunnel header, plus UDP header if any, has to fit the template */
+	hlen = prm->tun.hdr_len;
+	if ((type & RTE_IPSEC_SATP_NATT_MASK) == RTE_IPSEC_SATP_NATT_ENABLE)
+		hlen += sizeof(struct rte_udp_hdr);
+
 	if (prm->ipsec_xform.mode == RTE_SECURITY_IPSEC_SA_MODE_TUNNEL &&
-			prm->tun.hdr_len > sizeof(sa->hdr))
+			hlen > sizeof(sa->hdr))
 		return -EINVAL;
 
+	rc = check_sa_lifetime(&prm->lifetime);
+	if (rc != 0)
+		return rc;
+
 	rc = fill_crypto_xform(&cxf, type, prm);
 	if (rc != 0)
 		return rc;
@@ -525,6 +598,8 @@ rte_ipsec_sa_init(struct rte_ipsec_sa *sa, const struct rte_ipsec_sa_prm *prm,
 	sa->sqn_mask = (prm->ipsec_xform.options.esn == 0) ?
 		UINT32_MAX : UINT64_MAX;
 
+	fill_sa_lifetime(sa, &prm->lifetime);
+
 	rc = esp_sa_init(sa, prm, &cxf);
 	if (rc != 0)
 		rte_ipsec_sa_fini(sa);
@@ -536,6 +611,42 @@ rte_ipsec_sa_init(struct rte_ipsec_sa *sa, const struct rte_ipsec_sa_prm *prm,
 	return sz;
 }
 
+int
+rte_ipsec_sa_stats_get(const struct rte_ipsec_sa * const sa[],
+	struct rte_ipsec_sa_stats stats[], uint32_t num)
+{
+	uint32_t i;
+	uint64_t count, bytes, flags;
+
+	if (sa == NULL || stats == NULL)
+		return -EINVAL;
+
+	for (i = 0; i != num; i++) {
+
+		if (sa[i] == NULL)
+			return -EINVAL;
+
+		count = __atomic_load_n(&sa[i]->stats.count, __ATOMIC_RELAXED);
+		bytes = __atomic_load_n(&sa[i]->stats.bytes, __ATOMIC_RELAXED);
+
+		flags = 0;
+		if (count >= sa[i]->lifetime.packets_soft_limit ||
+				bytes >= sa[i]->lifetime.bytes_soft_limit)
+			flags |= RTE_IPSEC_SA_STATS_SOFT_EXPIRED;
+		if (count >= sa[i]->lifetime.packets_hard_limit ||
+				bytes >= sa[i]->lifetime.bytes_hard_limit)
+			flags |= RTE_IPSEC_SA_STATS_HARD_EXPIRED;
+
+		stats[i].count = count;
+		stats[i].bytes = bytes;
+		stats[i].errors = __atomic_load_n(&sa[i]->stats.errors,
+			__ATOMIC_RELAXED);
+		stats[i].flags = flags;
+	}
+
+	return 0;
+}
+
 /*
  *  setup crypto ops for LOOKASIDE_PROTO type of devices.
  */
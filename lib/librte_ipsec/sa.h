@@ -5,8 +5,6 @@
 #ifndef _SA_H_
 #define _SA_H_
 
-#include <rte_rwlock.h>
-
 #define IPSEC_MAX_HDR_SIZE	64
 #define IPSEC_MAX_IV_SIZE	16
 #define IPSEC_MAX_IV_QWORD	(IPSEC_MAX_IV_SIZE / sizeof(uint64_t))
@@ -51,11 +49,7 @@ union sym_op_data {
 	};
 };
 
-#define REPLAY_SQN_NUM		2
-#define REPLAY_SQN_NEXT(n)	((n) ^ 1)
-
 struct replay_sqn {
-	rte_rwlock_t rwl;
 	uint64_t sqn;
 	__extension__ uint64_t window[0];
 };
@@ -95,6 +89,8 @@ struct rte_ipsec_sa {
 		uint64_t msk;
 		uint64_t val;
 	} tx_offload;
+	/* lifetime limits, UINT64_MAX when not set */
+	struct rte_ipsec_sa_lifetime lifetime;
 	uint32_t salt;
 	uint8_t algo_type;
 	uint8_t proto;    /* next proto */
@@ -107,6 +103,7 @@ struct rte_ipsec_sa {
 	uint8_t iv_len;
 	uint8_t pad_align;
 	uint8_t tos_mask;
+	uint8_t natt_len; /* UDP encapsulation header length, 0 if none */
 
 	/* template for tunnel header */
 	uint8_t hdr[IPSEC_MAX_HDR_SIZE];
@@ -121,12 +118,20 @@ struct rte_ipsec_sa {
 	union {
 		uint64_t outb;
 		struct {
-			uint32_t rdidx; /* read index */
-			uint32_t wridx; /* write index */
-			struct replay_sqn *rsn[REPLAY_SQN_NUM];
+			struct replay_sqn *rsn;
 		} inb;
 	} sqn;
 
+	/*
+	 * per SA statistics, updated once per burst by the same threads
+	 * that update *sqn*, so kept next to it.
+	 */
+	struct {
+		uint64_t count;
+		uint64_t bytes;
+		uint64_t errors;
+	} stats;
+
 } __rte_cache_aligned;
 
 int
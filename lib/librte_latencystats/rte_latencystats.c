@@ -6,6 +6,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <math.h>
+#include <string.h>
 
 #include <rte_string_fns.h>
 #include <rte_mbuf.h>
@@ -15,6 +16,7 @@
 #include <rte_metrics.h>
 #include <rte_memzone.h>
 #include <rte_lcore.h>
+#include <rte_telemetry.h>
 
 #include "rte_latencystats.h"
 
@@ -34,55 +36,180 @@ latencystat_cycles_per_ns(void)
 static const char *MZ_RTE_LATENCY_STATS = "rte_latencystats";
 static int latency_stats_index;
 static uint64_t samp_intvl;
-static uint64_t timer_tsc;
-static uint64_t prev_tsc;
+
+/*
+ * Latency histogram, log-linear: each power of two range of latencies (in
+ * TSC cycles) is split in 2^LATENCY_HIST_SUB_BITS equal width buckets, which
+ * bounds the relative error of the reported percentiles to ~3%. Latencies
+ * below 2^(LATENCY_HIST_SUB_BITS + 1) cycles get one bucket each, latencies
+ * above 2^LATENCY_HIST_MAX_BITS cycles are accounted in the last bucket.
+ */
+#define LATENCY_HIST_SUB_BITS 5
+#define LATENCY_HIST_SUB_BUCKETS (1 << LATENCY_HIST_SUB_BITS)
+#define LATENCY_HIST_MAX_BITS 36
+#define LATENCY_HIST_BUCKETS \
+	((LATENCY_HIST_MAX_BITS - LATENCY_HIST_SUB_BITS + 1) * \
+	 LATENCY_HIST_SUB_BUCKETS)
+
+/*
+ * Latency stats of one Tx queue. Only the lcore transmitting on the queue
+ * updates them, so no lock is needed; readers merge the stats of all the
+ * queues, a sample being possibly missed if it is updated concurrently.
+ */
+struct latency_queue_stats {
+	uint64_t samples; /**< Number of latency samples */
+	float min_latency; /**< Minimum latency in cycles */
+	float avg_latency; /**< Average latency in cycles */
+	float max_latency; /**< Maximum latency in cycles */
+	float jitter; /**< Latency variation in cycles */
+	float prev_latency; /**< Latency of the previous sample */
+	uint64_t hist[LATENCY_HIST_BUCKETS]; /**< Latency histogram */
+} __rte_cache_aligned;
 
 struct rte_latency_stats {
-	float min_latency; /**< Minimum latency in nano seconds */
-	float avg_latency; /**< Average latency in nano seconds */
-	float max_latency; /**< Maximum latency in nano seconds */
-	float jitter; /** Latency variation */
-	rte_spinlock_t lock; /** Latency calculation lock */
+	uint32_t nb_queues; /**< Number of Tx queues with stats */
+	struct latency_queue_stats queues[]; /**< Per Tx queue stats */
 };
 
 static struct rte_latency_stats *glob_stats;
 
 struct rxtx_cbs {
 	const struct rte_eth_rxtx_callback *cb;
+	uint64_t prev_tsc; /**< Rx: time of the last packet seen */
+	uint64_t timer_tsc; /**< Rx: time elapsed since the last sample */
 };
 
 static struct rxtx_cbs rx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
 static struct rxtx_cbs tx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
 
-struct latency_stats_nameoff {
-	char name[RTE_ETH_XSTATS_NAME_SIZE];
-	unsigned int offset;
+enum latency_stats_id {
+	LATENCY_STATS_MIN,
+	LATENCY_STATS_AVG,
+	LATENCY_STATS_MAX,
+	LATENCY_STATS_JITTER,
+	LATENCY_STATS_P50,
+	LATENCY_STATS_P99,
+	LATENCY_STATS_P99_9,
+	LATENCY_STATS_P99_99,
+	NUM_LATENCY_STATS
+};
+
+static const char * const lat_stats_strings[NUM_LATENCY_STATS] = {
+	[LATENCY_STATS_MIN] = "min_latency_ns",
+	[LATENCY_STATS_AVG] = "avg_latency_ns",
+	[LATENCY_STATS_MAX] = "max_latency_ns",
+	[LATENCY_STATS_JITTER] = "jitter_ns",
+	[LATENCY_STATS_P50] = "p50_latency_ns",
+	[LATENCY_STATS_P99] = "p99_latency_ns",
+	[LATENCY_STATS_P99_9] = "p99_9_latency_ns",
+	[LATENCY_STATS_P99_99] = "p99_99_latency_ns",
 };
 
-static const struct latency_stats_nameoff lat_stats_strings[] = {
-	{"min_latency_ns", offsetof(struct rte_latency_stats, min_latency)},
-	{"avg_latency_ns", offsetof(struct rte_latency_stats, avg_latency)},
-	{"max_latency_ns", offsetof(struct rte_latency_stats, max_latency)},
-	{"jitter_ns", offsetof(struct rte_latency_stats, jitter)},
+/* Percentiles reported, in hundredths of percent */
+static const struct {
+	enum latency_stats_id id;
+	uint32_t rank;
+} lat_stats_percentiles[] = {
+	{LATENCY_STATS_P50, 5000},
+	{LATENCY_STATS_P99, 9900},
+	{LATENCY_STATS_P99_9, 9990},
+	{LATENCY_STATS_P99_99, 9999},
 };
 
-#define NUM_LATENCY_STATS (sizeof(lat_stats_strings) / \
-				sizeof(lat_stats_strings[0]))
+static inline uint32_t
+latency_hist_index(uint64_t latency)
+{
+	uint32_t msb, idx;
+
+	if (latency < LATENCY_HIST_SUB_BUCKETS)
+		return latency;
+
+	msb = 63 - __builtin_clzll(latency);
+	idx = (msb - LATENCY_HIST_SUB_BITS + 1) * LATENCY_HIST_SUB_BUCKETS +
+		((latency >> (msb - LATENCY_HIST_SUB_BITS)) &
+		 (LATENCY_HIST_SUB_BUCKETS - 1));
+
+	return RTE_MIN(idx, (uint32_t)LATENCY_HIST_BUCKETS - 1);
+}
+
+/* Highest latency accounted in a histogram bucket */
+static uint64_t
+latency_hist_value(uint32_t idx)
+{
+	uint32_t shift;
+
+	if (idx < 2 * LATENCY_HIST_SUB_BUCKETS)
+		return idx;
+
+	shift = idx / LATENCY_HIST_SUB_BUCKETS - 1;
+	return (((uint64_t)LATENCY_HIST_SUB_BUCKETS +
+		(idx & (LATENCY_HIST_SUB_BUCKETS - 1)) + 1) << shift) - 1;
+}
+
+/* Merge the stats of all the Tx queues, in cycles */
+static void
+latencystats_collect(uint64_t values[NUM_LATENCY_STATS])
+{
+	const struct latency_queue_stats *qs;
+	uint64_t samples = 0, count = 0, target;
+	float min = 0, max = 0, avg = 0, jitter = 0;
+	uint32_t i, q, p = 0;
+
+	for (q = 0; q < glob_stats->nb_queues; q++) {
+		qs = &glob_stats->queues[q];
+		if (qs->samples == 0)
+			continue;
+		if (min == 0 || qs->min_latency < min)
+			min = qs->min_latency;
+		if (qs->max_latency > max)
+			max = qs->max_latency;
+		avg += qs->avg_latency * qs->samples;
+		jitter += qs->jitter * qs->samples;
+		samples += qs->samples;
+	}
+
+	memset(values, 0, sizeof(values[0]) * NUM_LATENCY_STATS);
+	if (samples == 0)
+		return;
+
+	values[LATENCY_STATS_MIN] = min;
+	values[LATENCY_STATS_AVG] = avg / samples;
+	values[LATENCY_STATS_MAX] = max;
+	values[LATENCY_STATS_JITTER] = jitter / samples;
+
+	/* Walk the merged histogram once for all the percentiles */
+	target = (samples * lat_stats_percentiles[0].rank + 9999) / 10000;
+	for (i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+		for (q = 0; q < glob_stats->nb_queues; q++)
+			count += glob_stats->queues[q].hist[i];
+
+		while (count >= target) {
+			values[lat_stats_percentiles[p].id] =
+				RTE_MIN(latency_hist_value(i),
+					values[LATENCY_STATS_MAX]);
+			if (++p == RTE_DIM(lat_stats_percentiles))
+				return;
+			target = (samples * lat_stats_percentiles[p].rank +
+				  9999) / 10000;
+		}
+	}
+
+	/* Histogram behind the sample count: use the max */
+	for (; p < RTE_DIM(lat_stats_percentiles); p++)
+		values[lat_stats_percentiles[p].id] = values[LATENCY_STATS_MAX];
+}
 
 int32_t
 rte_latencystats_update(void)
 {
 	unsigned int i;
-	float *stats_ptr = NULL;
 	uint64_t values[NUM_LATENCY_STATS] = {0};
 	int ret;
 
-	for (i = 0; i < NUM_LATENCY_STATS; i++) {
-		stats_ptr = RTE_PTR_ADD(glob_stats,
-				lat_stats_strings[i].offset);
-		values[i] = (uint64_t)floor((*stats_ptr)/
+	latencystats_collect(values);
+	for (i = 0; i < NUM_LATENCY_STATS; i++)
+		values[i] = (uint64_t)floor(values[i] /
 				latencystat_cycles_per_ns());
-	}
 
 	ret = rte_metrics_update_values(RTE_METRICS_GLOBAL,
 					latency_stats_index,
@@ -97,13 +224,12 @@ static void
 rte_latencystats_fill_values(struct rte_metric_value *values)
 {
 	unsigned int i;
-	float *stats_ptr = NULL;
+	uint64_t stats[NUM_LATENCY_STATS];
 
+	latencystats_collect(stats);
 	for (i = 0; i < NUM_LATENCY_STATS; i++) {
-		stats_ptr = RTE_PTR_ADD(glob_stats,
-				lat_stats_strings[i].offset);
 		values[i].key = i;
-		values[i].value = (uint64_t)floor((*stats_ptr)/
+		values[i].value = (uint64_t)floor(stats[i] /
 						latencystat_cycles_per_ns());
 	}
 }
@@ -114,8 +240,9 @@ add_time_stamps(uint16_t pid __rte_unused,
 		struct rte_mbuf **pkts,
 		uint16_t nb_pkts,
 		uint16_t max_pkts __rte_unused,
-		void *user_cb __rte_unused)
+		void *user_cb)
 {
+	struct rxtx_cbs *cbs = user_cb;
 	unsigned int i;
 	uint64_t diff_tsc, now;
 
@@ -125,16 +252,16 @@ add_time_stamps(uint16_t pid __rte_unused,
 	 */
 	now = rte_rdtsc();
 	for (i = 0; i < nb_pkts; i++) {
-		diff_tsc = now - prev_tsc;
-		timer_tsc += diff_tsc;
+		diff_tsc = now - cbs->prev_tsc;
+		cbs->timer_tsc += diff_tsc;
 
 		if ((pkts[i]->ol_flags & PKT_RX_TIMESTAMP) == 0
-				&& (timer_tsc >= samp_intvl)) {
+				&& (cbs->timer_tsc >= samp_intvl)) {
 			pkts[i]->timestamp = now;
 			pkts[i]->ol_flags |= PKT_RX_TIMESTAMP;
-			timer_tsc = 0;
+			cbs->timer_tsc = 0;
 		}
-		prev_tsc = now;
+		cbs->prev_tsc = now;
 		now = rte_rdtsc();
 	}
 
@@ -146,12 +273,12 @@ calc_latency(uint16_t pid __rte_unused,
 		uint16_t qid __rte_unused,
 		struct rte_mbuf **pkts,
 		uint16_t nb_pkts,
-		void *_ __rte_unused)
+		void *user_cb)
 {
-	unsigned int i, cnt = 0;
-	uint64_t now;
-	float latency[nb_pkts];
-	static float prev_latency;
+	struct latency_queue_stats *stats = user_cb;
+	unsigned int i;
+	uint64_t now, diff;
+	float latency;
 	/*
 	 * Alpha represents degree of weighting decrease in EWMA,
 	 * a constant smoothing factor between 0 and 1. The value
@@ -161,12 +288,13 @@ calc_latency(uint16_t pid __rte_unused,
 
 	now = rte_rdtsc();
 	for (i = 0; i < nb_pkts; i++) {
-		if (pkts[i]->ol_flags & PKT_RX_TIMESTAMP)
-			latency[cnt++] = now - pkts[i]->timestamp;
-	}
+		if ((pkts[i]->ol_flags & PKT_RX_TIMESTAMP) == 0)
+			continue;
+
+		diff = now - pkts[i]->timestamp;
+		latency = diff;
+		stats->hist[latency_hist_index(diff)]++;
 
-	rte_spinlock_lock(&glob_stats->lock);
-	for (i = 0; i < cnt; i++) {
 		/*
 		 * The jitter is calculated as statistical mean of interpacket
 		 * delay variation. The "jitter estimate" is computed by taking
@@ -178,35 +306,74 @@ calc_latency(uint16_t pid __rte_unused,
 		 * Reference: Calculated as per RFC 5481, sec 4.1,
 		 * RFC 3393 sec 4.5, RFC 1889 sec.
 		 */
-		glob_stats->jitter +=  (fabsf(prev_latency - latency[i])
-					- glob_stats->jitter)/16;
-		if (glob_stats->min_latency == 0)
-			glob_stats->min_latency = latency[i];
-		else if (latency[i] < glob_stats->min_latency)
-			glob_stats->min_latency = latency[i];
-		else if (latency[i] > glob_stats->max_latency)
-			glob_stats->max_latency = latency[i];
+		stats->jitter += (fabsf(stats->prev_latency - latency)
+					- stats->jitter)/16;
+		if (stats->samples == 0 || latency < stats->min_latency)
+			stats->min_latency = latency;
+		if (latency > stats->max_latency)
+			stats->max_latency = latency;
 		/*
 		 * The average latency is measured using exponential moving
 		 * average, i.e. using EWMA
 		 * https://en.wikipedia.org/wiki/Moving_average
 		 */
-		glob_stats->avg_latency +=
-			alpha * (latency[i] - glob_stats->avg_latency);
-		prev_latency = latency[i];
+		if (stats->samples == 0)
+			stats->avg_latency = latency;
+		else
+			stats->avg_latency +=
+				alpha * (latency - stats->avg_latency);
+		stats->prev_latency = latency;
+		stats->samples++;
 	}
-	rte_spinlock_unlock(&glob_stats->lock);
 
 	return nb_pkts;
 }
 
+/* Attach to the stats of the primary process */
+static int
+latencystats_lookup(void)
+{
+	const struct rte_memzone *mz;
+
+	if (glob_stats != NULL && rte_eal_process_type() == RTE_PROC_PRIMARY)
+		return 0;
+
+	mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
+	if (mz == NULL) {
+		RTE_LOG(ERR, LATENCY_STATS,
+			"Latency stats memzone not found\n");
+		return -ENOMEM;
+	}
+	glob_stats = mz->addr;
+
+	return 0;
+}
+
+/* Number of Tx queues of the ports, to size the stats */
+static uint32_t
+latencystats_nb_queues(void)
+{
+	struct rte_eth_dev_info dev_info;
+	uint32_t nb_queues = 0;
+	uint16_t pid;
+
+	RTE_ETH_FOREACH_DEV(pid) {
+		if (rte_eth_dev_info_get(pid, &dev_info) == 0)
+			nb_queues += dev_info.nb_tx_queues;
+	}
+
+	return nb_queues;
+}
+
 int
 rte_latencystats_init(uint64_t app_samp_intvl,
-		rte_latency_stats_flow_type_fn user_cb)
+		rte_latency_stats_flow_type_fn user_cb __rte_unused)
 {
 	unsigned int i;
 	uint16_t pid;
 	uint16_t qid;
+	uint32_t nb_queues, q = 0;
+	size_t size;
 	struct rxtx_cbs *cbs = NULL;
 	const char *ptr_strings[NUM_LATENCY_STATS] = {0};
 	const struct rte_memzone *mz = NULL;
@@ -217,8 +384,12 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 		return -EEXIST;
 
 	/** Allocate stats in shared memory fo multi process support */
-	mz = rte_memzone_reserve(MZ_RTE_LATENCY_STATS, sizeof(*glob_stats),
-					rte_socket_id(), flags);
+	nb_queues = latencystats_nb_queues();
+	size = sizeof(*glob_stats) +
+		sizeof(glob_stats->queues[0]) * nb_queues;
+	mz = rte_memzone_reserve_aligned(MZ_RTE_LATENCY_STATS, size,
+					rte_socket_id(), flags,
+					RTE_CACHE_LINE_SIZE);
 	if (mz == NULL) {
 		RTE_LOG(ERR, LATENCY_STATS, "Cannot reserve memory: %s:%d\n",
 			__func__, __LINE__);
@@ -226,12 +397,13 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 	}
 
 	glob_stats = mz->addr;
-	rte_spinlock_init(&glob_stats->lock);
+	memset(glob_stats, 0, size);
+	glob_stats->nb_queues = nb_queues;
 	samp_intvl = app_samp_intvl * latencystat_cycles_per_ns();
 
 	/** Register latency stats with stats library */
 	for (i = 0; i < NUM_LATENCY_STATS; i++)
-		ptr_strings[i] = lat_stats_strings[i].name;
+		ptr_strings[i] = lat_stats_strings[i];
 
 	latency_stats_index = rte_metrics_reg_names(ptr_strings,
 							NUM_LATENCY_STATS);
@@ -256,17 +428,25 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 
 		for (qid = 0; qid < dev_info.nb_rx_queues; qid++) {
 			cbs = &rx_cbs[pid][qid];
+			cbs->prev_tsc = 0;
+			cbs->timer_tsc = 0;
 			cbs->cb = rte_eth_add_first_rx_callback(pid, qid,
-					add_time_stamps, user_cb);
+					add_time_stamps, cbs);
 			if (!cbs->cb)
 				RTE_LOG(INFO, LATENCY_STATS, "Failed to "
 					"register Rx callback for pid=%d, "
 					"qid=%d\n", pid, qid);
 		}
 		for (qid = 0; qid < dev_info.nb_tx_queues; qid++) {
+			/* Queues added since the stats were sized */
+			if (q == nb_queues) {
+				RTE_LOG(INFO, LATENCY_STATS, "No stats for "
+					"pid=%d, qid=%d\n", pid, qid);
+				break;
+			}
 			cbs = &tx_cbs[pid][qid];
 			cbs->cb =  rte_eth_add_tx_callback(pid, qid,
-					calc_latency, user_cb);
+					calc_latency, &glob_stats->queues[q++]);
 			if (!cbs->cb)
 				RTE_LOG(INFO, LATENCY_STATS, "Failed to "
 					"register Tx callback for pid=%d, "
@@ -320,6 +500,7 @@ rte_latencystats_uninit(void)
 	mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
 	if (mz)
 		rte_memzone_free(mz);
+	glob_stats = NULL;
 
 	return 0;
 }
@@ -333,7 +514,7 @@ rte_latencystats_get_names(struct rte_metric_name *names, uint16_t size)
 		return NUM_LATENCY_STATS;
 
 	for (i = 0; i < NUM_LATENCY_STATS; i++)
-		strlcpy(names[i].name, lat_stats_strings[i].name,
+		strlcpy(names[i].name, lat_stats_strings[i],
 			sizeof(names[i].name));
 
 	return NUM_LATENCY_STATS;
@@ -345,19 +526,38 @@ rte_latencystats_get(struct rte_metric_value *values, uint16_t size)
 	if (size < NUM_LATENCY_STATS || values == NULL)
 		return NUM_LATENCY_STATS;
 
-	if (rte_eal_process_type() == RTE_PROC_SECONDARY) {
-		const struct rte_memzone *mz;
-		mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
-		if (mz == NULL) {
-			RTE_LOG(ERR, LATENCY_STATS,
-				"Latency stats memzone not found\n");
-			return -ENOMEM;
-		}
-		glob_stats =  mz->addr;
-	}
+	if (latencystats_lookup() < 0)
+		return -ENOMEM;
 
 	/* Retrieve latency stats */
 	rte_latencystats_fill_values(values);
 
 	return NUM_LATENCY_STATS;
 }
+
+static int
+latencystats_handle_stats(const char *cmd __rte_unused,
+		const char *params __rte_unused,
+		struct rte_tel_data *d)
+{
+	struct rte_metric_value values[NUM_LATENCY_STATS];
+	unsigned int i;
+
+	if (latencystats_lookup() < 0)
+		return -1;
+
+	rte_latencystats_fill_values(values);
+
+	rte_tel_data_start_dict(d);
+	for (i = 0; i < NUM_LATENCY_STATS; i++)
+		rte_tel_data_add_dict_u64(d, lat_stats_strings[i],
+				values[i].value);
+
+	return 0;
+}
+
+RTE_INIT(latencystats_init_telemetry)
+{
+	rte_telemetry_register_cmd("/latencystats", latencystats_handle_stats,
+			"Returns the latency stats. Takes no parameters");
+}
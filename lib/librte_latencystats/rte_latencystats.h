@@ -10,6 +10,11 @@
  * RTE latency stats
  *
  * library to provide application and flow based latency stats.
+ *
+ * The latency of the sampled packets is accounted per Tx queue, without
+ * locking, in a log-linear histogram; the stats of all the queues are merged
+ * when read, giving the minimum, average, maximum, jitter and the 50th, 99th,
+ * 99.9th and 99.99th percentiles of the latency, in nano seconds.
  */
 
 #include <stdint.h>
@@ -42,6 +47,7 @@ typedef uint16_t (*rte_latency_stats_flow_type_fn)(struct rte_mbuf *pkt,
 
 /**
  *  Registers Rx/Tx callbacks for each active port, queue.
+ *  The stats are sized for the Tx queues configured at this time.
  *
  * @param samp_intvl
  *  Sampling time period in nano seconds, at which packet
@@ -32,6 +32,7 @@
 #include <rte_tailq.h>
 #include <rte_function_versioning.h>
 #include <rte_eal_paging.h>
+#include <rte_telemetry.h>
 
 
 #include "rte_mempool.h"
@@ -806,6 +807,25 @@ mempool_cache_init(struct rte_mempool_cache *cache, uint32_t size)
 	cache->len = 0;
 }
 
+/*
+ * Init the state of a default cache. With an adaptive cache, let the
+ * flush threshold vary between its default value and twice the cache
+ * size, without holding more objects than the pool size.
+ */
+static void
+mempool_cache_ext_init(struct rte_mempool_cache_ext *ext,
+	const struct rte_mempool_cache *cache, uint32_t n, int adaptive)
+{
+	memset(ext, 0, sizeof(*ext));
+	ext->flushthresh_min = cache->flushthresh;
+	ext->flushthresh_max = cache->flushthresh;
+	if (adaptive) {
+		ext->adaptive = 1;
+		ext->flushthresh_max = RTE_MAX(ext->flushthresh_min,
+			RTE_MIN(2 * cache->size, n));
+	}
+}
+
 /*
  * Create and initialize a cache for objects that are retrieved from and
  * returned to an underlying mempool. This structure is identical to the
@@ -869,6 +889,8 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 			  RTE_CACHE_LINE_MASK) != 0);
 	RTE_BUILD_BUG_ON((sizeof(struct rte_mempool_cache) &
 			  RTE_CACHE_LINE_MASK) != 0);
+	RTE_BUILD_BUG_ON((sizeof(struct rte_mempool_cache_ext) &
+			  RTE_CACHE_LINE_MASK) != 0);
 #ifdef RTE_LIBRTE_MEMPOOL_DEBUG
 	RTE_BUILD_BUG_ON((sizeof(struct rte_mempool_debug_stats) &
 			  RTE_CACHE_LINE_MASK) != 0);
@@ -920,6 +942,10 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 
 	mempool_size = MEMPOOL_HEADER_SIZE(mp, cache_size);
 	mempool_size += private_data_size;
+	/* state of the default caches, after the private data */
+	if (cache_size != 0)
+		mempool_size += sizeof(struct rte_mempool_cache_ext) *
+			RTE_MAX_LCORE;
 	mempool_size = RTE_ALIGN_CEIL(mempool_size, RTE_MEMPOOL_ALIGN);
 
 	ret = snprintf(mz_name, sizeof(mz_name), RTE_MEMPOOL_MZ_FORMAT, name);
@@ -962,9 +988,13 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 
 	/* Init all default caches. */
 	if (cache_size != 0) {
-		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
 			mempool_cache_init(&mp->local_cache[lcore_id],
 					   cache_size);
+			mempool_cache_ext_init(&MEMPOOL_CACHE_EXT(mp)[lcore_id],
+				&mp->local_cache[lcore_id], n,
+				flags & MEMPOOL_F_ADAPTIVE_CACHE);
+		}
 	}
 
 	te->data = mp;
@@ -1093,6 +1123,81 @@ rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 	return count;
 }
 
+int
+rte_mempool_cache_stats_get(const struct rte_mempool *mp,
+	unsigned int lcore_id, struct rte_mempool_cache_stats *stats)
+{
+	const struct rte_mempool_cache_stats *cs;
+	unsigned int i;
+
+	if (mp == NULL || stats == NULL ||
+			(lcore_id >= RTE_MAX_LCORE && lcore_id != LCORE_ID_ANY))
+		return -EINVAL;
+
+	if (mp->cache_size == 0)
+		return -ENOTSUP;
+
+	if (lcore_id != LCORE_ID_ANY) {
+		*stats = MEMPOOL_CACHE_EXT(mp)[lcore_id].stats;
+		return 0;
+	}
+
+	memset(stats, 0, sizeof(*stats));
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		cs = &MEMPOOL_CACHE_EXT(mp)[i].stats;
+		stats->get_bulk += cs->get_bulk;
+		stats->get_objs += cs->get_objs;
+		stats->put_bulk += cs->put_bulk;
+		stats->put_objs += cs->put_objs;
+		stats->refill_bulk += cs->refill_bulk;
+		stats->refill_objs += cs->refill_objs;
+		stats->flush_bulk += cs->flush_bulk;
+		stats->flush_objs += cs->flush_objs;
+		stats->bypass_bulk += cs->bypass_bulk;
+		stats->bypass_objs += cs->bypass_objs;
+	}
+
+	return 0;
+}
+
+void
+rte_mempool_cache_stats_reset(struct rte_mempool *mp)
+{
+	unsigned int i;
+
+	if (mp == NULL || mp->cache_size == 0)
+		return;
+
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		struct rte_mempool_cache_ext *ext = &MEMPOOL_CACHE_EXT(mp)[i];
+
+		memset(&ext->stats, 0, sizeof(ext->stats));
+		ext->refill_mark = 0;
+	}
+}
+
+/* dump the cache statistics */
+static void
+rte_mempool_dump_cache_stats(FILE *f, const struct rte_mempool *mp)
+{
+	struct rte_mempool_cache_stats sum;
+
+	if (rte_mempool_cache_stats_get(mp, LCORE_ID_ANY, &sum) != 0)
+		return;
+
+	fprintf(f, "  cache stats:\n");
+	fprintf(f, "    get_bulk=%"PRIu64"\n", sum.get_bulk);
+	fprintf(f, "    get_objs=%"PRIu64"\n", sum.get_objs);
+	fprintf(f, "    put_bulk=%"PRIu64"\n", sum.put_bulk);
+	fprintf(f, "    put_objs=%"PRIu64"\n", sum.put_objs);
+	fprintf(f, "    refill_bulk=%"PRIu64"\n", sum.refill_bulk);
+	fprintf(f, "    refill_objs=%"PRIu64"\n", sum.refill_objs);
+	fprintf(f, "    flush_bulk=%"PRIu64"\n", sum.flush_bulk);
+	fprintf(f, "    flush_objs=%"PRIu64"\n", sum.flush_objs);
+	fprintf(f, "    bypass_bulk=%"PRIu64"\n", sum.bypass_bulk);
+	fprintf(f, "    bypass_objs=%"PRIu64"\n", sum.bypass_objs);
+}
+
 #ifndef __INTEL_COMPILER
 #pragma GCC diagnostic ignored "-Wcast-qual"
 #endif
@@ -1301,6 +1406,8 @@ rte_mempool_dump(FILE *f, struct rte_mempool *mp)
 		common_count = mp->size - cache_count;
 	fprintf(f, "  common_pool_count=%u\n", common_count);
 
+	rte_mempool_dump_cache_stats(f, mp);
+
 	/* sum and dump statistics */
 #ifdef RTE_LIBRTE_MEMPOOL_DEBUG
 	rte_mempool_ops_get_info(mp, &info);
@@ -1399,3 +1506,95 @@ void rte_mempool_walk(void (*func)(struct rte_mempool *, void *),
 
 	rte_mcfg_mempool_read_unlock();
 }
+
+static void
+mempool_list_cb(struct rte_mempool *mp, void *arg)
+{
+	struct rte_tel_data *d = (struct rte_tel_data *)arg;
+
+	rte_tel_data_add_array_string(d, mp->name);
+}
+
+static int
+mempool_handle_list(const char *cmd __rte_unused,
+		const char *params __rte_unused, struct rte_tel_data *d)
+{
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+	rte_mempool_walk(mempool_list_cb, d);
+	return 0;
+}
+
+static int
+mempool_handle_cache_stats(const char *cmd __rte_unused,
+		const char *params, struct rte_tel_data *d)
+{
+	char name[RTE_MEMPOOL_NAMESIZE];
+	struct rte_mempool_cache_stats stats;
+	const struct rte_mempool *mp;
+	unsigned int lcore_id = LCORE_ID_ANY;
+	const char *sep;
+	char *end;
+	size_t len;
+
+	if (params == NULL || strlen(params) == 0)
+		return -1;
+
+	/*
+	 * parameters are "<mempool name>[:<lcore id>]", telemetry splits them
+	 * on ','. Mempool names may contain ':', so try the full string first.
+	 */
+	mp = rte_mempool_lookup(params);
+	if (mp == NULL) {
+		sep = strrchr(params, ':');
+		if (sep == NULL)
+			return -1;
+		len = sep - params;
+		if (len == 0 || len >= sizeof(name))
+			return -1;
+		memcpy(name, params, len);
+		name[len] = '\0';
+
+		lcore_id = strtoul(sep + 1, &end, 10);
+		if (end == sep + 1 || *end != '\0' ||
+				lcore_id >= RTE_MAX_LCORE)
+			return -1;
+
+		mp = rte_mempool_lookup(name);
+		if (mp == NULL)
+			return -1;
+	}
+
+	if (rte_mempool_cache_stats_get(mp, lcore_id, &stats) != 0)
+		return -1;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_int(d, "cache_size", mp->cache_size);
+	if (lcore_id != LCORE_ID_ANY) {
+		rte_tel_data_add_dict_int(d, "cache_len",
+			mp->local_cache[lcore_id].len);
+		rte_tel_data_add_dict_int(d, "flushthresh",
+			mp->local_cache[lcore_id].flushthresh);
+	}
+	rte_tel_data_add_dict_u64(d, "get_bulk", stats.get_bulk);
+	rte_tel_data_add_dict_u64(d, "get_objs", stats.get_objs);
+	rte_tel_data_add_dict_u64(d, "get_hit_bulk",
+		stats.get_bulk - stats.refill_bulk);
+	rte_tel_data_add_dict_u64(d, "put_bulk", stats.put_bulk);
+	rte_tel_data_add_dict_u64(d, "put_objs", stats.put_objs);
+	rte_tel_data_add_dict_u64(d, "refill_bulk", stats.refill_bulk);
+	rte_tel_data_add_dict_u64(d, "refill_objs", stats.refill_objs);
+	rte_tel_data_add_dict_u64(d, "flush_bulk", stats.flush_bulk);
+	rte_tel_data_add_dict_u64(d, "flush_objs", stats.flush_objs);
+	rte_tel_data_add_dict_u64(d, "bypass_bulk", stats.bypass_bulk);
+	rte_tel_data_add_dict_u64(d, "bypass_objs", stats.bypass_objs);
+	return 0;
+}
+
+RTE_INIT(mempool_init_telemetry)
+{
+	rte_telemetry_register_cmd("/mempool/list", mempool_handle_list,
+		"Returns list of available mempools. Takes no parameters");
+	rte_telemetry_register_cmd("/mempool/cache_stats",
+		mempool_handle_cache_stats,
+		"Returns cache stats of a mempool. Parameters: name[:lcore_id]");
+}
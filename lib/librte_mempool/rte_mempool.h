@@ -79,6 +79,30 @@ struct rte_mempool_debug_stats {
 } __rte_cache_aligned;
 #endif
 
+/**
+ * A structure that stores the statistics of a per-core object cache.
+ *
+ * Unlike the debug statistics, these counters are always maintained.
+ * They are only updated by the thread owning the cache. The number of
+ * gets served without accessing the backing pool (cache hits) is
+ * get_bulk - refill_bulk.
+ */
+struct rte_mempool_cache_stats {
+	uint64_t get_bulk;    /**< Number of gets served by the cache. */
+	uint64_t get_objs;    /**< Objects got from the cache. */
+	uint64_t put_bulk;    /**< Number of puts to the cache. */
+	uint64_t put_objs;    /**< Objects put to the cache. */
+	uint64_t refill_bulk; /**< Number of refills from the backing pool. */
+	uint64_t refill_objs; /**< Objects moved from the pool to the cache. */
+	uint64_t flush_bulk;  /**< Number of flushes to the backing pool. */
+	uint64_t flush_objs;  /**< Objects moved from the cache to the pool. */
+	/** Number of requests too large for the cache or which could not be
+	 * served by a refill, going directly to the backing pool.
+	 */
+	uint64_t bypass_bulk;
+	uint64_t bypass_objs; /**< Objects of the bypass requests. */
+};
+
 /**
  * A structure that stores a per-core object cache.
  */
@@ -93,6 +117,20 @@ struct rte_mempool_cache {
 	void *objs[RTE_MEMPOOL_CACHE_MAX_SIZE * 3]; /**< Cache objects */
 } __rte_cache_aligned;
 
+/**
+ * @internal Per-lcore state of a default cache, kept apart from the
+ * cache structure so that its layout is unchanged. The array of
+ * RTE_MAX_LCORE entries is stored after the mempool private data.
+ */
+struct rte_mempool_cache_ext {
+	struct rte_mempool_cache_stats stats; /**< Cache statistics */
+	/** Non-zero if the flush threshold adapts to the traffic. */
+	uint32_t adaptive;
+	uint32_t flushthresh_min; /**< Lowest adaptive flush threshold */
+	uint32_t flushthresh_max; /**< Highest adaptive flush threshold */
+	uint64_t refill_mark;     /**< Value of stats.refill_bulk at last flush */
+} __rte_cache_aligned;
+
 /**
  * A structure that stores the size of mempool elements.
  */
@@ -269,6 +307,7 @@ struct rte_mempool {
 #define MEMPOOL_F_SC_GET         0x0008 /**< Default get is "single-consumer".*/
 #define MEMPOOL_F_POOL_CREATED   0x0010 /**< Internal: pool is created. */
 #define MEMPOOL_F_NO_IOVA_CONTIG 0x0020 /**< Don't need IOVA contiguous objs. */
+#define MEMPOOL_F_ADAPTIVE_CACHE 0x0040 /**< Adaptive cache flush threshold. */
 #define MEMPOOL_F_NO_PHYS_CONTIG MEMPOOL_F_NO_IOVA_CONTIG /* deprecated */
 
 /**
@@ -313,6 +352,17 @@ struct rte_mempool {
 	(sizeof(*(mp)) + (((cs) == 0) ? 0 : \
 	(sizeof(struct rte_mempool_cache) * RTE_MAX_LCORE)))
 
+/**
+ * @internal Get the per-lcore state array of the default caches, located
+ * after the private data. Only valid if the mempool has default caches.
+ *
+ * @param mp
+ *   Pointer to the memory pool.
+ */
+#define MEMPOOL_CACHE_EXT(mp) \
+	((struct rte_mempool_cache_ext *)RTE_PTR_ADD(mp, \
+	MEMPOOL_HEADER_SIZE(mp, (mp)->cache_size) + (mp)->private_data_size))
+
 /* return the header of a mempool object (internal) */
 static inline struct rte_mempool_objhdr *__mempool_get_header(void *obj)
 {
@@ -1021,6 +1071,12 @@ typedef void (rte_mempool_ctor_t)(struct rte_mempool *, void *);
  *     "single-consumer". Otherwise, it is "multi-consumers".
  *   - MEMPOOL_F_NO_IOVA_CONTIG: If set, allocated objects won't
  *     necessarily be contiguous in IO memory.
+ *   - MEMPOOL_F_ADAPTIVE_CACHE: If set, the flush threshold of each
+ *     per-lcore default cache is tuned at runtime, between its default
+ *     value and twice the cache size, depending on the traffic observed
+ *     on that lcore. This can reduce the accesses to the common pool for
+ *     lcores both allocating and freeing objects in bursts, at the cost
+ *     of more objects staying in the caches.
  * @return
  *   The pointer to the new allocated mempool, on success. NULL on error
  *   with rte_errno set appropriately. Possible rte_errno values include:
@@ -1256,6 +1312,46 @@ rte_mempool_cache_create(uint32_t size, int socket_id);
 void
 rte_mempool_cache_free(struct rte_mempool_cache *cache);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the statistics of the per-lcore default caches of a mempool.
+ *
+ * The statistics are updated without synchronization by the lcores
+ * owning the caches, so the values read while the mempool is in use
+ * may be slightly out of date.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param lcore_id
+ *   The logical core id, or LCORE_ID_ANY to get the sum of the
+ *   statistics of all the default caches.
+ * @param stats
+ *   A pointer to the structure to fill.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: Invalid parameters.
+ *   - -ENOTSUP: The mempool has no default cache.
+ */
+__rte_experimental
+int
+rte_mempool_cache_stats_get(const struct rte_mempool *mp,
+	unsigned int lcore_id, struct rte_mempool_cache_stats *stats);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Reset the statistics of all the per-lcore default caches of a mempool.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ */
+__rte_experimental
+void
+rte_mempool_cache_stats_reset(struct rte_mempool *mp);
+
 /**
  * Get a pointer to the per-lcore default mempool cache.
  *
@@ -1281,6 +1377,39 @@ rte_mempool_default_cache(struct rte_mempool *mp, unsigned lcore_id)
 	return &mp->local_cache[lcore_id];
 }
 
+/**
+ * @internal Get the per-lcore state of a cache.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to the mempool cache.
+ * @return
+ *   A pointer to the state of the cache, or NULL if it is not one of
+ *   the default caches of the mempool.
+ */
+static __rte_always_inline struct rte_mempool_cache_ext *
+__mempool_cache_ext(const struct rte_mempool *mp,
+		    const struct rte_mempool_cache *cache)
+{
+	uintptr_t off = (uintptr_t)cache - (uintptr_t)mp->local_cache;
+
+	if (unlikely(mp->cache_size == 0 || off >=
+			sizeof(struct rte_mempool_cache) * RTE_MAX_LCORE))
+		return NULL;
+
+	return MEMPOOL_CACHE_EXT(mp) + off / sizeof(struct rte_mempool_cache);
+}
+
+/* update the statistics of a cache, if it is a default cache (internal) */
+#define __MEMPOOL_CACHE_STAT_ADD(ext, name, n) do {		\
+		struct rte_mempool_cache_ext *__ext = (ext);	\
+		if (__ext != NULL) {				\
+			__ext->stats.name##_bulk += 1;		\
+			__ext->stats.name##_objs += (n);	\
+		}						\
+	} while (0)
+
 /**
  * Flush a user-owned mempool cache to the specified mempool.
  *
@@ -1298,10 +1427,42 @@ rte_mempool_cache_flush(struct rte_mempool_cache *cache,
 	if (cache == NULL || cache->len == 0)
 		return;
 	rte_mempool_trace_cache_flush(cache, mp);
+	__MEMPOOL_CACHE_STAT_ADD(__mempool_cache_ext(mp, cache), flush,
+		cache->len);
 	rte_mempool_ops_enqueue_bulk(mp, cache->objs, cache->len);
 	cache->len = 0;
 }
 
+/**
+ * @internal Adapt the flush threshold of a cache after it was flushed.
+ *
+ * A refill since the previous flush means that the lcore both gets and
+ * puts objects through the backing pool: the threshold is raised to
+ * absorb the bursts in the cache. Otherwise it decays back towards
+ * its default value.
+ *
+ * @param cache
+ *   A pointer to the mempool cache.
+ * @param ext
+ *   A pointer to the state of the cache.
+ */
+static __rte_always_inline void
+__mempool_cache_adapt(struct rte_mempool_cache *cache,
+		      struct rte_mempool_cache_ext *ext)
+{
+	uint32_t step = RTE_MAX(cache->size / 4, 1U);
+
+	if (ext->stats.refill_bulk != ext->refill_mark)
+		cache->flushthresh = RTE_MIN(cache->flushthresh + step,
+			ext->flushthresh_max);
+	else if (cache->flushthresh > ext->flushthresh_min + step)
+		cache->flushthresh -= step;
+	else
+		cache->flushthresh = ext->flushthresh_min;
+
+	ext->refill_mark = ext->stats.refill_bulk;
+}
+
 /**
  * @internal Put several objects back in the mempool; used internally.
  * @param mp
@@ -1318,15 +1479,26 @@ static __rte_always_inline void
 __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 		      unsigned int n, struct rte_mempool_cache *cache)
 {
+	struct rte_mempool_cache_ext *ext;
 	void **cache_objs;
 
 	/* increment stat now, adding in mempool always success */
 	__MEMPOOL_STAT_ADD(mp, put, n);
 
-	/* No cache provided or if put would overflow mem allocated for cache */
-	if (unlikely(cache == NULL || n > RTE_MEMPOOL_CACHE_MAX_SIZE))
+	/* No cache provided */
+	if (unlikely(cache == NULL))
 		goto ring_enqueue;
 
+	ext = __mempool_cache_ext(mp, cache);
+
+	/* Put would overflow mem allocated for cache */
+	if (unlikely(n > RTE_MEMPOOL_CACHE_MAX_SIZE)) {
+		__MEMPOOL_CACHE_STAT_ADD(ext, bypass, n);
+		goto ring_enqueue;
+	}
+
+	__MEMPOOL_CACHE_STAT_ADD(ext, put, n);
+
 	cache_objs = &cache->objs[cache->len];
 
 	/*
@@ -1342,9 +1514,13 @@ __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	cache->len += n;
 
 	if (cache->len >= cache->flushthresh) {
+		__MEMPOOL_CACHE_STAT_ADD(ext, flush,
+			cache->len - cache->size);
 		rte_mempool_ops_enqueue_bulk(mp, &cache->objs[cache->size],
 				cache->len - cache->size);
 		cache->len = cache->size;
+		if (ext != NULL && ext->adaptive)
+			__mempool_cache_adapt(cache, ext);
 	}
 
 	return;
@@ -1444,12 +1620,19 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 {
 	int ret;
 	uint32_t index, len;
+	struct rte_mempool_cache_ext *ext;
 	void **cache_objs;
 
-	/* No cache provided or cannot be satisfied from cache */
-	if (unlikely(cache == NULL || n >= cache->size))
+	/* No cache provided */
+	if (unlikely(cache == NULL))
 		goto ring_dequeue;
 
+	ext = __mempool_cache_ext(mp, cache);
+
+	/* Cannot be satisfied from cache */
+	if (unlikely(n >= cache->size))
+		goto cache_bypass;
+
 	cache_objs = cache->objs;
 
 	/* Can this be satisfied from the cache? */
@@ -1467,9 +1650,10 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 			 * the ring directly. If that fails, we are truly out of
 			 * buffers.
 			 */
-			goto ring_dequeue;
+			goto cache_bypass;
 		}
 
+		__MEMPOOL_CACHE_STAT_ADD(ext, refill, req);
 		cache->len += req;
 	}
 
@@ -1479,10 +1663,16 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 
 	cache->len -= n;
 
+	__MEMPOOL_CACHE_STAT_ADD(ext, get, n);
+
 	__MEMPOOL_STAT_ADD(mp, get_success, n);
 
 	return 0;
 
+cache_bypass:
+
+	__MEMPOOL_CACHE_STAT_ADD(ext, bypass, n);
+
 ring_dequeue:
 
 	/* get remaining objects from ring */
@@ -23,10 +23,11 @@ extern int rte_node_logtype;
 /**
  *
  * Node mbuf private data to store next hop, ttl and checksum.
+ * The ttl field holds the hop limit for IPv6.
  */
 struct node_mbuf_priv1 {
 	union {
-		/* IP4 rewrite */
+		/* IP4/IP6 rewrite */
 		struct {
 			uint16_t nh;
 			uint16_t ttl;
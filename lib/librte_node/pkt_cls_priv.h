@@ -17,6 +17,7 @@ struct pkt_cls_node_ctx {
 enum pkt_cls_next_nodes {
 	PKT_CLS_NEXT_PKT_DROP,
 	PKT_CLS_NEXT_IP4_LOOKUP,
+	PKT_CLS_NEXT_IP6_LOOKUP,
 	PKT_CLS_NEXT_MAX,
 };
 
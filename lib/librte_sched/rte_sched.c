@@ -13,6 +13,7 @@
 #include <rte_prefetch.h>
 #include <rte_branch_prediction.h>
 #include <rte_mbuf.h>
+#include <rte_ring.h>
 #include <rte_bitmap.h>
 #include <rte_reciprocal.h>
 
@@ -29,6 +30,9 @@
 
 #ifdef RTE_ARCH_X86
 #define SCHED_VECTOR_SSE4
+#ifdef RTE_MACHINE_CPUFLAG_AVX2
+#define SCHED_VECTOR_AVX2
+#endif
 #elif defined(RTE_MACHINE_CPUFLAG_NEON)
 #define SCHED_VECTOR_NEON
 #endif
@@ -37,8 +41,9 @@
 
 #define RTE_SCHED_TB_RATE_CONFIG_ERR          (1e-7)
 #define RTE_SCHED_WRR_SHIFT                   3
-#define RTE_SCHED_MAX_QUEUES_PER_TC           RTE_SCHED_BE_QUEUES_PER_PIPE
-#define RTE_SCHED_GRINDER_PCACHE_SIZE         (64 / RTE_SCHED_QUEUES_PER_PIPE)
+#define RTE_SCHED_MAX_QUEUES_PER_TC           RTE_SCHED_BE_QUEUES_PER_PIPE_MAX
+#define RTE_SCHED_QUEUES_PER_PIPE_MIN         4
+#define RTE_SCHED_GRINDER_PCACHE_SIZE         (64 / RTE_SCHED_QUEUES_PER_PIPE_MIN)
 #define RTE_SCHED_PIPE_INVALID                UINT32_MAX
 #define RTE_SCHED_BMP_POS_INVALID             UINT32_MAX
 
@@ -47,6 +52,9 @@
  */
 #define RTE_SCHED_TIME_SHIFT		      8
 
+/* Multi-core mode: max packets moved per subport handoff ring access */
+#define RTE_SCHED_PORT_MERGE_BURST            32
+
 struct rte_sched_pipe_profile {
 	/* Token bucket (TB) */
 	uint64_t tb_period;
@@ -59,7 +67,7 @@ struct rte_sched_pipe_profile {
 	uint8_t tc_ov_weight;
 
 	/* Pipe best-effort traffic class queues */
-	uint8_t  wrr_cost[RTE_SCHED_BE_QUEUES_PER_PIPE];
+	uint8_t  wrr_cost[RTE_SCHED_BE_QUEUES_PER_PIPE_MAX];
 };
 
 struct rte_sched_pipe {
@@ -75,7 +83,7 @@ struct rte_sched_pipe {
 	uint64_t tc_credits[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
 
 	/* Weighted Round Robin (WRR) */
-	uint8_t wrr_tokens[RTE_SCHED_BE_QUEUES_PER_PIPE];
+	uint8_t wrr_tokens[RTE_SCHED_BE_QUEUES_PER_PIPE_MAX];
 
 	/* TC oversubscription */
 	uint64_t tc_ov_credits;
@@ -103,7 +111,7 @@ enum grinder_state {
 
 struct rte_sched_grinder {
 	/* Pipe cache */
-	uint16_t pcache_qmask[RTE_SCHED_GRINDER_PCACHE_SIZE];
+	uint32_t pcache_qmask[RTE_SCHED_GRINDER_PCACHE_SIZE];
 	uint32_t pcache_qindex[RTE_SCHED_GRINDER_PCACHE_SIZE];
 	uint32_t pcache_w;
 	uint32_t pcache_r;
@@ -117,7 +125,7 @@ struct rte_sched_grinder {
 	struct rte_sched_pipe_profile *pipe_params;
 
 	/* TC cache */
-	uint8_t tccache_qmask[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
+	uint16_t tccache_qmask[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
 	uint32_t tccache_qindex[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
 	uint32_t tccache_w;
 	uint32_t tccache_r;
@@ -133,9 +141,15 @@ struct rte_sched_grinder {
 	struct rte_mbuf *pkt;
 
 	/* WRR */
-	uint16_t wrr_tokens[RTE_SCHED_BE_QUEUES_PER_PIPE];
-	uint16_t wrr_mask[RTE_SCHED_BE_QUEUES_PER_PIPE];
-	uint8_t wrr_cost[RTE_SCHED_BE_QUEUES_PER_PIPE];
+	uint16_t wrr_tokens[RTE_SCHED_BE_QUEUES_PER_PIPE_MAX];
+	uint16_t wrr_mask[RTE_SCHED_BE_QUEUES_PER_PIPE_MAX];
+	uint8_t wrr_cost[RTE_SCHED_BE_QUEUES_PER_PIPE_MAX];
+};
+
+struct rte_sched_clock {
+	uint64_t time_cpu_cycles;     /* Current CPU time measured in CPU cyles */
+	uint64_t time_cpu_bytes;      /* Current CPU time measured in bytes */
+	uint64_t time;                /* Current NIC TX time measured in bytes */
 };
 
 struct rte_sched_subport {
@@ -175,6 +189,17 @@ struct rte_sched_subport {
 	/* Pipe queues size */
 	uint16_t qsize[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
 
+	/* Pipe queue layout */
+	uint32_t n_traffic_classes;
+	uint32_t tc_be;
+	uint32_t n_be_queues;
+	uint32_t n_pipe_queues_log2;
+	uint32_t pipe_queue_mask;
+	uint16_t pipe_queue[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
+	uint8_t pipe_tc[RTE_SCHED_QUEUES_PER_PIPE_MAX];
+	uint8_t tc_queue[RTE_SCHED_QUEUES_PER_PIPE_MAX];
+	uint16_t pipe_qsize[RTE_SCHED_QUEUES_PER_PIPE_MAX];
+
 #ifdef RTE_SCHED_RED
 	struct rte_red_config red_config[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE][RTE_COLORS];
 #endif
@@ -190,9 +215,18 @@ struct rte_sched_subport {
 	/* Grinders */
 	struct rte_sched_grinder grinder[RTE_SCHED_PORT_N_GRINDERS];
 	uint32_t busy_grinders;
+	struct rte_mbuf **pkts_out;
+	uint32_t n_pkts_out;
+
+	/* Timing: the port clock, or the subport own clock in multi-core mode */
+	struct rte_sched_clock *clock;
+	struct rte_sched_clock mc_clock;
+
+	/* Multi-core mode: handoff ring to the port dequeue lcore */
+	struct rte_ring *mc_ring;
 
 	/* Queue base calculation */
-	uint32_t qsize_add[RTE_SCHED_QUEUES_PER_PIPE];
+	uint32_t qsize_add[RTE_SCHED_QUEUES_PER_PIPE_MAX];
 	uint32_t qsize_sum;
 
 	struct rte_sched_pipe *pipe;
@@ -209,26 +243,26 @@ struct rte_sched_port {
 	uint32_t n_subports_per_port;
 	uint32_t n_pipes_per_subport;
 	uint32_t n_pipes_per_subport_log2;
-	uint16_t pipe_queue[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
-	uint8_t pipe_tc[RTE_SCHED_QUEUES_PER_PIPE];
-	uint8_t tc_queue[RTE_SCHED_QUEUES_PER_PIPE];
+	uint32_t n_pipe_queues_log2;
 	uint64_t rate;
 	uint32_t mtu;
 	uint32_t frame_overhead;
 	int socket;
 
 	/* Timing */
-	uint64_t time_cpu_cycles;     /* Current CPU time measured in CPU cyles */
-	uint64_t time_cpu_bytes;      /* Current CPU time measured in bytes */
-	uint64_t time;                /* Current NIC TX time measured in bytes */
+	struct rte_sched_clock clock;
 	struct rte_reciprocal inv_cycles_per_byte; /* CPU cycles per byte */
 	uint64_t cycles_per_byte;
 
 	/* Grinders */
-	struct rte_mbuf **pkts_out;
-	uint32_t n_pkts_out;
 	uint32_t subport_id;
 
+	/* Multi-core mode: port TB enforcing the port rate on the merge */
+	uint32_t mc_ring_size;
+	uint64_t mc_tb_time; /* time of last update */
+	int64_t mc_tb_size;
+	int64_t mc_tb_credits;
+
 	/* Large data structures */
 	struct rte_sched_subport *subports[0] __rte_cache_aligned;
 } __rte_cache_aligned;
@@ -246,26 +280,23 @@ enum rte_sched_subport_array {
 static inline uint32_t
 rte_sched_subport_pipe_queues(struct rte_sched_subport *subport)
 {
-	return RTE_SCHED_QUEUES_PER_PIPE * subport->n_pipes_per_subport_enabled;
+	return subport->n_pipes_per_subport_enabled << subport->n_pipe_queues_log2;
 }
 
 static inline struct rte_mbuf **
 rte_sched_subport_pipe_qbase(struct rte_sched_subport *subport, uint32_t qindex)
 {
-	uint32_t pindex = qindex >> 4;
-	uint32_t qpos = qindex & (RTE_SCHED_QUEUES_PER_PIPE - 1);
+	uint32_t pindex = qindex >> subport->n_pipe_queues_log2;
+	uint32_t qpos = qindex & subport->pipe_queue_mask;
 
 	return (subport->queue_array + pindex *
 		subport->qsize_sum + subport->qsize_add[qpos]);
 }
 
 static inline uint16_t
-rte_sched_subport_pipe_qsize(struct rte_sched_port *port,
-struct rte_sched_subport *subport, uint32_t qindex)
+rte_sched_subport_pipe_qsize(struct rte_sched_subport *subport, uint32_t qindex)
 {
-	uint32_t tc = port->pipe_tc[qindex & (RTE_SCHED_QUEUES_PER_PIPE - 1)];
-
-	return subport->qsize[tc];
+	return subport->pipe_qsize[qindex & subport->pipe_queue_mask];
 }
 
 static inline uint32_t
@@ -280,33 +311,79 @@ rte_sched_port_queues_per_port(struct rte_sched_port *port)
 }
 
 static inline uint16_t
-rte_sched_port_pipe_queue(struct rte_sched_port *port, uint32_t traffic_class)
+rte_sched_subport_pipe_queue(struct rte_sched_subport *subport,
+	uint32_t traffic_class)
 {
-	uint16_t pipe_queue = port->pipe_queue[traffic_class];
+	uint16_t pipe_queue = subport->pipe_queue[traffic_class];
 
 	return pipe_queue;
 }
 
 static inline uint8_t
-rte_sched_port_pipe_tc(struct rte_sched_port *port, uint32_t qindex)
+rte_sched_subport_pipe_tc(struct rte_sched_subport *subport, uint32_t qindex)
 {
-	uint8_t pipe_tc = port->pipe_tc[qindex & (RTE_SCHED_QUEUES_PER_PIPE - 1)];
+	uint8_t pipe_tc = subport->pipe_tc[qindex & subport->pipe_queue_mask];
 
 	return pipe_tc;
 }
 
 static inline uint8_t
-rte_sched_port_tc_queue(struct rte_sched_port *port, uint32_t qindex)
+rte_sched_subport_tc_queue(struct rte_sched_subport *subport, uint32_t qindex)
 {
-	uint8_t tc_queue = port->tc_queue[qindex & (RTE_SCHED_QUEUES_PER_PIPE - 1)];
+	uint8_t tc_queue = subport->tc_queue[qindex & subport->pipe_queue_mask];
 
 	return tc_queue;
 }
 
+static inline uint32_t
+rte_sched_port_ext_params_n_pipe_queues(
+	struct rte_sched_port_ext_params *ext_params)
+{
+	if (ext_params == NULL || ext_params->n_queues_per_pipe == 0)
+		return RTE_SCHED_QUEUES_PER_PIPE;
+
+	return ext_params->n_queues_per_pipe;
+}
+
+static inline uint32_t
+rte_sched_subport_ext_params_n_tcs(
+	struct rte_sched_subport_ext_params *ext_params)
+{
+	if (ext_params == NULL || ext_params->n_traffic_classes == 0)
+		return RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE;
+
+	return ext_params->n_traffic_classes;
+}
+
+static inline uint32_t
+rte_sched_subport_ext_params_n_be_queues(
+	struct rte_sched_subport_ext_params *ext_params)
+{
+	if (ext_params == NULL || ext_params->n_be_queues == 0)
+		return RTE_SCHED_BE_QUEUES_PER_PIPE;
+
+	return ext_params->n_be_queues;
+}
+
+/* WRR weights of pipe profile i of the subport parameters */
+static inline const uint8_t *
+rte_sched_subport_ext_params_wrr_weights(
+	struct rte_sched_subport_params *params,
+	struct rte_sched_subport_ext_params *ext_params,
+	uint32_t i)
+{
+	if (ext_params == NULL || ext_params->pipe_wrr_weights == NULL)
+		return params->pipe_profiles[i].wrr_weights;
+
+	return ext_params->pipe_wrr_weights[i];
+}
+
 static int
 pipe_profile_check(struct rte_sched_pipe_params *params,
-	uint64_t rate, uint16_t *qsize)
+	const uint8_t *wrr_weights, uint64_t rate, uint16_t *qsize,
+	uint32_t n_traffic_classes, uint32_t n_be_queues)
 {
+	uint32_t tc_be = n_traffic_classes - 1;
 	uint32_t i;
 
 	/* Pipe parameters */
@@ -342,8 +419,7 @@ pipe_profile_check(struct rte_sched_pipe_params *params,
 		}
 	}
 
-	if (params->tc_rate[RTE_SCHED_TRAFFIC_CLASS_BE] == 0 ||
-		qsize[RTE_SCHED_TRAFFIC_CLASS_BE] == 0) {
+	if (params->tc_rate[tc_be] == 0 || qsize[tc_be] == 0) {
 		RTE_LOG(ERR, SCHED,
 			"%s: Incorrect value for be traffic class rate\n", __func__);
 		return -EINVAL;
@@ -364,8 +440,8 @@ pipe_profile_check(struct rte_sched_pipe_params *params,
 	}
 
 	/* Queue WRR weights: non-zero */
-	for (i = 0; i < RTE_SCHED_BE_QUEUES_PER_PIPE; i++) {
-		if (params->wrr_weights[i] == 0) {
+	for (i = 0; i < n_be_queues; i++) {
+		if (wrr_weights[i] == 0) {
 			RTE_LOG(ERR, SCHED,
 				"%s: Incorrect value for wrr weight\n", __func__);
 			return -EINVAL;
@@ -376,8 +452,11 @@ pipe_profile_check(struct rte_sched_pipe_params *params,
 }
 
 static int
-rte_sched_port_check_params(struct rte_sched_port_params *params)
+rte_sched_port_check_params(struct rte_sched_port_params *params,
+	struct rte_sched_port_ext_params *ext_params)
 {
+	uint32_t n_pipe_queues;
+
 	if (params == NULL) {
 		RTE_LOG(ERR, SCHED,
 			"%s: Incorrect value for parameter params\n", __func__);
@@ -422,16 +501,39 @@ rte_sched_port_check_params(struct rte_sched_port_params *params)
 		return -EINVAL;
 	}
 
+	/* n_queues_per_pipe: power of 2, limited by the pipe cache size */
+	n_pipe_queues = rte_sched_port_ext_params_n_pipe_queues(ext_params);
+	if (n_pipe_queues < RTE_SCHED_QUEUES_PER_PIPE_MIN ||
+	    n_pipe_queues > RTE_SCHED_QUEUES_PER_PIPE_MAX ||
+	    !rte_is_power_of_2(n_pipe_queues)) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for queues per pipe\n", __func__);
+		return -EINVAL;
+	}
+
+	/* mc_ring_size: power of 2, valid ring size */
+	if (ext_params != NULL && ext_params->mc_ring_size != 0 &&
+	    (!rte_is_power_of_2(ext_params->mc_ring_size) ||
+	     ext_params->mc_ring_size > RTE_RING_SZ_MASK)) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for multi-core ring size\n", __func__);
+		return -EINVAL;
+	}
+
 	return 0;
 }
 
 static uint32_t
 rte_sched_subport_get_array_base(struct rte_sched_subport_params *params,
+	struct rte_sched_subport_ext_params *ext_params,
+	uint32_t n_pipe_queues,
 	enum rte_sched_subport_array array)
 {
 	uint32_t n_pipes_per_subport = params->n_pipes_per_subport_enabled;
-	uint32_t n_subport_pipe_queues =
-		RTE_SCHED_QUEUES_PER_PIPE * n_pipes_per_subport;
+	uint32_t n_subport_pipe_queues = n_pipe_queues * n_pipes_per_subport;
+	uint32_t n_tcs = rte_sched_subport_ext_params_n_tcs(ext_params);
+	uint32_t n_be_queues =
+		rte_sched_subport_ext_params_n_be_queues(ext_params);
 
 	uint32_t size_pipe = n_pipes_per_subport * sizeof(struct rte_sched_pipe);
 	uint32_t size_queue =
@@ -447,12 +549,12 @@ rte_sched_subport_get_array_base(struct rte_sched_subport_params *params,
 	uint32_t base, i;
 
 	size_per_pipe_queue_array = 0;
-	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++) {
-		if (i < RTE_SCHED_TRAFFIC_CLASS_BE)
+	for (i = 0; i < n_tcs; i++) {
+		if (i < n_tcs - 1)
 			size_per_pipe_queue_array +=
 				params->qsize[i] * sizeof(struct rte_mbuf *);
 		else
-			size_per_pipe_queue_array += RTE_SCHED_MAX_QUEUES_PER_TC *
+			size_per_pipe_queue_array += n_be_queues *
 				params->qsize[i] * sizeof(struct rte_mbuf *);
 	}
 	size_queue_array = n_pipes_per_subport * size_per_pipe_queue_array;
@@ -486,36 +588,63 @@ rte_sched_subport_get_array_base(struct rte_sched_subport_params *params,
 	return base;
 }
 
+static void
+rte_sched_subport_config_queues(struct rte_sched_subport *subport)
+{
+	uint32_t n_pipe_queues = subport->pipe_queue_mask + 1;
+	uint32_t tc_be = subport->tc_be;
+	uint32_t i;
+
+	for (i = 0; i < subport->n_traffic_classes; i++)
+		subport->pipe_queue[i] = i;
+
+	/* Strict priority traffic classes have one queue each, followed by
+	 * the best-effort traffic class queues. The remaining queues of the
+	 * pipe are not used and have zero size.
+	 */
+	for (i = 0; i < n_pipe_queues; i++) {
+		if (i < tc_be) {
+			subport->pipe_tc[i] = i;
+			subport->tc_queue[i] = 0;
+			subport->pipe_qsize[i] = subport->qsize[i];
+		} else if (i < tc_be + subport->n_be_queues) {
+			subport->pipe_tc[i] = tc_be;
+			subport->tc_queue[i] = i - tc_be;
+			subport->pipe_qsize[i] = subport->qsize[tc_be];
+		} else {
+			subport->pipe_tc[i] = tc_be;
+			subport->tc_queue[i] = 0;
+			subport->pipe_qsize[i] = 0;
+		}
+	}
+}
+
 static void
 rte_sched_subport_config_qsize(struct rte_sched_subport *subport)
 {
+	uint32_t n_pipe_queues = subport->pipe_queue_mask + 1;
 	uint32_t i;
 
 	subport->qsize_add[0] = 0;
 
-	/* Strict prority traffic class */
-	for (i = 1; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
-		subport->qsize_add[i] = subport->qsize_add[i-1] + subport->qsize[i-1];
+	for (i = 1; i < n_pipe_queues; i++)
+		subport->qsize_add[i] = subport->qsize_add[i - 1] +
+			subport->pipe_qsize[i - 1];
 
-	/* Best-effort traffic class */
-	subport->qsize_add[RTE_SCHED_TRAFFIC_CLASS_BE + 1] =
-		subport->qsize_add[RTE_SCHED_TRAFFIC_CLASS_BE] +
-		subport->qsize[RTE_SCHED_TRAFFIC_CLASS_BE];
-	subport->qsize_add[RTE_SCHED_TRAFFIC_CLASS_BE + 2] =
-		subport->qsize_add[RTE_SCHED_TRAFFIC_CLASS_BE + 1] +
-		subport->qsize[RTE_SCHED_TRAFFIC_CLASS_BE];
-	subport->qsize_add[RTE_SCHED_TRAFFIC_CLASS_BE + 3] =
-		subport->qsize_add[RTE_SCHED_TRAFFIC_CLASS_BE + 2] +
-		subport->qsize[RTE_SCHED_TRAFFIC_CLASS_BE];
-
-	subport->qsize_sum = subport->qsize_add[RTE_SCHED_TRAFFIC_CLASS_BE + 3] +
-		subport->qsize[RTE_SCHED_TRAFFIC_CLASS_BE];
+	subport->qsize_sum = subport->qsize_add[n_pipe_queues - 1] +
+		subport->pipe_qsize[n_pipe_queues - 1];
 }
 
 static void
 rte_sched_port_log_pipe_profile(struct rte_sched_subport *subport, uint32_t i)
 {
 	struct rte_sched_pipe_profile *p = subport->pipe_profiles + i;
+	char wrr_cost[RTE_SCHED_BE_QUEUES_PER_PIPE_MAX * 5];
+	uint32_t j, n = 0;
+
+	for (j = 0; j < subport->n_be_queues; j++)
+		n += snprintf(wrr_cost + n, sizeof(wrr_cost) - n, "%s%hhu",
+			j ? ", " : "", p->wrr_cost[j]);
 
 	RTE_LOG(DEBUG, SCHED, "Low level config for pipe profile %u:\n"
 		"	Token bucket: period = %"PRIu64", credits per period = %"PRIu64", size = %"PRIu64"\n"
@@ -524,7 +653,7 @@ rte_sched_port_log_pipe_profile(struct rte_sched_subport *subport, uint32_t i)
 		", %"PRIu64", %"PRIu64", %"PRIu64", %"PRIu64", %"PRIu64", %"PRIu64
 		", %"PRIu64", %"PRIu64", %"PRIu64"]\n"
 		"	Best-effort traffic class oversubscription: weight = %hhu\n"
-		"	WRR cost: [%hhu, %hhu, %hhu, %hhu]\n",
+		"	WRR cost: [%s]\n",
 		i,
 
 		/* Token bucket */
@@ -552,7 +681,7 @@ rte_sched_port_log_pipe_profile(struct rte_sched_subport *subport, uint32_t i)
 		p->tc_ov_weight,
 
 		/* WRR */
-		p->wrr_cost[0], p->wrr_cost[1], p->wrr_cost[2], p->wrr_cost[3]);
+		wrr_cost);
 }
 
 static inline uint64_t
@@ -568,11 +697,13 @@ rte_sched_time_ms_to_bytes(uint64_t time_ms, uint64_t rate)
 static void
 rte_sched_pipe_profile_convert(struct rte_sched_subport *subport,
 	struct rte_sched_pipe_params *src,
+	const uint8_t *wrr_weights,
 	struct rte_sched_pipe_profile *dst,
 	uint64_t rate)
 {
-	uint32_t wrr_cost[RTE_SCHED_BE_QUEUES_PER_PIPE];
-	uint32_t lcd1, lcd2, lcd;
+	uint32_t wrr_cost[RTE_SCHED_BE_QUEUES_PER_PIPE_MAX];
+	uint32_t n_be_queues = subport->n_be_queues;
+	uint32_t lcd;
 	uint32_t i;
 
 	/* Token Bucket */
@@ -603,44 +734,41 @@ rte_sched_pipe_profile_convert(struct rte_sched_subport *subport,
 	dst->tc_ov_weight = src->tc_ov_weight;
 
 	/* WRR queues */
-	wrr_cost[0] = src->wrr_weights[0];
-	wrr_cost[1] = src->wrr_weights[1];
-	wrr_cost[2] = src->wrr_weights[2];
-	wrr_cost[3] = src->wrr_weights[3];
+	for (i = 0; i < n_be_queues; i++)
+		wrr_cost[i] = wrr_weights[i];
 
-	lcd1 = rte_get_lcd(wrr_cost[0], wrr_cost[1]);
-	lcd2 = rte_get_lcd(wrr_cost[2], wrr_cost[3]);
-	lcd = rte_get_lcd(lcd1, lcd2);
+	lcd = wrr_cost[0];
+	for (i = 1; i < n_be_queues; i++)
+		lcd = rte_get_lcd(lcd, wrr_cost[i]);
 
-	wrr_cost[0] = lcd / wrr_cost[0];
-	wrr_cost[1] = lcd / wrr_cost[1];
-	wrr_cost[2] = lcd / wrr_cost[2];
-	wrr_cost[3] = lcd / wrr_cost[3];
-
-	dst->wrr_cost[0] = (uint8_t) wrr_cost[0];
-	dst->wrr_cost[1] = (uint8_t) wrr_cost[1];
-	dst->wrr_cost[2] = (uint8_t) wrr_cost[2];
-	dst->wrr_cost[3] = (uint8_t) wrr_cost[3];
+	for (i = 0; i < n_be_queues; i++)
+		dst->wrr_cost[i] = (uint8_t) (lcd / wrr_cost[i]);
 }
 
 static void
 rte_sched_subport_config_pipe_profile_table(struct rte_sched_subport *subport,
-	struct rte_sched_subport_params *params, uint64_t rate)
+	struct rte_sched_subport_params *params,
+	struct rte_sched_subport_ext_params *ext_params,
+	uint64_t rate)
 {
 	uint32_t i;
 
 	for (i = 0; i < subport->n_pipe_profiles; i++) {
 		struct rte_sched_pipe_params *src = params->pipe_profiles + i;
 		struct rte_sched_pipe_profile *dst = subport->pipe_profiles + i;
+		const uint8_t *wrr_weights =
+			rte_sched_subport_ext_params_wrr_weights(params,
+				ext_params, i);
 
-		rte_sched_pipe_profile_convert(subport, src, dst, rate);
+		rte_sched_pipe_profile_convert(subport, src, wrr_weights, dst,
+			rate);
 		rte_sched_port_log_pipe_profile(subport, i);
 	}
 
 	subport->pipe_tc_be_rate_max = 0;
 	for (i = 0; i < subport->n_pipe_profiles; i++) {
 		struct rte_sched_pipe_params *src = params->pipe_profiles + i;
-		uint64_t pipe_tc_be_rate = src->tc_rate[RTE_SCHED_TRAFFIC_CLASS_BE];
+		uint64_t pipe_tc_be_rate = src->tc_rate[subport->tc_be];
 
 		if (subport->pipe_tc_be_rate_max < pipe_tc_be_rate)
 			subport->pipe_tc_be_rate_max = pipe_tc_be_rate;
@@ -649,10 +777,12 @@ rte_sched_subport_config_pipe_profile_table(struct rte_sched_subport *subport,
 
 static int
 rte_sched_subport_check_params(struct rte_sched_subport_params *params,
+	struct rte_sched_subport_ext_params *ext_params,
 	uint32_t n_max_pipes_per_subport,
+	uint32_t n_pipe_queues,
 	uint64_t rate)
 {
-	uint32_t i;
+	uint32_t n_tcs, n_be_queues, tc_be, i;
 
 	/* Check user parameters */
 	if (params == NULL) {
@@ -673,13 +803,37 @@ rte_sched_subport_check_params(struct rte_sched_subport_params *params,
 		return -EINVAL;
 	}
 
+	/* n_traffic_classes, n_be_queues: all the pipe queues fit in the
+	 * queues reserved per pipe
+	 */
+	n_tcs = rte_sched_subport_ext_params_n_tcs(ext_params);
+	n_be_queues = rte_sched_subport_ext_params_n_be_queues(ext_params);
+	if (n_tcs > RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE ||
+	    n_be_queues > RTE_SCHED_BE_QUEUES_PER_PIPE_MAX ||
+	    n_tcs - 1 + n_be_queues > n_pipe_queues) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for traffic classes or be queues\n",
+			__func__);
+		return -EINVAL;
+	}
+	tc_be = n_tcs - 1;
+
+	/* pipe_wrr_weights: mandatory beyond the pipe profile wrr_weights */
+	if (n_be_queues > RTE_SCHED_BE_QUEUES_PER_PIPE &&
+	    ext_params->pipe_wrr_weights == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for pipe wrr weights\n", __func__);
+		return -EINVAL;
+	}
+
 	/* qsize: if non-zero, power of 2,
 	 * no bigger than 32K (due to 16-bit read/write pointers)
 	 */
 	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++) {
 		uint16_t qsize = params->qsize[i];
 
-		if (qsize != 0 && !rte_is_power_of_2(qsize)) {
+		if ((qsize != 0 && !rte_is_power_of_2(qsize)) ||
+		    (qsize != 0 && i >= n_tcs)) {
 			RTE_LOG(ERR, SCHED,
 				"%s: Incorrect value for qsize\n", __func__);
 			return -EINVAL;
@@ -699,8 +853,7 @@ rte_sched_subport_check_params(struct rte_sched_subport_params *params,
 		}
 	}
 
-	if (params->qsize[RTE_SCHED_TRAFFIC_CLASS_BE] == 0 ||
-		params->tc_rate[RTE_SCHED_TRAFFIC_CLASS_BE] == 0) {
+	if (params->qsize[tc_be] == 0 || params->tc_rate[tc_be] == 0) {
 		RTE_LOG(ERR, SCHED,
 			"%s: Incorrect qsize or tc rate(best effort)\n", __func__);
 		return -EINVAL;
@@ -733,9 +886,13 @@ rte_sched_subport_check_params(struct rte_sched_subport_params *params,
 
 	for (i = 0; i < params->n_pipe_profiles; i++) {
 		struct rte_sched_pipe_params *p = params->pipe_profiles + i;
+		const uint8_t *wrr_weights =
+			rte_sched_subport_ext_params_wrr_weights(params,
+				ext_params, i);
 		int status;
 
-		status = pipe_profile_check(p, rate, &params->qsize[0]);
+		status = pipe_profile_check(p, wrr_weights, rate,
+			&params->qsize[0], n_tcs, n_be_queues);
 		if (status != 0) {
 			RTE_LOG(ERR, SCHED,
 				"%s: Pipe profile check failed(%d)\n", __func__, status);
@@ -750,10 +907,21 @@ uint32_t
 rte_sched_port_get_memory_footprint(struct rte_sched_port_params *port_params,
 	struct rte_sched_subport_params **subport_params)
 {
-	uint32_t size0 = 0, size1 = 0, i;
+	return rte_sched_port_get_memory_footprint_ext(port_params,
+		subport_params, NULL, NULL);
+}
+
+uint32_t
+rte_sched_port_get_memory_footprint_ext(
+	struct rte_sched_port_params *port_params,
+	struct rte_sched_subport_params **subport_params,
+	struct rte_sched_port_ext_params *port_ext_params,
+	struct rte_sched_subport_ext_params **subport_ext_params)
+{
+	uint32_t size0 = 0, size1 = 0, n_pipe_queues, i;
 	int status;
 
-	status = rte_sched_port_check_params(port_params);
+	status = rte_sched_port_check_params(port_params, port_ext_params);
 	if (status != 0) {
 		RTE_LOG(ERR, SCHED,
 			"%s: Port scheduler port params check failed (%d)\n",
@@ -762,11 +930,16 @@ rte_sched_port_get_memory_footprint(struct rte_sched_port_params *port_params,
 		return 0;
 	}
 
+	n_pipe_queues = rte_sched_port_ext_params_n_pipe_queues(port_ext_params);
+
 	for (i = 0; i < port_params->n_subports_per_port; i++) {
 		struct rte_sched_subport_params *sp = subport_params[i];
+		struct rte_sched_subport_ext_params *sp_ext =
+			subport_ext_params ? subport_ext_params[i] : NULL;
 
-		status = rte_sched_subport_check_params(sp,
+		status = rte_sched_subport_check_params(sp, sp_ext,
 				port_params->n_pipes_per_subport,
+				n_pipe_queues,
 				port_params->rate);
 		if (status != 0) {
 			RTE_LOG(ERR, SCHED,
@@ -781,9 +954,16 @@ rte_sched_port_get_memory_footprint(struct rte_sched_port_params *port_params,
 
 	for (i = 0; i < port_params->n_subports_per_port; i++) {
 		struct rte_sched_subport_params *sp = subport_params[i];
+		struct rte_sched_subport_ext_params *sp_ext =
+			subport_ext_params ? subport_ext_params[i] : NULL;
 
-		size1 += rte_sched_subport_get_array_base(sp,
+		size1 += rte_sched_subport_get_array_base(sp, sp_ext,
+					n_pipe_queues,
 					e_RTE_SCHED_SUBPORT_ARRAY_TOTAL);
+		if (port_ext_params != NULL &&
+		    port_ext_params->mc_ring_size != 0)
+			size1 += rte_ring_get_memsize(
+				port_ext_params->mc_ring_size);
 	}
 
 	return size0 + size1;
@@ -791,14 +971,20 @@ rte_sched_port_get_memory_footprint(struct rte_sched_port_params *port_params,
 
 struct rte_sched_port *
 rte_sched_port_config(struct rte_sched_port_params *params)
+{
+	return rte_sched_port_config_ext(params, NULL);
+}
+
+struct rte_sched_port *
+rte_sched_port_config_ext(struct rte_sched_port_params *params,
+	struct rte_sched_port_ext_params *ext_params)
 {
 	struct rte_sched_port *port = NULL;
 	uint32_t size0, size1;
 	uint32_t cycles_per_byte;
-	uint32_t i, j;
 	int status;
 
-	status = rte_sched_port_check_params(params);
+	status = rte_sched_port_check_params(params, ext_params);
 	if (status != 0) {
 		RTE_LOG(ERR, SCHED,
 			"%s: Port scheduler params check failed (%d)\n",
@@ -823,32 +1009,17 @@ rte_sched_port_config(struct rte_sched_port_params *params)
 	port->n_pipes_per_subport = params->n_pipes_per_subport;
 	port->n_pipes_per_subport_log2 =
 			__builtin_ctz(params->n_pipes_per_subport);
+	port->n_pipe_queues_log2 = __builtin_ctz(
+			rte_sched_port_ext_params_n_pipe_queues(ext_params));
 	port->socket = params->socket;
-
-	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
-		port->pipe_queue[i] = i;
-
-	for (i = 0, j = 0; i < RTE_SCHED_QUEUES_PER_PIPE; i++) {
-		port->pipe_tc[i] = j;
-
-		if (j < RTE_SCHED_TRAFFIC_CLASS_BE)
-			j++;
-	}
-
-	for (i = 0, j = 0; i < RTE_SCHED_QUEUES_PER_PIPE; i++) {
-		port->tc_queue[i] = j;
-
-		if (i >= RTE_SCHED_TRAFFIC_CLASS_BE)
-			j++;
-	}
 	port->rate = params->rate;
 	port->mtu = params->mtu + params->frame_overhead;
 	port->frame_overhead = params->frame_overhead;
 
 	/* Timing */
-	port->time_cpu_cycles = rte_get_tsc_cycles();
-	port->time_cpu_bytes = 0;
-	port->time = 0;
+	port->clock.time_cpu_cycles = rte_get_tsc_cycles();
+	port->clock.time_cpu_bytes = 0;
+	port->clock.time = 0;
 
 	cycles_per_byte = (rte_get_tsc_hz() << RTE_SCHED_TIME_SHIFT)
 		/ params->rate;
@@ -856,16 +1027,19 @@ rte_sched_port_config(struct rte_sched_port_params *params)
 	port->cycles_per_byte = cycles_per_byte;
 
 	/* Grinders */
-	port->pkts_out = NULL;
-	port->n_pkts_out = 0;
 	port->subport_id = 0;
 
+	/* Multi-core mode */
+	port->mc_ring_size = ext_params ? ext_params->mc_ring_size : 0;
+	port->mc_tb_time = 0;
+	port->mc_tb_size = RTE_SCHED_PORT_MERGE_BURST * port->mtu;
+	port->mc_tb_credits = port->mc_tb_size;
+
 	return port;
 }
 
 static inline void
-rte_sched_subport_free(struct rte_sched_port *port,
-	struct rte_sched_subport *subport)
+rte_sched_subport_free(struct rte_sched_subport *subport)
 {
 	uint32_t n_subport_pipe_queues;
 	uint32_t qindex;
@@ -879,7 +1053,7 @@ rte_sched_subport_free(struct rte_sched_port *port,
 	for (qindex = 0; qindex < n_subport_pipe_queues; qindex++) {
 		struct rte_mbuf **mbufs =
 			rte_sched_subport_pipe_qbase(subport, qindex);
-		uint16_t qsize = rte_sched_subport_pipe_qsize(port, subport, qindex);
+		uint16_t qsize = rte_sched_subport_pipe_qsize(subport, qindex);
 		if (qsize != 0) {
 			struct rte_sched_queue *queue = subport->queue + qindex;
 			uint16_t qr = queue->qr & (qsize - 1);
@@ -890,6 +1064,16 @@ rte_sched_subport_free(struct rte_sched_port *port,
 		}
 	}
 
+	/* Free the mbufs not yet read from the handoff ring */
+	if (subport->mc_ring != NULL) {
+		struct rte_mbuf *pkt;
+
+		while (rte_ring_sc_dequeue(subport->mc_ring, (void **)&pkt) == 0)
+			rte_pktmbuf_free(pkt);
+
+		rte_free(subport->mc_ring);
+	}
+
 	rte_free(subport);
 }
 
@@ -903,7 +1087,7 @@ rte_sched_port_free(struct rte_sched_port *port)
 		return;
 
 	for (i = 0; i < port->n_subports_per_port; i++)
-		rte_sched_subport_free(port, port->subports[i]);
+		rte_sched_subport_free(port->subports[i]);
 
 	rte_free(port);
 }
@@ -958,7 +1142,7 @@ rte_sched_free_memory(struct rte_sched_port *port, uint32_t n_subports)
 	for (i = 0; i < n_subports; i++) {
 		struct rte_sched_subport *subport = port->subports[i];
 
-		rte_sched_subport_free(port, subport);
+		rte_sched_subport_free(subport);
 	}
 
 	rte_free(port);
@@ -968,10 +1152,19 @@ int
 rte_sched_subport_config(struct rte_sched_port *port,
 	uint32_t subport_id,
 	struct rte_sched_subport_params *params)
+{
+	return rte_sched_subport_config_ext(port, subport_id, params, NULL);
+}
+
+int
+rte_sched_subport_config_ext(struct rte_sched_port *port,
+	uint32_t subport_id,
+	struct rte_sched_subport_params *params,
+	struct rte_sched_subport_ext_params *ext_params)
 {
 	struct rte_sched_subport *s = NULL;
 	uint32_t n_subports = subport_id;
-	uint32_t n_subport_pipe_queues, i;
+	uint32_t n_subport_pipe_queues, pipe_queues, i;
 	uint32_t size0, size1, bmp_mem_size;
 	int status;
 
@@ -990,8 +1183,10 @@ rte_sched_subport_config(struct rte_sched_port *port,
 		return -EINVAL;
 	}
 
-	status = rte_sched_subport_check_params(params,
+	pipe_queues = 1 << port->n_pipe_queues_log2;
+	status = rte_sched_subport_check_params(params, ext_params,
 		port->n_pipes_per_subport,
+		pipe_queues,
 		port->rate);
 	if (status != 0) {
 		RTE_LOG(NOTICE, SCHED,
@@ -1004,8 +1199,8 @@ rte_sched_subport_config(struct rte_sched_port *port,
 
 	/* Determine the amount of memory to allocate */
 	size0 = sizeof(struct rte_sched_subport);
-	size1 = rte_sched_subport_get_array_base(params,
-				e_RTE_SCHED_SUBPORT_ARRAY_TOTAL);
+	size1 = rte_sched_subport_get_array_base(params, ext_params,
+				pipe_queues, e_RTE_SCHED_SUBPORT_ARRAY_TOTAL);
 
 	/* Allocate memory to store the data structures */
 	s = rte_zmalloc_socket("subport_params", size0 + size1,
@@ -1023,6 +1218,32 @@ rte_sched_subport_config(struct rte_sched_port *port,
 	/* Port */
 	port->subports[subport_id] = s;
 
+	/* Timing */
+	if (port->mc_ring_size != 0) {
+		char ring_name[RTE_RING_NAMESIZE];
+		ssize_t ring_size;
+
+		s->mc_clock = port->clock;
+		s->clock = &s->mc_clock;
+
+		ring_size = rte_ring_get_memsize(port->mc_ring_size);
+		s->mc_ring = rte_zmalloc_socket("subport_ring", ring_size,
+			RTE_CACHE_LINE_SIZE, port->socket);
+		if (s->mc_ring == NULL) {
+			RTE_LOG(ERR, SCHED,
+				"%s: Memory allocation fails\n", __func__);
+
+			rte_sched_free_memory(port, n_subports);
+			return -ENOMEM;
+		}
+
+		snprintf(ring_name, sizeof(ring_name), "SCHED_SP%u", subport_id);
+		rte_ring_init(s->mc_ring, ring_name, port->mc_ring_size,
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+	} else {
+		s->clock = &port->clock;
+	}
+
 	/* Token Bucket (TB) */
 	if (params->tb_rate == port->rate) {
 		s->tb_credits_per_period = 1;
@@ -1035,7 +1256,7 @@ rte_sched_subport_config(struct rte_sched_port *port,
 	}
 
 	s->tb_size = params->tb_size;
-	s->tb_time = port->time;
+	s->tb_time = s->clock->time;
 	s->tb_credits = s->tb_size / 2;
 
 	/* Traffic Classes (TCs) */
@@ -1046,7 +1267,7 @@ rte_sched_subport_config(struct rte_sched_port *port,
 				= rte_sched_time_ms_to_bytes(params->tc_period,
 					params->tc_rate[i]);
 	}
-	s->tc_time = port->time + s->tc_period;
+	s->tc_time = s->clock->time + s->tc_period;
 	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
 		if (params->qsize[i])
 			s->tc_credits[i] = s->tc_credits_per_period[i];
@@ -1061,6 +1282,11 @@ rte_sched_subport_config(struct rte_sched_port *port,
 	memcpy(s->qsize, params->qsize, sizeof(params->qsize));
 	s->n_pipe_profiles = params->n_pipe_profiles;
 	s->n_max_pipe_profiles = params->n_max_pipe_profiles;
+	s->n_traffic_classes = rte_sched_subport_ext_params_n_tcs(ext_params);
+	s->tc_be = s->n_traffic_classes - 1;
+	s->n_be_queues = rte_sched_subport_ext_params_n_be_queues(ext_params);
+	s->n_pipe_queues_log2 = port->n_pipe_queues_log2;
+	s->pipe_queue_mask = (1 << port->n_pipe_queues_log2) - 1;
 
 #ifdef RTE_SCHED_RED
 	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++) {
@@ -1095,30 +1321,38 @@ rte_sched_subport_config(struct rte_sched_port *port,
 	/* Grinders */
 	s->busy_grinders = 0;
 
-	/* Queue base calculation */
+	/* Queue layout and base calculation */
+	rte_sched_subport_config_queues(s);
 	rte_sched_subport_config_qsize(s);
 
 	/* Large data structures */
 	s->pipe = (struct rte_sched_pipe *)
 		(s->memory + rte_sched_subport_get_array_base(params,
+		ext_params, pipe_queues,
 		e_RTE_SCHED_SUBPORT_ARRAY_PIPE));
 	s->queue = (struct rte_sched_queue *)
 		(s->memory + rte_sched_subport_get_array_base(params,
+		ext_params, pipe_queues,
 		e_RTE_SCHED_SUBPORT_ARRAY_QUEUE));
 	s->queue_extra = (struct rte_sched_queue_extra *)
 		(s->memory + rte_sched_subport_get_array_base(params,
+		ext_params, pipe_queues,
 		e_RTE_SCHED_SUBPORT_ARRAY_QUEUE_EXTRA));
 	s->pipe_profiles = (struct rte_sched_pipe_profile *)
 		(s->memory + rte_sched_subport_get_array_base(params,
+		ext_params, pipe_queues,
 		e_RTE_SCHED_SUBPORT_ARRAY_PIPE_PROFILES));
 	s->bmp_array =  s->memory + rte_sched_subport_get_array_base(params,
+		ext_params, pipe_queues,
 		e_RTE_SCHED_SUBPORT_ARRAY_BMP_ARRAY);
 	s->queue_array = (struct rte_mbuf **)
 		(s->memory + rte_sched_subport_get_array_base(params,
+		ext_params, pipe_queues,
 		e_RTE_SCHED_SUBPORT_ARRAY_QUEUE_ARRAY));
 
 	/* Pipe profile table */
-	rte_sched_subport_config_pipe_profile_table(s, params, port->rate);
+	rte_sched_subport_config_pipe_profile_table(s, params, ext_params,
+		port->rate);
 
 	/* Bitmap */
 	n_subport_pipe_queues = rte_sched_subport_pipe_queues(s);
@@ -1206,10 +1440,10 @@ rte_sched_pipe_config(struct rte_sched_port *port,
 		params = s->pipe_profiles + p->profile;
 
 		double subport_tc_be_rate =
-			(double) s->tc_credits_per_period[RTE_SCHED_TRAFFIC_CLASS_BE]
+			(double) s->tc_credits_per_period[s->tc_be]
 			/ (double) s->tc_period;
 		double pipe_tc_be_rate =
-			(double) params->tc_credits_per_period[RTE_SCHED_TRAFFIC_CLASS_BE]
+			(double) params->tc_credits_per_period[s->tc_be]
 			/ (double) params->tc_period;
 		uint32_t tc_be_ov = s->tc_ov;
 
@@ -1236,11 +1470,11 @@ rte_sched_pipe_config(struct rte_sched_port *port,
 	params = s->pipe_profiles + p->profile;
 
 	/* Token Bucket (TB) */
-	p->tb_time = port->time;
+	p->tb_time = s->clock->time;
 	p->tb_credits = params->tb_size / 2;
 
 	/* Traffic Classes (TCs) */
-	p->tc_time = port->time + params->tc_period;
+	p->tc_time = s->clock->time + params->tc_period;
 
 	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
 		if (s->qsize[i])
@@ -1249,10 +1483,10 @@ rte_sched_pipe_config(struct rte_sched_port *port,
 	{
 		/* Subport best effort tc oversubscription */
 		double subport_tc_be_rate =
-			(double) s->tc_credits_per_period[RTE_SCHED_TRAFFIC_CLASS_BE]
+			(double) s->tc_credits_per_period[s->tc_be]
 			/ (double) s->tc_period;
 		double pipe_tc_be_rate =
-			(double) params->tc_credits_per_period[RTE_SCHED_TRAFFIC_CLASS_BE]
+			(double) params->tc_credits_per_period[s->tc_be]
 			/ (double) params->tc_period;
 		uint32_t tc_be_ov = s->tc_ov;
 
@@ -1277,6 +1511,17 @@ rte_sched_subport_pipe_profile_add(struct rte_sched_port *port,
 	uint32_t subport_id,
 	struct rte_sched_pipe_params *params,
 	uint32_t *pipe_profile_id)
+{
+	return rte_sched_subport_pipe_profile_add_ext(port, subport_id, params,
+		NULL, pipe_profile_id);
+}
+
+int
+rte_sched_subport_pipe_profile_add_ext(struct rte_sched_port *port,
+	uint32_t subport_id,
+	struct rte_sched_pipe_params *params,
+	const uint8_t *wrr_weights,
+	uint32_t *pipe_profile_id)
 {
 	struct rte_sched_subport *s;
 	struct rte_sched_pipe_profile *pp;
@@ -1306,8 +1551,21 @@ rte_sched_subport_pipe_profile_add(struct rte_sched_port *port,
 		return -EINVAL;
 	}
 
+	/* WRR weights: mandatory beyond the pipe params wrr_weights */
+	if (wrr_weights == NULL) {
+		if (s->n_be_queues > RTE_SCHED_BE_QUEUES_PER_PIPE) {
+			RTE_LOG(ERR, SCHED,
+				"%s: Incorrect value for wrr weights\n", __func__);
+			return -EINVAL;
+		}
+
+		if (params != NULL)
+			wrr_weights = params->wrr_weights;
+	}
+
 	/* Pipe params */
-	status = pipe_profile_check(params, port->rate, &s->qsize[0]);
+	status = pipe_profile_check(params, wrr_weights, port->rate,
+		&s->qsize[0], s->n_traffic_classes, s->n_be_queues);
 	if (status != 0) {
 		RTE_LOG(ERR, SCHED,
 			"%s: Pipe profile check failed(%d)\n", __func__, status);
@@ -1315,7 +1573,7 @@ rte_sched_subport_pipe_profile_add(struct rte_sched_port *port,
 	}
 
 	pp = &s->pipe_profiles[s->n_pipe_profiles];
-	rte_sched_pipe_profile_convert(s, params, pp, port->rate);
+	rte_sched_pipe_profile_convert(s, params, wrr_weights, pp, port->rate);
 
 	/* Pipe profile should not exists */
 	for (i = 0; i < s->n_pipe_profiles; i++)
@@ -1329,8 +1587,8 @@ rte_sched_subport_pipe_profile_add(struct rte_sched_port *port,
 	*pipe_profile_id = s->n_pipe_profiles;
 	s->n_pipe_profiles++;
 
-	if (s->pipe_tc_be_rate_max < params->tc_rate[RTE_SCHED_TRAFFIC_CLASS_BE])
-		s->pipe_tc_be_rate_max = params->tc_rate[RTE_SCHED_TRAFFIC_CLASS_BE];
+	if (s->pipe_tc_be_rate_max < params->tc_rate[s->tc_be])
+		s->pipe_tc_be_rate_max = params->tc_rate[s->tc_be];
 
 	rte_sched_port_log_pipe_profile(s, *pipe_profile_id);
 
@@ -1344,12 +1602,14 @@ rte_sched_port_qindex(struct rte_sched_port *port,
 	uint32_t traffic_class,
 	uint32_t queue)
 {
+	struct rte_sched_subport *s = port->subports[subport];
+
 	return ((subport & (port->n_subports_per_port - 1)) <<
-		(port->n_pipes_per_subport_log2 + 4)) |
-		((pipe &
-		(port->subports[subport]->n_pipes_per_subport_enabled - 1)) << 4) |
-		((rte_sched_port_pipe_queue(port, traffic_class) + queue) &
-		(RTE_SCHED_QUEUES_PER_PIPE - 1));
+		(port->n_pipes_per_subport_log2 + port->n_pipe_queues_log2)) |
+		((pipe & (s->n_pipes_per_subport_enabled - 1)) <<
+		port->n_pipe_queues_log2) |
+		((rte_sched_subport_pipe_queue(s, traffic_class) + queue) &
+		s->pipe_queue_mask);
 }
 
 void
@@ -1372,12 +1632,15 @@ rte_sched_port_pkt_read_tree_path(struct rte_sched_port *port,
 				  uint32_t *traffic_class, uint32_t *queue)
 {
 	uint32_t queue_id = rte_mbuf_sched_queue_get(pkt);
+	struct rte_sched_subport *s;
 
-	*subport = queue_id >> (port->n_pipes_per_subport_log2 + 4);
-	*pipe = (queue_id >> 4) &
-		(port->subports[*subport]->n_pipes_per_subport_enabled - 1);
-	*traffic_class = rte_sched_port_pipe_tc(port, queue_id);
-	*queue = rte_sched_port_tc_queue(port, queue_id);
+	*subport = queue_id >>
+		(port->n_pipes_per_subport_log2 + port->n_pipe_queues_log2);
+	s = port->subports[*subport];
+	*pipe = (queue_id >> port->n_pipe_queues_log2) &
+		(s->n_pipes_per_subport_enabled - 1);
+	*traffic_class = rte_sched_subport_pipe_tc(s, queue_id);
+	*queue = rte_sched_subport_tc_queue(s, queue_id);
 }
 
 enum rte_color
@@ -1466,7 +1729,7 @@ rte_sched_queue_read_stats(struct rte_sched_port *port,
 			"%s: Incorrect value for parameter qlen\n", __func__);
 		return -EINVAL;
 	}
-	subport_qmask = port->n_pipes_per_subport_log2 + 4;
+	subport_qmask = port->n_pipes_per_subport_log2 + port->n_pipe_queues_log2;
 	subport_id = (queue_id >> subport_qmask) & (port->n_subports_per_port - 1);
 
 	s = port->subports[subport_id];
@@ -1500,12 +1763,11 @@ rte_sched_port_queue_is_empty(struct rte_sched_subport *subport,
 #ifdef RTE_SCHED_COLLECT_STATS
 
 static inline void
-rte_sched_port_update_subport_stats(struct rte_sched_port *port,
-	struct rte_sched_subport *subport,
+rte_sched_port_update_subport_stats(struct rte_sched_subport *subport,
 	uint32_t qindex,
 	struct rte_mbuf *pkt)
 {
-	uint32_t tc_index = rte_sched_port_pipe_tc(port, qindex);
+	uint32_t tc_index = rte_sched_subport_pipe_tc(subport, qindex);
 	uint32_t pkt_len = pkt->pkt_len;
 
 	subport->stats.n_pkts_tc[tc_index] += 1;
@@ -1514,21 +1776,19 @@ rte_sched_port_update_subport_stats(struct rte_sched_port *port,
 
 #ifdef RTE_SCHED_RED
 static inline void
-rte_sched_port_update_subport_stats_on_drop(struct rte_sched_port *port,
-	struct rte_sched_subport *subport,
+rte_sched_port_update_subport_stats_on_drop(struct rte_sched_subport *subport,
 	uint32_t qindex,
 	struct rte_mbuf *pkt,
 	uint32_t red)
 #else
 static inline void
-rte_sched_port_update_subport_stats_on_drop(struct rte_sched_port *port,
-	struct rte_sched_subport *subport,
+rte_sched_port_update_subport_stats_on_drop(struct rte_sched_subport *subport,
 	uint32_t qindex,
 	struct rte_mbuf *pkt,
 	__rte_unused uint32_t red)
 #endif
 {
-	uint32_t tc_index = rte_sched_port_pipe_tc(port, qindex);
+	uint32_t tc_index = rte_sched_subport_pipe_tc(subport, qindex);
 	uint32_t pkt_len = pkt->pkt_len;
 
 	subport->stats.n_pkts_tc_dropped[tc_index] += 1;
@@ -1579,8 +1839,7 @@ rte_sched_port_update_queue_stats_on_drop(struct rte_sched_subport *subport,
 #ifdef RTE_SCHED_RED
 
 static inline int
-rte_sched_port_red_drop(struct rte_sched_port *port,
-	struct rte_sched_subport *subport,
+rte_sched_port_red_drop(struct rte_sched_subport *subport,
 	struct rte_mbuf *pkt,
 	uint32_t qindex,
 	uint16_t qlen)
@@ -1591,7 +1850,7 @@ rte_sched_port_red_drop(struct rte_sched_port *port,
 	uint32_t tc_index;
 	enum rte_color color;
 
-	tc_index = rte_sched_port_pipe_tc(port, qindex);
+	tc_index = rte_sched_subport_pipe_tc(subport, qindex);
 	color = rte_sched_port_pkt_read_color(pkt);
 	red_cfg = &subport->red_config[tc_index][color];
 
@@ -1601,23 +1860,22 @@ rte_sched_port_red_drop(struct rte_sched_port *port,
 	qe = subport->queue_extra + qindex;
 	red = &qe->red;
 
-	return rte_red_enqueue(red_cfg, red, qlen, port->time);
+	return rte_red_enqueue(red_cfg, red, qlen, subport->clock->time);
 }
 
 static inline void
-rte_sched_port_set_queue_empty_timestamp(struct rte_sched_port *port,
-	struct rte_sched_subport *subport, uint32_t qindex)
+rte_sched_port_set_queue_empty_timestamp(struct rte_sched_subport *subport,
+	uint32_t qindex)
 {
 	struct rte_sched_queue_extra *qe = subport->queue_extra + qindex;
 	struct rte_red *red = &qe->red;
 
-	rte_red_mark_queue_empty(red, port->time);
+	rte_red_mark_queue_empty(red, subport->clock->time);
 }
 
 #else
 
-static inline int rte_sched_port_red_drop(struct rte_sched_port *port __rte_unused,
-	struct rte_sched_subport *subport __rte_unused,
+static inline int rte_sched_port_red_drop(struct rte_sched_subport *subport __rte_unused,
 	struct rte_mbuf *pkt __rte_unused,
 	uint32_t qindex __rte_unused,
 	uint16_t qlen __rte_unused)
@@ -1625,7 +1883,7 @@ static inline int rte_sched_port_red_drop(struct rte_sched_port *port __rte_unus
 	return 0;
 }
 
-#define rte_sched_port_set_queue_empty_timestamp(port, subport, qindex)
+#define rte_sched_port_set_queue_empty_timestamp(subport, qindex)
 
 #endif /* RTE_SCHED_RED */
 
@@ -1663,7 +1921,8 @@ rte_sched_port_subport(struct rte_sched_port *port,
 	struct rte_mbuf *pkt)
 {
 	uint32_t queue_id = rte_mbuf_sched_queue_get(pkt);
-	uint32_t subport_id = queue_id >> (port->n_pipes_per_subport_log2 + 4);
+	uint32_t subport_id = queue_id >>
+		(port->n_pipes_per_subport_log2 + port->n_pipe_queues_log2);
 
 	return port->subports[subport_id];
 }
@@ -1690,8 +1949,7 @@ rte_sched_port_enqueue_qptrs_prefetch0(struct rte_sched_subport *subport,
 }
 
 static inline void
-rte_sched_port_enqueue_qwa_prefetch0(struct rte_sched_port *port,
-	struct rte_sched_subport *subport,
+rte_sched_port_enqueue_qwa_prefetch0(struct rte_sched_subport *subport,
 	uint32_t qindex,
 	struct rte_mbuf **qbase)
 {
@@ -1700,7 +1958,7 @@ rte_sched_port_enqueue_qwa_prefetch0(struct rte_sched_port *port,
 	uint16_t qsize;
 
 	q = subport->queue + qindex;
-	qsize = rte_sched_subport_pipe_qsize(port, subport, qindex);
+	qsize = rte_sched_subport_pipe_qsize(subport, qindex);
 	q_qw = qbase + (q->qw & (qsize - 1));
 
 	rte_prefetch0(q_qw);
@@ -1708,8 +1966,7 @@ rte_sched_port_enqueue_qwa_prefetch0(struct rte_sched_port *port,
 }
 
 static inline int
-rte_sched_port_enqueue_qwa(struct rte_sched_port *port,
-	struct rte_sched_subport *subport,
+rte_sched_port_enqueue_qwa(struct rte_sched_subport *subport,
 	uint32_t qindex,
 	struct rte_mbuf **qbase,
 	struct rte_mbuf *pkt)
@@ -1719,15 +1976,15 @@ rte_sched_port_enqueue_qwa(struct rte_sched_port *port,
 	uint16_t qlen;
 
 	q = subport->queue + qindex;
-	qsize = rte_sched_subport_pipe_qsize(port, subport, qindex);
+	qsize = rte_sched_subport_pipe_qsize(subport, qindex);
 	qlen = q->qw - q->qr;
 
 	/* Drop the packet (and update drop stats) when queue is full */
-	if (unlikely(rte_sched_port_red_drop(port, subport, pkt, qindex, qlen) ||
+	if (unlikely(rte_sched_port_red_drop(subport, pkt, qindex, qlen) ||
 		     (qlen >= qsize))) {
 		rte_pktmbuf_free(pkt);
 #ifdef RTE_SCHED_COLLECT_STATS
-		rte_sched_port_update_subport_stats_on_drop(port, subport,
+		rte_sched_port_update_subport_stats_on_drop(subport,
 			qindex, pkt, qlen < qsize);
 		rte_sched_port_update_queue_stats_on_drop(subport, qindex, pkt,
 			qlen < qsize);
@@ -1744,7 +2001,7 @@ rte_sched_port_enqueue_qwa(struct rte_sched_port *port,
 
 	/* Statistics */
 #ifdef RTE_SCHED_COLLECT_STATS
-	rte_sched_port_update_subport_stats(port, subport, qindex, pkt);
+	rte_sched_port_update_subport_stats(subport, qindex, pkt);
 	rte_sched_port_update_queue_stats(subport, qindex, pkt);
 #endif
 
@@ -1781,7 +2038,8 @@ rte_sched_port_enqueue(struct rte_sched_port *port, struct rte_mbuf **pkts,
 	uint32_t result, i;
 
 	result = 0;
-	subport_qmask = (1 << (port->n_pipes_per_subport_log2 + 4)) - 1;
+	subport_qmask = (1 << (port->n_pipes_per_subport_log2 +
+		port->n_pipe_queues_log2)) - 1;
 
 	/*
 	 * Less then 6 input packets available, which is not enough to
@@ -1808,13 +2066,13 @@ rte_sched_port_enqueue(struct rte_sched_port *port, struct rte_mbuf **pkts,
 		/* Prefetch the write pointer location of each queue */
 		for (i = 0; i < n_pkts; i++) {
 			q_base[i] = rte_sched_subport_pipe_qbase(subports[i], q[i]);
-			rte_sched_port_enqueue_qwa_prefetch0(port, subports[i],
+			rte_sched_port_enqueue_qwa_prefetch0(subports[i],
 				q[i], q_base[i]);
 		}
 
 		/* Write each packet to its queue */
 		for (i = 0; i < n_pkts; i++)
-			result += rte_sched_port_enqueue_qwa(port, subports[i],
+			result += rte_sched_port_enqueue_qwa(subports[i],
 						q[i], q_base[i], pkts[i]);
 
 		return result;
@@ -1852,8 +2110,8 @@ rte_sched_port_enqueue(struct rte_sched_port *port, struct rte_mbuf **pkts,
 
 	q20_base = rte_sched_subport_pipe_qbase(subport20, q20);
 	q21_base = rte_sched_subport_pipe_qbase(subport21, q21);
-	rte_sched_port_enqueue_qwa_prefetch0(port, subport20, q20, q20_base);
-	rte_sched_port_enqueue_qwa_prefetch0(port, subport21, q21, q21_base);
+	rte_sched_port_enqueue_qwa_prefetch0(subport20, q20, q20_base);
+	rte_sched_port_enqueue_qwa_prefetch0(subport21, q21, q21_base);
 
 	/* Run the pipeline */
 	for (i = 6; i < (n_pkts & (~1)); i += 2) {
@@ -1892,13 +2150,13 @@ rte_sched_port_enqueue(struct rte_sched_port *port, struct rte_mbuf **pkts,
 		/* Stage 2: Prefetch queue write location */
 		q20_base = rte_sched_subport_pipe_qbase(subport20, q20);
 		q21_base = rte_sched_subport_pipe_qbase(subport21, q21);
-		rte_sched_port_enqueue_qwa_prefetch0(port, subport20, q20, q20_base);
-		rte_sched_port_enqueue_qwa_prefetch0(port, subport21, q21, q21_base);
+		rte_sched_port_enqueue_qwa_prefetch0(subport20, q20, q20_base);
+		rte_sched_port_enqueue_qwa_prefetch0(subport21, q21, q21_base);
 
 		/* Stage 3: Write packet to queue and activate queue */
-		r30 = rte_sched_port_enqueue_qwa(port, subport30,
+		r30 = rte_sched_port_enqueue_qwa(subport30,
 				q30, q30_base, pkt30);
-		r31 = rte_sched_port_enqueue_qwa(port, subport31,
+		r31 = rte_sched_port_enqueue_qwa(subport31,
 				q31, q31_base, pkt31);
 		result += r30 + r31;
 	}
@@ -1920,12 +2178,12 @@ rte_sched_port_enqueue(struct rte_sched_port *port, struct rte_mbuf **pkts,
 
 	q10_base = rte_sched_subport_pipe_qbase(subport10, q10);
 	q11_base = rte_sched_subport_pipe_qbase(subport11, q11);
-	rte_sched_port_enqueue_qwa_prefetch0(port, subport10, q10, q10_base);
-	rte_sched_port_enqueue_qwa_prefetch0(port, subport11, q11, q11_base);
+	rte_sched_port_enqueue_qwa_prefetch0(subport10, q10, q10_base);
+	rte_sched_port_enqueue_qwa_prefetch0(subport11, q11, q11_base);
 
-	r20 = rte_sched_port_enqueue_qwa(port, subport20,
+	r20 = rte_sched_port_enqueue_qwa(subport20,
 			q20, q20_base, pkt20);
-	r21 = rte_sched_port_enqueue_qwa(port, subport21,
+	r21 = rte_sched_port_enqueue_qwa(subport21,
 			q21, q21_base, pkt21);
 	result += r20 + r21;
 
@@ -1935,27 +2193,27 @@ rte_sched_port_enqueue(struct rte_sched_port *port, struct rte_mbuf **pkts,
 
 	q00_base = rte_sched_subport_pipe_qbase(subport00, q00);
 	q01_base = rte_sched_subport_pipe_qbase(subport01, q01);
-	rte_sched_port_enqueue_qwa_prefetch0(port, subport00, q00, q00_base);
-	rte_sched_port_enqueue_qwa_prefetch0(port, subport01, q01, q01_base);
+	rte_sched_port_enqueue_qwa_prefetch0(subport00, q00, q00_base);
+	rte_sched_port_enqueue_qwa_prefetch0(subport01, q01, q01_base);
 
-	r10 = rte_sched_port_enqueue_qwa(port, subport10, q10,
+	r10 = rte_sched_port_enqueue_qwa(subport10, q10,
 			q10_base, pkt10);
-	r11 = rte_sched_port_enqueue_qwa(port, subport11, q11,
+	r11 = rte_sched_port_enqueue_qwa(subport11, q11,
 			q11_base, pkt11);
 	result += r10 + r11;
 
 	q_last_base = rte_sched_subport_pipe_qbase(subport_last, q_last);
-	rte_sched_port_enqueue_qwa_prefetch0(port, subport_last,
+	rte_sched_port_enqueue_qwa_prefetch0(subport_last,
 		q_last, q_last_base);
 
-	r00 = rte_sched_port_enqueue_qwa(port, subport00, q00,
+	r00 = rte_sched_port_enqueue_qwa(subport00, q00,
 			q00_base, pkt00);
-	r01 = rte_sched_port_enqueue_qwa(port, subport01, q01,
+	r01 = rte_sched_port_enqueue_qwa(subport01, q01,
 			q01_base, pkt01);
 	result += r00 + r01;
 
 	if (n_pkts & 1) {
-		r_last = rte_sched_port_enqueue_qwa(port, subport_last,
+		r_last = rte_sched_port_enqueue_qwa(subport_last,
 					q_last,	q_last_base, pkt_last);
 		result += r_last;
 	}
@@ -1966,41 +2224,42 @@ rte_sched_port_enqueue(struct rte_sched_port *port, struct rte_mbuf **pkts,
 #ifndef RTE_SCHED_SUBPORT_TC_OV
 
 static inline void
-grinder_credits_update(struct rte_sched_port *port,
+grinder_credits_update(struct rte_sched_port *port __rte_unused,
 	struct rte_sched_subport *subport, uint32_t pos)
 {
 	struct rte_sched_grinder *grinder = subport->grinder + pos;
 	struct rte_sched_pipe *pipe = grinder->pipe;
 	struct rte_sched_pipe_profile *params = grinder->pipe_params;
+	uint64_t time = subport->clock->time;
 	uint64_t n_periods;
 	uint32_t i;
 
 	/* Subport TB */
-	n_periods = (port->time - subport->tb_time) / subport->tb_period;
+	n_periods = (time - subport->tb_time) / subport->tb_period;
 	subport->tb_credits += n_periods * subport->tb_credits_per_period;
 	subport->tb_credits = RTE_MIN(subport->tb_credits, subport->tb_size);
 	subport->tb_time += n_periods * subport->tb_period;
 
 	/* Pipe TB */
-	n_periods = (port->time - pipe->tb_time) / params->tb_period;
+	n_periods = (time - pipe->tb_time) / params->tb_period;
 	pipe->tb_credits += n_periods * params->tb_credits_per_period;
 	pipe->tb_credits = RTE_MIN(pipe->tb_credits, params->tb_size);
 	pipe->tb_time += n_periods * params->tb_period;
 
 	/* Subport TCs */
-	if (unlikely(port->time >= subport->tc_time)) {
-		for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
+	if (unlikely(time >= subport->tc_time)) {
+		for (i = 0; i < subport->n_traffic_classes; i++)
 			subport->tc_credits[i] = subport->tc_credits_per_period[i];
 
-		subport->tc_time = port->time + subport->tc_period;
+		subport->tc_time = time + subport->tc_period;
 	}
 
 	/* Pipe TCs */
-	if (unlikely(port->time >= pipe->tc_time)) {
-		for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
+	if (unlikely(time >= pipe->tc_time)) {
+		for (i = 0; i < subport->n_traffic_classes; i++)
 			pipe->tc_credits[i] = params->tc_credits_per_period[i];
 
-		pipe->tc_time = port->time + params->tc_period;
+		pipe->tc_time = time + params->tc_period;
 	}
 }
 
@@ -2013,26 +2272,27 @@ grinder_tc_ov_credits_update(struct rte_sched_port *port,
 	uint64_t tc_ov_consumption[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
 	uint64_t tc_consumption = 0, tc_ov_consumption_max;
 	uint64_t tc_ov_wm = subport->tc_ov_wm;
+	uint32_t tc_be = subport->tc_be;
 	uint32_t i;
 
 	if (subport->tc_ov == 0)
 		return subport->tc_ov_wm_max;
 
-	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASS_BE; i++) {
+	for (i = 0; i < tc_be; i++) {
 		tc_ov_consumption[i] =
 			subport->tc_credits_per_period[i] - subport->tc_credits[i];
 		tc_consumption += tc_ov_consumption[i];
 	}
 
-	tc_ov_consumption[RTE_SCHED_TRAFFIC_CLASS_BE] =
-		subport->tc_credits_per_period[RTE_SCHED_TRAFFIC_CLASS_BE] -
-		subport->tc_credits[RTE_SCHED_TRAFFIC_CLASS_BE];
+	tc_ov_consumption[tc_be] =
+		subport->tc_credits_per_period[tc_be] -
+		subport->tc_credits[tc_be];
 
 	tc_ov_consumption_max =
-		subport->tc_credits_per_period[RTE_SCHED_TRAFFIC_CLASS_BE] -
+		subport->tc_credits_per_period[tc_be] -
 			tc_consumption;
 
-	if (tc_ov_consumption[RTE_SCHED_TRAFFIC_CLASS_BE] >
+	if (tc_ov_consumption[tc_be] >
 		(tc_ov_consumption_max - port->mtu)) {
 		tc_ov_wm  -= tc_ov_wm >> 7;
 		if (tc_ov_wm < subport->tc_ov_wm_min)
@@ -2055,37 +2315,38 @@ grinder_credits_update(struct rte_sched_port *port,
 	struct rte_sched_grinder *grinder = subport->grinder + pos;
 	struct rte_sched_pipe *pipe = grinder->pipe;
 	struct rte_sched_pipe_profile *params = grinder->pipe_params;
+	uint64_t time = subport->clock->time;
 	uint64_t n_periods;
 	uint32_t i;
 
 	/* Subport TB */
-	n_periods = (port->time - subport->tb_time) / subport->tb_period;
+	n_periods = (time - subport->tb_time) / subport->tb_period;
 	subport->tb_credits += n_periods * subport->tb_credits_per_period;
 	subport->tb_credits = RTE_MIN(subport->tb_credits, subport->tb_size);
 	subport->tb_time += n_periods * subport->tb_period;
 
 	/* Pipe TB */
-	n_periods = (port->time - pipe->tb_time) / params->tb_period;
+	n_periods = (time - pipe->tb_time) / params->tb_period;
 	pipe->tb_credits += n_periods * params->tb_credits_per_period;
 	pipe->tb_credits = RTE_MIN(pipe->tb_credits, params->tb_size);
 	pipe->tb_time += n_periods * params->tb_period;
 
 	/* Subport TCs */
-	if (unlikely(port->time >= subport->tc_time)) {
+	if (unlikely(time >= subport->tc_time)) {
 		subport->tc_ov_wm = grinder_tc_ov_credits_update(port, subport);
 
-		for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
+		for (i = 0; i < subport->n_traffic_classes; i++)
 			subport->tc_credits[i] = subport->tc_credits_per_period[i];
 
-		subport->tc_time = port->time + subport->tc_period;
+		subport->tc_time = time + subport->tc_period;
 		subport->tc_ov_period_id++;
 	}
 
 	/* Pipe TCs */
-	if (unlikely(port->time >= pipe->tc_time)) {
-		for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
+	if (unlikely(time >= pipe->tc_time)) {
+		for (i = 0; i < subport->n_traffic_classes; i++)
 			pipe->tc_credits[i] = params->tc_credits_per_period[i];
-		pipe->tc_time = port->time + params->tc_period;
+		pipe->tc_time = time + params->tc_period;
 	}
 
 	/* Pipe TCs - Oversubscription */
@@ -2099,6 +2360,39 @@ grinder_credits_update(struct rte_sched_port *port,
 #endif /* RTE_SCHED_TS_CREDITS_UPDATE, RTE_SCHED_SUBPORT_TC_OV */
 
 
+#ifdef SCHED_VECTOR_AVX2
+
+/* Check the subport and pipe TB and TC credits with a single compare */
+static inline int
+grinder_credits_enough(uint64_t pkt_len, uint64_t subport_tb_credits,
+	uint64_t subport_tc_credits, uint64_t pipe_tb_credits,
+	uint64_t pipe_tc_credits)
+{
+	/* Flip the sign bit to get an unsigned compare out of a signed one */
+	__m256i sign = _mm256_set1_epi64x(INT64_MIN);
+	__m256i len = _mm256_xor_si256(_mm256_set1_epi64x(pkt_len), sign);
+	__m256i credits = _mm256_xor_si256(_mm256_set_epi64x(pipe_tc_credits,
+		pipe_tb_credits, subport_tc_credits, subport_tb_credits), sign);
+	__m256i short_credits = _mm256_cmpgt_epi64(len, credits);
+
+	return _mm256_testz_si256(short_credits, short_credits);
+}
+
+#else
+
+static inline int
+grinder_credits_enough(uint64_t pkt_len, uint64_t subport_tb_credits,
+	uint64_t subport_tc_credits, uint64_t pipe_tb_credits,
+	uint64_t pipe_tc_credits)
+{
+	return (pkt_len <= subport_tb_credits) &&
+		(pkt_len <= subport_tc_credits) &&
+		(pkt_len <= pipe_tb_credits) &&
+		(pkt_len <= pipe_tc_credits);
+}
+
+#endif /* SCHED_VECTOR_AVX2 */
+
 #ifndef RTE_SCHED_SUBPORT_TC_OV
 
 static inline int
@@ -2117,10 +2411,8 @@ grinder_credits_check(struct rte_sched_port *port,
 	int enough_credits;
 
 	/* Check queue credits */
-	enough_credits = (pkt_len <= subport_tb_credits) &&
-		(pkt_len <= subport_tc_credits) &&
-		(pkt_len <= pipe_tb_credits) &&
-		(pkt_len <= pipe_tc_credits);
+	enough_credits = grinder_credits_enough(pkt_len, subport_tb_credits,
+		subport_tc_credits, pipe_tb_credits, pipe_tc_credits);
 
 	if (!enough_credits)
 		return 0;
@@ -2158,15 +2450,13 @@ grinder_credits_check(struct rte_sched_port *port,
 	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
 		pipe_tc_ov_mask1[i] = ~0LLU;
 
-	pipe_tc_ov_mask1[RTE_SCHED_TRAFFIC_CLASS_BE] = pipe->tc_ov_credits;
-	pipe_tc_ov_mask2[RTE_SCHED_TRAFFIC_CLASS_BE] = ~0LLU;
+	pipe_tc_ov_mask1[subport->tc_be] = pipe->tc_ov_credits;
+	pipe_tc_ov_mask2[subport->tc_be] = ~0LLU;
 	pipe_tc_ov_credits = pipe_tc_ov_mask1[tc_index];
 
 	/* Check pipe and subport credits */
-	enough_credits = (pkt_len <= subport_tb_credits) &&
-		(pkt_len <= subport_tc_credits) &&
-		(pkt_len <= pipe_tb_credits) &&
-		(pkt_len <= pipe_tc_credits) &&
+	enough_credits = grinder_credits_enough(pkt_len, subport_tb_credits,
+		subport_tc_credits, pipe_tb_credits, pipe_tc_credits) &&
 		(pkt_len <= pipe_tc_ov_credits);
 
 	if (!enough_credits)
@@ -2199,13 +2489,13 @@ grinder_schedule(struct rte_sched_port *port,
 		return 0;
 
 	/* Advance port time */
-	port->time += pkt_len;
+	subport->clock->time += pkt_len;
 
 	/* Send packet */
-	port->pkts_out[port->n_pkts_out++] = pkt;
+	subport->pkts_out[subport->n_pkts_out++] = pkt;
 	queue->qr++;
 
-	be_tc_active = (grinder->tc_index == RTE_SCHED_TRAFFIC_CLASS_BE) ? ~0x0 : 0x0;
+	be_tc_active = (grinder->tc_index == subport->tc_be) ? ~0x0 : 0x0;
 	grinder->wrr_tokens[grinder->qpos] +=
 		(pkt_len * grinder->wrr_cost[grinder->qpos]) & be_tc_active;
 
@@ -2216,7 +2506,7 @@ grinder_schedule(struct rte_sched_port *port,
 		grinder->qmask &= ~(1 << grinder->qpos);
 		if (be_tc_active)
 			grinder->wrr_mask[grinder->qpos] = 0;
-		rte_sched_port_set_queue_empty_timestamp(port, subport, qindex);
+		rte_sched_port_set_queue_empty_timestamp(subport, qindex);
 	}
 
 	/* Reset pipe loop detection */
@@ -2226,7 +2516,23 @@ grinder_schedule(struct rte_sched_port *port,
 	return 1;
 }
 
-#ifdef SCHED_VECTOR_SSE4
+#ifdef SCHED_VECTOR_AVX2
+
+static inline int
+grinder_pipe_exists(struct rte_sched_subport *subport, uint32_t base_pipe)
+{
+	__m256i index = _mm256_set1_epi32(base_pipe);
+	__m256i pipes = _mm256_loadu_si256(
+		(__m256i *)subport->grinder_base_bmp_pos);
+	__m256i res = _mm256_cmpeq_epi32(pipes, index);
+
+	if (_mm256_testz_si256(res, res))
+		return 0;
+
+	return 1;
+}
+
+#elif defined(SCHED_VECTOR_SSE4)
 
 static inline int
 grinder_pipe_exists(struct rte_sched_subport *subport, uint32_t base_pipe)
@@ -2287,64 +2593,54 @@ grinder_pcache_populate(struct rte_sched_subport *subport,
 	uint32_t pos, uint32_t bmp_pos, uint64_t bmp_slab)
 {
 	struct rte_sched_grinder *grinder = subport->grinder + pos;
-	uint16_t w[4];
+	uint32_t n_pipe_queues = subport->pipe_queue_mask + 1;
+	uint32_t w_mask = (uint32_t) ((1LLU << n_pipe_queues) - 1);
+	uint32_t i;
 
 	grinder->pcache_w = 0;
 	grinder->pcache_r = 0;
 
-	w[0] = (uint16_t) bmp_slab;
-	w[1] = (uint16_t) (bmp_slab >> 16);
-	w[2] = (uint16_t) (bmp_slab >> 32);
-	w[3] = (uint16_t) (bmp_slab >> 48);
-
-	grinder->pcache_qmask[grinder->pcache_w] = w[0];
-	grinder->pcache_qindex[grinder->pcache_w] = bmp_pos;
-	grinder->pcache_w += (w[0] != 0);
+	/* Each 64-bit bitmap slab covers (64 / n_pipe_queues) pipes */
+	for (i = 0; i < 64; i += n_pipe_queues) {
+		uint32_t w = (uint32_t) (bmp_slab >> i) & w_mask;
 
-	grinder->pcache_qmask[grinder->pcache_w] = w[1];
-	grinder->pcache_qindex[grinder->pcache_w] = bmp_pos + 16;
-	grinder->pcache_w += (w[1] != 0);
-
-	grinder->pcache_qmask[grinder->pcache_w] = w[2];
-	grinder->pcache_qindex[grinder->pcache_w] = bmp_pos + 32;
-	grinder->pcache_w += (w[2] != 0);
-
-	grinder->pcache_qmask[grinder->pcache_w] = w[3];
-	grinder->pcache_qindex[grinder->pcache_w] = bmp_pos + 48;
-	grinder->pcache_w += (w[3] != 0);
+		grinder->pcache_qmask[grinder->pcache_w] = w;
+		grinder->pcache_qindex[grinder->pcache_w] = bmp_pos + i;
+		grinder->pcache_w += (w != 0);
+	}
 }
 
 static inline void
 grinder_tccache_populate(struct rte_sched_subport *subport,
-	uint32_t pos, uint32_t qindex, uint16_t qmask)
+	uint32_t pos, uint32_t qindex, uint32_t qmask)
 {
 	struct rte_sched_grinder *grinder = subport->grinder + pos;
-	uint8_t b, i;
+	uint32_t tc_be = subport->tc_be;
+	uint16_t b;
+	uint32_t i;
 
 	grinder->tccache_w = 0;
 	grinder->tccache_r = 0;
 
-	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASS_BE; i++) {
-		b = (uint8_t) ((qmask >> i) & 0x1);
+	for (i = 0; i < tc_be; i++) {
+		b = (uint16_t) ((qmask >> i) & 0x1);
 		grinder->tccache_qmask[grinder->tccache_w] = b;
 		grinder->tccache_qindex[grinder->tccache_w] = qindex + i;
 		grinder->tccache_w += (b != 0);
 	}
 
-	b = (uint8_t) (qmask >> (RTE_SCHED_TRAFFIC_CLASS_BE));
+	b = (uint16_t) (qmask >> tc_be);
 	grinder->tccache_qmask[grinder->tccache_w] = b;
-	grinder->tccache_qindex[grinder->tccache_w] = qindex +
-		RTE_SCHED_TRAFFIC_CLASS_BE;
+	grinder->tccache_qindex[grinder->tccache_w] = qindex + tc_be;
 	grinder->tccache_w += (b != 0);
 }
 
 static inline int
-grinder_next_tc(struct rte_sched_port *port,
-	struct rte_sched_subport *subport, uint32_t pos)
+grinder_next_tc(struct rte_sched_subport *subport, uint32_t pos)
 {
 	struct rte_sched_grinder *grinder = subport->grinder + pos;
 	struct rte_mbuf **qbase;
-	uint32_t qindex;
+	uint32_t qindex, i;
 	uint16_t qsize;
 
 	if (grinder->tccache_r == grinder->tccache_w)
@@ -2352,13 +2648,13 @@ grinder_next_tc(struct rte_sched_port *port,
 
 	qindex = grinder->tccache_qindex[grinder->tccache_r];
 	qbase = rte_sched_subport_pipe_qbase(subport, qindex);
-	qsize = rte_sched_subport_pipe_qsize(port, subport, qindex);
+	qsize = rte_sched_subport_pipe_qsize(subport, qindex);
 
-	grinder->tc_index = rte_sched_port_pipe_tc(port, qindex);
+	grinder->tc_index = rte_sched_subport_pipe_tc(subport, qindex);
 	grinder->qmask = grinder->tccache_qmask[grinder->tccache_r];
 	grinder->qsize = qsize;
 
-	if (grinder->tc_index < RTE_SCHED_TRAFFIC_CLASS_BE) {
+	if (grinder->tc_index < subport->tc_be) {
 		grinder->queue[0] = subport->queue + qindex;
 		grinder->qbase[0] = qbase;
 		grinder->qindex[0] = qindex;
@@ -2367,32 +2663,22 @@ grinder_next_tc(struct rte_sched_port *port,
 		return 1;
 	}
 
-	grinder->queue[0] = subport->queue + qindex;
-	grinder->queue[1] = subport->queue + qindex + 1;
-	grinder->queue[2] = subport->queue + qindex + 2;
-	grinder->queue[3] = subport->queue + qindex + 3;
-
-	grinder->qbase[0] = qbase;
-	grinder->qbase[1] = qbase + qsize;
-	grinder->qbase[2] = qbase + 2 * qsize;
-	grinder->qbase[3] = qbase + 3 * qsize;
-
-	grinder->qindex[0] = qindex;
-	grinder->qindex[1] = qindex + 1;
-	grinder->qindex[2] = qindex + 2;
-	grinder->qindex[3] = qindex + 3;
+	for (i = 0; i < subport->n_be_queues; i++) {
+		grinder->queue[i] = subport->queue + qindex + i;
+		grinder->qbase[i] = qbase + i * qsize;
+		grinder->qindex[i] = qindex + i;
+	}
 
 	grinder->tccache_r++;
 	return 1;
 }
 
 static inline int
-grinder_next_pipe(struct rte_sched_port *port,
-	struct rte_sched_subport *subport, uint32_t pos)
+grinder_next_pipe(struct rte_sched_subport *subport, uint32_t pos)
 {
 	struct rte_sched_grinder *grinder = subport->grinder + pos;
 	uint32_t pipe_qindex;
-	uint16_t pipe_qmask;
+	uint32_t pipe_qmask;
 
 	if (grinder->pcache_r < grinder->pcache_w) {
 		pipe_qmask = grinder->pcache_qmask[grinder->pcache_r];
@@ -2426,14 +2712,14 @@ grinder_next_pipe(struct rte_sched_port *port,
 	}
 
 	/* Install new pipe in the grinder */
-	grinder->pindex = pipe_qindex >> 4;
+	grinder->pindex = pipe_qindex >> subport->n_pipe_queues_log2;
 	grinder->subport = subport;
 	grinder->pipe = subport->pipe + grinder->pindex;
 	grinder->pipe_params = NULL; /* to be set after the pipe structure is prefetched */
 	grinder->productive = 0;
 
 	grinder_tccache_populate(subport, pos, pipe_qindex, pipe_qmask);
-	grinder_next_tc(port, subport, pos);
+	grinder_next_tc(subport, pos);
 
 	/* Check for pipe exhaustion */
 	if (grinder->pindex == subport->pipe_loop) {
@@ -2452,25 +2738,14 @@ grinder_wrr_load(struct rte_sched_subport *subport, uint32_t pos)
 	struct rte_sched_pipe *pipe = grinder->pipe;
 	struct rte_sched_pipe_profile *pipe_params = grinder->pipe_params;
 	uint32_t qmask = grinder->qmask;
+	uint32_t i;
 
-	grinder->wrr_tokens[0] =
-		((uint16_t) pipe->wrr_tokens[0]) << RTE_SCHED_WRR_SHIFT;
-	grinder->wrr_tokens[1] =
-		((uint16_t) pipe->wrr_tokens[1]) << RTE_SCHED_WRR_SHIFT;
-	grinder->wrr_tokens[2] =
-		((uint16_t) pipe->wrr_tokens[2]) << RTE_SCHED_WRR_SHIFT;
-	grinder->wrr_tokens[3] =
-		((uint16_t) pipe->wrr_tokens[3]) << RTE_SCHED_WRR_SHIFT;
-
-	grinder->wrr_mask[0] = (qmask & 0x1) * 0xFFFF;
-	grinder->wrr_mask[1] = ((qmask >> 1) & 0x1) * 0xFFFF;
-	grinder->wrr_mask[2] = ((qmask >> 2) & 0x1) * 0xFFFF;
-	grinder->wrr_mask[3] = ((qmask >> 3) & 0x1) * 0xFFFF;
-
-	grinder->wrr_cost[0] = pipe_params->wrr_cost[0];
-	grinder->wrr_cost[1] = pipe_params->wrr_cost[1];
-	grinder->wrr_cost[2] = pipe_params->wrr_cost[2];
-	grinder->wrr_cost[3] = pipe_params->wrr_cost[3];
+	for (i = 0; i < subport->n_be_queues; i++) {
+		grinder->wrr_tokens[i] =
+			((uint16_t) pipe->wrr_tokens[i]) << RTE_SCHED_WRR_SHIFT;
+		grinder->wrr_mask[i] = ((qmask >> i) & 0x1) * 0xFFFF;
+		grinder->wrr_cost[i] = pipe_params->wrr_cost[i];
+	}
 }
 
 static inline void
@@ -2478,39 +2753,86 @@ grinder_wrr_store(struct rte_sched_subport *subport, uint32_t pos)
 {
 	struct rte_sched_grinder *grinder = subport->grinder + pos;
 	struct rte_sched_pipe *pipe = grinder->pipe;
+	uint32_t i;
 
-	pipe->wrr_tokens[0] =
-			(grinder->wrr_tokens[0] & grinder->wrr_mask[0]) >>
-				RTE_SCHED_WRR_SHIFT;
-	pipe->wrr_tokens[1] =
-			(grinder->wrr_tokens[1] & grinder->wrr_mask[1]) >>
-				RTE_SCHED_WRR_SHIFT;
-	pipe->wrr_tokens[2] =
-			(grinder->wrr_tokens[2] & grinder->wrr_mask[2]) >>
-				RTE_SCHED_WRR_SHIFT;
-	pipe->wrr_tokens[3] =
-			(grinder->wrr_tokens[3] & grinder->wrr_mask[3]) >>
+	for (i = 0; i < subport->n_be_queues; i++)
+		pipe->wrr_tokens[i] =
+			(grinder->wrr_tokens[i] & grinder->wrr_mask[i]) >>
 				RTE_SCHED_WRR_SHIFT;
 }
 
+#ifdef SCHED_VECTOR_SSE4
+
+/*
+ * Up to 16 best-effort queues: mask, minimum search and token update are done
+ * on 8 queues per instruction. The tokens of the queues beyond the configured
+ * ones are always masked, so they never win the minimum search.
+ */
+static inline uint32_t
+grinder_wrr_min_pos(struct rte_sched_grinder *grinder)
+{
+	__m128i ones = _mm_set1_epi16(-1);
+	__m128i t0, t1, min0, min1, min;
+	uint32_t min0_val, min1_val, qpos;
+
+	t0 = _mm_loadu_si128((__m128i *)grinder->wrr_tokens);
+	t1 = _mm_loadu_si128((__m128i *)(grinder->wrr_tokens + 8));
+	t0 = _mm_or_si128(t0, _mm_xor_si128(ones,
+		_mm_loadu_si128((__m128i *)grinder->wrr_mask)));
+	t1 = _mm_or_si128(t1, _mm_xor_si128(ones,
+		_mm_loadu_si128((__m128i *)(grinder->wrr_mask + 8))));
+
+	min0 = _mm_minpos_epu16(t0);
+	min1 = _mm_minpos_epu16(t1);
+	min0_val = _mm_extract_epi16(min0, 0);
+	min1_val = _mm_extract_epi16(min1, 0);
+
+	if (min1_val < min0_val) {
+		qpos = 8 + _mm_extract_epi16(min1, 1);
+		min = _mm_set1_epi16(min1_val);
+	} else {
+		qpos = _mm_extract_epi16(min0, 1);
+		min = _mm_set1_epi16(min0_val);
+	}
+
+	_mm_storeu_si128((__m128i *)grinder->wrr_tokens, _mm_sub_epi16(t0, min));
+	_mm_storeu_si128((__m128i *)(grinder->wrr_tokens + 8),
+		_mm_sub_epi16(t1, min));
+
+	return qpos;
+}
+
+#endif /* SCHED_VECTOR_SSE4 */
+
 static inline void
 grinder_wrr(struct rte_sched_subport *subport, uint32_t pos)
 {
 	struct rte_sched_grinder *grinder = subport->grinder + pos;
+	uint32_t n_be_queues = subport->n_be_queues;
 	uint16_t wrr_tokens_min;
+	uint32_t i;
+
+#ifdef SCHED_VECTOR_SSE4
+	RTE_BUILD_BUG_ON(RTE_SCHED_BE_QUEUES_PER_PIPE_MAX != 16);
+
+	if (n_be_queues > RTE_SCHED_BE_QUEUES_PER_PIPE) {
+		grinder->qpos = grinder_wrr_min_pos(grinder);
+		return;
+	}
+#endif
 
-	grinder->wrr_tokens[0] |= ~grinder->wrr_mask[0];
-	grinder->wrr_tokens[1] |= ~grinder->wrr_mask[1];
-	grinder->wrr_tokens[2] |= ~grinder->wrr_mask[2];
-	grinder->wrr_tokens[3] |= ~grinder->wrr_mask[3];
+	for (i = 0; i < n_be_queues; i++)
+		grinder->wrr_tokens[i] |= ~grinder->wrr_mask[i];
 
-	grinder->qpos = rte_min_pos_4_u16(grinder->wrr_tokens);
+	if (likely(n_be_queues == RTE_SCHED_BE_QUEUES_PER_PIPE))
+		grinder->qpos = rte_min_pos_4_u16(grinder->wrr_tokens);
+	else
+		grinder->qpos = rte_min_pos_n_u16(grinder->wrr_tokens,
+			n_be_queues);
 	wrr_tokens_min = grinder->wrr_tokens[grinder->qpos];
 
-	grinder->wrr_tokens[0] -= wrr_tokens_min;
-	grinder->wrr_tokens[1] -= wrr_tokens_min;
-	grinder->wrr_tokens[2] -= wrr_tokens_min;
-	grinder->wrr_tokens[3] -= wrr_tokens_min;
+	for (i = 0; i < n_be_queues; i++)
+		grinder->wrr_tokens[i] -= wrr_tokens_min;
 }
 
 
@@ -2530,30 +2852,30 @@ grinder_prefetch_tc_queue_arrays(struct rte_sched_subport *subport, uint32_t pos
 {
 	struct rte_sched_grinder *grinder = subport->grinder + pos;
 	uint16_t qsize, qr[RTE_SCHED_MAX_QUEUES_PER_TC];
+	uint32_t n_be_queues = subport->n_be_queues;
+	uint32_t i;
 
 	qsize = grinder->qsize;
 	grinder->qpos = 0;
 
-	if (grinder->tc_index < RTE_SCHED_TRAFFIC_CLASS_BE) {
+	if (grinder->tc_index < subport->tc_be) {
 		qr[0] = grinder->queue[0]->qr & (qsize - 1);
 
 		rte_prefetch0(grinder->qbase[0] + qr[0]);
 		return;
 	}
 
-	qr[0] = grinder->queue[0]->qr & (qsize - 1);
-	qr[1] = grinder->queue[1]->qr & (qsize - 1);
-	qr[2] = grinder->queue[2]->qr & (qsize - 1);
-	qr[3] = grinder->queue[3]->qr & (qsize - 1);
+	for (i = 0; i < n_be_queues; i++)
+		qr[i] = grinder->queue[i]->qr & (qsize - 1);
 
-	rte_prefetch0(grinder->qbase[0] + qr[0]);
-	rte_prefetch0(grinder->qbase[1] + qr[1]);
+	for (i = 0; i < (n_be_queues + 1) / 2; i++)
+		rte_prefetch0(grinder->qbase[i] + qr[i]);
 
 	grinder_wrr_load(subport, pos);
 	grinder_wrr(subport, pos);
 
-	rte_prefetch0(grinder->qbase[2] + qr[2]);
-	rte_prefetch0(grinder->qbase[3] + qr[3]);
+	for (; i < n_be_queues; i++)
+		rte_prefetch0(grinder->qbase[i] + qr[i]);
 }
 
 static inline void
@@ -2584,7 +2906,7 @@ grinder_handle(struct rte_sched_port *port,
 	switch (grinder->state) {
 	case e_GRINDER_PREFETCH_PIPE:
 	{
-		if (grinder_next_pipe(port, subport, pos)) {
+		if (grinder_next_pipe(subport, pos)) {
 			grinder_prefetch_pipe(subport, pos);
 			subport->busy_grinders++;
 
@@ -2621,7 +2943,7 @@ grinder_handle(struct rte_sched_port *port,
 
 		result = grinder_schedule(port, subport, pos);
 
-		wrr_active = (grinder->tc_index == RTE_SCHED_TRAFFIC_CLASS_BE);
+		wrr_active = (grinder->tc_index == subport->tc_be);
 
 		/* Look for next packet within the same TC */
 		if (result && grinder->qmask) {
@@ -2637,7 +2959,7 @@ grinder_handle(struct rte_sched_port *port,
 			grinder_wrr_store(subport, pos);
 
 		/* Look for another active TC within same pipe */
-		if (grinder_next_tc(port, subport, pos)) {
+		if (grinder_next_tc(subport, pos)) {
 			grinder_prefetch_tc_queue_arrays(subport, pos);
 
 			grinder->state = e_GRINDER_PREFETCH_MBUF;
@@ -2651,7 +2973,7 @@ grinder_handle(struct rte_sched_port *port,
 		grinder_evict(subport, pos);
 
 		/* Look for another active pipe */
-		if (grinder_next_pipe(port, subport, pos)) {
+		if (grinder_next_pipe(subport, pos)) {
 			grinder_prefetch_pipe(subport, pos);
 
 			grinder->state = e_GRINDER_PREFETCH_TC_QUEUE_ARRAYS;
@@ -2672,27 +2994,35 @@ grinder_handle(struct rte_sched_port *port,
 }
 
 static inline void
-rte_sched_port_time_resync(struct rte_sched_port *port)
+rte_sched_clock_resync(struct rte_sched_port *port,
+	struct rte_sched_clock *clock)
 {
 	uint64_t cycles = rte_get_tsc_cycles();
 	uint64_t cycles_diff;
 	uint64_t bytes_diff;
-	uint32_t i;
 
-	if (cycles < port->time_cpu_cycles)
-		port->time_cpu_cycles = 0;
+	if (cycles < clock->time_cpu_cycles)
+		clock->time_cpu_cycles = 0;
 
-	cycles_diff = cycles - port->time_cpu_cycles;
+	cycles_diff = cycles - clock->time_cpu_cycles;
 	/* Compute elapsed time in bytes */
 	bytes_diff = rte_reciprocal_divide(cycles_diff << RTE_SCHED_TIME_SHIFT,
 					   port->inv_cycles_per_byte);
 
 	/* Advance port time */
-	port->time_cpu_cycles +=
+	clock->time_cpu_cycles +=
 		(bytes_diff * port->cycles_per_byte) >> RTE_SCHED_TIME_SHIFT;
-	port->time_cpu_bytes += bytes_diff;
-	if (port->time < port->time_cpu_bytes)
-		port->time = port->time_cpu_bytes;
+	clock->time_cpu_bytes += bytes_diff;
+	if (clock->time < clock->time_cpu_bytes)
+		clock->time = clock->time_cpu_bytes;
+}
+
+static inline void
+rte_sched_port_time_resync(struct rte_sched_port *port)
+{
+	uint32_t i;
+
+	rte_sched_clock_resync(port, &port->clock);
 
 	/* Reset pipe loop detection */
 	for (i = 0; i < port->n_subports_per_port; i++)
@@ -2714,6 +3044,52 @@ rte_sched_port_exceptions(struct rte_sched_subport *subport, int second_pass)
 	return exceptions;
 }
 
+static int
+rte_sched_port_dequeue_merge(struct rte_sched_port *port,
+	struct rte_mbuf **pkts, uint32_t n_pkts)
+{
+	uint32_t subport_id = port->subport_id;
+	uint32_t n_subports = 0, count = 0;
+
+	/* Port TB, refilled at the port rate */
+	rte_sched_clock_resync(port, &port->clock);
+	port->mc_tb_credits += port->clock.time_cpu_bytes - port->mc_tb_time;
+	port->mc_tb_credits = RTE_MIN(port->mc_tb_credits, port->mc_tb_size);
+	port->mc_tb_time = port->clock.time_cpu_bytes;
+
+	/*
+	 * Read a burst from each subport ring in turn, as long as there are
+	 * port credits left. The credits may go negative by up to one burst,
+	 * which is paid back on the next refills.
+	 */
+	while (count < n_pkts && port->mc_tb_credits > 0 &&
+	       n_subports < port->n_subports_per_port) {
+		struct rte_sched_subport *subport = port->subports[subport_id];
+		uint32_t n, k;
+
+		n = rte_ring_sc_dequeue_burst(subport->mc_ring,
+			(void **)&pkts[count],
+			RTE_MIN(n_pkts - count,
+				(uint32_t)RTE_SCHED_PORT_MERGE_BURST),
+			NULL);
+
+		for (k = 0; k < n; k++)
+			port->mc_tb_credits -=
+				pkts[count + k]->pkt_len + port->frame_overhead;
+
+		count += n;
+		n_subports = (n == 0) ? n_subports + 1 : 0;
+
+		subport_id++;
+		if (subport_id == port->n_subports_per_port)
+			subport_id = 0;
+	}
+
+	port->subport_id = subport_id;
+
+	return count;
+}
+
 int
 rte_sched_port_dequeue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint32_t n_pkts)
 {
@@ -2721,14 +3097,16 @@ rte_sched_port_dequeue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint
 	uint32_t subport_id = port->subport_id;
 	uint32_t i, n_subports = 0, count;
 
-	port->pkts_out = pkts;
-	port->n_pkts_out = 0;
+	if (port->mc_ring_size != 0)
+		return rte_sched_port_dequeue_merge(port, pkts, n_pkts);
 
 	rte_sched_port_time_resync(port);
 
 	/* Take each queue in the grinder one step further */
 	for (i = 0, count = 0; ; i++)  {
 		subport = port->subports[subport_id];
+		subport->pkts_out = pkts;
+		subport->n_pkts_out = count;
 
 		count += grinder_handle(port, subport,
 				i & (RTE_SCHED_PORT_N_GRINDERS - 1));
@@ -2760,3 +3138,69 @@ rte_sched_port_dequeue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint
 
 	return count;
 }
+
+int
+rte_sched_subport_schedule(struct rte_sched_port *port, uint32_t subport_id,
+	uint32_t n_pkts)
+{
+	struct rte_sched_subport *subport;
+	struct rte_mbuf *pkts[RTE_SCHED_PORT_MERGE_BURST];
+	uint32_t i, count, n_free, n;
+
+	/* Check user parameters */
+	if (port == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter port\n", __func__);
+		return -EINVAL;
+	}
+
+	if (subport_id >= port->n_subports_per_port) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for subport id\n", __func__);
+		return -EINVAL;
+	}
+
+	if (port->mc_ring_size == 0) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Port not in multi-core mode\n", __func__);
+		return -EINVAL;
+	}
+
+	subport = port->subports[subport_id];
+	n_free = rte_ring_free_count(subport->mc_ring);
+	n_pkts = RTE_MIN(n_pkts, n_free);
+	if (n_pkts == 0)
+		return 0;
+
+	rte_sched_clock_resync(port, subport->clock);
+
+	/* Reset pipe loop detection */
+	subport->pipe_loop = RTE_SCHED_PIPE_INVALID;
+
+	/* Run the subport grinders, handing off the packets in bursts */
+	for (i = 0, count = 0; count < n_pkts; count += n) {
+		uint32_t n_burst = RTE_MIN(n_pkts - count,
+			(uint32_t)RTE_SCHED_PORT_MERGE_BURST);
+
+		subport->pkts_out = pkts;
+		subport->n_pkts_out = 0;
+
+		for (n = 0; n < n_burst; i++) {
+			n += grinder_handle(port, subport,
+				i & (RTE_SCHED_PORT_N_GRINDERS - 1));
+
+			if (rte_sched_port_exceptions(subport,
+					i >= RTE_SCHED_PORT_N_GRINDERS))
+				break;
+		}
+
+		/* Single producer, free space checked upfront */
+		rte_ring_sp_enqueue_burst(subport->mc_ring, (void **)pkts, n,
+			NULL);
+
+		if (n < n_burst)
+			return count + n;
+	}
+
+	return count;
+}
@@ -66,31 +66,44 @@ extern "C" {
 #include "rte_red.h"
 #endif
 
-/** Maximum number of queues per pipe.
- * Note that the multiple queues (power of 2) can only be assigned to
- * lowest priority (best-effort) traffic class. Other higher priority traffic
- * classes can only have one queue.
- * Can not change.
+/** Default number of queues per pipe.
+ * Note that the multiple queues can only be assigned to lowest priority
+ * (best-effort) traffic class. Other higher priority traffic classes can
+ * only have one queue.
  *
  * @see struct rte_sched_port_params
  */
 #define RTE_SCHED_QUEUES_PER_PIPE    16
 
-/** Number of WRR queues for best-effort traffic class per pipe.
+/** Maximum number of queues per pipe.
+ *
+ * @see struct rte_sched_port_ext_params
+ */
+#define RTE_SCHED_QUEUES_PER_PIPE_MAX    32
+
+/** Default number of WRR queues for best-effort traffic class per pipe.
  *
  * @see struct rte_sched_pipe_params
  */
 #define RTE_SCHED_BE_QUEUES_PER_PIPE    4
 
-/** Number of traffic classes per pipe (as well as subport).
+/** Maximum number of WRR queues for best-effort traffic class per pipe.
+ *
+ * @see struct rte_sched_subport_ext_params
+ */
+#define RTE_SCHED_BE_QUEUES_PER_PIPE_MAX    16
+
+/** Maximum (and default) number of traffic classes per pipe (as well as
+ * subport).
  * @see struct rte_sched_subport_params
  * @see struct rte_sched_pipe_params
  */
 #define RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE    \
 (RTE_SCHED_QUEUES_PER_PIPE - RTE_SCHED_BE_QUEUES_PER_PIPE + 1)
 
-/** Best-effort traffic class ID
- * Can not change.
+/** Best-effort traffic class ID of the default pipe layout.
+ * With n_traffic_classes set in struct rte_sched_subport_ext_params, the
+ * best-effort traffic class is traffic class (n_traffic_classes - 1).
  */
 #define RTE_SCHED_TRAFFIC_CLASS_BE    (RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE - 1)
 
@@ -262,6 +275,68 @@ struct rte_sched_port_params {
 	uint32_t n_pipes_per_subport;
 };
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this structure may change without prior notice.
+ *
+ * Port extended configuration parameters, for the port settings not
+ * covered by struct rte_sched_port_params. A zero field selects the
+ * default value.
+ */
+struct rte_sched_port_ext_params {
+	/** Number of queues reserved per pipe.
+	 * Power of 2, no bigger than RTE_SCHED_QUEUES_PER_PIPE_MAX. This
+	 * parameter is used to reserve a fixed number of bits in struct
+	 * rte_mbuf::sched.queue_id for the queue within pipe for all the
+	 * subports of the same port. Zero selects RTE_SCHED_QUEUES_PER_PIPE.
+	 */
+	uint32_t n_queues_per_pipe;
+
+	/** Multi-core mode handoff ring size (power of 2).
+	 * When non-zero, each subport is scheduled independently by the lcore
+	 * calling rte_sched_subport_schedule() for it, which moves the
+	 * scheduled packets to a single producer single consumer ring of this
+	 * size, while rte_sched_port_dequeue() merges the subport rings under
+	 * the port rate. Zero selects the single-core mode, where
+	 * rte_sched_port_dequeue() schedules all the subports.
+	 */
+	uint32_t mc_ring_size;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this structure may change without prior notice.
+ *
+ * Subport extended configuration parameters, setting the layout of the
+ * subport pipes. A zero field selects the default value.
+ */
+struct rte_sched_subport_ext_params {
+	/** Number of traffic classes of the subport pipes, the best-effort
+	 * traffic class included. Strict priority traffic classes are
+	 * 0 .. (n_traffic_classes - 2), the best-effort traffic class is
+	 * (n_traffic_classes - 1). The per traffic class arrays of struct
+	 * rte_sched_subport_params and struct rte_sched_pipe_params are
+	 * indexed the same way, entries beyond the best-effort traffic class
+	 * must be zero. Zero selects RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE.
+	 */
+	uint32_t n_traffic_classes;
+
+	/** Number of WRR queues of the best-effort traffic class, up to
+	 * RTE_SCHED_BE_QUEUES_PER_PIPE_MAX. The total number of queues,
+	 * (n_traffic_classes - 1 + n_be_queues), must not exceed the port
+	 * n_queues_per_pipe. Zero selects RTE_SCHED_BE_QUEUES_PER_PIPE.
+	 */
+	uint32_t n_be_queues;
+
+	/** WRR weights of the best-effort traffic class queues, one row per
+	 * entry of the subport pipe profile table, replacing the wrr_weights
+	 * of the pipe profiles. Only the first n_be_queues entries of each
+	 * row are used. Can be NULL when n_be_queues is not bigger than
+	 * RTE_SCHED_BE_QUEUES_PER_PIPE.
+	 */
+	uint8_t (*pipe_wrr_weights)[RTE_SCHED_BE_QUEUES_PER_PIPE_MAX];
+};
+
 /*
  * Configuration
  *
@@ -278,6 +353,25 @@ struct rte_sched_port_params {
 struct rte_sched_port *
 rte_sched_port_config(struct rte_sched_port_params *params);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler port configuration with extended parameters
+ *
+ * @param params
+ *   Port scheduler configuration parameter structure
+ * @param ext_params
+ *   Port scheduler extended configuration parameter structure, NULL
+ *   selects the defaults
+ * @return
+ *   Handle to port scheduler instance upon success or NULL otherwise.
+ */
+__rte_experimental
+struct rte_sched_port *
+rte_sched_port_config_ext(struct rte_sched_port_params *params,
+	struct rte_sched_port_ext_params *ext_params);
+
 /**
  * Hierarchical scheduler port free
  *
@@ -311,6 +405,36 @@ rte_sched_subport_pipe_profile_add(struct rte_sched_port *port,
 	struct rte_sched_pipe_params *params,
 	uint32_t *pipe_profile_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler pipe profile add with extended parameters
+ *
+ * @param port
+ *   Handle to port scheduler instance
+ * @param subport_id
+ *   Subport ID
+ * @param params
+ *   Pipe profile parameters
+ * @param wrr_weights
+ *   WRR weights of the best-effort traffic class queues, n_be_queues
+ *   entries of the subport, replacing the wrr_weights of the pipe profile
+ *   parameters. Can be NULL when the subport n_be_queues is not bigger
+ *   than RTE_SCHED_BE_QUEUES_PER_PIPE.
+ * @param pipe_profile_id
+ *   Set to valid profile id when profile is added successfully.
+ * @return
+ *   0 upon success, error code otherwise
+ */
+__rte_experimental
+int
+rte_sched_subport_pipe_profile_add_ext(struct rte_sched_port *port,
+	uint32_t subport_id,
+	struct rte_sched_pipe_params *params,
+	const uint8_t *wrr_weights,
+	uint32_t *pipe_profile_id);
+
 /**
  * Hierarchical scheduler subport configuration
  *
@@ -328,6 +452,30 @@ rte_sched_subport_config(struct rte_sched_port *port,
 	uint32_t subport_id,
 	struct rte_sched_subport_params *params);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler subport configuration with extended parameters
+ *
+ * @param port
+ *   Handle to port scheduler instance
+ * @param subport_id
+ *   Subport ID
+ * @param params
+ *   Subport configuration parameters
+ * @param ext_params
+ *   Subport extended configuration parameters, NULL selects the defaults
+ * @return
+ *   0 upon success, error code otherwise
+ */
+__rte_experimental
+int
+rte_sched_subport_config_ext(struct rte_sched_port *port,
+	uint32_t subport_id,
+	struct rte_sched_subport_params *params,
+	struct rte_sched_subport_ext_params *ext_params);
+
 /**
  * Hierarchical scheduler pipe configuration
  *
@@ -361,6 +509,34 @@ rte_sched_pipe_config(struct rte_sched_port *port,
 uint32_t
 rte_sched_port_get_memory_footprint(struct rte_sched_port_params *port_params,
 	struct rte_sched_subport_params **subport_params);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler memory footprint size per port with extended
+ * parameters
+ *
+ * @param port_params
+ *   Port scheduler configuration parameter structure
+ * @param subport_params
+ *   Array of subport parameter structures
+ * @param port_ext_params
+ *   Port scheduler extended configuration parameter structure, NULL
+ *   selects the defaults
+ * @param subport_ext_params
+ *   Array of subport extended parameter structures, NULL or a NULL entry
+ *   selects the defaults
+ * @return
+ *   Memory footprint size in bytes upon success, 0 otherwise
+ */
+__rte_experimental
+uint32_t
+rte_sched_port_get_memory_footprint_ext(
+	struct rte_sched_port_params *port_params,
+	struct rte_sched_subport_params **subport_params,
+	struct rte_sched_port_ext_params *port_ext_params,
+	struct rte_sched_subport_ext_params **subport_ext_params);
 /*
  * Statistics
  *
@@ -424,10 +600,10 @@ rte_sched_queue_read_stats(struct rte_sched_port *port,
  * @param pipe
  *   Pipe ID within subport
  * @param traffic_class
- *   Traffic class ID within pipe (0 .. RTE_SCHED_TRAFFIC_CLASS_BE)
+ *   Traffic class ID within pipe (0 .. n_traffic_classes - 1 of the subport)
  * @param queue
  *   Queue ID within pipe traffic class, 0 for high priority TCs, and
- *   0 .. (RTE_SCHED_BE_QUEUES_PER_PIPE - 1) for best-effort TC
+ *   0 .. (n_be_queues - 1 of the subport) for best-effort TC
  * @param color
  *   Packet color set
  */
@@ -452,10 +628,10 @@ rte_sched_port_pkt_write(struct rte_sched_port *port,
  * @param pipe
  *   Pipe ID within subport
  * @param traffic_class
- *   Traffic class ID within pipe (0 .. RTE_SCHED_TRAFFIC_CLASS_BE)
+ *   Traffic class ID within pipe (0 .. n_traffic_classes - 1 of the subport)
  * @param queue
  *   Queue ID within pipe traffic class, 0 for high priority TCs, and
- *   0 .. (RTE_SCHED_BE_QUEUES_PER_PIPE - 1) for best-effort TC
+ *   0 .. (n_be_queues - 1 of the subport) for best-effort TC
  */
 void
 rte_sched_port_pkt_read_tree_path(struct rte_sched_port *port,
@@ -475,6 +651,10 @@ rte_sched_port_pkt_read_color(const struct rte_mbuf *pkt);
  * written to the queue, then the packet is automatically dropped
  * without any action required from the caller.
  *
+ * In multi-core mode, several lcores can enqueue to the same port
+ * concurrently, provided that each subport is only written by the lcore
+ * scheduling it through rte_sched_subport_schedule().
+ *
  * @param port
  *   Handle to port scheduler instance
  * @param pkts
@@ -493,6 +673,10 @@ rte_sched_port_enqueue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint
  * number of packets actually read.  The pkts array needs to be
  * pre-allocated by the caller with at least n_pkts entries.
  *
+ * In multi-core mode, the packets are read from the subport handoff
+ * rings in round robin order, limited by the port rate. This function
+ * must be called by a single lcore at a time.
+ *
  * @param port
  *   Handle to port scheduler instance
  * @param pkts
@@ -507,6 +691,33 @@ rte_sched_port_enqueue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint
 int
 rte_sched_port_dequeue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint32_t n_pkts);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler subport schedule, multi-core mode only. Runs
+ * the scheduler of a single subport and moves up to n_pkts scheduled
+ * packets to the subport handoff ring, from where they are read by
+ * rte_sched_port_dequeue(). Different subports of the same port can be
+ * scheduled by different lcores concurrently, but each subport must be
+ * scheduled by a single lcore at a time.
+ *
+ * @param port
+ *   Handle to port scheduler instance
+ * @param subport_id
+ *   Subport ID
+ * @param n_pkts
+ *   Maximum number of packets to schedule, limited by the free space
+ *   in the subport handoff ring
+ * @return
+ *   Number of packets moved to the subport handoff ring, -EINVAL when the
+ *   parameters are invalid or the port is not in multi-core mode
+ */
+__rte_experimental
+int
+rte_sched_subport_schedule(struct rte_sched_port *port, uint32_t subport_id,
+	uint32_t n_pkts);
+
 #ifdef __cplusplus
 }
 #endif
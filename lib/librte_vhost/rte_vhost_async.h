@@ -173,4 +173,49 @@ __rte_experimental
 uint16_t rte_vhost_poll_enqueue_completed(int vid, uint16_t queue_id,
 		struct rte_mbuf **pkts, uint16_t count);
 
+/**
+ * This function submits dequeue data copies of a vhost device queue to
+ * the async engine. Descriptors are fetched from the guest TX ring and
+ * copied into mbufs allocated from mbuf_pool; copies of at least the
+ * channel threshold are offloaded, shorter ones are done by CPU. The
+ * packets are not returned by this function, applications should poll
+ * them by rte_vhost_poll_dequeue_completed(). Only split rings are
+ * supported, nothing is submitted on packed rings.
+ *
+ * @param vid
+ *  id of vhost device to dequeue data
+ * @param queue_id
+ *  queue id to dequeue data
+ * @param mbuf_pool
+ *  mbuf_pool where host mbuf is allocated
+ * @param count
+ *  packets num to be dequeued
+ * @return
+ *  num of packets submitted
+ */
+__rte_experimental
+uint16_t rte_vhost_submit_dequeue_burst(int vid, uint16_t queue_id,
+		struct rte_mempool *mbuf_pool, uint16_t count);
+
+/**
+ * This function check async completion status for a specific vhost
+ * device queue. Packets which finish copying (dequeue) operation
+ * will be returned in an array, in the order they were submitted,
+ * and their descriptors are given back to the guest.
+ *
+ * @param vid
+ *  id of vhost device to dequeue data
+ * @param queue_id
+ *  queue id to dequeue data
+ * @param pkts
+ *  blank array to get return packet pointer
+ * @param count
+ *  size of the packet array
+ * @return
+ *  num of packets returned
+ */
+__rte_experimental
+uint16_t rte_vhost_poll_dequeue_completed(int vid, uint16_t queue_id,
+		struct rte_mbuf **pkts, uint16_t count);
+
 #endif /* _RTE_VHOST_ASYNC_H_ */
@@ -335,6 +335,8 @@ free_vq(struct virtio_net *dev, struct vhost_virtqueue *vq)
 			rte_free(vq->async_pkts_pending);
 		if (vq->async_pending_info)
 			rte_free(vq->async_pending_info);
+		if (vq->async_pkts_hdr)
+			rte_free(vq->async_pkts_hdr);
 	}
 	rte_free(vq->batch_copy_elems);
 	rte_mempool_free(vq->iotlb_pool);
@@ -1541,6 +1543,14 @@ int rte_vhost_async_channel_register(int vid, uint16_t queue_id,
 		return -1;
 	}
 
+	/* dequeue zero copy already avoids the copy on guest TX queues */
+	if (unlikely((queue_id & 1) && dev->dequeue_zero_copy)) {
+		VHOST_LOG_CONFIG(ERR,
+			"async copy is not supported with dequeue zero copy "
+			"(vid %d, qid: %d)\n", vid, queue_id);
+		return -1;
+	}
+
 	if (unlikely(ops->check_completed_copies == NULL ||
 		ops->transfer_data == NULL))
 		return -1;
@@ -1560,12 +1570,27 @@ int rte_vhost_async_channel_register(int vid, uint16_t queue_id,
 	vq->async_pending_info = rte_malloc(NULL,
 			vq->size * sizeof(uint64_t),
 			RTE_CACHE_LINE_SIZE);
-	if (!vq->async_pkts_pending || !vq->async_pending_info) {
-		if (vq->async_pkts_pending)
+	/* guest TX queue, keep virtio-net headers until copy completion */
+	if (queue_id & 1)
+		vq->async_pkts_hdr = rte_malloc(NULL,
+				vq->size * sizeof(struct virtio_net_hdr),
+				RTE_CACHE_LINE_SIZE);
+	if (!vq->async_pkts_pending || !vq->async_pending_info ||
+			((queue_id & 1) && !vq->async_pkts_hdr)) {
+		if (vq->async_pkts_pending) {
 			rte_free(vq->async_pkts_pending);
+			vq->async_pkts_pending = NULL;
+		}
 
-		if (vq->async_pending_info)
+		if (vq->async_pending_info) {
 			rte_free(vq->async_pending_info);
+			vq->async_pending_info = NULL;
+		}
+
+		if (vq->async_pkts_hdr) {
+			rte_free(vq->async_pkts_hdr);
+			vq->async_pkts_hdr = NULL;
+		}
 
 		VHOST_LOG_CONFIG(ERR,
 				"async register failed: cannot allocate memory for vq data "
@@ -1624,6 +1649,11 @@ int rte_vhost_async_channel_unregister(int vid, uint16_t queue_id)
 		vq->async_pending_info = NULL;
 	}
 
+	if (vq->async_pkts_hdr) {
+		rte_free(vq->async_pkts_hdr);
+		vq->async_pkts_hdr = NULL;
+	}
+
 	vq->async_ops.transfer_data = NULL;
 	vq->async_ops.check_completed_copies = NULL;
 	vq->async_registered = false;
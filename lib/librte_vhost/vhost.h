@@ -225,6 +225,8 @@ struct vhost_virtqueue {
 	#define		ASYNC_PENDING_INFO_N_MSK 0xFFFF
 	#define		ASYNC_PENDING_INFO_N_SFT 16
 	uint64_t	*async_pending_info;
+	/* virtio-net headers of dequeued packets, for offloads */
+	struct virtio_net_hdr	*async_pkts_hdr;
 	uint16_t	async_pkts_idx;
 	uint16_t	async_pkts_inflight_n;
 	uint16_t	async_last_seg_n;
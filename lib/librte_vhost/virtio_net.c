@@ -2861,3 +2861,484 @@ rte_vhost_dequeue_burst(int vid, uint16_t queue_id,
 
 	return count;
 }
+
+static __rte_always_inline int
+async_desc_to_mbuf(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		  struct buf_vector *buf_vec, uint16_t nr_vec,
+		  struct rte_mbuf *m, struct rte_mempool *mbuf_pool,
+		  struct virtio_net_hdr *pkt_hdr, uint16_t max_segs,
+		  struct iovec *src_iovec, struct iovec *dst_iovec,
+		  struct rte_vhost_iov_iter *src_it,
+		  struct rte_vhost_iov_iter *dst_it)
+{
+	uint32_t buf_avail, buf_offset;
+	uint64_t buf_addr, buf_iova, buf_len;
+	uint32_t mbuf_avail, mbuf_offset;
+	uint32_t cpy_len, cpy_threshold;
+	struct rte_mbuf *cur = m, *prev = m;
+	/* A counter to avoid desc dead loop chain */
+	uint16_t vec_idx = 0;
+	struct batch_copy_elem *batch_copy = vq->batch_copy_elems;
+	int error = 0;
+
+	uint32_t tlen = 0;
+	int tvec_idx = 0;
+	void *hpa;
+
+	cpy_threshold = vq->async_threshold;
+
+	buf_addr = buf_vec[vec_idx].buf_addr;
+	buf_iova = buf_vec[vec_idx].buf_iova;
+	buf_len = buf_vec[vec_idx].buf_len;
+
+	if (unlikely(buf_len < dev->vhost_hlen && nr_vec <= 1)) {
+		error = -1;
+		goto out;
+	}
+
+	/*
+	 * The payload may still be in flight when this returns, so the
+	 * offloads are applied at completion time from a copy of the
+	 * virtio-net header.
+	 */
+	if (virtio_net_with_host_offload(dev)) {
+		if (unlikely(buf_len < sizeof(struct virtio_net_hdr)))
+			copy_vnet_hdr_from_desc(pkt_hdr, buf_vec);
+		else
+			rte_memcpy(pkt_hdr, (void *)((uintptr_t)buf_addr),
+				sizeof(struct virtio_net_hdr));
+	} else {
+		pkt_hdr->flags = 0;
+		pkt_hdr->gso_type = VIRTIO_NET_HDR_GSO_NONE;
+	}
+
+	if (unlikely(buf_len < dev->vhost_hlen)) {
+		buf_offset = dev->vhost_hlen - buf_len;
+		vec_idx++;
+		buf_addr = buf_vec[vec_idx].buf_addr;
+		buf_iova = buf_vec[vec_idx].buf_iova;
+		buf_len = buf_vec[vec_idx].buf_len;
+		buf_avail  = buf_len - buf_offset;
+	} else if (buf_len == dev->vhost_hlen) {
+		if (unlikely(++vec_idx >= nr_vec))
+			goto out;
+		buf_addr = buf_vec[vec_idx].buf_addr;
+		buf_iova = buf_vec[vec_idx].buf_iova;
+		buf_len = buf_vec[vec_idx].buf_len;
+
+		buf_offset = 0;
+		buf_avail = buf_len;
+	} else {
+		buf_offset = dev->vhost_hlen;
+		buf_avail = buf_vec[vec_idx].buf_len - dev->vhost_hlen;
+	}
+
+	PRINT_PACKET(dev,
+			(uintptr_t)(buf_addr + buf_offset),
+			(uint32_t)buf_avail, 0);
+
+	mbuf_offset = 0;
+	mbuf_avail  = m->buf_len - RTE_PKTMBUF_HEADROOM;
+	while (1) {
+		cpy_len = RTE_MIN(buf_avail, mbuf_avail);
+
+		/*
+		 * A desc buf might across two host physical pages that are
+		 * not continuous. In such case (gpa_to_hpa returns 0), or
+		 * when the iovec pool is exhausted, data is copied by CPU.
+		 */
+		if (cpy_len >= cpy_threshold && tvec_idx < max_segs &&
+				(hpa = (void *)(uintptr_t)gpa_to_hpa(dev,
+					buf_iova + buf_offset, cpy_len))) {
+			async_fill_vec(src_iovec + tvec_idx, hpa, cpy_len);
+
+			async_fill_vec(dst_iovec + tvec_idx,
+				(void *)(uintptr_t)rte_pktmbuf_iova_offset(cur,
+						mbuf_offset), cpy_len);
+
+			tlen += cpy_len;
+			tvec_idx++;
+		} else if (likely(cpy_len > MAX_BATCH_LEN ||
+				vq->batch_copy_nb_elems >= vq->size)) {
+			rte_memcpy(rte_pktmbuf_mtod_offset(cur, void *,
+							   mbuf_offset),
+				   (void *)((uintptr_t)(buf_addr +
+						   buf_offset)),
+				   cpy_len);
+		} else {
+			batch_copy[vq->batch_copy_nb_elems].dst =
+				rte_pktmbuf_mtod_offset(cur, void *,
+							mbuf_offset);
+			batch_copy[vq->batch_copy_nb_elems].src =
+				(void *)((uintptr_t)(buf_addr + buf_offset));
+			batch_copy[vq->batch_copy_nb_elems].len = cpy_len;
+			vq->batch_copy_nb_elems++;
+		}
+
+		mbuf_avail  -= cpy_len;
+		mbuf_offset += cpy_len;
+		buf_avail -= cpy_len;
+		buf_offset += cpy_len;
+
+		/* This buf reaches to its end, get the next one */
+		if (buf_avail == 0) {
+			if (++vec_idx >= nr_vec)
+				break;
+
+			buf_addr = buf_vec[vec_idx].buf_addr;
+			buf_iova = buf_vec[vec_idx].buf_iova;
+			buf_len = buf_vec[vec_idx].buf_len;
+
+			buf_offset = 0;
+			buf_avail  = buf_len;
+
+			PRINT_PACKET(dev, (uintptr_t)buf_addr,
+					(uint32_t)buf_avail, 0);
+		}
+
+		/*
+		 * This mbuf reaches to its end, get a new one
+		 * to hold more data.
+		 */
+		if (mbuf_avail == 0) {
+			cur = rte_pktmbuf_alloc(mbuf_pool);
+			if (unlikely(cur == NULL)) {
+				VHOST_LOG_DATA(ERR, "Failed to "
+					"allocate memory for mbuf.\n");
+				error = -1;
+				goto out;
+			}
+
+			prev->next = cur;
+			prev->data_len = mbuf_offset;
+			m->nb_segs += 1;
+			m->pkt_len += mbuf_offset;
+			prev = cur;
+
+			mbuf_offset = 0;
+			mbuf_avail  = cur->buf_len - RTE_PKTMBUF_HEADROOM;
+		}
+	}
+
+	prev->data_len = mbuf_offset;
+	m->pkt_len    += mbuf_offset;
+
+out:
+	async_fill_iter(src_it, tlen, src_iovec, tvec_idx);
+	async_fill_iter(dst_it, tlen, dst_iovec, tvec_idx);
+
+	return error;
+}
+
+static __rte_noinline uint16_t
+virtio_dev_tx_async_submit_split(struct virtio_net *dev,
+	struct vhost_virtqueue *vq, uint16_t queue_id,
+	struct rte_mempool *mbuf_pool, uint16_t count)
+{
+	uint16_t pkt_idx, pkt_burst_idx = 0;
+	uint16_t free_entries, n_free_slot, slot_idx;
+	uint16_t dropped = 0;
+	static bool allocerr_warned;
+
+	struct rte_vhost_iov_iter *it_pool = vq->it_pool;
+	struct iovec *vec_pool = vq->vec_pool;
+	struct rte_vhost_async_desc tdes[MAX_PKT_BURST];
+	struct iovec *src_iovec = vec_pool;
+	struct iovec *dst_iovec = vec_pool + (VHOST_MAX_ASYNC_VEC >> 1);
+	struct rte_vhost_iov_iter *src_it = it_pool;
+	struct rte_vhost_iov_iter *dst_it = it_pool + 1;
+	uint16_t n_free_vec = VHOST_MAX_ASYNC_VEC >> 1;
+	struct rte_mbuf *pkts[MAX_PKT_BURST];
+	uint16_t burst_pkt_idx[MAX_PKT_BURST];
+	int n_pkts;
+
+	/*
+	 * The ordering between avail index and
+	 * desc reads needs to be enforced.
+	 */
+	free_entries = __atomic_load_n(&vq->avail->idx, __ATOMIC_ACQUIRE) -
+			vq->last_avail_idx;
+	if (free_entries == 0)
+		return 0;
+
+	rte_prefetch0(&vq->avail->ring[vq->last_avail_idx & (vq->size - 1)]);
+
+	VHOST_LOG_DATA(DEBUG, "(%d) %s\n", dev->vid, __func__);
+
+	count = RTE_MIN(count, MAX_PKT_BURST);
+	count = RTE_MIN(count, free_entries);
+	count = RTE_MIN(count, vq->size - vq->async_pkts_inflight_n);
+	VHOST_LOG_DATA(DEBUG, "(%d) about to dequeue %u buffers\n",
+			dev->vid, count);
+
+	for (pkt_idx = 0; pkt_idx < count; pkt_idx++) {
+		struct buf_vector buf_vec[BUF_VECTOR_MAX];
+		uint16_t head_idx, nr_batch;
+		uint32_t buf_len;
+		uint16_t nr_vec = 0;
+		int err;
+
+		if (unlikely(fill_vec_buf_split(dev, vq,
+						vq->last_avail_idx + pkt_idx,
+						&nr_vec, buf_vec,
+						&head_idx, &buf_len,
+						VHOST_ACCESS_RO) < 0))
+			break;
+
+		update_shadow_used_ring_split(vq, head_idx, 0);
+
+		slot_idx = (vq->async_pkts_idx + pkt_idx) & (vq->size - 1);
+		/* a dropped packet only returns its descriptor */
+		vq->async_pending_info[slot_idx] = 1;
+
+		pkts[pkt_idx] = virtio_dev_pktmbuf_alloc(dev, mbuf_pool,
+				buf_len);
+		if (unlikely(pkts[pkt_idx] == NULL)) {
+			if (!allocerr_warned) {
+				VHOST_LOG_DATA(ERR,
+					"Failed mbuf alloc of size %d from %s on %s.\n",
+					buf_len, mbuf_pool->name, dev->ifname);
+				allocerr_warned = true;
+			}
+			dropped += 1;
+			pkt_idx++;
+			break;
+		}
+
+		nr_batch = vq->batch_copy_nb_elems;
+		err = async_desc_to_mbuf(dev, vq, buf_vec, nr_vec,
+				pkts[pkt_idx], mbuf_pool,
+				&vq->async_pkts_hdr[slot_idx], n_free_vec,
+				src_iovec, dst_iovec, src_it, dst_it);
+		if (unlikely(err)) {
+			vq->batch_copy_nb_elems = nr_batch;
+			rte_pktmbuf_free(pkts[pkt_idx]);
+			pkts[pkt_idx] = NULL;
+			if (!allocerr_warned) {
+				VHOST_LOG_DATA(ERR,
+					"Failed to copy desc to mbuf on %s.\n",
+					dev->ifname);
+				allocerr_warned = true;
+			}
+			dropped += 1;
+			pkt_idx++;
+			break;
+		}
+
+		if (src_it->count) {
+			async_fill_desc(&tdes[pkt_burst_idx], src_it, dst_it);
+			burst_pkt_idx[pkt_burst_idx++] = pkt_idx;
+			vq->async_pending_info[slot_idx] = 1 |
+				(src_it->nr_segs << ASYNC_PENDING_INFO_N_SFT);
+			src_iovec += src_it->nr_segs;
+			dst_iovec += dst_it->nr_segs;
+			n_free_vec -= src_it->nr_segs;
+			src_it += 2;
+			dst_it += 2;
+		}
+	}
+
+	if (unlikely(pkt_idx == 0))
+		return 0;
+
+	vq->last_avail_idx += pkt_idx;
+
+	do_data_copy_dequeue(vq);
+
+	if (pkt_burst_idx) {
+		n_pkts = vq->async_ops.transfer_data(dev->vid,
+				queue_id, tdes, 0, pkt_burst_idx);
+		if (unlikely(n_pkts < (int)pkt_burst_idx)) {
+			uint16_t i;
+
+			/*
+			 * The descriptors are consumed already, drop the
+			 * packets the async engine didn't take.
+			 */
+			for (i = RTE_MAX(n_pkts, 0); i < pkt_burst_idx; i++) {
+				uint16_t idx = burst_pkt_idx[i];
+
+				rte_pktmbuf_free(pkts[idx]);
+				pkts[idx] = NULL;
+				vq->async_pending_info[(vq->async_pkts_idx +
+					idx) & (vq->size - 1)] = 1;
+				dropped += 1;
+			}
+		}
+	}
+
+	n_free_slot = vq->size - vq->async_pkts_idx;
+	if (n_free_slot > pkt_idx) {
+		rte_memcpy(&vq->async_pkts_pending[vq->async_pkts_idx],
+			pkts, pkt_idx * sizeof(uintptr_t));
+		vq->async_pkts_idx += pkt_idx;
+	} else {
+		rte_memcpy(&vq->async_pkts_pending[vq->async_pkts_idx],
+			pkts, n_free_slot * sizeof(uintptr_t));
+		rte_memcpy(&vq->async_pkts_pending[0],
+			&pkts[n_free_slot],
+			(pkt_idx - n_free_slot) * sizeof(uintptr_t));
+		vq->async_pkts_idx = pkt_idx - n_free_slot;
+	}
+	vq->async_pkts_inflight_n += pkt_idx;
+
+	if (likely(vq->shadow_used_idx))
+		async_flush_shadow_used_ring_split(dev, vq);
+
+	return pkt_idx - dropped;
+}
+
+uint16_t
+rte_vhost_submit_dequeue_burst(int vid, uint16_t queue_id,
+	struct rte_mempool *mbuf_pool, uint16_t count)
+{
+	struct virtio_net *dev;
+	struct vhost_virtqueue *vq;
+	uint16_t nb_rx = 0;
+
+	dev = get_device(vid);
+	if (!dev)
+		return 0;
+
+	if (unlikely(!(dev->flags & VIRTIO_DEV_BUILTIN_VIRTIO_NET))) {
+		VHOST_LOG_DATA(ERR,
+			"(%d) %s: built-in vhost net backend is disabled.\n",
+			dev->vid, __func__);
+		return 0;
+	}
+
+	if (unlikely(!is_valid_virt_queue_idx(queue_id, 1, dev->nr_vring))) {
+		VHOST_LOG_DATA(ERR,
+			"(%d) %s: invalid virtqueue idx %d.\n",
+			dev->vid, __func__, queue_id);
+		return 0;
+	}
+
+	if (unlikely(vq_is_packed(dev))) {
+		VHOST_LOG_DATA(ERR,
+			"(%d) %s: async dequeue is not supported on packed ring.\n",
+			dev->vid, __func__);
+		return 0;
+	}
+
+	vq = dev->virtqueue[queue_id];
+
+	if (unlikely(rte_spinlock_trylock(&vq->access_lock) == 0))
+		return 0;
+
+	if (unlikely(vq->enabled == 0 || !vq->async_registered))
+		goto out_access_unlock;
+
+	if (dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM))
+		vhost_user_iotlb_rd_lock(vq);
+
+	if (unlikely(vq->access_ok == 0))
+		if (unlikely(vring_translate(dev, vq) < 0))
+			goto out;
+
+	nb_rx = virtio_dev_tx_async_submit_split(dev, vq, queue_id,
+			mbuf_pool, count);
+
+out:
+	if (dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM))
+		vhost_user_iotlb_rd_unlock(vq);
+
+out_access_unlock:
+	rte_spinlock_unlock(&vq->access_lock);
+
+	return nb_rx;
+}
+
+uint16_t
+rte_vhost_poll_dequeue_completed(int vid, uint16_t queue_id,
+	struct rte_mbuf **pkts, uint16_t count)
+{
+	struct virtio_net *dev = get_device(vid);
+	struct vhost_virtqueue *vq;
+	uint16_t n_segs_cpl, n_pkts_put = 0, n_slots = 0, n_descs = 0;
+	uint16_t start_idx, slot_idx, vq_size;
+	uint16_t n_inflight;
+	uint64_t *async_pending_info;
+	int n_cpl;
+
+	if (!dev)
+		return 0;
+
+	VHOST_LOG_DATA(DEBUG, "(%d) %s\n", dev->vid, __func__);
+	if (unlikely(!is_valid_virt_queue_idx(queue_id, 1, dev->nr_vring))) {
+		VHOST_LOG_DATA(ERR, "(%d) %s: invalid virtqueue idx %d.\n",
+			dev->vid, __func__, queue_id);
+		return 0;
+	}
+
+	vq = dev->virtqueue[queue_id];
+
+	rte_spinlock_lock(&vq->access_lock);
+
+	if (unlikely(!vq->async_registered))
+		goto out;
+
+	n_inflight = vq->async_pkts_inflight_n;
+	async_pending_info = vq->async_pending_info;
+	vq_size = vq->size;
+	start_idx = virtio_dev_rx_async_get_info_idx(vq->async_pkts_idx,
+		vq_size, n_inflight);
+
+	n_cpl = vq->async_ops.check_completed_copies(vid, queue_id,
+		0, ASYNC_MAX_POLL_SEG - vq->async_last_seg_n);
+	n_segs_cpl = RTE_MAX(n_cpl, 0) + vq->async_last_seg_n;
+
+	/* the copied data must be visible before the offloads parse it */
+	rte_smp_rmb();
+
+	while (likely((n_pkts_put < count) && n_inflight)) {
+		uint64_t info, n_segs;
+		struct rte_mbuf *pkt;
+
+		slot_idx = (start_idx + n_slots) & (vq_size - 1);
+		info = async_pending_info[slot_idx];
+		n_segs = info >> ASYNC_PENDING_INFO_N_SFT;
+
+		if (n_segs) {
+			if (unlikely(n_segs_cpl < n_segs)) {
+				if (n_segs_cpl) {
+					async_pending_info[slot_idx] =
+					((n_segs - n_segs_cpl) <<
+					 ASYNC_PENDING_INFO_N_SFT) |
+					(info & ASYNC_PENDING_INFO_N_MSK);
+					n_segs_cpl = 0;
+				}
+				break;
+			}
+			n_segs_cpl -= n_segs;
+		}
+
+		n_slots++;
+		n_inflight--;
+		n_descs += info & ASYNC_PENDING_INFO_N_MSK;
+
+		/* dropped packets leave an empty slot */
+		pkt = (struct rte_mbuf *)vq->async_pkts_pending[slot_idx];
+		if (likely(pkt != NULL)) {
+			vhost_dequeue_offload(&vq->async_pkts_hdr[slot_idx],
+				pkt);
+			pkts[n_pkts_put++] = pkt;
+		}
+	}
+
+	vq->async_last_seg_n = n_segs_cpl;
+
+	if (n_slots) {
+		vq->async_pkts_inflight_n = n_inflight;
+		if (likely(vq->enabled && vq->access_ok)) {
+			__atomic_add_fetch(&vq->used->idx,
+					n_descs, __ATOMIC_RELEASE);
+			vhost_vring_call_split(dev, vq);
+		}
+	}
+
+out:
+	rte_spinlock_unlock(&vq->access_lock);
+
+	return n_pkts_put;
+}